@@ -23,6 +23,7 @@
 #include <ctime>
 #include <string>
 #include "com/centreon/engine/namespace.hh"
+#include "com/centreon/engine/perfdata.hh"
 
 CCE_BEGIN()
 namespace commands {
@@ -98,6 +99,8 @@ class checkable {
   void set_long_plugin_output(std::string const& long_plugin_output);
   std::string const& get_perf_data() const;
   void set_perf_data(std::string const& perf_data);
+  void set_perf_data(std::string&& perf_data, perfdata&& metrics);
+  perfdata const& get_perf_data_metrics() const;
   bool get_flap_detection_enabled(void) const;
   void set_flap_detection_enabled(bool flap_detection_enabled);
   double get_low_flap_threshold() const;
@@ -177,6 +180,8 @@ class checkable {
   std::string _plugin_output;
   std::string _long_plugin_output;
   std::string _perf_data;
+  mutable perfdata _perf_data_metrics;
+  mutable bool _perf_data_parsed;
   bool _flap_detection_enabled;
   double _low_flap_threshold;
   double _high_flap_threshold;
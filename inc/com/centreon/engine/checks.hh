@@ -58,6 +58,7 @@ class check_result {
   check_result(check_result const& other);
   check_result(check_result&& other);
   check_result& operator=(check_result const& other);
+  check_result& operator=(check_result&& other);
 
   enum check_source get_object_check_type() const;
   void set_object_check_type(enum check_source object_check_type);
@@ -75,6 +76,7 @@ class check_result {
   void set_early_timeout(bool early_timeout);
   std::string const& get_output() const;
   void set_output(std::string const& output);
+  void set_output(std::string&& output);
   bool get_exited_ok() const;
   void set_exited_ok(bool exited_ok);
   bool get_reschedule_check() const;
@@ -85,6 +87,15 @@ class check_result {
   void set_latency(double latency);
   int get_check_options() const;
   void set_check_options(int check_options);
+  bool get_output_parsed() const;
+  void parse_output();
+  void take_parsed_output(std::string& plugin_output,
+                          std::string& long_plugin_output,
+                          std::string& perf_data);
+  void take_parsed_output(std::string& plugin_output,
+                          std::string& long_plugin_output,
+                          std::string& perf_data,
+                          perfdata& metrics);
 
   static bool process_check_result_queue(std::string const& dirname);
   static bool process_check_result_file(std::string const& fname);
@@ -105,6 +116,12 @@ class check_result {
   bool _exited_ok;              // did the plugin check return okay?
   int _return_code;             // plugin return code
   std::string _output;          // plugin output
+  // output split by parse_output(), possibly ahead of the reaper
+  bool _output_parsed;
+  std::string _plugin_output;
+  std::string _long_plugin_output;
+  std::string _perf_data;
+  perfdata _perf_data_metrics;
 };
 CCE_END()
 
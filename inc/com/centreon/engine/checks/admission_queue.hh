@@ -0,0 +1,109 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_CHECKS_ADMISSION_QUEUE_HH
+#  define CCE_CHECKS_ADMISSION_QUEUE_HH
+
+#  include <chrono>
+#  include <list>
+#  include <stdint.h>
+#  include <string>
+#  include <unordered_map>
+#  include <utility>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                checks {
+  /**
+   *  @class admission_queue admission_queue.hh
+   *  @brief Service checks waiting for an execution slot.
+   *
+   *  Due service checks that cannot run because the maximum number of
+   *  parallel checks is reached are queued here instead of being
+   *  rescheduled. They are released in FIFO order as soon as slots
+   *  free, optionally honoring per host and per command limits. The
+   *  time checks spend in the queue is accounted separately from
+   *  their scheduling latency.
+   */
+  class                  admission_queue {
+  public:
+    /**
+     *  A queued service check.
+     */
+    struct               entry {
+      uint64_t           host_id;
+      uint64_t           service_id;
+      std::string        command;
+      int                check_options;
+      double             latency;
+      std::chrono::steady_clock::time_point
+                         queued;
+    };
+
+                         admission_queue();
+                         ~admission_queue() throw ();
+    double               average_delay() const throw ();
+    bool                 can_run(
+                           uint64_t host_id,
+                           std::string const& command) const;
+    void                 clear();
+    bool                 empty() const throw ();
+    void                 finished(uint64_t host_id, uint64_t service_id);
+    double               max_delay() const throw ();
+    bool                 pop(entry& e);
+    bool                 push(entry const& e);
+    size_t               size() const throw ();
+    void                 started(
+                           uint64_t host_id,
+                           uint64_t service_id,
+                           std::string const& command);
+
+  private:
+    typedef std::pair<uint64_t, uint64_t>
+                         id;
+    typedef std::list<entry>
+                         entry_list;
+
+    struct               id_hash {
+      size_t             operator()(id const& i) const throw ();
+    };
+
+                         admission_queue(admission_queue const& right);
+    admission_queue&     operator=(admission_queue const& right);
+    bool                 _global_slot_free() const;
+
+    unsigned long long   _admitted;
+    double               _delay_sum;
+    double               _max_delay;
+    std::unordered_map<id, entry_list::iterator, id_hash>
+                         _queued;
+    entry_list           _queue;
+    std::unordered_map<id, std::pair<uint64_t, std::string>, id_hash>
+                         _running;
+    std::unordered_map<std::string, unsigned int>
+                         _running_per_command;
+    std::unordered_map<uint64_t, unsigned int>
+                         _running_per_host;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_CHECKS_ADMISSION_QUEUE_HH
@@ -20,8 +20,12 @@
 #ifndef CCE_CHECKS_CHECKER_HH
 #  define CCE_CHECKS_CHECKER_HH
 
-#  include <queue>
-#  include "com/centreon/concurrency/mutex.hh"
+#  include <deque>
+#  include <unordered_map>
+#  include "com/centreon/engine/checks/admission_queue.hh"
+#  include "com/centreon/engine/checks/reaper_queue.hh"
+#  include "com/centreon/engine/checks/result_workers.hh"
+#  include "com/centreon/engine/checks/spool_watcher.hh"
 #  include "com/centreon/engine/checks.hh"
 #  include "com/centreon/engine/commands/command.hh"
 #  include "com/centreon/engine/commands/command_listener.hh"
@@ -42,11 +46,14 @@ namespace                checks {
    */
 class checker : public commands::command_listener {
  public:
+  admission_queue& admission() throw();
   static checker& instance();
   static void load();
   void push_check_result(check_result const* result);
   void push_check_result(check_result&& result);
   void reap();
+  double reap_rate() const throw();
+  size_t reaper_backlog() const throw();
   bool reaper_is_empty();
   void run(host* hst,
            int check_options = CHECK_OPTION_NONE,
@@ -76,11 +83,19 @@ class checker : public commands::command_listener {
   checker& operator=(checker const& right);
   void finished(commands::result const& res) throw() override;
   host::host_state _execute_sync(host* hst);
+  bool _next_result(check_result& result, bool hosts_first);
+  bool _pop_result(check_result& result);
+  void _queue_result(check_result&& result, uint64_t command_id = 0);
 
+  admission_queue _admission;
   std::unordered_map<uint64_t, check_result> _list_id;
-  concurrency::mutex _mut_reap;
-  std::queue<check_result> _to_reap;
-  std::unordered_map<uint64_t, check_result> _to_reap_partial;
+  int64_t _reap_time;
+  std::deque<check_result> _reaped;
+  std::deque<check_result> _reaped_hosts;
+  uint64_t _reaped_results;
+  spool_watcher _spool;
+  reaper_queue _to_reap;
+  result_workers _workers;
 };
 }
 
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_CHECKS_HOST_CACHE_HH
+#  define CCE_CHECKS_HOST_CACHE_HH
+
+#  include <ctime>
+#  include <stdint.h>
+#  include <unordered_map>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class                    host;
+
+namespace                checks {
+  /**
+   *  @class host_cache host_cache.hh
+   *  @brief Tell whether the last state of a host can be reused.
+   *
+   *  On-demand host checks (reachability of parents and children,
+   *  predictive dependency checks, checks triggered by services) reuse
+   *  the last state of a host if it was checked recently enough. The
+   *  horizon is the one requested by the caller, unless the host has
+   *  its own cached_check_horizon. The cached state of a host is also
+   *  invalidated when one of its parents or of the hosts it depends on
+   *  changes state, as it was determined from their previous state.
+   *
+   *  Lookups are counted as hits (the check was saved) or misses. The
+   *  cache is only used by the events loop thread.
+   */
+  class                  host_cache {
+  public:
+                         host_cache();
+                         ~host_cache() throw ();
+    void                 clear();
+    void                 forget(uint64_t host_id);
+    uint64_t             hits() const throw ();
+    unsigned long        horizon(
+                           host const& hst,
+                           unsigned long default_horizon) const;
+    static host_cache&   instance();
+    void                 invalidate_dependents(
+                           host const& hst,
+                           time_t when);
+    bool                 is_fresh(
+                           host const& hst,
+                           time_t now,
+                           unsigned long horizon) const;
+    bool                 lookup(
+                           host const& hst,
+                           time_t now,
+                           unsigned long horizon);
+    uint64_t             misses() const throw ();
+    void                 reset_stats() throw ();
+    void                 set_horizon(
+                           uint64_t host_id,
+                           unsigned long horizon);
+    void                 unset_horizon(uint64_t host_id);
+
+  private:
+    struct               entry {
+                         entry();
+      bool               has_horizon;
+      unsigned long      horizon;
+      time_t             valid_since;
+    };
+
+                         host_cache(host_cache const& right);
+    host_cache&          operator=(host_cache const& right);
+    void                 _invalidate(host const* hst, time_t when);
+
+    std::unordered_map<uint64_t, entry>
+                         _entries;
+    uint64_t             _hits;
+    uint64_t             _misses;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_CHECKS_HOST_CACHE_HH
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_CHECKS_REAPER_QUEUE_HH
+#  define CCE_CHECKS_REAPER_QUEUE_HH
+
+#  include <atomic>
+#  include <cstddef>
+#  include <stdint.h>
+#  include "com/centreon/engine/checks.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                checks {
+  /**
+   *  @class reaper_queue reaper_queue.hh
+   *  @brief Check results waiting to be reaped.
+   *
+   *  Lock-free multiple producers, single consumer FIFO (Vyukov's
+   *  node based queue). Any thread can push a result, only the events
+   *  loop pops them. Results are moved in and out of the queue, their
+   *  output is never copied.
+   */
+  class                  reaper_queue {
+  public:
+    /**
+     *  A queued result. Results coming from a command execution only
+     *  hold the execution part, their command ID is used to find the
+     *  rest of the result. Complete results have a null command ID.
+     */
+    struct               entry {
+      uint64_t           command_id;
+      check_result       result;
+    };
+
+                         reaper_queue();
+                         ~reaper_queue() throw ();
+    bool                 empty() const throw ();
+    bool                 pop(entry& e);
+    bool                 push(check_result&& result, uint64_t command_id = 0);
+    size_t               size() const throw ();
+
+  private:
+    struct               node {
+      std::atomic<node*> next;
+      entry              value;
+    };
+
+                         reaper_queue(reaper_queue const& right);
+    reaper_queue&        operator=(reaper_queue const& right);
+
+    std::atomic<node*>   _head;
+    std::atomic<size_t>  _size;
+    node*                _tail;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_CHECKS_REAPER_QUEUE_HH
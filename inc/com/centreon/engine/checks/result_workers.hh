@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_CHECKS_RESULT_WORKERS_HH
+#  define CCE_CHECKS_RESULT_WORKERS_HH
+
+#  include <condition_variable>
+#  include <deque>
+#  include <mutex>
+#  include <stdint.h>
+#  include <thread>
+#  include <vector>
+#  include "com/centreon/engine/checks.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                checks {
+  /**
+   *  @class result_workers result_workers.hh
+   *  @brief Pool of threads preparing check results.
+   *
+   *  The reaper hands batches of check results to the pool, which runs
+   *  in parallel the parts of result handling that only depend on the
+   *  result itself (output parsing) or on its objects (flap detection
+   *  state history). Results are sharded by host so that all results
+   *  and objects of a host are prepared by the same thread. Handling
+   *  the prepared results, and all its side effects, is still done by
+   *  the events loop, in the order results were received.
+   */
+  class                  result_workers {
+  public:
+                         result_workers();
+                         ~result_workers() throw ();
+    void                 prepare(std::deque<check_result>& results);
+    void                 resize(unsigned int count);
+    unsigned int         size() const throw ();
+
+  private:
+                         result_workers(result_workers const& right);
+    result_workers&      operator=(result_workers const& right);
+    static void          _prepare_flapping(check_result const& result);
+    void                 _stop();
+    void                 _work(unsigned int shard);
+
+    std::deque<check_result>*
+                         _batch;
+    std::condition_variable
+                         _cv_done;
+    std::condition_variable
+                         _cv_work;
+    uint64_t             _generation;
+    std::mutex           _mutex;
+    unsigned int         _pending;
+    bool                 _quit;
+    std::vector<std::thread>
+                         _threads;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_CHECKS_RESULT_WORKERS_HH
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_CHECKS_SPOOL_WATCHER_HH
+#  define CCE_CHECKS_SPOOL_WATCHER_HH
+
+#  include <atomic>
+#  include <cstddef>
+#  include <ctime>
+#  include <list>
+#  include <mutex>
+#  include <string>
+#  include <thread>
+#  include "com/centreon/engine/checks.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                checks {
+  /**
+   *  @class spool_watcher spool_watcher.hh
+   *  @brief Read check result files dropped in check_result_path.
+   *
+   *  A thread waits for inotify events on the spool directory. When
+   *  the ok-to-go file of a result file appears, the result file is
+   *  read at once, parsed into records and removed. Records are kept
+   *  until the reaper takes them: host and service names are resolved
+   *  by the events loop, which owns the object maps.
+   *
+   *  A file can hold several results, separated by empty lines.
+   */
+  class                  spool_watcher {
+  public:
+    /**
+     *  Check result read from a file, before name resolution.
+     */
+    struct               record {
+      std::string        host_name;
+      check_result       result;
+      std::string        service_description;
+    };
+
+                         spool_watcher();
+                         ~spool_watcher() throw ();
+    static void          parse(
+                           char const* data,
+                           size_t size,
+                           time_t now,
+                           unsigned long max_file_age,
+                           std::list<record>& records);
+    static bool          read_file(
+                           std::string const& path,
+                           time_t now,
+                           unsigned long max_file_age,
+                           std::list<record>& records);
+    static bool          resolve(record& r);
+    void                 stop();
+    void                 take(std::list<record>& records);
+    bool                 watch(
+                           std::string const& dir,
+                           unsigned long max_file_age);
+
+  private:
+                         spool_watcher(spool_watcher const& right);
+    spool_watcher&       operator=(spool_watcher const& right);
+    void                 _process(
+                           std::string const& name,
+                           std::list<record>& records);
+    void                 _publish(std::list<record>& records);
+    void                 _run();
+    void                 _scan(std::list<record>& records);
+
+    std::string          _dir;
+    bool                 _failed;
+    int                  _inotify_fd;
+    std::atomic<unsigned long>
+                         _max_file_age;
+    std::mutex           _mutex;
+    std::list<record>    _records;
+    std::thread          _thread;
+    int                  _wake_fds[2];
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_CHECKS_SPOOL_WATCHER_HH
@@ -21,11 +21,15 @@
 #  define CCE_COMMANDS_CONNECTOR_HH
 
 #  include <memory>
+#  include <mutex>
 #  include <string>
+#  include <unordered_set>
+#  include <vector>
 #  include "com/centreon/concurrency/condvar.hh"
 #  include "com/centreon/concurrency/mutex.hh"
 #  include "com/centreon/concurrency/thread.hh"
 #  include "com/centreon/engine/commands/command.hh"
+#  include "com/centreon/engine/commands/response_buffer.hh"
 #  include "com/centreon/engine/namespace.hh"
 #  include "com/centreon/process.hh"
 #  include "com/centreon/process_listener.hh"
@@ -48,6 +52,16 @@ namespace                commands {
    *
    *  Command is a specific implementation of commands::command who
    *  provide connector, is more efficiente that a raw command.
+   *
+   *  While queries are batched by the calling thread (the events loop),
+   *  execution queries sent by run() are queued and written to the
+   *  connector with a single write when flush_queries() is called, once
+   *  per events loop iteration.
+   *
+   *  When connector_instances is greater than 1, the connector is a
+   *  pool of connector processes. Each query is sent to the member with
+   *  the fewest outstanding queries and members are restarted
+   *  independently.
    */
   class                  connector
     : public command,
@@ -60,7 +74,9 @@ namespace                commands {
                          connector(connector const& right);
                          ~connector() noexcept override;
     connector&           operator=(connector const& right) = delete;
+    static void          batch_queries(bool enable);
     commands::command*   clone() const override;
+    static void          flush_queries();
     unsigned long        run(
                            std::string const& processed_cmd,
                            nagios_macros& macros,
@@ -89,6 +105,12 @@ namespace                commands {
       connector*         _c;
     };
 
+                         connector(
+                           std::string const& connector_name,
+                           std::string const& connector_line,
+                           command_listener* listener,
+                           connector* pool);
+
     struct               query_info {
       std::string        processed_cmd;
       timestamp          start_time;
@@ -101,7 +123,10 @@ namespace                commands {
     void                 finished(process& p) throw () override;
     void                 _connector_close();
     void                 _connector_start();
+    void                 _flush_queries();
+    void                 _forward(result const& res);
     void                 _internal_copy(connector const& right);
+    connector*           _least_loaded();
     std::string const&   _query_ending() const throw ();
     void                 _recv_query_error(char const* data);
     void                 _recv_query_execute(char const* data);
@@ -114,16 +139,28 @@ namespace                commands {
                            unsigned int timeout);
     void                 _send_query_quit();
     void                 _send_query_version();
+    void                 _schedule_flush();
+
+    static thread_local bool
+                         _batching;
+    static std::unordered_set<connector*>
+                         _pending;
+    static std::mutex    _pending_lock;
 
     concurrency::condvar _cv_query;
-    std::string          _data_available;
+    bool                 _flush_scheduled;
     bool                 _is_running;
     std::unordered_map<unsigned long, std::shared_ptr<query_info> >
                          _queries;
     bool                 _query_quit_ok;
     bool                 _query_version_ok;
     concurrency::mutex   _lock;
+    std::vector<std::unique_ptr<connector> >
+                         _members;
+    std::string          _pending_queries;
+    connector*           _pool;
     process              _process;
+    response_buffer      _responses;
     std::unordered_map<unsigned long, result>
                          _results;
     restart              _restart;
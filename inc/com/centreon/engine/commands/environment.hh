@@ -21,7 +21,9 @@
 #ifndef CCE_COMMANDS_ENVIRONMENT_HH
 #  define CCE_COMMANDS_ENVIRONMENT_HH
 
+#  include <memory>
 #  include <string>
+#  include <vector>
 #  include "com/centreon/engine/namespace.hh"
 
 CCE_BEGIN()
@@ -31,7 +33,8 @@ namespace        commands {
    *  @class process environment.hh "com/centreon/environment.hh"
    *  @brief Allow to get and manage environment.
    *
-   *  This class allow to get and set environment.
+   *  This class allow to get and set environment. Variables of another
+   *  environment (a fragment) can be referenced without being copied.
    */
   class          environment {
   public:
@@ -45,16 +48,19 @@ namespace        commands {
     void         add(char const* name, char const* value);
     void         add(std::string const& line);
     void         add(std::string const& name, std::string const& value);
+    void         add(std::shared_ptr<environment const> const& fragment);
     char**       data() throw ();
 
   private:
     void         _internal_copy(environment const& right);
     void         _realoc_buffer(unsigned int size);
     void         _realoc_env(unsigned int size);
-    void         _rebuild_env();
+    void         _relocate(char const* old_buffer) throw ();
 
     char*        _buffer;
     char**       _env;
+    std::vector<std::shared_ptr<environment const> >
+                 _fragments;
     unsigned int _pos_buffer;
     unsigned int _pos_env;
     unsigned int _size_buffer;
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_ENVIRONMENT_CACHE_HH
+#  define CCE_COMMANDS_ENVIRONMENT_CACHE_HH
+
+#  include <memory>
+#  include <mutex>
+#  include <stdint.h>
+#  include <unordered_map>
+#  include "com/centreon/engine/commands/environment.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class contact;
+class host;
+class service;
+
+namespace                commands {
+  /**
+   *  @class environment_cache environment_cache.hh
+   *  @brief Environment macros that only depend on the configuration.
+   *
+   *  Names, aliases, addresses, groups, custom variables, ... of hosts,
+   *  services and contacts, and global macros such as $ADMINEMAIL$ only
+   *  change when a configuration is applied. They are computed once per
+   *  object into an environment fragment that commands reference
+   *  instead of copying. Fragments are tagged with the generation of
+   *  the cache, which is incremented by invalidate() when objects are
+   *  modified, and are rebuilt when they are older. Objects modified
+   *  at runtime, by external commands for example, only drop their own
+   *  fragment.
+   */
+  class                  environment_cache {
+  public:
+    typedef std::shared_ptr<environment const>
+                         fragment;
+
+    fragment             contact(engine::contact* cntct);
+    uint64_t             generation() const;
+    fragment             global();
+    fragment             host(engine::host* hst);
+    static environment_cache&
+                         instance();
+    void                 invalidate();
+    void                 invalidate(void const* object);
+    static bool          is_cached(unsigned int macro) throw ();
+    fragment             service(engine::service* svc);
+
+  private:
+    enum                 kind {
+      kind_contact = 0,
+      kind_global,
+      kind_host,
+      kind_service,
+      kinds
+    };
+
+    struct               entry {
+                         entry() : generation(0) {}
+
+      fragment           env;
+      uint64_t           generation;
+    };
+
+                         environment_cache();
+                         environment_cache(environment_cache const& right);
+                         ~environment_cache() throw ();
+    environment_cache&   operator=(environment_cache const& right);
+    static fragment      _build(kind k, void* object);
+    fragment             _get(kind k, void* object);
+
+    entry                _empty[kinds];
+    std::unordered_map<void const*, entry>
+                         _entries;
+    uint64_t             _generation;
+    mutable std::mutex   _lock;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_COMMANDS_ENVIRONMENT_CACHE_HH
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_PLUGIN_HH
+#  define CCE_COMMANDS_PLUGIN_HH
+
+#  include <memory>
+#  include <string>
+#  include "com/centreon/engine/commands/command.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace               commands {
+  class                 plugin_module;
+
+  /**
+   *  @class plugin plugin.hh
+   *  @brief Command run by a check plugin loaded in the engine.
+   *
+   *  The processed command line is handed to a check plugin loaded
+   *  from a shared object (see plugin_api.hh). Checks run on the
+   *  threads of the plugin pool instead of forked processes.
+   */
+  class                 plugin : public command {
+  public:
+                        plugin(
+                          std::string const& name,
+                          std::string const& command_line,
+                          std::string const& library,
+                          command_listener* listener = NULL);
+                        plugin(plugin const& right);
+                        ~plugin() throw () override;
+    plugin&             operator=(plugin const& right);
+    command*            clone() const override;
+    std::string const&  get_library() const throw ();
+    unsigned long       run(
+                          std::string const& processed_cmd,
+                          nagios_macros& macros,
+                          unsigned int timeout) override;
+    void                run(
+                          std::string const& processed_cmd,
+                          nagios_macros& macros,
+                          unsigned int timeout,
+                          result& res) override;
+
+  private:
+    std::string         _library;
+    std::shared_ptr<plugin_module>
+                        _module;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_COMMANDS_PLUGIN_HH
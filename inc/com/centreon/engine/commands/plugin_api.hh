@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_PLUGIN_API_HH
+#  define CCE_COMMANDS_PLUGIN_API_HH
+
+/*
+** In-process check plugins are shared objects loaded by Centreon
+** Engine, referenced by the plugin property of commands. They are
+** written in C or in any language able to export C functions:
+**
+**   CCE_PLUGIN_API_VERSION(CURRENT_CCE_PLUGIN_API_VERSION)
+**
+**   int cce_plugin_init(void** plugin);
+**     Called once when the shared object is loaded. The plugin can
+**     store its state in *plugin. Returns 0 on success.
+**
+**   int cce_plugin_run(
+**         void* plugin,
+**         char const* args,
+**         unsigned int timeout,
+**         cce_plugin_done done,
+**         void* context);
+**     Called from a check plugin thread of the engine for each check,
+**     args being the command line of the command with its macros
+**     replaced, valid until run returns. The plugin must not block
+**     longer than needed to start the check: done(context, exit_code,
+**     output) is called exactly once, before run returns or later
+**     from any thread. The output is copied by done. Returns 0 if the
+**     check was started, otherwise done must not be called. Checks
+**     not completed after timeout seconds are reported as timed out
+**     by the engine, their late completion is ignored.
+**
+**   void cce_plugin_destroy(void* plugin);
+**     Called once when no command uses the shared object anymore,
+**     after all checks were completed. Threads started by the plugin
+**     must be joined before it returns, the shared object is
+**     unloaded right after.
+*/
+
+/* Plugin API version. */
+#  define CCE_PLUGIN_API_VERSION(x) int __cce_plugin_api_version = x;
+#  define CURRENT_CCE_PLUGIN_API_VERSION 1
+
+#  ifdef __cplusplus
+extern "C" {
+#  endif /* C++ */
+
+typedef void (*cce_plugin_done)(
+               void* context,
+               int exit_code,
+               char const* output);
+typedef int  (*cce_plugin_init_func)(void** plugin);
+typedef int  (*cce_plugin_run_func)(
+               void* plugin,
+               char const* args,
+               unsigned int timeout,
+               cce_plugin_done done,
+               void* context);
+typedef void (*cce_plugin_destroy_func)(void* plugin);
+
+#  ifdef __cplusplus
+}
+#  endif /* C++ */
+
+#endif /* !CCE_COMMANDS_PLUGIN_API_HH */
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_PLUGIN_MODULE_HH
+#  define CCE_COMMANDS_PLUGIN_MODULE_HH
+
+#  include <memory>
+#  include <mutex>
+#  include <string>
+#  include <unordered_map>
+#  include "com/centreon/engine/commands/plugin_api.hh"
+#  include "com/centreon/engine/namespace.hh"
+#  include "com/centreon/library.hh"
+
+CCE_BEGIN()
+
+namespace                commands {
+  /**
+   *  @class plugin_module plugin_module.hh
+   *  @brief Shared object of in-process check plugins.
+   *
+   *  A shared object is loaded and initialized once for all the
+   *  commands using it, and destroyed when the last command and the
+   *  last check using it are gone.
+   */
+  class                  plugin_module {
+  public:
+                         ~plugin_module() throw ();
+    std::string const&   filename() const throw ();
+    static std::shared_ptr<plugin_module>
+                         load(std::string const& filename);
+    int                  run(
+                           char const* args,
+                           unsigned int timeout,
+                           cce_plugin_done done,
+                           void* context);
+
+  private:
+                         plugin_module(std::string const& filename);
+                         plugin_module(plugin_module const& right);
+    plugin_module&       operator=(plugin_module const& right);
+
+    cce_plugin_destroy_func
+                         _destroy;
+    void*                _instance;
+    library              _library;
+    static std::unordered_map<std::string, std::weak_ptr<plugin_module> >
+                         _modules;
+    static std::mutex    _modules_lock;
+    cce_plugin_run_func  _run;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_COMMANDS_PLUGIN_MODULE_HH
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_PLUGIN_POOL_HH
+#  define CCE_COMMANDS_PLUGIN_POOL_HH
+
+#  include <condition_variable>
+#  include <deque>
+#  include <map>
+#  include <memory>
+#  include <mutex>
+#  include <stdint.h>
+#  include <string>
+#  include <thread>
+#  include <vector>
+#  include "com/centreon/engine/commands/command_listener.hh"
+#  include "com/centreon/engine/commands/plugin_module.hh"
+#  include "com/centreon/engine/namespace.hh"
+#  include "com/centreon/process.hh"
+#  include "com/centreon/timestamp.hh"
+
+CCE_BEGIN()
+
+namespace                commands {
+  /**
+   *  @class plugin_pool plugin_pool.hh
+   *  @brief Threads running in-process check plugins.
+   *
+   *  Checks are queued by the events loop and started by the threads
+   *  of the pool. Their results are handed to the listener of their
+   *  command, as raw commands do from the process thread. The pool
+   *  also enforces check timeouts: a check not completed in time is
+   *  reported as timed out and its late completion is ignored.
+   */
+  class                  plugin_pool {
+  public:
+    static plugin_pool&  instance();
+    void                 resize(unsigned int count);
+    void                 run(
+                           std::shared_ptr<plugin_module> const& module,
+                           unsigned long command_id,
+                           std::string const& args,
+                           unsigned int timeout,
+                           command_listener* listener);
+    unsigned int         size() const;
+
+  private:
+    /**
+     *  Check queued or run by a plugin.
+     */
+    struct               query {
+      std::string        args;
+      unsigned long      command_id;
+      std::multimap<int64_t, query*>::iterator
+                         deadline;
+      bool               expired;
+      command_listener*  listener;
+      std::shared_ptr<plugin_module>
+                         module;
+      plugin_pool*       pool;
+      timestamp          start_time;
+      unsigned int       timeout;
+    };
+
+                         plugin_pool();
+                         plugin_pool(plugin_pool const& right);
+                         ~plugin_pool() throw ();
+    plugin_pool&         operator=(plugin_pool const& right);
+    static void          _deliver(
+                           unsigned long command_id,
+                           command_listener* listener,
+                           timestamp const& start_time,
+                           int exit_code,
+                           process::status exit_status,
+                           std::string const& output);
+    static void          _done(
+                           void* context,
+                           int exit_code,
+                           char const* output);
+    void                 _stop();
+    void                 _work();
+
+    std::condition_variable
+                         _cv;
+    std::multimap<int64_t, query*>
+                         _deadlines;
+    mutable std::mutex   _lock;
+    std::deque<query*>   _queue;
+    bool                 _quit;
+    std::vector<std::shared_ptr<plugin_module> >
+                         _released;
+    std::vector<std::thread>
+                         _threads;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_COMMANDS_PLUGIN_POOL_HH
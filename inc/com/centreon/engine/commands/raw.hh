@@ -22,8 +22,11 @@
 
 #  include <list>
 #  include <string>
+#  include <vector>
+#  include "com/centreon/concurrency/condvar.hh"
 #  include "com/centreon/concurrency/mutex.hh"
 #  include "com/centreon/engine/commands/command.hh"
+#  include "com/centreon/engine/commands/spawner.hh"
 #  include "com/centreon/engine/namespace.hh"
 #  include "com/centreon/process.hh"
 #  include "com/centreon/process_listener.hh"
@@ -37,12 +40,21 @@ namespace               commands {
    *  @class raw raw.hh
    *  @brief Raw is a specific implementation of command.
    *
-   *  Raw is a specific implementation of command.
+   *  Raw is a specific implementation of command. Processes are
+   *  forked by clib, or started by the process spawner depending on
+   *  the launcher of the command (command_launcher by default).
    */
   class                 raw
     : public command,
-      public process_listener {
+      public process_listener,
+      public spawner::listener {
   public:
+    enum                launcher_type {
+      launcher_default = 0,
+      launcher_fork,
+      launcher_spawn
+    };
+
                         raw(
                           std::string const& name,
                           std::string const& command_line,
@@ -51,6 +63,7 @@ namespace               commands {
                         ~raw() throw () override;
     raw&                operator=(raw const& right);
     command*            clone() const override;
+    launcher_type       get_launcher() const throw ();
     unsigned long       run(
                           std::string const& process_cmd,
                           nagios_macros& macros,
@@ -60,38 +73,66 @@ namespace               commands {
                           nagios_macros& macros,
                           unsigned int timeout,
                           result& res) override;
+    void                set_command_line(
+                          std::string const& command_line) override;
+    void                set_launcher(launcher_type launcher) throw ();
 
   private:
+    /**
+     *  Macro of the command line exported in the environment.
+     */
+    struct              env_macro {
+      enum              macro_type {
+        argv = 0,
+        contact_address,
+        custom_contact,
+        custom_host,
+        custom_service,
+        standard
+      };
+
+      unsigned int      index;
+      std::string       name;
+      macro_type        type;
+    };
+
     void                data_is_available(process& p) throw () override;
     void                data_is_available_err(process& p) throw () override;
     void                finished(process& p) throw () override;
+    void                spawned(result& res) throw () override;
     static void         _build_argv_macro_environment(
                           nagios_macros const& macros,
                           environment& env);
-    static void         _build_contact_address_environment(
-                          nagios_macros const& macros,
-                          environment& env);
-    static void         _build_custom_contact_macro_environment(
-                          nagios_macros& macros,
-                          environment& env);
-    static void         _build_custom_host_macro_environment(
+    void                _build_environment_macros(
                           nagios_macros& macros,
-                          environment& env);
-    static void         _build_custom_service_macro_environment(
+                          environment& env) const;
+    static void         _build_macrosx_environment(
                           nagios_macros& macros,
                           environment& env);
-    static void         _build_environment_macros(
+    static void         _build_macrox_environment(
                           nagios_macros& macros,
+                          unsigned int macro,
                           environment& env);
-    static void         _build_macrosx_environment(
+    void                _build_referenced_environment(
                           nagios_macros& macros,
-                          environment& env);
+                          environment& env) const;
+    static void         _check_exit(result& res);
     process*            _get_free_process();
+    static void         _parse_env_macros(
+                          std::string const& command_line,
+                          std::vector<env_macro>& macros);
+    bool                _use_spawner() const;
 
+    concurrency::condvar
+                        _cv_spawned;
+    std::vector<env_macro>
+                        _env_macros;
+    launcher_type       _launcher;
     concurrency::mutex  _lock;
     std::unordered_map<process*, unsigned long>
                         _processes_busy;
     std::list<process*> _processes_free;
+    unsigned int        _spawned_busy;
   };
 }
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_RESPONSE_BUFFER_HH
+#  define CCE_COMMANDS_RESPONSE_BUFFER_HH
+
+#  include <cstddef>
+#  include <string>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                commands {
+  /**
+   *  @class response_buffer response_buffer.hh
+   *  @brief Split the output of a connector into responses.
+   *
+   *  Connector responses are terminated by NUL characters. Output
+   *  is appended into a ring buffer and scanned incrementally: bytes
+   *  that were already searched for the terminator are never searched
+   *  again and extracting a response does not move the remaining data,
+   *  so splitting a large read holding many responses is linear.
+   */
+  class                  response_buffer {
+  public:
+                         response_buffer(size_t capacity = 4096);
+                         response_buffer(response_buffer const& right);
+                         ~response_buffer() throw ();
+    response_buffer&     operator=(response_buffer const& right);
+    void                 append(char const* data, size_t size);
+    void                 append(std::string const& data);
+    size_t               capacity() const throw ();
+    void                 clear() throw ();
+    bool                 pop(std::string& response);
+    size_t               size() const throw ();
+
+  private:
+    enum {
+      terminator_size = 4
+    };
+
+    void                 _extract(std::string& response);
+    void                 _grow(size_t size);
+    void                 _internal_copy(response_buffer const& right);
+
+    size_t               _capacity;
+    char*                _data;
+    size_t               _head;
+    size_t               _nuls;
+    size_t               _scanned;
+    size_t               _size;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_COMMANDS_RESPONSE_BUFFER_HH
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_SPAWNER_HH
+#  define CCE_COMMANDS_SPAWNER_HH
+
+#  include <ctime>
+#  include <mutex>
+#  include <string>
+#  include <sys/types.h>
+#  include <thread>
+#  include <unordered_map>
+#  include "com/centreon/engine/commands/result.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                commands {
+  /**
+   *  @class spawner spawner.hh
+   *  @brief Run processes from a small helper process.
+   *
+   *  Forking the engine copies its page tables, which gets slower as
+   *  the engine grows. The spawner forks a helper process once, as
+   *  early as possible, and sends it the commands to run through a
+   *  socket. The helper starts them with posix_spawn() (which does not
+   *  copy the page tables either), reads their output, enforces their
+   *  timeout, reaps them and sends their result back. Children of the
+   *  helper are not children of the engine, so they are not reaped by
+   *  the process manager of clib.
+   *
+   *  Results are read by a thread of the engine, which forwards them to
+   *  the listener of their command. If the helper dies, pending
+   *  commands end as crashed.
+   */
+  class                  spawner {
+  public:
+    /**
+     *  @class listener spawner.hh
+     *  @brief Receive the results of spawned commands.
+     */
+    class                listener {
+    public:
+      virtual            ~listener() throw () {}
+      virtual void       spawned(result& res) throw () = 0;
+    };
+
+                         spawner();
+                         ~spawner() throw ();
+    static spawner&      instance();
+    bool                 is_running() const;
+    void                 run(
+                           listener* l,
+                           unsigned long command_id,
+                           std::string const& cmd,
+                           char** env,
+                           unsigned int timeout,
+                           bool setpgid);
+    void                 run(
+                           unsigned long command_id,
+                           std::string const& cmd,
+                           char** env,
+                           unsigned int timeout,
+                           bool setpgid,
+                           result& res);
+    bool                 start();
+    void                 stop();
+
+  private:
+                         spawner(spawner const& right);
+    spawner&             operator=(spawner const& right);
+    void                 _dispatch(result& res);
+    void                 _fail_pending();
+    void                 _read_results();
+
+    int                  _fd;
+    pid_t                _helper;
+    time_t               _last_start;
+    mutable std::mutex   _lock;
+    std::unordered_map<unsigned long, listener*>
+                         _pending;
+    std::thread          _reader;
+    bool                 _running;
+    bool                 _stopping;
+    std::mutex           _write_lock;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_COMMANDS_SPAWNER_HH
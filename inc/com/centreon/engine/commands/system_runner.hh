@@ -0,0 +1,120 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_SYSTEM_RUNNER_HH
+#  define CCE_COMMANDS_SYSTEM_RUNNER_HH
+
+#  include <condition_variable>
+#  include <deque>
+#  include <functional>
+#  include <memory>
+#  include <mutex>
+#  include <string>
+#  include <unordered_map>
+#  include "com/centreon/engine/commands/command_listener.hh"
+#  include "com/centreon/engine/commands/raw.hh"
+#  include "com/centreon/engine/macros/defines.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace              commands {
+  /**
+   *  @class system_runner system_runner.hh
+   *  @brief Run notification, event handler, OCSP/OCHP and performance
+   *         data commands asynchronously.
+   *
+   *  Commands are started by the same raw command machinery as checks
+   *  and their results are handed to completion callbacks by reap(),
+   *  from the events loop thread, in the order commands finished. At
+   *  most max_concurrent_system_commands commands run at the same
+   *  time, the following ones wait in a queue with a copy of their
+   *  macros, up to max_queued_system_commands commands. Commands above
+   *  this limit fail. Objects may be modified or removed while commands
+   *  run, callbacks look them up again by ID when they are called.
+   */
+  class                system_runner : public command_listener {
+  public:
+    typedef std::function<void (result const&)>
+                       callback;
+    typedef std::shared_ptr<void>
+                       completion;
+    typedef std::function<void ()>
+                       start_callback;
+
+    void               drain();
+    bool               empty() const;
+    static system_runner&
+                       instance();
+    static completion  make_completion(std::function<void ()> const& f);
+    void               reap();
+    void               run(
+                         std::string const& cmd,
+                         nagios_macros& macros,
+                         unsigned int timeout,
+                         callback const& cb,
+                         start_callback const& started = start_callback());
+    unsigned int       running() const;
+    unsigned int       waiting() const;
+
+  private:
+    /**
+     *  Command waiting for a free slot.
+     */
+    struct             job {
+      callback         cb;
+      std::string      cmd;
+      std::unique_ptr<nagios_macros>
+                       macros;
+      start_callback   started;
+      unsigned int     timeout;
+    };
+
+                       system_runner();
+                       system_runner(system_runner const& right);
+                       ~system_runner() throw ();
+    system_runner&     operator=(system_runner const& right);
+    void               finished(result const& res) throw () override;
+    void               _fail(callback const& cb, std::string const& error);
+    bool               _has_free_slot() const;
+    void               _start(
+                         std::string const& cmd,
+                         nagios_macros& macros,
+                         unsigned int timeout,
+                         callback const& cb,
+                         start_callback const& started);
+
+    std::deque<std::pair<callback, result> >
+                       _failed;
+    mutable std::mutex _lock;
+    raw                _raw;
+    std::deque<result> _results;
+    std::condition_variable
+                       _results_cv;
+    std::mutex         _results_lock;
+    std::unordered_map<unsigned long, callback>
+                       _running;
+    unsigned int       _starting;
+    std::deque<job>    _waiting;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_COMMANDS_SYSTEM_RUNNER_HH
@@ -207,6 +207,8 @@
 #  define CMD_DEL_DOWNTIME_BY_HOST_NAME                      170
 #  define CMD_DEL_DOWNTIME_BY_HOSTGROUP_NAME                 171
 #  define CMD_DEL_DOWNTIME_BY_START_TIME_COMMENT             172
+#  define CMD_DUMP_EVENT_STATS                               173
+#  define CMD_RESET_EVENT_STATS                              174
 #  define CMD_DEL_HOST_DOWNTIME_FULL                         501
 #  define CMD_DEL_SVC_DOWNTIME_FULL                          502
 #  define CMD_CUSTOM_COMMAND                                 999
@@ -49,7 +49,11 @@ namespace           configuration {
      *  @class state state.hh
      *  @brief Simple configuration applier for state class.
      *
-     *  Simple configuration applier for state class.
+     *  Simple configuration applier for state class. A reload can be
+     *  done in two steps: prepare() expands the new configuration and
+     *  computes its differences with the current one on any thread,
+     *  then apply_prepared() applies these differences from the
+     *  events loop thread. Only the latter stops the events loop.
      */
     class           state {
     public:
@@ -57,8 +61,11 @@ namespace           configuration {
       void          apply(
                       configuration::state& new_cfg,
                       retention::state& state);
+      bool          apply_prepared();
       static state& instance();
       static void   load();
+      void          prepare(std::unique_ptr<configuration::state> new_cfg);
+      double        stop_the_world_time() const throw ();
       static void   unload();
 
       servicedependency_mmap const&
@@ -95,6 +102,8 @@ namespace           configuration {
                     void _check_hosts() const;
 #endif
 
+      struct        delta;
+
       state&        operator=(state const&);
       void          _apply(configuration::state const& new_cfg);
       template      <typename ConfigurationType, typename ApplierType>
@@ -103,8 +112,16 @@ namespace           configuration {
       void          _apply(
                       configuration::state& new_cfg,
                       retention::state& state);
+      void          _commit(
+                      configuration::state& new_cfg,
+                      delta& d,
+                      retention::state* state);
       template      <typename ConfigurationType, typename ApplierType>
       void          _expand(configuration::state& new_state);
+      void          _prepare(
+                      configuration::state& new_cfg,
+                      configuration::state const& current,
+                      delta& d);
       void          _processing(
                       configuration::state& new_cfg,
                       retention::state* state = NULL);
@@ -115,11 +132,15 @@ namespace           configuration {
 
       std::mutex    _apply_lock;
       state*        _config;
+      std::unique_ptr<delta>
+                    _prepared;
+      std::mutex    _prepared_lock;
       processing_state
                     _processing_state;
 
       servicedependency_mmap
                     _servicedependencies;
+      double        _stop_the_world_time;
       std::unordered_map<std::string, std::string>
                     _user_macros;
     };
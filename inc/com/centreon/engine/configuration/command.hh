@@ -51,6 +51,8 @@ namespace                  configuration {
     std::string const&     command_line() const throw ();
     std::string const&     command_name() const throw ();
     std::string const&     connector() const throw ();
+    std::string const&     launcher() const throw ();
+    std::string const&     plugin() const throw ();
 
    private:
     typedef bool (*setter_func)(command&, char const*);
@@ -58,10 +60,14 @@ namespace                  configuration {
     bool                   _set_command_line(std::string const& value);
     bool                   _set_command_name(std::string const& value);
     bool                   _set_connector(std::string const& value);
+    bool                   _set_launcher(std::string const& value);
+    bool                   _set_plugin(std::string const& value);
 
     std::string            _command_line;
     std::string            _command_name;
     std::string            _connector;
+    std::string            _launcher;
+    std::string            _plugin;
     static std::unordered_map<std::string, setter_func> const _setters;
   };
 
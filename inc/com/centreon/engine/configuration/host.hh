@@ -65,6 +65,7 @@ namespace                  configuration {
     std::string const&     action_url() const throw ();
     std::string const&     address() const throw ();
     std::string const&     alias() const throw ();
+    unsigned int           cached_check_horizon() const throw ();
     bool                   checks_active() const throw ();
     bool                   checks_passive() const throw ();
     std::string const&     check_command() const throw ();
@@ -84,6 +85,7 @@ namespace                  configuration {
     bool                   flap_detection_enabled() const throw ();
     unsigned int           flap_detection_options() const throw ();
     unsigned int           freshness_threshold() const throw ();
+    bool                   have_cached_check_horizon() const throw ();
     bool                   have_coords_2d() const throw ();
     bool                   have_coords_3d() const throw ();
     unsigned int           high_flap_threshold() const throw ();
@@ -123,6 +125,7 @@ namespace                  configuration {
     bool                   _set_action_url(std::string const& value);
     bool                   _set_address(std::string const& value);
     bool                   _set_alias(std::string const& value);
+    bool                   _set_cached_check_horizon(unsigned int value);
     bool                   _set_checks_active(bool value);
     bool                   _set_checks_passive(bool value);
     bool                   _set_check_command(std::string const& value);
@@ -173,6 +176,7 @@ namespace                  configuration {
     std::string            _action_url;
     std::string            _address;
     std::string            _alias;
+    opt<unsigned int>      _cached_check_horizon;
     opt<bool>              _checks_active;
     opt<bool>              _checks_passive;
     std::string            _check_command;
@@ -64,6 +64,33 @@ namespace               configuration {
       strict_iso8601    // ISO8601 (YYYY-MM-DDTHH:MM:SS)
     };
 
+    /**
+     *  @enum state::environment_macros_mode_type
+     *  Macros exported in the environment of commands
+     */
+    enum                environment_macros_mode_type {
+      environment_macros_all = 0,   // all macros
+      environment_macros_referenced // macros of the command line only
+    };
+
+    /**
+     *  @enum state::event_scheduler_type
+     *  Event scheduler implementations
+     */
+    enum                event_scheduler_type {
+      scheduler_heap = 0, // indexed binary heap
+      scheduler_wheel     // hierarchical timing wheel
+    };
+
+    /**
+     *  @enum state::launcher_type
+     *  Process launchers of raw commands
+     */
+    enum                launcher_type {
+      launcher_fork = 0, // processes forked by the engine
+      launcher_spawn     // processes spawned by a helper process
+    };
+
     /**
      *  @enum state::inter_check_delay
      *  Inter-check delay calculation types
@@ -141,12 +168,20 @@ namespace               configuration {
     void                check_orphaned_hosts(bool value);
     void                check_orphaned_services(bool value);
     bool                check_orphaned_services() const throw ();
+    unsigned int        check_plugin_threads() const throw ();
+    void                check_plugin_threads(unsigned int value);
+    unsigned int        check_reaper_budget() const throw ();
+    void                check_reaper_budget(unsigned int value);
     unsigned int        check_reaper_interval() const throw ();
     void                check_reaper_interval(unsigned int value);
     std::string const&  check_result_path() const throw ();
     void                check_result_path(std::string const& value);
+    unsigned int        check_result_workers() const throw ();
+    void                check_result_workers(unsigned int value);
     bool                check_service_freshness() const throw ();
     void                check_service_freshness(bool value);
+    launcher_type       command_launcher() const throw ();
+    void                command_launcher(launcher_type value);
     set_command const&  commands() const throw ();
     set_command&        commands() throw ();
     set_command::const_iterator
@@ -159,6 +194,8 @@ namespace               configuration {
     bool                command_check_interval_is_seconds() const throw();
     std::string const&  command_file() const throw ();
     void                command_file(std::string const& value);
+    unsigned int        connector_instances() const throw ();
+    void                connector_instances(unsigned int value);
     set_connector const&
                         connectors() const throw ();
     set_connector&      connectors() throw ();
@@ -201,10 +238,20 @@ namespace               configuration {
     void                enable_predictive_host_dependency_checks(bool value);
     bool                enable_predictive_service_dependency_checks() const throw ();
     void                enable_predictive_service_dependency_checks(bool value);
+    environment_macros_mode_type
+                        environment_macros_mode() const throw ();
+    void                environment_macros_mode(environment_macros_mode_type value);
+    unsigned int        event_batch_size() const throw ();
+    void                event_batch_size(unsigned int value);
+    unsigned int        event_batch_time() const throw ();
+    void                event_batch_time(unsigned int value);
     unsigned long       event_broker_options() const throw ();
     void                event_broker_options(unsigned long value);
     unsigned int        event_handler_timeout() const throw ();
     void                event_handler_timeout(unsigned int value);
+    event_scheduler_type
+                        event_scheduler() const throw ();
+    void                event_scheduler(event_scheduler_type value);
     bool                execute_host_checks() const throw ();
     void                execute_host_checks(bool value);
     bool                execute_service_checks() const throw ();
@@ -290,14 +337,22 @@ namespace               configuration {
     void                max_check_reaper_time(unsigned int value);
     unsigned long       max_check_result_file_age() const throw ();
     void                max_check_result_file_age(unsigned long value);
+    unsigned int        max_concurrent_system_commands() const throw ();
+    void                max_concurrent_system_commands(unsigned int value);
     unsigned long       max_debug_file_size() const throw ();
     void                max_debug_file_size(unsigned long value);
     unsigned int        max_host_check_spread() const throw ();
     void                max_host_check_spread(unsigned int value);
     unsigned long       max_log_file_size() const throw ();
     void                max_log_file_size(unsigned long value);
+    unsigned int        max_parallel_checks_per_command() const throw ();
+    void                max_parallel_checks_per_command(unsigned int value);
+    unsigned int        max_parallel_checks_per_host() const throw ();
+    void                max_parallel_checks_per_host(unsigned int value);
     unsigned int        max_parallel_service_checks() const throw ();
     void                max_parallel_service_checks(unsigned int value);
+    unsigned int        max_queued_system_commands() const throw ();
+    void                max_queued_system_commands(unsigned int value);
     unsigned int        max_service_check_spread() const throw ();
     void                max_service_check_spread(unsigned int value);
     unsigned int        notification_timeout() const throw ();
@@ -426,6 +481,8 @@ namespace               configuration {
     void                use_timezone(std::string const& value);
     bool                use_true_regexp_matching() const throw ();
     void                use_true_regexp_matching(bool value);
+    bool                watch_check_result_path() const throw ();
+    void                watch_check_result_path(bool value);
 
   private:
     typedef bool (*setter_func)(state&, char const*);
@@ -440,13 +497,16 @@ namespace               configuration {
     void                _set_check_result_path(std::string const& value);
     void                _set_child_processes_fork_twice(std::string const& value);
     void                _set_command_check_interval(std::string const& value);
+    void                _set_command_launcher(std::string const& value);
     void                _set_comment_file(std::string const& value);
     void                _set_daemon_dumps_core(std::string const& value);
     void                _set_date_format(std::string const& value);
     void                _set_downtime_file(std::string const& value);
     void                _set_enable_embedded_perl(std::string const& value);
     void                _set_enable_failure_prediction(std::string const& value);
+    void                _set_environment_macros_mode(std::string const& value);
     void                _set_event_broker_options(std::string const& value);
+    void                _set_event_scheduler(std::string const& value);
     void                _set_free_child_process_memory(std::string const& value);
     void                _set_host_inter_check_delay_method(std::string const& value);
     void                _set_host_perfdata_file_mode(std::string const& value);
@@ -525,13 +585,18 @@ namespace               configuration {
     bool                _check_host_freshness;
     bool                _check_orphaned_hosts;
     bool                _check_orphaned_services;
+    unsigned int        _check_plugin_threads;
+    unsigned int        _check_reaper_budget;
     unsigned int        _check_reaper_interval;
     std::string         _check_result_path;
+    unsigned int        _check_result_workers;
     bool                _check_service_freshness;
     set_command         _commands;
     int                 _command_check_interval;
     bool                _command_check_interval_is_seconds;
     std::string         _command_file;
+    launcher_type       _command_launcher;
+    unsigned int        _connector_instances;
     set_connector       _connectors;
     set_contactgroup    _contactgroups;
     set_contact         _contacts;
@@ -546,8 +611,14 @@ namespace               configuration {
     bool                _enable_notifications;
     bool                _enable_predictive_host_dependency_checks;
     bool                _enable_predictive_service_dependency_checks;
+    environment_macros_mode_type
+                        _environment_macros_mode;
+    unsigned int        _event_batch_size;
+    unsigned int        _event_batch_time;
     unsigned long       _event_broker_options;
     unsigned int        _event_handler_timeout;
+    event_scheduler_type
+                        _event_scheduler;
     bool                _execute_host_checks;
     bool                _execute_service_checks;
     int                 _external_command_buffer_slots;
@@ -585,10 +656,14 @@ namespace               configuration {
                         _macros_filter;
     unsigned int        _max_check_reaper_time;
     unsigned long       _max_check_result_file_age;
+    unsigned int        _max_concurrent_system_commands;
     unsigned long       _max_debug_file_size;
     unsigned int        _max_host_check_spread;
     unsigned long       _max_log_file_size;
+    unsigned int        _max_parallel_checks_per_command;
+    unsigned int        _max_parallel_checks_per_host;
     unsigned int        _max_parallel_service_checks;
+    unsigned int        _max_queued_system_commands;
     unsigned int        _max_service_check_spread;
     unsigned int        _notification_timeout;
     bool                _obsess_over_hosts;
@@ -646,6 +721,7 @@ namespace               configuration {
     bool                _use_syslog;
     std::string         _use_timezone;
     bool                _use_true_regexp_matching;
+    bool                _watch_check_result_path;
   };
 }
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_EVENT_STATS_HH
+#  define CCE_EVENTS_EVENT_STATS_HH
+
+#  include <ostream>
+#  include <stdint.h>
+#  include "com/centreon/engine/events/defines.hh"
+#  include "com/centreon/engine/events/histogram.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                  events {
+  /**
+   *  @class event_stats event_stats.hh
+   *  @brief Time spent by the events loop for each event type.
+   *
+   *  For every event type, the dispatch lag (how late the event ran
+   *  compared to its run time) and the handler duration are recorded
+   *  in histograms, in microseconds. Events are only handled by the
+   *  events loop thread, the statistics are therefore not protected.
+   */
+  class                    event_stats {
+  public:
+    /**
+     *  Statistics of one event type.
+     */
+    struct                 entry {
+      histogram            execution;
+      histogram            lag;
+    };
+
+    enum {
+      // Event types 0 to EVENT_EXPIRE_SERVICE_ACK, then user functions.
+      types = EVENT_EXPIRE_SERVICE_ACK + 2
+    };
+
+                           event_stats();
+                           ~event_stats() throw ();
+    void                   dump(
+                             std::ostream& os,
+                             char const* prefix = "") const;
+    entry const*           find(uint32_t event_type) const throw ();
+    static event_stats&    instance();
+    void                   record(
+                             uint32_t event_type,
+                             uint64_t lag,
+                             uint64_t execution) throw ();
+    void                   reset() throw ();
+
+  private:
+                           event_stats(event_stats const& right);
+    event_stats&           operator=(event_stats const& right);
+    static int             _slot(uint32_t event_type) throw ();
+
+    entry                  _entries[types];
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_EVENTS_EVENT_STATS_HH
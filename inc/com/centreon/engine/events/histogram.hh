@@ -0,0 +1,73 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_HISTOGRAM_HH
+#  define CCE_EVENTS_HISTOGRAM_HH
+
+#  include <stdint.h>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                  events {
+  /**
+   *  @class histogram histogram.hh
+   *  @brief Log-linear histogram of durations.
+   *
+   *  Values are counted in buckets whose width grows with the value,
+   *  like HDR histograms: every power of two is split in sub_buckets
+   *  buckets, so that the relative error of a percentile is at most
+   *  1 / sub_buckets. Recording a value is O(1) and does not allocate.
+   */
+  class                    histogram {
+  public:
+    enum {
+      sub_bucket_bits = 3,
+      sub_buckets = 1 << sub_bucket_bits,
+      buckets = (64 - sub_bucket_bits + 1) * sub_buckets
+    };
+
+                           histogram();
+                           histogram(histogram const& right);
+                           ~histogram() throw ();
+    histogram&             operator=(histogram const& right);
+    uint64_t               count() const throw ();
+    uint64_t               max() const throw ();
+    double                 mean() const throw ();
+    uint64_t               min() const throw ();
+    uint64_t               percentile(double p) const throw ();
+    void                   record(uint64_t value) throw ();
+    void                   reset() throw ();
+    uint64_t               total() const throw ();
+
+  private:
+    static unsigned int    _index(uint64_t value) throw ();
+    static uint64_t        _upper_bound(unsigned int index) throw ();
+
+    uint64_t               _buckets[buckets];
+    uint64_t               _count;
+    uint64_t               _max;
+    uint64_t               _min;
+    uint64_t               _total;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_EVENTS_HISTOGRAM_HH
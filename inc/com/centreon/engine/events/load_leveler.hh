@@ -0,0 +1,100 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_LOAD_LEVELER_HH
+#  define CCE_EVENTS_LOAD_LEVELER_HH
+
+#  include <stdint.h>
+#  include <time.h>
+#  include <unordered_map>
+#  include <vector>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class checkable;
+
+namespace                  events {
+  /**
+   *  @class load_leveler load_leveler.hh
+   *  @brief Projected check load, second per second.
+   *
+   *  Every scheduled host or service check reserves its expected
+   *  execution time in the second it is scheduled in. The expected
+   *  execution time is learned from the completed executions of the
+   *  check. When a check is placed, it can be postponed by a few
+   *  seconds to the least loaded second, so that the check load stays
+   *  flat instead of spiky.
+   *
+   *  The projection covers the next horizon seconds on the monotonic
+   *  clock, checks scheduled farther are not accounted.
+   */
+  class                    load_leveler {
+  public:
+    enum {
+      horizon = 1 << 12
+    };
+
+                           load_leveler();
+                           ~load_leveler() throw ();
+    double                 average_load(unsigned int seconds) const;
+    void                   clear();
+    double                 expected_cost(void const* check) const;
+    void                   forget(void const* check);
+    static load_leveler&   instance();
+    void                   learn(
+                             void const* check,
+                             double execution_time);
+    double                 load(time_t when) const;
+    static time_t          max_delay(checkable const& check);
+    double                 peak_load(unsigned int seconds) const;
+    time_t                 place(
+                             void const* check,
+                             time_t when,
+                             time_t max_delay);
+    bool                   placed(void const* check) const;
+
+  private:
+    struct                 reservation {
+      double               cost;
+      bool                 learned;
+      double               reserved;
+      time_t               when;
+    };
+
+                           load_leveler(load_leveler const& right);
+    load_leveler&          operator=(load_leveler const& right);
+    void                   _advance(time_t now) const;
+    double                 _default_cost() const throw ();
+    void                   _release(reservation& r);
+    size_t                 _slot(time_t when) const throw ();
+
+    double                 _learned_costs;
+    unsigned int           _learned_count;
+    mutable std::vector<double>
+                           _load;
+    mutable time_t         _origin;
+    std::unordered_map<void const*, reservation>
+                           _reservations;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_EVENTS_LOAD_LEVELER_HH
@@ -23,38 +23,76 @@
 #  define CCE_EVENTS_LOOP_HH
 
 #  include <ctime>
+#  include <future>
 #  include "com/centreon/engine/events/timed_event.hh"
 #  include "com/centreon/engine/namespace.hh"
 
 CCE_BEGIN()
 
+class                 service;
+
 namespace             events {
   /**
    *  @class loop loop.hh
    *  @brief Create Centreon Engine event loop on a new thread.
    *
    *  Events loop is a singleton to create a new thread
-   *  and dispatch the Centreon Engine events.
+   *  and dispatch the Centreon Engine events. When idle, the loop
+   *  blocks until the next event is due or until a producer wakes
+   *  it up.
    */
   class               loop {
   public:
+    enum              wakeup_reason {
+      wakeup_event = 1,
+      wakeup_check_result = 2,
+      wakeup_external_command = 4,
+      wakeup_system_command = 8
+    };
+
+    /**
+     *  Counters of the last loop iteration that handled events.
+     */
+    struct            iteration {
+      unsigned int    events_run;
+      unsigned int    events_deferred;
+      unsigned long   duration;
+      time_t          lag;
+    };
+
     static loop&      instance();
+    iteration const&  last_iteration() const throw ();
     static void       load();
     void              run();
     static void       unload();
+    static void       wakeup(unsigned int reasons = wakeup_event) throw ();
 
   private:
+    enum              dispatch_status {
+      event_none = 0,
+      event_run,
+      event_deferred
+    };
+
                       loop();
                       loop(loop const&);
                       ~loop() throw ();
     loop&             operator=(loop const&);
+    dispatch_status   _dispatch_event(time_t current_time);
     void              _dispatching();
+    void              _handle_wakeup(unsigned int reasons);
+    time_t            _lag(time_t now) const;
+    bool              _queue_check(service* svc);
+    void              _release_checks();
+    void              _update_scheduler(time_t now);
+    void              _wait(int timeout);
+    int               _wait_timeout() const;
 
+    iteration         _last_iteration;
     time_t            _last_status_update;
     time_t            _last_time;
     unsigned int      _need_reload;
-
-    bool              _reload_running;
+    std::future<void> _reload;
     timed_event       _sleep_event;
   };
 }
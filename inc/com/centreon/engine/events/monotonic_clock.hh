@@ -0,0 +1,59 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_MONOTONIC_CLOCK_HH
+#  define CCE_EVENTS_MONOTONIC_CLOCK_HH
+
+#  include <stdint.h>
+#  include <time.h>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                  events {
+  /**
+   *  @class monotonic_clock monotonic_clock.hh
+   *  @brief Clock used to schedule timed events.
+   *
+   *  This clock is CLOCK_MONOTONIC shifted so that it matches the wall
+   *  clock when the engine starts. It is not affected by system time
+   *  changes: when the wall clock jumps, only the skew between both
+   *  clocks changes and wall clock times (event run times, next check
+   *  times, ...) can be converted back and forth in O(1).
+   */
+  class                    monotonic_clock {
+  public:
+    static time_t          now() throw ();
+    static int64_t         now_us() throw ();
+    static time_t          skew() throw ();
+    static time_t          sync() throw ();
+    static time_t          to_monotonic(time_t wall) throw ();
+    static time_t          to_wall(time_t monotonic) throw ();
+
+  private:
+                           monotonic_clock();
+                           monotonic_clock(monotonic_clock const& right);
+                           ~monotonic_clock();
+    monotonic_clock&       operator=(monotonic_clock const& right);
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_EVENTS_MONOTONIC_CLOCK_HH
@@ -23,18 +23,18 @@
 #ifndef CCE_EVENTS_TIMED_EVENT_HH
 #  define CCE_EVENTS_TIMED_EVENT_HH
 
-#  include <deque>
 #  include <stdint.h>
 #  include <time.h>
+#  include "com/centreon/engine/events/timed_event_list.hh"
 #  include "com/centreon/engine/namespace.hh"
 
-CCE_BEGIN()
-class timed_event;
-CCE_END()
-
-typedef std::deque<com::centreon::engine::timed_event*> timed_event_list;
+typedef com::centreon::engine::timed_event_list timed_event_list;
 
 CCE_BEGIN()
+namespace events {
+  class timing_wheel;
+}
+
 class                        timed_event{
  public:
   enum                priority {
@@ -55,7 +55,6 @@ class                        timed_event{
                                 int32_t event_options);
 
   uint32_t                   event_type;
-  time_t                     run_time;
   bool                       recurring;
   unsigned long              event_interval;
   bool                       compensate_for_time_change;
@@ -68,7 +67,23 @@ class                        timed_event{
   static timed_event_list    event_list_low;
 
   static timed_event*        find_event(timed_event::priority, uint32_t event, void *data);
+  time_t                     get_run_time() const throw ();
+  time_t                     monotonic_time() const throw ();
+  void                       set_run_time(time_t run_time) throw ();
   void schedule(bool high_priority);
+
+ private:
+  friend class               timed_event_list;
+  friend class               events::timing_wheel;
+
+  size_t                     _position;
+  uint32_t                   _indexed_type;
+  void*                      _indexed_data;
+  time_t                     _monotonic_time;
+  uint64_t                   _sequence;
+  timed_event*               _wheel_next;
+  timed_event*               _wheel_prev;
+  unsigned int               _wheel_slot;
 };
 CCE_END()
 
@@ -103,16 +118,21 @@ void resort_event_list(com::centreon::engine::timed_event::priority priority);
 #  ifdef __cplusplus
 
 #    include <ostream>
+#    include <vector>
 #    include "com/centreon/engine/namespace.hh"
 
 CCE_BEGIN()
 
 namespace            events {
   std::string const& name(timed_event const& evt);
+  std::string const& name(uint32_t event_type);
 }
 
 CCE_END()
 
+void          add_events(
+  std::vector<com::centreon::engine::timed_event*> const& events,
+  com::centreon::engine::timed_event::priority priority);
 bool          operator==(
   com::centreon::engine::timed_event const& obj1,
   com::centreon::engine::timed_event const& obj2) throw ();
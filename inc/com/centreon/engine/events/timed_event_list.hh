@@ -0,0 +1,130 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_TIMED_EVENT_LIST_HH
+#  define CCE_EVENTS_TIMED_EVENT_LIST_HH
+
+#  include <cstddef>
+#  include <memory>
+#  include <stdint.h>
+#  include <time.h>
+#  include <unordered_map>
+#  include <unordered_set>
+#  include <utility>
+#  include <vector>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class timed_event;
+namespace events {
+  class timing_wheel;
+}
+
+/**
+ *  @class timed_event_list timed_event_list.hh
+ *  @brief Indexed priority queue of timed events.
+ *
+ *  Two schedulers are available. The default one stores events in a
+ *  binary min-heap ordered by run time, events sharing the same run
+ *  time being kept in insertion order. Every event remembers its
+ *  position in the heap so that it can be removed or moved in
+ *  O(log n). The wheel scheduler stores events in a hierarchical
+ *  timing wheel (see events::timing_wheel) with O(1) insertion and
+ *  removal, at the price of a one second granularity.
+ *
+ *  In both cases a hash index keyed by (event_type, event_data) gives
+ *  O(1) lookups and iteration (begin()/end()) is not ordered by run
+ *  time. Many events can be pushed at once, in which case the heap is
+ *  rebuilt once in O(n) instead of sifting every event up.
+ *
+ *  Events are ordered on the monotonic clock (see
+ *  events::monotonic_clock), on which their run time is stored. A wall
+ *  clock change therefore does not break the ordering. Events that
+ *  occur at specific wall clock times or that use a timing function
+ *  are tracked apart (see pinned()), they are the only ones to move
+ *  when the wall clock changes.
+ */
+class                      timed_event_list {
+ public:
+  typedef std::vector<timed_event*>::const_iterator
+                           const_iterator;
+  typedef const_iterator   iterator;
+
+  enum                     scheduler_type {
+    heap = 0,
+    wheel
+  };
+
+                           timed_event_list();
+                           ~timed_event_list() throw ();
+  void                     advance(time_t now);
+  const_iterator           begin() const throw ();
+  void                     clear() throw ();
+  bool                     contains(timed_event const* evt) const throw ();
+  bool                     empty() const throw ();
+  const_iterator           end() const throw ();
+  bool                     erase(timed_event* evt);
+  timed_event*             find(uint32_t event_type, void* event_data) const;
+  timed_event*             front() const;
+  scheduler_type           get_scheduler() const throw ();
+  std::unordered_set<timed_event*> const&
+                           pinned() const throw ();
+  timed_event*             pop_front();
+  void                     push(timed_event* evt);
+  void                     push(std::vector<timed_event*> const& events);
+  void                     resort();
+  void                     set_scheduler(scheduler_type type);
+  size_t                   size() const throw ();
+  void                     update(timed_event* evt);
+
+ private:
+  typedef std::pair<uint32_t, void*>
+                           key;
+  struct                   key_hash {
+    size_t                 operator()(key const& k) const throw ();
+  };
+  typedef std::unordered_multimap<key, timed_event*, key_hash>
+                           index;
+
+                           timed_event_list(timed_event_list const& right);
+  timed_event_list&        operator=(timed_event_list const& right);
+  void                     _append(timed_event* evt);
+  bool                     _before(
+                             timed_event const* first,
+                             timed_event const* second) const throw ();
+  void                     _index_erase(timed_event* evt);
+  void                     _place(timed_event* evt, size_t pos) throw ();
+  void                     _remove_at(size_t pos);
+  void                     _sift_down(size_t pos) throw ();
+  void                     _sift_up(size_t pos) throw ();
+
+  std::vector<timed_event*>
+                           _events;
+  index                    _index;
+  std::unordered_set<timed_event*>
+                           _pinned;
+  uint64_t                 _sequence;
+  std::unique_ptr<events::timing_wheel>
+                           _wheel;
+};
+
+CCE_END()
+
+#endif // !CCE_EVENTS_TIMED_EVENT_LIST_HH
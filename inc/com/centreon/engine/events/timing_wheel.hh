@@ -0,0 +1,110 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_TIMING_WHEEL_HH
+#  define CCE_EVENTS_TIMING_WHEEL_HH
+
+#  include <cstddef>
+#  include <stdint.h>
+#  include <time.h>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class timed_event;
+
+namespace                  events {
+  /**
+   *  @class timing_wheel timing_wheel.hh
+   *  @brief Hierarchical timing wheel of timed events.
+   *
+   *  The wheel has a one second granularity. Its first level holds
+   *  the events of the next 256 seconds (one slot per second), the
+   *  three following levels hold 64 slots each covering respectively
+   *  256 seconds, ~4.5 hours and ~12 days. Events farther in time are
+   *  kept in an overflow slot. Insertion and removal are O(1), slots
+   *  of upper levels are cascaded down when the wheel advances.
+   *
+   *  The front event is cached and only looked up again when it is
+   *  removed. Occupancy bitmaps of the levels and the cached earliest
+   *  event of upper slots keep this lookup independent of the number
+   *  of events.
+   *
+   *  Events whose run time is reached are moved to a ready slot from
+   *  which they are returned in FIFO order: there is no ordering
+   *  among events due during the same second.
+   *
+   *  Times are on the monotonic clock (see events::monotonic_clock).
+   */
+  class                    timing_wheel {
+  public:
+                           timing_wheel(time_t now);
+                           ~timing_wheel() throw ();
+    void                   advance(time_t now);
+    void                   clear() throw ();
+    time_t                 current() const throw ();
+    timed_event*           front() const;
+    void                   insert(timed_event* evt);
+    void                   remove(timed_event* evt);
+    void                   reset(time_t now);
+    size_t                 size() const throw ();
+
+  private:
+    enum {
+      first_level_bits = 8,
+      first_level_slots = 1 << first_level_bits,
+      level_bits = 6,
+      level_slots = 1 << level_bits,
+      levels = 4,
+      overflow_slot = first_level_slots + (levels - 1) * level_slots,
+      ready_slot,
+      slot_count
+    };
+
+    struct                 slot {
+      mutable timed_event* earliest;
+      timed_event*         head;
+      timed_event*         tail;
+    };
+
+                           timing_wheel(timing_wheel const& right);
+    timing_wheel&          operator=(timing_wheel const& right);
+    void                   _append(unsigned int idx, timed_event* evt);
+    void                   _cascade(unsigned int idx);
+    timed_event*           _earliest(unsigned int idx) const;
+    int                    _first_occupied(
+                             unsigned int offset,
+                             unsigned int count,
+                             unsigned int from) const throw ();
+    unsigned int           _slot_of(time_t when) const throw ();
+    void                   _unlink(timed_event* evt) throw ();
+
+    time_t                 _current;
+    size_t                 _first_level;
+    mutable timed_event*   _front;
+    uint64_t               _occupied[overflow_slot / 64];
+    size_t                 _ready;
+    size_t                 _size;
+    slot                   _slots[slot_count];
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_EVENTS_TIMING_WHEEL_HH
@@ -22,6 +22,7 @@
 
 #  include <list>
 #  include <unordered_map>
+#  include <unordered_set>
 #  include <memory>
 #  include <ostream>
 #  include <string>
@@ -252,7 +253,9 @@ class                host : public notifier {
                                     std::string const& not_author,
                                     std::string const& not_data,
                                     int options,
-                                    int escalated) override;
+                                    int escalated,
+                                    std::shared_ptr<void> const&
+                                      notification_done) override;
   void               update_notification_flags() override;
   void               schedule_acknowledgement_expiration();
   bool               is_valid_escalation_for_notification(
@@ -266,6 +269,7 @@ class                host : public notifier {
 
   host_map_unsafe     parent_hosts;
   host_map_unsafe     child_hosts;
+  host_map_unsafe     dependent_hosts;
   static host_map     hosts;
   static host_id_map  hosts_by_id;
 
@@ -276,6 +280,9 @@ class                host : public notifier {
                       get_parent_groups();
 
 private:
+  void                _resolve_reachability();
+  void                _resolve_reachability_waiters();
+
   uint64_t            _id;
   std::string         _name;
   std::string         _alias;
@@ -307,6 +314,8 @@ private:
   enum host_state    _initial_state;
   std::list<hostgroup*>
                      _hostgroups;
+  std::unordered_set<uint64_t>
+                     _reachability_waiters;
 };
 
 CCE_END()
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_MACROS_COMMAND_TEMPLATE_HH
+#  define CCE_MACROS_COMMAND_TEMPLATE_HH
+
+#  include <string>
+#  include <vector>
+#  include "com/centreon/engine/macros/defines.hh"
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace                macros {
+  /**
+   *  @class command_template command_template.hh
+   *  @brief Command line compiled for macro expansion.
+   *
+   *  The command line is split once into literal spans and macros.
+   *  $ARGn$, $USERn$ and the standard macros are identified when the
+   *  template is compiled, other macros (custom variables, contact
+   *  addresses, on-demand macros, ...) are looked up by name on every
+   *  expansion. Expanding produces the same output as
+   *  process_macros_r() with a single allocation of the output.
+   */
+  class                  command_template {
+  public:
+                         command_template();
+                         command_template(std::string const& command_line);
+                         command_template(command_template const& right);
+                         ~command_template() throw ();
+    command_template&    operator=(command_template const& right);
+    void                 compile(std::string const& command_line);
+    void                 expand(
+                           nagios_macros* mac,
+                           std::string& output,
+                           int options = 0) const;
+
+  private:
+    enum                 token_type {
+      token_argv = 0,
+      token_literal,
+      token_macrox,
+      token_named,
+      token_user
+    };
+
+    struct               token {
+      int                clean_options;
+      unsigned int       index;
+      size_t             offset;
+      size_t             size;
+      token_type         type;
+    };
+
+    void                 _add_literal(char const* data, size_t size);
+    void                 _add_macro(std::string const& name);
+
+    size_t               _literals_size;
+    std::vector<token>   _tokens;
+    std::string          _text;
+  };
+}
+
+CCE_END()
+
+#endif // !CCE_MACROS_COMMAND_TEMPLATE_HH
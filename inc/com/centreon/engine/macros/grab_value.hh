@@ -33,6 +33,7 @@ int grab_macro_value_r(
       std::string& output,
       int* clean_options,
       int* free_macro);
+int grab_macrox_clean_options(int macro_type);
 int grab_macrox_value_r(
       nagios_macros* mac,
       int macro_type,
@@ -380,6 +380,9 @@ typedef struct   nebstruct_host_check_struct {
   char*          perf_data;
 
   void*          object_ptr;
+  /* Metrics of perf_data, NULL if it is not the object's one. */
+  com::centreon::engine::perfdata const*
+                 perf_data_metrics;
 }                nebstruct_host_check_data;
 
 /* Host status structure. */
@@ -527,6 +530,9 @@ typedef struct   nebstruct_service_check_struct {
   char*          perf_data;
 
   void*          object_ptr;
+  /* Metrics of perf_data, NULL if it is not the object's one. */
+  com::centreon::engine::perfdata const*
+                 perf_data_metrics;
 }                nebstruct_service_check_data;
 
 /* Service status structure. */
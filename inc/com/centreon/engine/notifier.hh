@@ -22,6 +22,7 @@
 
 #include <array>
 #include <list>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include "com/centreon/engine/checkable.hh"
@@ -183,7 +184,8 @@ class notifier : public checkable {
                              std::string const& not_author,
                              std::string const& not_data,
                              int options,
-                             int escalated) = 0;
+                             int escalated,
+                             std::shared_ptr<void> const& notification_done) = 0;
   time_t get_next_notification() const;
   void set_next_notification(time_t next_notification);
   time_t get_last_notification() const;
@@ -265,9 +267,13 @@ class notifier : public checkable {
   timeperiod* get_notification_period_ptr() const;
   void set_notification_period_ptr(timeperiod* tp);
   int get_acknowledgement_timeout() const;
+  void prepare_flapping();
 
   map_customvar custom_variables;
 
+ protected:
+  double _record_state_history(bool update, int state);
+
  private:
   static std::array<is_viable, 6> const _is_notification_viable;
   static uint64_t _next_notification_id;
@@ -327,6 +333,13 @@ class notifier : public checkable {
   std::array<std::shared_ptr<notification>, 6> _notification;
   std::array<int, MAX_STATE_HISTORY_ENTRIES> _state_history;
   int _pending_flex_downtime;
+
+  // Percent state changes computed ahead by prepare_flapping(), for
+  // each state recorded next and when no state is recorded.
+  static unsigned int const _prepared_states = 4;
+  std::array<double, _prepared_states + 1> _prepared_percent_state_change;
+  bool _prepared_flapping;
+  uint32_t _prepared_state_history_index;
 };
 
 CCE_END()
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_PERFDATA_HH
+#  define CCE_PERFDATA_HH
+
+#  include <memory>
+#  include <string>
+#  include <vector>
+#  include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+/**
+ *  @class perfdata perfdata.hh
+ *  @brief Typed performance data of a check result.
+ *
+ *  Performance data are parsed once, when the result is processed,
+ *  from the 'label'=value[UOM];[warn];[crit];[min];[max] format of the
+ *  plugins guidelines. Labels and units are interned: all metrics with
+ *  the same label share the same string, so that they can be compared
+ *  by address. Interned strings live as long as performance data use
+ *  them, copies included. Absent values are NaN, unbounded range ends
+ *  are infinite.
+ */
+class                    perfdata {
+public:
+  /**
+   *  Warning or critical threshold range.
+   */
+  struct                 range {
+    bool                 is_set() const throw ();
+    double               high;
+    bool                 inverted;
+    double               low;
+  };
+
+  /**
+   *  One metric of the performance data.
+   */
+  struct                 metric {
+    range                critical;
+    char const*          label;
+    double               max;
+    double               min;
+    char const*          unit;
+    double               value;
+    range                warning;
+  };
+
+                         perfdata();
+                         perfdata(perfdata const& right);
+                         perfdata(perfdata&& right);
+                         ~perfdata() throw ();
+  perfdata&              operator=(perfdata const& right);
+  perfdata&              operator=(perfdata&& right);
+  void                   clear() throw ();
+  bool                   empty() const throw ();
+  metric const*          find(std::string const& label) const;
+  static std::shared_ptr<std::string const>
+                         intern(std::string const& str);
+  std::vector<metric> const&
+                         metrics() const throw ();
+  bool                   parse(std::string const& data);
+  unsigned int           size() const throw ();
+
+private:
+  std::vector<metric>    _metrics;
+  std::vector<std::shared_ptr<std::string const> >
+                         _strings;
+};
+
+CCE_END()
+
+#endif // !CCE_PERFDATA_HH
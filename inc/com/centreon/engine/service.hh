@@ -185,7 +185,9 @@ class                           service : public notifier {
                                                std::string const& not_author,
                                                std::string const& not_data,
                                                int options,
-                                               int escalated) override;
+                                               int escalated,
+                                               std::shared_ptr<void> const&
+                                                 notification_done) override;
   void                          update_notification_flags() override;
   void                          check_for_expired_acknowledgement();
   void                          schedule_acknowledgement_expiration();
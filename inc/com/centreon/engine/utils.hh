@@ -21,6 +21,8 @@
 #ifndef CCE_UTILS_HH
 #  define CCE_UTILS_HH
 
+#  include <functional>
+#  include <string>
 #  include <sys/time.h>
 #  include "com/centreon/engine/checks.hh"
 #  include "com/centreon/engine/daterange.hh"
@@ -83,4 +85,16 @@ void parse_check_output(std::string const& buffer,
 }
 #  endif // C++
 
+// callback of my_system_async_r(): result, early timeout, execution
+// time and output of the command
+typedef std::function<void (int, int, double, std::string const&)>
+  my_system_callback;
+// runs a system command without waiting for it, the callback is called
+// from the events loop once the command finished
+void my_system_async_r(
+       nagios_macros* mac,
+       std::string const& cmd,
+       int timeout,
+       my_system_callback const& callback);
+
 #endif // !CCE_UTILS_HH
@@ -0,0 +1,29 @@
+/*
+** Copyright 2012-2013 Merethis
+**
+** This file is part of Centreon Engine.
+**
+** Centreon Engine is free software: you can redistribute it and/or
+** modify it under the terms of the GNU General Public License version 2
+** as published by the Free Software Foundation.
+**
+** Centreon Engine is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Centreon Engine. If not, see
+** <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CCE_VERSION_HH
+#  define CCE_VERSION_HH
+
+// Compile-time values.
+#  define CENTREON_ENGINE_VERSION_MAJOR  19
+#  define CENTREON_ENGINE_VERSION_MINOR  10
+#  define CENTREON_ENGINE_VERSION_PATCH  8
+#  define CENTREON_ENGINE_VERSION_STRING "19.10.8"
+
+#endif // !CCE_VERSION_HH
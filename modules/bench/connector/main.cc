@@ -0,0 +1,321 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#ifdef HAVE_GETOPT_H
+#  include <getopt.h>
+#endif // HAVE_GETOPT_H
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/commands/connector.hh"
+#include "com/centreon/engine/commands/response_buffer.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/events/histogram.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/logging/engine.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+/**
+ *  Answer connector queries on the standard input, like a connector
+ *  whose checks complete immediately.
+ */
+static int run_stub() {
+  std::string const ending(3, '\0');
+  commands::response_buffer queries;
+  std::string query;
+  char buffer[65536];
+  while (true) {
+    ssize_t rb(read(STDIN_FILENO, buffer, sizeof(buffer)));
+    if (rb <= 0)
+      return (rb < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+    queries.append(buffer, rb);
+
+    // All the responses to a read are written at once.
+    std::string responses;
+    bool quit(false);
+    while (queries.pop(query)) {
+      char* endptr(nullptr);
+      unsigned int type(strtoul(query.c_str(), &endptr, 10));
+      if (type == 0) {
+        std::ostringstream oss;
+        oss << "1" << '\0' << 1 << '\0' << 0 << '\0' << ending;
+        responses.append(oss.str());
+      }
+      else if (type == 2) {
+        unsigned long id(strtoul(endptr + 1, nullptr, 10));
+        std::ostringstream oss;
+        oss << "3" << '\0' << id << '\0' << 1 << '\0' << 0 << '\0'
+            << '\0' << "OK - stub connector" << '\0' << ending;
+        responses.append(oss.str());
+      }
+      else if (type == 4) {
+        responses.append("5\0", 2).append(ending);
+        quit = true;
+      }
+    }
+    size_t written(0);
+    while (written < responses.size()) {
+      ssize_t wb(write(
+                   STDOUT_FILENO,
+                   responses.data() + written,
+                   responses.size() - written));
+      if (wb < 0)
+        return EXIT_FAILURE;
+      written += wb;
+    }
+    if (quit)
+      return EXIT_SUCCESS;
+  }
+}
+
+/**
+ *  Record the latency of connector results.
+ */
+class latency : public commands::command_listener {
+public:
+  void         finished(commands::result const& res) throw () override {
+    std::lock_guard<std::mutex> lock(_lock);
+    _latency.record((res.end_time - res.start_time).to_useconds());
+  }
+  uint64_t     count() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _latency.count();
+  }
+  events::histogram
+               get() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _latency;
+  }
+
+private:
+  events::histogram
+               _latency;
+  mutable std::mutex
+               _lock;
+};
+
+/**
+ *  Send queries to the stub connector at a fixed rate, from a thread
+ *  ticking like the events loop.
+ */
+static void run_queries(
+              std::string const& stub,
+              bool batched,
+              unsigned int qps,
+              unsigned int duration,
+              unsigned int tick) {
+  commands::connector c("bench", stub);
+  nagios_macros macros = nagios_macros();
+  std::string const cmd("check_stub");
+
+  // Start the connector.
+  commands::result res;
+  c.run(cmd, macros, 0, res);
+
+  latency l;
+  c.set_listener(&l);
+  commands::connector::batch_queries(batched);
+  uint64_t sent(0);
+  uint64_t total(static_cast<uint64_t>(qps) * duration);
+  std::chrono::steady_clock::time_point
+    start(std::chrono::steady_clock::now());
+  std::chrono::steady_clock::time_point next(start);
+  while (sent < total) {
+    std::chrono::duration<double> elapsed(
+      std::chrono::steady_clock::now() - start);
+    uint64_t due(static_cast<uint64_t>(elapsed.count() * qps));
+    if (due > total)
+      due = total;
+    for (; sent < due; ++sent)
+      c.run(cmd, macros, 0);
+    commands::connector::flush_queries();
+    next += std::chrono::microseconds(tick);
+    std::this_thread::sleep_until(next);
+  }
+  commands::connector::batch_queries(false);
+
+  // Wait for pending results.
+  std::chrono::steady_clock::time_point
+    deadline(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+  while (l.count() < total && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  std::chrono::duration<double> elapsed(
+    std::chrono::steady_clock::now() - start);
+  c.set_listener(nullptr);
+
+  events::histogram h(l.get());
+  std::cout << std::fixed << std::setprecision(0)
+    << std::setw(10) << (batched ? "batched" : "direct")
+    << std::setw(12) << h.count()
+    << std::setw(12) << h.count() / elapsed.count()
+    << std::setw(12) << h.percentile(50)
+    << std::setw(12) << h.percentile(99)
+    << std::setw(12) << h.max() << std::endl;
+}
+
+/**
+ *  Split responses like the connector did before the response buffer.
+ */
+static unsigned int split_string(
+                      std::string& buffer,
+                      std::string const& data) {
+  std::string const ending(4, '\0');
+  std::list<std::string> responses;
+  buffer.append(data);
+  while (buffer.size() > 0) {
+    size_t pos(buffer.find(ending));
+    if (pos == std::string::npos)
+      break;
+    responses.push_back(buffer.substr(0, pos));
+    buffer.erase(0, pos + ending.size());
+  }
+  return responses.size();
+}
+
+/**
+ *  Split responses with the response buffer.
+ */
+static unsigned int split_ring(
+                      commands::response_buffer& buffer,
+                      std::string const& data) {
+  std::list<std::string> responses;
+  buffer.append(data);
+  std::string response;
+  while (buffer.pop(response))
+    responses.push_back(std::move(response));
+  return responses.size();
+}
+
+/**
+ *  Compare response splitting when a single read holds many responses.
+ */
+static void run_split(unsigned int responses) {
+  std::string data;
+  for (unsigned int i(0); i < responses; ++i) {
+    std::ostringstream oss;
+    oss << "3" << '\0' << i << '\0' << 1 << '\0' << 0 << '\0' << '\0'
+        << "OK - " << std::string(100, 'x') << '\0' << std::string(3, '\0');
+    data.append(oss.str());
+  }
+
+  std::string buffer;
+  std::chrono::steady_clock::time_point
+    start(std::chrono::steady_clock::now());
+  unsigned int legacy(split_string(buffer, data));
+  std::chrono::duration<double, std::milli> string_time(
+    std::chrono::steady_clock::now() - start);
+
+  commands::response_buffer ring;
+  start = std::chrono::steady_clock::now();
+  unsigned int current(split_ring(ring, data));
+  std::chrono::duration<double, std::milli> ring_time(
+    std::chrono::steady_clock::now() - start);
+
+  if (legacy != responses || current != responses)
+    std::cerr << "response count mismatch" << std::endl;
+  std::cout << std::fixed << std::setprecision(3)
+    << std::setw(10) << responses
+    << std::setw(16) << string_time.count()
+    << std::setw(16) << ring_time.count() << std::endl;
+}
+
+/**
+ *  Print usage.
+ */
+static void usage(char const* appname) {
+  std::cout
+    << "usage: " << appname << " [options]\n"
+    << "  -d <seconds>    Duration of each run (default 5).\n"
+    << "  -h              Print this help.\n"
+    << "  -q <queries>    Queries per second (default 20000).\n"
+    << "  -s              Run as the stub connector.\n"
+    << "  -t <usec>       Events loop tick (default 1000).\n";
+}
+
+/**
+ *  Drive a stub connector at a fixed query rate, with queries written
+ *  as they are sent and batched once per tick, then compare response
+ *  splitting of large reads.
+ */
+int main(int argc, char* argv[]) {
+  unsigned int duration(5);
+  unsigned int qps(20000);
+  unsigned int tick(1000);
+  int opt;
+  while ((opt = getopt(argc, argv, "d:hq:st:")) != -1) {
+    switch (opt) {
+    case 'd':
+      duration = strtoul(optarg, nullptr, 0);
+      break;
+    case 'q':
+      qps = strtoul(optarg, nullptr, 0);
+      break;
+    case 's':
+      return run_stub();
+    case 't':
+      tick = strtoul(optarg, nullptr, 0);
+      break;
+    default:
+      usage(argv[0]);
+      return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (!tick)
+    tick = 1;
+
+  clib::load();
+  com::centreon::logging::engine::load();
+  config = new configuration::state;
+
+  std::string stub(argv[0]);
+  stub.append(" -s");
+  std::cout
+    << std::setw(10) << "mode"
+    << std::setw(12) << "results"
+    << std::setw(12) << "results/s"
+    << std::setw(12) << "p50 (us)"
+    << std::setw(12) << "p99 (us)"
+    << std::setw(12) << "max (us)" << "\n";
+  run_queries(stub, false, qps, duration, tick);
+  run_queries(stub, true, qps, duration, tick);
+
+  std::cout << "\n"
+    << std::setw(10) << "responses"
+    << std::setw(16) << "string (ms)"
+    << std::setw(16) << "ring (ms)" << "\n";
+  for (unsigned int responses(1000); responses <= 100000; responses *= 10)
+    run_split(responses);
+
+  delete config;
+  config = nullptr;
+  com::centreon::logging::engine::unload();
+  clib::unload();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,338 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#ifdef HAVE_GETOPT_H
+#  include <getopt.h>
+#endif // HAVE_GETOPT_H
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/timed_event.hh"
+
+using namespace com::centreon::engine;
+
+typedef std::deque<timed_event*> legacy_list;
+
+/**
+ *  Insert an event the way the historical sorted deque did.
+ */
+static void legacy_add(legacy_list& list, timed_event* evt) {
+  if (list.empty() || (evt->get_run_time() < list.front()->get_run_time()))
+    list.push_front(evt);
+  else
+    for (legacy_list::reverse_iterator
+           it(list.rbegin()),
+           end(list.rend());
+         it != end;
+         ++it)
+      if (evt->get_run_time() >= (*it)->get_run_time()) {
+        list.insert(it.base(), evt);
+        break ;
+      }
+}
+
+/**
+ *  Find an event the way the historical sorted deque did.
+ */
+static timed_event* legacy_find(
+                      legacy_list& list,
+                      uint32_t type,
+                      void* data) {
+  for (legacy_list::iterator it(list.begin()), end(list.end());
+       it != end;
+       ++it)
+    if (((*it)->event_type == type) && ((*it)->event_data == data))
+      return *it;
+  return nullptr;
+}
+
+/**
+ *  Remove an event the way the historical sorted deque did.
+ */
+static void legacy_remove(legacy_list& list, timed_event* evt) {
+  for (legacy_list::iterator it(list.begin()), end(list.end());
+       it != end;
+       ++it)
+    if (*it == evt) {
+      list.erase(it);
+      break ;
+    }
+}
+
+/**
+ *  Timings of one benchmark run.
+ */
+struct timings {
+  double build;
+  double reschedule;
+  double drain;
+};
+
+/**
+ *  Get the elapsed time since some point in seconds.
+ */
+static double elapsed(std::chrono::steady_clock::time_point const& since) {
+  return std::chrono::duration<double>(
+           std::chrono::steady_clock::now() - since).count();
+}
+
+/**
+ *  Create the events of a run. Events are spread over the check
+ *  interval the same way the initial scheduling does.
+ */
+static void create_events(
+              std::vector<timed_event*>& events,
+              std::vector<int>& objects,
+              int count,
+              int interval) {
+  time_t now(time(nullptr));
+  objects.resize(count);
+  events.reserve(count);
+  for (int i(0); i < count; ++i)
+    events.push_back(new timed_event(
+                           EVENT_SERVICE_CHECK,
+                           now + static_cast<time_t>(
+                             static_cast<long long>(i) * interval / count),
+                           false,
+                           0,
+                           nullptr,
+                           true,
+                           &objects[i],
+                           nullptr,
+                           0));
+}
+
+/**
+ *  Bench the historical sorted deque.
+ */
+static timings bench_legacy(
+                 int count,
+                 int reschedules,
+                 int interval) {
+  std::vector<timed_event*> events;
+  std::vector<int> objects;
+  create_events(events, objects, count, interval);
+  timings t;
+  legacy_list list;
+
+  std::chrono::steady_clock::time_point start(
+    std::chrono::steady_clock::now());
+  for (int i(0); i < count; ++i)
+    legacy_add(list, events[i]);
+  t.build = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i(0); i < reschedules; ++i) {
+    int obj(random() % count);
+    timed_event* evt(legacy_find(list, EVENT_SERVICE_CHECK, &objects[obj]));
+    legacy_remove(list, evt);
+    evt->set_run_time(evt->get_run_time() + interval);
+    legacy_add(list, evt);
+  }
+  t.reschedule = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  while (!list.empty())
+    list.pop_front();
+  t.drain = elapsed(start);
+
+  for (int i(0); i < count; ++i)
+    delete events[i];
+  return t;
+}
+
+/**
+ *  Bench the timed event list. With bulk, events are pushed at once
+ *  like the initial scheduling does.
+ */
+static timings bench_list(
+                 int count,
+                 int reschedules,
+                 int interval,
+                 timed_event_list::scheduler_type type,
+                 bool bulk = false) {
+  std::vector<timed_event*> events;
+  std::vector<int> objects;
+  create_events(events, objects, count, interval);
+  timings t;
+  timed_event_list list;
+  list.set_scheduler(type);
+
+  std::chrono::steady_clock::time_point start(
+    std::chrono::steady_clock::now());
+  if (bulk)
+    list.push(events);
+  else
+    for (int i(0); i < count; ++i)
+      list.push(events[i]);
+  t.build = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i(0); i < reschedules; ++i) {
+    int obj(random() % count);
+    timed_event* evt(list.find(EVENT_SERVICE_CHECK, &objects[obj]));
+    list.erase(evt);
+    evt->set_run_time(evt->get_run_time() + interval);
+    list.push(evt);
+    // add_event() looks at the front after every push.
+    list.front();
+  }
+  t.reschedule = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  list.advance(time(nullptr) + 2 * interval);
+  while (!list.empty())
+    list.pop_front();
+  t.drain = elapsed(start);
+
+  for (int i(0); i < count; ++i)
+    delete events[i];
+  return t;
+}
+
+/**
+ *  Print one result line.
+ */
+static void print(std::string const& name, int count, timings const& t) {
+  std::cout << "  " << std::left << std::setw(8) << name
+            << std::right << std::setw(10) << count
+            << std::setw(14) << t.build
+            << std::setw(14) << t.reschedule
+            << std::setw(14) << t.drain << "\n";
+}
+
+/**
+ *  Compare the timed event list schedulers against the historical
+ *  sorted deque.
+ *
+ *  @return EXIT_SUCCESS.
+ */
+int main(int argc, char* argv[]) {
+  srandom(getpid());
+
+  // Options.
+#ifdef HAVE_GETOPT_H
+  int option_index(0);
+  static struct option const long_options[] = {
+    { "help", no_argument, NULL, '?' },
+    { "count", required_argument, NULL, 'c' },
+    { "interval", required_argument, NULL, 'i' },
+    { "reschedules", required_argument, NULL, 'r' },
+    { "skip-legacy", no_argument, NULL, 's' },
+    { NULL, no_argument, NULL, '\0' }
+  };
+#endif // HAVE_GETOPT_H
+  std::vector<int> counts;
+  int interval(300);
+  int reschedules(10000);
+  bool legacy(true);
+  bool help(false);
+
+  int c;
+#ifdef HAVE_GETOPT_H
+  while ((c = getopt_long(
+                argc,
+                argv,
+                "+?c:i:r:s",
+                long_options,
+                &option_index)) != -1) {
+#else
+  while ((c = getopt(argc, argv, "+?c:i:r:s")) != -1) {
+#endif // HAVE_GETOPT_H
+    switch (c) {
+    case 'c':
+      counts.push_back(strtol(optarg, NULL, 0));
+      break ;
+    case 'i':
+      interval = strtol(optarg, NULL, 0);
+      break ;
+    case 'r':
+      reschedules = strtol(optarg, NULL, 0);
+      break ;
+    case 's':
+      legacy = false;
+      break ;
+    default:
+      help = true;
+    }
+  }
+  if (counts.empty()) {
+    counts.push_back(10000);
+    counts.push_back(100000);
+    counts.push_back(1000000);
+  }
+
+  if (help) {
+    std::cout
+      << "Common options\n"
+      << "  -? --help             Print this help.\n"
+      << "  -c --count            Number of scheduled events, can be repeated\n"
+      << "                        (default is 10000, 100000 and 1000000).\n"
+      << "  -i --interval         Check interval in seconds (default is "
+      << interval << ").\n"
+      << "  -r --reschedules      Number of random reschedules (default is "
+      << reschedules << ").\n"
+      << "  -s --skip-legacy      Only bench the heap and wheel schedulers.\n";
+    return (EXIT_SUCCESS);
+  }
+
+  // Banner.
+  std::cout << "-------------------------------------------\n"
+            << "Centreon Engine event scheduler benchmark\n"
+            << "-------------------------------------------\n"
+            << "\n"
+            << "  " << std::left << std::setw(8) << "list"
+            << std::right << std::setw(10) << "events"
+            << std::setw(14) << "build (s)"
+            << std::setw(14) << "resched (s)"
+            << std::setw(14) << "drain (s)" << "\n";
+
+  for (std::vector<int>::const_iterator
+         it(counts.begin()),
+         end(counts.end());
+       it != end;
+       ++it) {
+    if (legacy)
+      print("deque", *it, bench_legacy(*it, reschedules, interval));
+    print("heap", *it, bench_list(
+                         *it,
+                         reschedules,
+                         interval,
+                         timed_event_list::heap));
+    print("bulk", *it, bench_list(
+                         *it,
+                         reschedules,
+                         interval,
+                         timed_event_list::heap,
+                         true));
+    print("wheel", *it, bench_list(
+                          *it,
+                          reschedules,
+                          interval,
+                          timed_event_list::wheel));
+  }
+
+  return (EXIT_SUCCESS);
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#ifdef HAVE_GETOPT_H
+#  include <getopt.h>
+#endif // HAVE_GETOPT_H
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/host.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/macros/command_template.hh"
+#include "com/centreon/engine/macros/process.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+#include "com/centreon/logging/engine.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+// Size of all outputs, printed so that they are not optimized out.
+static size_t output_size(0);
+
+/**
+ *  A check command line to expand.
+ */
+struct sample {
+  std::string name;
+  std::string command_line;
+};
+
+/**
+ *  Get typical check command lines.
+ */
+static std::vector<sample> samples() {
+  std::vector<sample> s;
+  s.push_back({ "check_ping",
+                "$USER1$/check_ping -H $HOSTADDRESS$ -w $ARG1$ -c $ARG2$ "
+                "-p 5" });
+  s.push_back({ "check_snmp",
+                "$USER1$/check_snmp -H $HOSTADDRESS$ "
+                "-C $_HOSTSNMPCOMMUNITY$ -o $ARG1$ -w $ARG2$ -c $ARG3$" });
+  s.push_back({ "check_http",
+                "$USER1$/check_http -I $HOSTADDRESS$ -H $HOSTNAME$ "
+                "-u $ARG1$ -t 10" });
+  s.push_back({ "check_nrpe",
+                "$USER1$/check_nrpe -H $HOSTADDRESS$ -t 30 -c $ARG1$ "
+                "-a '$ARG2$' '$ARG3$'" });
+  s.push_back({ "no macro", "/usr/lib/nagios/plugins/check_dummy 0" });
+  return s;
+}
+
+/**
+ *  Expand a command line in a loop.
+ *
+ *  @return Nanoseconds per expansion.
+ */
+template <typename F>
+static double bench(F expand, unsigned int iterations) {
+  std::chrono::steady_clock::time_point
+    start(std::chrono::steady_clock::now());
+  size_t total(0);
+  for (unsigned int i(0); i < iterations; ++i) {
+    std::string output;
+    expand(output);
+    total += output.size();
+  }
+  std::chrono::duration<double, std::nano>
+    elapsed(std::chrono::steady_clock::now() - start);
+  output_size += total;
+  return elapsed.count() / iterations;
+}
+
+/**
+ *  Compare process_macros_r() against command templates compiled
+ *  once.
+ *
+ *  @return EXIT_SUCCESS.
+ */
+int main(int argc, char* argv[]) {
+  // Options.
+#ifdef HAVE_GETOPT_H
+  int option_index(0);
+  static struct option const long_options[] = {
+    { "help", no_argument, NULL, '?' },
+    { "iterations", required_argument, NULL, 'i' },
+    { NULL, no_argument, NULL, '\0' }
+  };
+#endif // HAVE_GETOPT_H
+  unsigned int iterations(100000);
+  bool help(false);
+
+  int c;
+#ifdef HAVE_GETOPT_H
+  while ((c = getopt_long(
+                argc,
+                argv,
+                "+?i:",
+                long_options,
+                &option_index)) != -1) {
+#else
+  while ((c = getopt(argc, argv, "+?i:")) != -1) {
+#endif // HAVE_GETOPT_H
+    switch (c) {
+    case 'i':
+      iterations = strtoul(optarg, NULL, 0);
+      break ;
+    default:
+      help = true;
+    }
+  }
+  if (!iterations)
+    iterations = 1;
+
+  if (help) {
+    std::cout
+      << "Common options\n"
+      << "  -? --help             Print this help.\n"
+      << "  -i --iterations       Number of expansions of each command "
+         "line (default is " << iterations << ").\n";
+    return (EXIT_SUCCESS);
+  }
+
+  // Engine objects used by macros.
+  clib::load();
+  com::centreon::logging::engine::load();
+  config = new configuration::state;
+  timezone_manager::load();
+  configuration::applier::state::load();
+  {
+    configuration::applier::host hst_aply;
+    configuration::host hst;
+    hst.parse("host_name", "bench_host");
+    hst.parse("alias", "Benchmark host");
+    hst.parse("address", "192.168.1.42");
+    hst.parse("_SNMPCOMMUNITY", "public");
+    hst_aply.add_object(hst);
+  }
+  nagios_macros mac;
+  mac.host_ptr = engine::host::hosts["bench_host"].get();
+  mac.argv[0] = "100.0,20%";
+  mac.argv[1] = "500.0,60%";
+  mac.argv[2] = "/status";
+  macro_user[0] = "/usr/lib/nagios/plugins";
+
+  // Banner.
+  std::cout << "-------------------------------------------\n"
+            << "Centreon Engine macro expansion benchmark\n"
+            << "-------------------------------------------\n"
+            << "\n"
+            << "  " << std::left << std::setw(16) << "command"
+            << std::right << std::setw(16) << "processed (ns)"
+            << std::setw(16) << "template (ns)" << "\n";
+
+  std::vector<sample> s(samples());
+  for (std::vector<sample>::const_iterator
+         it(s.begin()),
+         end(s.end());
+       it != end;
+       ++it) {
+    std::string const& command_line(it->command_line);
+    macros::command_template tmpl(command_line);
+    std::string processed;
+    std::string expanded;
+    process_macros_r(&mac, command_line, processed, 0);
+    tmpl.expand(&mac, expanded);
+    if (processed != expanded)
+      std::cerr << "expansions of " << it->name << " differ: '"
+                << processed << "' and '" << expanded << "'\n";
+
+    double legacy(bench(
+      [&](std::string& output) {
+        process_macros_r(&mac, command_line, output, 0);
+      },
+      iterations));
+    double current(bench(
+      [&](std::string& output) { tmpl.expand(&mac, output); },
+      iterations));
+    std::cout << "  " << std::left << std::setw(16) << it->name
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(16) << legacy
+              << std::setw(16) << current << "\n";
+  }
+
+  std::cout << "\n  " << output_size << " bytes expanded\n";
+
+  macro_user[0].clear();
+  configuration::applier::state::unload();
+  delete config;
+  config = nullptr;
+  timezone_manager::unload();
+  com::centreon::logging::engine::unload();
+  clib::unload();
+  return (EXIT_SUCCESS);
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#ifdef HAVE_GETOPT_H
+#  include <getopt.h>
+#endif // HAVE_GETOPT_H
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "com/centreon/engine/utils.hh"
+
+// Size of all outputs, printed so that they are not optimized out.
+static size_t output_size(0);
+
+/**
+ *  The historical parse_check_output(), which copied every line.
+ */
+static void legacy_parse_check_output(
+              std::string const& buffer,
+              std::string& short_buffer,
+              std::string& long_buffer,
+              std::string& pd_buffer,
+              bool escape_newlines_please,
+              bool newlines_are_escaped) {
+  bool long_pipe{false};
+  bool perfdata_already_filled{false};
+  bool eof{false};
+  std::string line;
+  size_t start_line{0}, end_line, pos_line;
+  int line_number{1};
+  while (!eof) {
+    if (newlines_are_escaped
+        && (pos_line = buffer.find("\\n", start_line)) != std::string::npos) {
+      end_line = pos_line;
+      pos_line += 2;
+    }
+    else if ((pos_line = buffer.find("\n", start_line)) != std::string::npos) {
+      end_line = pos_line;
+      pos_line++;
+    }
+    else {
+      end_line = buffer.size();
+      eof = true;
+    }
+    line = buffer.substr(start_line, end_line - start_line);
+    size_t pipe;
+    if (!long_pipe)
+      pipe = line.find_last_of('|');
+    else
+      pipe = std::string::npos;
+
+    if (pipe != std::string::npos) {
+      end_line = pipe;
+      while (end_line > 1 && std::isspace(line[end_line - 1]))
+        end_line--;
+      pipe++;
+      while (pipe < line.size() - 1 && std::isspace(line[pipe]))
+        pipe++;
+      if (line_number == 1) {
+        short_buffer.append(line.substr(0, end_line));
+        pd_buffer.append(line.substr(pipe));
+        perfdata_already_filled = true;
+      }
+      else {
+        if (line_number > 2)
+          long_buffer.append(escape_newlines_please ? "\\n" : "\n");
+        long_buffer.append(line.substr(0, end_line));
+        if (perfdata_already_filled)
+          pd_buffer.append(" ");
+        pd_buffer.append(line.substr(pipe));
+        long_pipe = true;
+      }
+    }
+    else {
+      end_line = line.size();
+      while (end_line > 1 && std::isspace(line[end_line - 1]))
+        end_line--;
+      line.erase(end_line);
+      if (line_number == 1)
+        short_buffer.append(line);
+      else {
+        if (!long_pipe) {
+          if (line_number > 2)
+            long_buffer.append(escape_newlines_please ? "\\n" : "\n");
+          long_buffer.append(line);
+        }
+        else {
+          if (perfdata_already_filled)
+            pd_buffer.append(" ");
+          pd_buffer.append(line);
+        }
+      }
+    }
+    start_line = pos_line;
+    line_number++;
+  }
+}
+
+typedef void (*parser)(
+               std::string const&,
+               std::string&,
+               std::string&,
+               std::string&,
+               bool,
+               bool);
+
+/**
+ *  A check output to parse.
+ */
+struct sample {
+  std::string name;
+  std::string output;
+  bool newlines_are_escaped;
+};
+
+/**
+ *  Get the outputs to parse: the ones of tests/parse-check-output.cc
+ *  and a large SNMP table.
+ */
+static std::vector<sample> samples() {
+  std::vector<sample> s;
+  s.push_back({ "single line", "The service is OK", true });
+  s.push_back({ "single line, perfdata",
+                "The service is OK | a=25;50;75", true });
+  s.push_back({ "multiple pipes",
+                "The service is OK | The host is UP | a=25;50;75 b=1",
+                true });
+  s.push_back({ "escaped newlines",
+                "The service is OK | a=25;50;75 b=1\\nToto is a good guy"
+                "\\nBar is well known",
+                true });
+  s.push_back({ "long perfdata",
+                "DISK OK - free space: / 3326 MB (56%); | "
+                "/=2643MB;5948;5958;0;5968\n/ 15272 MB (77%);\n"
+                "/boot 68 MB (69%);\n/home 69357 MB (27%);\n"
+                "/var/log 819 MB (84%); | /boot=68MB;88;93;0;98\n"
+                "/home=69357MB;253404;253409;0;253414\n"
+                "/var/log=818MB;970;975;0;980",
+                false });
+  std::string snmp("SNMP OK - 1000 interfaces | if_count=1000");
+  for (int i(0); i < 1000; ++i)
+    snmp.append("\nIF-MIB::ifOperStatus.").append(std::to_string(i))
+        .append(" = INTEGER: up(1)  ");
+  s.push_back({ "50 KB SNMP table", snmp, false });
+  return s;
+}
+
+/**
+ *  Parse an output in a loop.
+ *
+ *  @return Nanoseconds per parse.
+ */
+static double bench(
+                parser p,
+                sample const& s,
+                unsigned int iterations) {
+  std::chrono::steady_clock::time_point
+    start(std::chrono::steady_clock::now());
+  size_t total(0);
+  for (unsigned int i(0); i < iterations; ++i) {
+    std::string short_output;
+    std::string long_output;
+    std::string perf_data;
+    p(s.output,
+      short_output,
+      long_output,
+      perf_data,
+      true,
+      s.newlines_are_escaped);
+    total += short_output.size() + long_output.size() + perf_data.size();
+  }
+  std::chrono::duration<double, std::nano>
+    elapsed(std::chrono::steady_clock::now() - start);
+  output_size += total;
+  return elapsed.count() / iterations;
+}
+
+/**
+ *  Compare parse_check_output() against its historical implementation.
+ *
+ *  @return EXIT_SUCCESS.
+ */
+int main(int argc, char* argv[]) {
+  // Options.
+#ifdef HAVE_GETOPT_H
+  int option_index(0);
+  static struct option const long_options[] = {
+    { "help", no_argument, NULL, '?' },
+    { "iterations", required_argument, NULL, 'i' },
+    { NULL, no_argument, NULL, '\0' }
+  };
+#endif // HAVE_GETOPT_H
+  unsigned int iterations(100000);
+  bool help(false);
+
+  int c;
+#ifdef HAVE_GETOPT_H
+  while ((c = getopt_long(
+                argc,
+                argv,
+                "+?i:",
+                long_options,
+                &option_index)) != -1) {
+#else
+  while ((c = getopt(argc, argv, "+?i:")) != -1) {
+#endif // HAVE_GETOPT_H
+    switch (c) {
+    case 'i':
+      iterations = strtoul(optarg, NULL, 0);
+      break ;
+    default:
+      help = true;
+    }
+  }
+  if (!iterations)
+    iterations = 1;
+
+  if (help) {
+    std::cout
+      << "Common options\n"
+      << "  -? --help             Print this help.\n"
+      << "  -i --iterations       Number of parses of each output (default is "
+      << iterations << ").\n";
+    return (EXIT_SUCCESS);
+  }
+
+  // Banner.
+  std::cout << "-------------------------------------------\n"
+            << "Centreon Engine check output parsing benchmark\n"
+            << "-------------------------------------------\n"
+            << "\n"
+            << "  " << std::left << std::setw(24) << "output"
+            << std::right << std::setw(10) << "bytes"
+            << std::setw(14) << "legacy (ns)"
+            << std::setw(14) << "current (ns)" << "\n";
+
+  std::vector<sample> s(samples());
+  for (std::vector<sample>::const_iterator
+         it(s.begin()),
+         end(s.end());
+       it != end;
+       ++it) {
+    // Large outputs are parsed less often.
+    unsigned int n(it->output.size() > 4096 ? iterations / 100 + 1
+                                            : iterations);
+    double legacy(bench(&legacy_parse_check_output, *it, n));
+    double current(bench(&parse_check_output, *it, n));
+    std::cout << "  " << std::left << std::setw(24) << it->name
+              << std::right << std::setw(10) << it->output.size()
+              << std::fixed << std::setprecision(0)
+              << std::setw(14) << legacy
+              << std::setw(14) << current << "\n";
+  }
+  std::cout << "\n  " << output_size << " bytes parsed\n";
+
+  return (EXIT_SUCCESS);
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "com/centreon/engine/commands/plugin_api.hh"
+
+/*
+** In-process counterpart of check_sleep, to compare in-process check
+** plugins with forked ones. The command line takes the same options
+** as check_sleep, an optional leading plugin path is ignored:
+**
+**   [path] [-s status] [-t timeout] [-l last_state] [text]
+**
+** Checks wait for their timeout on a single timer thread and never
+** block the check plugin threads of the engine.
+*/
+
+static int const STATUS_OK(0);
+static int const STATUS_WARNING(1);
+static int const STATUS_CRITICAL(2);
+static int const STATUS_UNKNOWN(3);
+
+namespace {
+  /**
+   *  Check waiting for its timeout.
+   */
+  struct           pending {
+    void*          context;
+    cce_plugin_done
+                   done;
+    std::string    output;
+    int            status;
+  };
+
+  typedef std::chrono::steady_clock steady;
+
+  /**
+   *  Timer thread completing checks.
+   */
+  struct           plugin_state {
+    std::condition_variable
+                   cv;
+    std::mutex     lock;
+    std::multimap<steady::time_point, pending>
+                   pendings;
+    bool           quit;
+    unsigned int   seed;
+    std::thread    timer;
+  };
+}
+
+/**
+ *  Complete checks whose timeout expired.
+ *
+ *  @param[in] state  Plugin state.
+ */
+static void timer(plugin_state* state) {
+  std::unique_lock<std::mutex> lock(state->lock);
+  while (!state->quit) {
+    if (state->pendings.empty())
+      state->cv.wait(lock);
+    else if (state->pendings.begin()->first > steady::now())
+      state->cv.wait_until(lock, state->pendings.begin()->first);
+    else {
+      pending p(state->pendings.begin()->second);
+      state->pendings.erase(state->pendings.begin());
+      lock.unlock();
+      p.done(p.context, p.status, p.output.c_str());
+      lock.lock();
+    }
+  }
+}
+
+extern "C" {
+  CCE_PLUGIN_API_VERSION(CURRENT_CCE_PLUGIN_API_VERSION)
+
+  int cce_plugin_init(void** plugin) {
+    plugin_state* state(new plugin_state);
+    state->quit = false;
+    state->seed = time(NULL);
+    state->timer = std::thread(&timer, state);
+    *plugin = state;
+    return 0;
+  }
+
+  int cce_plugin_run(
+        void* plugin,
+        char const* args,
+        unsigned int timeout,
+        cce_plugin_done done,
+        void* context) {
+    (void)timeout;
+    plugin_state* state(static_cast<plugin_state*>(plugin));
+    int status(-1);
+    int sleep(-1);
+    int last_state(STATUS_UNKNOWN);
+    std::string text;
+
+    // Parse options.
+    std::istringstream iss(args);
+    std::string arg;
+    if ((iss >> arg) && (arg[0] != '-'))
+      iss >> arg;
+    while (iss && !arg.empty()) {
+      if (arg == "-s")
+        iss >> status;
+      else if (arg == "-t")
+        iss >> sleep;
+      else if (arg == "-l") {
+        iss >> last_state;
+        if ((last_state > STATUS_UNKNOWN) || (last_state < STATUS_OK))
+          last_state = STATUS_UNKNOWN;
+      }
+      else {
+        text = arg;
+        break ;
+      }
+      arg.clear();
+      iss >> arg;
+    }
+
+    std::lock_guard<std::mutex> lock(state->lock);
+    if (status == -1) {
+      if (last_state && (rand_r(&state->seed) % 9))
+        status = last_state;
+      else {
+        int randomval(rand_r(&state->seed) % 100);
+        if (randomval < 2)
+          status = STATUS_UNKNOWN;
+        else if (randomval < 4)
+          status = STATUS_WARNING;
+        else if (randomval < 6)
+          status = STATUS_CRITICAL;
+        else
+          status = STATUS_OK;
+      }
+    }
+    if (sleep < 0)
+      sleep = ((rand_r(&state->seed) % 9) % 6);
+
+    // Build output.
+    std::ostringstream oss;
+    switch (status) {
+    case STATUS_OK:
+      oss << "OK";
+      break ;
+    case STATUS_WARNING:
+      oss << "WARNING";
+      break ;
+    case STATUS_CRITICAL:
+      oss << "CRITICAL";
+      break ;
+    default:
+      oss << "UNKNOWN";
+      break ;
+    }
+    oss << ": timeout=" << sleep << ", status=" << status;
+    if (!text.empty())
+      oss << ", output='" << text << "'";
+    oss << "|timeout=" << sleep << ";status=" << status;
+
+    pending p;
+    p.context = context;
+    p.done = done;
+    p.output = oss.str();
+    p.status = status;
+    state->pendings.insert(std::make_pair(
+      steady::now() + std::chrono::seconds(sleep),
+      p));
+    state->cv.notify_one();
+    return 0;
+  }
+
+  void cce_plugin_destroy(void* plugin) {
+    plugin_state* state(static_cast<plugin_state*>(plugin));
+    {
+      std::lock_guard<std::mutex> lock(state->lock);
+      state->quit = true;
+    }
+    state->cv.notify_one();
+    state->timer.join();
+    delete state;
+  }
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#ifdef HAVE_GETOPT_H
+#  include <getopt.h>
+#endif // HAVE_GETOPT_H
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "com/centreon/engine/checks.hh"
+#include "com/centreon/engine/checks/reaper_queue.hh"
+#include "com/centreon/engine/events/histogram.hh"
+
+using namespace com::centreon::engine;
+
+/**
+ *  The historical reaper queue: a mutex protected std::queue of
+ *  copied results.
+ */
+class legacy_queue {
+public:
+  bool push(check_result&& result, uint64_t command_id = 0) {
+    (void)command_id;
+    std::lock_guard<std::mutex> lock(_mutex);
+    bool was_empty(_queue.empty());
+    _queue.push(result);
+    return was_empty;
+  }
+
+  bool pop(checks::reaper_queue::entry& e) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_queue.empty())
+      return false;
+    e.command_id = 0;
+    e.result = _queue.front();
+    _queue.pop();
+    return true;
+  }
+
+private:
+  std::mutex _mutex;
+  std::queue<check_result> _queue;
+};
+
+/**
+ *  Results of one benchmark run.
+ */
+struct timings {
+  unsigned long long reaped;
+  double duration;
+  events::histogram latency;
+};
+
+/**
+ *  Get the current time of the steady clock in microseconds.
+ */
+static uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ *  Push results at a fixed rate from producer threads, the way
+ *  command execution threads do, and reap them from the calling
+ *  thread, the way the events loop does.
+ *
+ *  @param[in] queue      Queue to bench.
+ *  @param[in] producers  Number of producer threads.
+ *  @param[in] rate       Total results per second, 0 to push as fast
+ *                        as possible.
+ *  @param[in] duration   Run duration in seconds.
+ *  @param[in] output     Size of result outputs.
+ */
+template <typename T>
+static timings bench(
+                 T& queue,
+                 unsigned int producers,
+                 unsigned int rate,
+                 double duration,
+                 unsigned int output) {
+  std::atomic<unsigned int> running(producers);
+  uint64_t start(now_us());
+  uint64_t end(start + static_cast<uint64_t>(duration * 1000000));
+  std::vector<std::thread> threads;
+  for (unsigned int p(0); p < producers; ++p)
+    threads.push_back(std::thread([&, p]() {
+      std::string out(output, 'x');
+      double interval(rate ? 1000000.0 * producers / rate : 0.0);
+      for (unsigned long long i(0); ; ++i) {
+        uint64_t due(start + static_cast<uint64_t>(i * interval));
+        uint64_t now(now_us());
+        if (now >= end)
+          break ;
+        if (due > now)
+          std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+        check_result result;
+        result.set_host_id(p);
+        result.set_service_id(i);
+        timeval tv;
+        uint64_t pushed(now_us());
+        tv.tv_sec = pushed / 1000000;
+        tv.tv_usec = pushed % 1000000;
+        result.set_start_time(tv);
+        result.set_output(out);
+        queue.push(std::move(result));
+      }
+      --running;
+    }));
+
+  timings t;
+  t.reaped = 0;
+  checks::reaper_queue::entry e;
+  for (;;) {
+    if (!queue.pop(e)) {
+      if (running) {
+        std::this_thread::yield();
+        continue ;
+      }
+      // Producers are done, get what they pushed last.
+      if (!queue.pop(e))
+        break ;
+    }
+    timeval tv(e.result.get_start_time());
+    uint64_t pushed(tv.tv_sec * 1000000ull + tv.tv_usec);
+    uint64_t now(now_us());
+    t.latency.record(now > pushed ? now - pushed : 0);
+    ++t.reaped;
+  }
+  t.duration = (now_us() - start) / 1000000.0;
+  for (unsigned int p(0); p < producers; ++p)
+    threads[p].join();
+  return t;
+}
+
+/**
+ *  Print one result line.
+ */
+static void print(std::string const& name, timings const& t) {
+  std::cout << "  " << std::left << std::setw(8) << name
+            << std::right << std::setw(12) << t.reaped
+            << std::setw(14) << static_cast<unsigned long long>(
+                                  t.reaped / t.duration)
+            << std::setw(10) << t.latency.percentile(50)
+            << std::setw(10) << t.latency.percentile(99)
+            << std::setw(12) << t.latency.max() << "\n";
+}
+
+/**
+ *  Compare the lock-free reaper queue against the historical mutex
+ *  protected queue.
+ *
+ *  @return EXIT_SUCCESS.
+ */
+int main(int argc, char* argv[]) {
+  // Options.
+#ifdef HAVE_GETOPT_H
+  int option_index(0);
+  static struct option const long_options[] = {
+    { "help", no_argument, NULL, '?' },
+    { "duration", required_argument, NULL, 'd' },
+    { "output", required_argument, NULL, 'o' },
+    { "producers", required_argument, NULL, 'p' },
+    { "rate", required_argument, NULL, 'r' },
+    { NULL, no_argument, NULL, '\0' }
+  };
+#endif // HAVE_GETOPT_H
+  double duration(5.0);
+  unsigned int output(256);
+  unsigned int producers(4);
+  unsigned int rate(50000);
+  bool help(false);
+
+  int c;
+#ifdef HAVE_GETOPT_H
+  while ((c = getopt_long(
+                argc,
+                argv,
+                "+?d:o:p:r:",
+                long_options,
+                &option_index)) != -1) {
+#else
+  while ((c = getopt(argc, argv, "+?d:o:p:r:")) != -1) {
+#endif // HAVE_GETOPT_H
+    switch (c) {
+    case 'd':
+      duration = strtod(optarg, NULL);
+      break ;
+    case 'o':
+      output = strtoul(optarg, NULL, 0);
+      break ;
+    case 'p':
+      producers = strtoul(optarg, NULL, 0);
+      break ;
+    case 'r':
+      rate = strtoul(optarg, NULL, 0);
+      break ;
+    default:
+      help = true;
+    }
+  }
+  if (!producers)
+    producers = 1;
+
+  if (help) {
+    std::cout
+      << "Common options\n"
+      << "  -? --help             Print this help.\n"
+      << "  -d --duration         Duration of each run in seconds (default is "
+      << duration << ").\n"
+      << "  -o --output           Size of check outputs (default is "
+      << output << ").\n"
+      << "  -p --producers        Number of producer threads (default is "
+      << producers << ").\n"
+      << "  -r --rate             Results per second, 0 for as fast as\n"
+      << "                        possible (default is " << rate << ").\n";
+    return (EXIT_SUCCESS);
+  }
+
+  // Banner.
+  std::cout << "-------------------------------------------\n"
+            << "Centreon Engine check reaper benchmark\n"
+            << "-------------------------------------------\n"
+            << "\n"
+            << "  " << producers << " producers, "
+            << (rate ? std::to_string(rate) : std::string("unlimited"))
+            << " results/s, " << output << " bytes outputs\n\n"
+            << "  " << std::left << std::setw(8) << "queue"
+            << std::right << std::setw(12) << "results"
+            << std::setw(14) << "results/s"
+            << std::setw(10) << "p50 (us)"
+            << std::setw(10) << "p99 (us)"
+            << std::setw(12) << "max (us)" << "\n";
+
+  {
+    legacy_queue queue;
+    print("mutex", bench(queue, producers, rate, duration, output));
+  }
+  {
+    checks::reaper_queue queue;
+    print("mpsc", bench(queue, producers, rate, duration, output));
+  }
+
+  return (EXIT_SUCCESS);
+}
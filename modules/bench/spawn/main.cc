@@ -0,0 +1,253 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#ifdef HAVE_GETOPT_H
+#  include <getopt.h>
+#endif // HAVE_GETOPT_H
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <spawn.h>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/commands/spawner.hh"
+#include "com/centreon/logging/engine.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+extern char** environ;
+
+/**
+ *  Count results of the spawner, limiting the running processes.
+ */
+class counter : public commands::spawner::listener {
+public:
+               counter(unsigned int max_running)
+    : _done(0), _max_running(max_running), _running(0) {}
+  void         acquire() {
+    std::unique_lock<std::mutex> lock(_lock);
+    _cv.wait(lock, [this] { return _running < _max_running; });
+    ++_running;
+  }
+  void         spawned(commands::result& res) throw () override {
+    (void)res;
+    std::lock_guard<std::mutex> lock(_lock);
+    --_running;
+    ++_done;
+    _cv.notify_all();
+  }
+  void         wait(unsigned int count) {
+    std::unique_lock<std::mutex> lock(_lock);
+    _cv.wait(lock, [this, count] { return _done >= count; });
+  }
+
+private:
+  std::condition_variable
+               _cv;
+  unsigned int _done;
+  std::mutex   _lock;
+  unsigned int _max_running;
+  unsigned int _running;
+};
+
+/**
+ *  Start processes by forking this process.
+ */
+static void run_fork(
+              char** argv,
+              unsigned int count,
+              unsigned int max_running) {
+  unsigned int running(0);
+  for (unsigned int i(0); i < count; ++i) {
+    if (running == max_running) {
+      wait(nullptr);
+      --running;
+    }
+    pid_t pid(fork());
+    if (!pid) {
+      execve(argv[0], argv, environ);
+      _exit(127);
+    }
+    if (pid > 0)
+      ++running;
+  }
+  while (running--)
+    wait(nullptr);
+}
+
+/**
+ *  Start processes with posix_spawn() from this process.
+ */
+static void run_posix_spawn(
+              char** argv,
+              unsigned int count,
+              unsigned int max_running) {
+  unsigned int running(0);
+  for (unsigned int i(0); i < count; ++i) {
+    if (running == max_running) {
+      wait(nullptr);
+      --running;
+    }
+    pid_t pid;
+    if (!posix_spawn(&pid, argv[0], nullptr, nullptr, argv, environ))
+      ++running;
+  }
+  while (running--)
+    wait(nullptr);
+}
+
+/**
+ *  Start processes with the process spawner.
+ */
+static void run_spawner(
+              std::string const& cmd,
+              unsigned int count,
+              unsigned int max_running) {
+  counter c(max_running);
+  for (unsigned int i(0); i < count; ++i) {
+    c.acquire();
+    commands::spawner::instance().run(&c, i, cmd, nullptr, 0, true);
+  }
+  c.wait(count);
+}
+
+/**
+ *  Get the spawn rate of a launcher.
+ */
+template <typename F>
+static double rate(F f, unsigned int count) {
+  std::chrono::steady_clock::time_point
+    start(std::chrono::steady_clock::now());
+  f();
+  std::chrono::duration<double> elapsed(
+    std::chrono::steady_clock::now() - start);
+  return count / elapsed.count();
+}
+
+/**
+ *  Print usage.
+ */
+static void usage(char const* appname) {
+  std::cout
+    << "usage: " << appname << " [options]\n"
+    << "  -c <processes>  Running processes (default 8).\n"
+    << "  -h              Print this help.\n"
+    << "  -n <spawns>     Spawns per launcher and size (default 1000).\n"
+    << "  -p <program>    Program to run (default /bin/true).\n"
+    << "  -r <sizes>      Comma-separated resident sizes in MB\n"
+    << "                  (default 0,256,1024,4096).\n";
+}
+
+/**
+ *  Compare the spawn rate of process launchers as the resident size of
+ *  the engine grows. The process spawner is started first, like the
+ *  engine starts it before applying its configuration.
+ */
+int main(int argc, char* argv[]) {
+  unsigned int count(1000);
+  unsigned int max_running(8);
+  std::string program("/bin/true");
+  std::string sizes("0,256,1024,4096");
+  int opt;
+  while ((opt = getopt(argc, argv, "c:hn:p:r:")) != -1) {
+    switch (opt) {
+    case 'c':
+      max_running = strtoul(optarg, nullptr, 0);
+      break;
+    case 'n':
+      count = strtoul(optarg, nullptr, 0);
+      break;
+    case 'p':
+      program = optarg;
+      break;
+    case 'r':
+      sizes = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (!max_running)
+    max_running = 1;
+
+  clib::load();
+  logging::engine::load();
+  if (!commands::spawner::instance().start()) {
+    std::cerr << "could not start the process spawner" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<char> path(program.begin(), program.end());
+  path.push_back('\0');
+  char* args[] = { &path[0], nullptr };
+
+  std::cout
+    << std::setw(10) << "RSS (MB)"
+    << std::setw(16) << "fork/s"
+    << std::setw(16) << "posix_spawn/s"
+    << std::setw(16) << "spawner/s" << "\n";
+  std::vector<char*> blocks;
+  unsigned long allocated(0);
+  std::istringstream iss(sizes);
+  std::string size;
+  while (std::getline(iss, size, ',')) {
+    // Grow and touch the resident memory.
+    unsigned long target(strtoul(size.c_str(), nullptr, 0));
+    for (; allocated < target; ++allocated) {
+      char* block(new char[1024 * 1024]);
+      memset(block, 1, 1024 * 1024);
+      blocks.push_back(block);
+    }
+
+    double forked(rate(
+      [&] { run_fork(args, count, max_running); },
+      count));
+    double spawned(rate(
+      [&] { run_posix_spawn(args, count, max_running); },
+      count));
+    double helper(rate(
+      [&] { run_spawner(program, count, max_running); },
+      count));
+    std::cout << std::fixed << std::setprecision(0)
+      << std::setw(10) << allocated
+      << std::setw(16) << forked
+      << std::setw(16) << spawned
+      << std::setw(16) << helper << std::endl;
+  }
+
+  commands::spawner::instance().stop();
+  for (std::vector<char*>::iterator
+         it(blocks.begin()), end(blocks.end());
+       it != end;
+       ++it)
+    delete[] *it;
+  logging::engine::unload();
+  clib::unload();
+  return EXIT_SUCCESS;
+}
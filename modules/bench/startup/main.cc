@@ -0,0 +1,199 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#ifdef HAVE_GETOPT_H
+#  include <getopt.h>
+#endif // HAVE_GETOPT_H
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/broker/compatibility.hh"
+#include "com/centreon/engine/broker/loader.hh"
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/parser.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/events/timed_event.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+#include "com/centreon/logging/engine.hh"
+#include "engine_cfg.hh"
+
+using namespace com::centreon::engine;
+
+/**
+ *  Get the elapsed time since some point in seconds.
+ */
+static double elapsed(std::chrono::steady_clock::time_point const& since) {
+  return std::chrono::duration<double>(
+           std::chrono::steady_clock::now() - since).count();
+}
+
+/**
+ *  Print one result line.
+ */
+static void print(std::string const& name, double value) {
+  std::cout << "  " << std::left << std::setw(44) << name
+            << value << "\n";
+}
+
+/**
+ *  Bench how long Centreon Engine needs to start: parse its
+ *  configuration, apply it and get the first event to run.
+ *
+ *  @return EXIT_SUCCESS on success.
+ */
+int main(int argc, char* argv[]) {
+  // Options.
+#ifdef HAVE_GETOPT_H
+  int option_index(0);
+  static struct option const long_options[] = {
+    { "help", no_argument, NULL, '?' },
+    { "hosts", required_argument, NULL, 'h' },
+    { "services", required_argument, NULL, 's' },
+    { NULL, no_argument, NULL, '\0' }
+  };
+#endif // HAVE_GETOPT_H
+  int hosts(10000);
+  int services(200000);
+  bool help(false);
+
+  int c;
+#ifdef HAVE_GETOPT_H
+  while ((c = getopt_long(
+                argc,
+                argv,
+                "+?h:s:",
+                long_options,
+                &option_index)) != -1) {
+#else
+  while ((c = getopt(argc, argv, "+?h:s:")) != -1) {
+#endif // HAVE_GETOPT_H
+    switch (c) {
+    case 'h':
+      hosts = strtol(optarg, NULL, 0);
+      break ;
+    case 's':
+      services = strtol(optarg, NULL, 0);
+      break ;
+    default:
+      help = true;
+    }
+  }
+  if ((hosts <= 0) || (services < hosts))
+    help = true;
+
+  if (help) {
+    std::cout
+      << "Common options\n"
+      << "  -? --help             Print this help.\n"
+      << "  -h --hosts            Number of active hosts (default is "
+      << hosts << ").\n"
+      << "  -s --services         Number of active services, at least one\n"
+      << "                        per host (default is "
+      << services << ").\n";
+    return (EXIT_SUCCESS);
+  }
+
+  // Load singletons and global variable.
+  com::centreon::clib::load();
+  com::centreon::logging::engine::load();
+  config = new configuration::state;
+  timezone_manager::load();
+  configuration::applier::state::load();
+  checks::checker::load();
+  events::loop::load();
+  broker::loader::load();
+  broker::compatibility::load();
+
+  int retval(EXIT_FAILURE);
+  try {
+    // Banner.
+    std::cout << "--------------------------------------\n"
+              << "Centreon Engine startup time benchmark\n"
+              << "--------------------------------------\n"
+              << "\n";
+
+    // Generate configuration files.
+    std::cout << "Generating configuration files...               ";
+    std::cout.flush();
+    engine_cfg cfg_files("", 0, hosts, services, 0, 0);
+    std::cout << "Done\n\n";
+
+    // Parse configuration.
+    std::chrono::steady_clock::time_point start(
+      std::chrono::steady_clock::now());
+    configuration::state cfg;
+    {
+      configuration::parser p;
+      p.parse(cfg_files.main_file(), cfg);
+    }
+    double parse_time(elapsed(start));
+
+    // Apply configuration, this schedules the initial events.
+    std::chrono::steady_clock::time_point apply_start(
+      std::chrono::steady_clock::now());
+    configuration::applier::state::instance().apply(cfg);
+    double apply_time(elapsed(apply_start));
+
+    // Get the first event the events loop would run.
+    std::chrono::steady_clock::time_point first_start(
+      std::chrono::steady_clock::now());
+    timed_event* first(timed_event::event_list_low.front());
+    double first_time(elapsed(first_start));
+    double total_time(elapsed(start));
+
+    // Print results.
+    print("Hosts", hosts);
+    print("Services", services);
+    print("Scheduled events", timed_event::event_list_low.size()
+                              + timed_event::event_list_high.size());
+    print("Parse time in seconds", parse_time);
+    print("Apply time in seconds", apply_time);
+    print("First event time in seconds", first_time);
+    print("Total startup time in seconds", total_time);
+    if (!first)
+      std::cout << "\nNo event was scheduled\n";
+    else
+      retval = EXIT_SUCCESS;
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+  }
+
+  // Unload singletons and global objects.
+  events::loop::unload();
+  broker::compatibility::unload();
+  broker::loader::unload();
+  configuration::applier::state::unload();
+  checks::checker::unload();
+  delete config;
+  config = nullptr;
+  timezone_manager::unload();
+  com::centreon::logging::engine::unload();
+  com::centreon::clib::unload();
+
+  return (retval);
+}
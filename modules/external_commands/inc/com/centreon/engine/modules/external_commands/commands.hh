@@ -53,6 +53,8 @@ int cmd_change_object_int_var(int cmd,char* args);                          // c
 int cmd_change_object_char_var(int cmd,char* args);                         // changes host/svc (char) variable
 int cmd_change_object_custom_var(int cmd, char* args);                      // changes host/svc custom variable
 int cmd_process_external_commands_from_file(int cmd, char* args);           // process external commands from a file
+int cmd_dump_event_stats(int cmd, char* args);                              // writes the events loop statistics to a file
+void reset_event_stats();                                                   // forgets the events loop statistics
 int cmd_delete_downtime_by_start_time_comment(int, char*);
 int cmd_delete_downtime_by_host_name(int, char*);
 int cmd_delete_downtime_by_hostgroup_name(int, char*);
@@ -21,14 +21,17 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <sstream>
 #include <sys/time.h>
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/commands/environment_cache.hh"
 #include "com/centreon/engine/comment.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/downtimes/downtime_finder.hh"
 #include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/event_stats.hh"
 #include "com/centreon/engine/flapping.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
@@ -1652,6 +1655,7 @@ int cmd_change_object_int_var(int cmd, char* args) {
 
   case CMD_CHANGE_MAX_HOST_CHECK_ATTEMPTS:
     temp_host->set_max_attempts(intval);
+    commands::environment_cache::instance().invalidate(temp_host);
     attr = MODATTR_MAX_CHECK_ATTEMPTS;
 
     /* adjust current attempt number if in a hard state */
@@ -1703,6 +1707,8 @@ int cmd_change_object_int_var(int cmd, char* args) {
 
   case CMD_CHANGE_MAX_SVC_CHECK_ATTEMPTS:
     found_svc->second->set_max_attempts(intval);
+    commands::environment_cache::instance().invalidate(
+      found_svc->second.get());
     attr = MODATTR_MAX_CHECK_ATTEMPTS;
 
     /* adjust current attempt number if in a hard state */
@@ -2006,6 +2012,7 @@ int cmd_change_object_char_var(int cmd, char* args) {
   case CMD_CHANGE_HOST_CHECK_COMMAND:
     temp_host->set_check_command(temp_ptr);
     temp_host->set_check_command_ptr(cmd_found->second.get());
+    commands::environment_cache::instance().invalidate(temp_host);
     attr = MODATTR_CHECK_COMMAND;
     break;
 
@@ -2032,6 +2039,8 @@ int cmd_change_object_char_var(int cmd, char* args) {
     found_svc->second->set_check_command(temp_ptr);
     delete[] temp_ptr;
     found_svc->second->set_check_command_ptr(cmd_found->second.get());
+    commands::environment_cache::instance().invalidate(
+      found_svc->second.get());
     attr = MODATTR_CHECK_COMMAND;
     break;
 
@@ -2241,6 +2250,8 @@ int cmd_change_object_custom_var(int cmd, char* args) {
       else
         it->second.update(varvalue);
 
+      commands::environment_cache::instance().invalidate(temp_host);
+
       /* set the modified attributes and update the status of the object */
       temp_host->add_modified_attributes(MODATTR_CUSTOM_VARIABLE);
       temp_host->update_status(false);
@@ -2260,6 +2271,9 @@ int cmd_change_object_custom_var(int cmd, char* args) {
       else
         it->second.update(varvalue);
 
+      commands::environment_cache::instance().invalidate(
+        found->second.get());
+
       found->second->add_modified_attributes(MODATTR_CUSTOM_VARIABLE);
       found->second->update_status(false);
     }
@@ -2276,6 +2290,9 @@ int cmd_change_object_custom_var(int cmd, char* args) {
       else
         it->second.update(varvalue);
 
+      commands::environment_cache::instance().invalidate(
+        cnct_it->second.get());
+
       cnct_it->second->add_modified_attributes(MODATTR_CUSTOM_VARIABLE);
       cnct_it->second->update_status_info(false);
     }
@@ -2319,6 +2336,31 @@ int cmd_process_external_commands_from_file(int cmd, char* args) {
   return OK;
 }
 
+/* writes the events loop statistics to a file */
+int cmd_dump_event_stats(int cmd, char* args) {
+  (void)cmd;
+
+  /* get the file name */
+  char* fname(my_strtok(args, ";"));
+  if (!fname || !*fname)
+    return ERROR;
+
+  std::ofstream ofs(fname, std::ios::out | std::ios::trunc);
+  if (ofs.is_open())
+    events::event_stats::instance().dump(ofs);
+  if (!ofs.is_open() || !ofs.flush()) {
+    logger(log_runtime_error, basic)
+      << "Error: could not write event statistics to '" << fname << "'";
+    return ERROR;
+  }
+  return OK;
+}
+
+/* forgets the events loop statistics */
+void reset_event_stats() {
+  events::event_stats::instance().reset();
+}
+
 /******************************************************************/
 /*************** INTERNAL COMMAND IMPLEMENTATIONS  ****************/
 /******************************************************************/
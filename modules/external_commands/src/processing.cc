@@ -223,6 +223,10 @@ processing::processing()
   // misc commands.
   _lst_command["PROCESS_FILE"] = command_info(
       CMD_PROCESS_FILE, &_redirector<&cmd_process_external_commands_from_file>);
+  _lst_command["DUMP_EVENT_STATS"] = command_info(
+      CMD_DUMP_EVENT_STATS, &_redirector<&cmd_dump_event_stats>);
+  _lst_command["RESET_EVENT_STATS"] = command_info(
+      CMD_RESET_EVENT_STATS, &_redirector<&reset_event_stats>);
 }
 
 processing::~processing() throw() {}
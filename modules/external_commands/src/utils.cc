@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include "com/centreon/engine/common.hh"
+#include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/modules/external_commands/internal.hh"
@@ -398,6 +399,10 @@ int submit_external_command(char const* cmd, int* buffer_items) {
     external_command_buffer.items++;
     if (external_command_buffer.items > external_command_buffer.high)
       external_command_buffer.high = external_command_buffer.items;
+
+    /* wake the events loop up, unless it already has commands to process */
+    if (external_command_buffer.items == 1)
+      events::loop::wakeup(events::loop::wakeup_external_command);
   }
   /* buffer was full */
   else
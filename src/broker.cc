@@ -31,6 +31,23 @@
 
 using namespace com::centreon::engine;
 
+/**
+ *  Get the metrics of performance data sent to the broker.
+ *
+ *  @param[in] obj        Host or service.
+ *  @param[in] perf_data  Performance data sent.
+ *
+ *  @return Metrics of perf_data if they are the current performance
+ *          data of obj, nullptr otherwise.
+ */
+static perfdata const* get_perf_data_metrics(
+                         checkable const* obj,
+                         char const* perf_data) {
+  if (!perf_data || (perf_data != obj->get_perf_data().c_str()))
+    return nullptr;
+  return &obj->get_perf_data_metrics();
+}
+
 extern "C" {
 
 /**
@@ -1167,6 +1184,7 @@ int broker_host_check(
   ds.output = output;
   ds.long_output = long_output;
   ds.perf_data = perfdata;
+  ds.perf_data_metrics = get_perf_data_metrics(hst, perfdata);
 
   // Make callbacks.
   int return_code;
@@ -1598,6 +1616,7 @@ int broker_service_check(
   ds.output = const_cast<char*>(svc->get_plugin_output().c_str());
   ds.long_output = const_cast<char*>(svc->get_long_plugin_output().c_str());
   ds.perf_data = const_cast<char*>(svc->get_perf_data().c_str());
+  ds.perf_data_metrics = get_perf_data_metrics(svc, ds.perf_data);
 
   // Make callbacks.
   int return_code;
@@ -1787,7 +1806,7 @@ void broker_timed_event(
   ds.timestamp = get_broker_timestamp(timestamp);
   ds.event_type = event->event_type;
   ds.recurring = event->recurring;
-  ds.run_time = event->run_time;
+  ds.run_time = event->get_run_time();
   ds.event_data = event->event_data;
   ds.event_ptr = event;
 
@@ -199,11 +199,39 @@ int external_commands_last_15min = 0;
 int total_external_command_buffer_slots = 0;
 int used_external_command_buffer_slots = 0;
 int high_external_command_buffer_slots = 0;
+int loop_events_run = 0;
+int loop_events_deferred = 0;
+unsigned long loop_duration = 0L;
+long loop_lag = 0L;
+int queued_service_checks = 0;
+double average_service_check_queue_delay = 0.0;
+double max_service_check_queue_delay = 0.0;
+double current_check_load = 0.0;
+double average_check_load = 0.0;
+double peak_check_load = 0.0;
+double reload_stop_the_world_time = 0.0;
+int check_result_backlog = 0;
+double check_result_reap_rate = 0.0;
+unsigned long host_check_cache_hits = 0;
+unsigned long host_check_cache_misses = 0;
+
+// Time spent by the events loop for each event type (microseconds).
+#define MAX_EVENT_STATS            32
+struct event_stat {
+  char name[32];
+  unsigned long count;
+  unsigned long lag[4];
+  unsigned long execution[4];
+  unsigned long long total_execution;
+};
+event_stat event_stats[MAX_EVENT_STATS];
+int event_stats_entries = 0;
 
 // Forward declarations.
 int display_stats();
 void get_time_breakdown(unsigned long, int*, int*, int*, int*);
 int read_config_file();
+void read_event_stats(char*);
 int read_stats_file();
 int read_status_file();
 void strip(char*);
@@ -396,6 +424,27 @@ int display_stats() {
          used_external_command_buffer_slots,
          high_external_command_buffer_slots,
          total_external_command_buffer_slots);
+  printf("Last Loop Run/Deferred/Time/Lag:        %d / %d / %lu us / %ld sec\n",
+         loop_events_run,
+         loop_events_deferred,
+         loop_duration,
+         loop_lag);
+  printf("Queued Service Checks/Avg/Max Delay:    %d / %.3f / %.3f sec\n",
+         queued_service_checks,
+         average_service_check_queue_delay,
+         max_service_check_queue_delay);
+  printf("Check Load Now/1min Avg/5min Peak:      %.3f / %.3f / %.3f sec/sec\n",
+         current_check_load,
+         average_check_load,
+         peak_check_load);
+  printf("Last Reload Stop-The-World Time:        %.3f sec\n",
+         reload_stop_the_world_time);
+  printf("Check Result Backlog/Reap Rate:         %d / %.1f results/sec\n",
+         check_result_backlog,
+         check_result_reap_rate);
+  printf("Host Check Cache Hits/Misses:           %lu / %lu\n",
+         host_check_cache_hits,
+         host_check_cache_misses);
   printf("\n");
   printf("Total Services:                         %d\n", status_service_entries);
   printf("Services Checked:                       %d\n", services_checked);
@@ -533,6 +582,27 @@ int display_stats() {
   printf("\n");
   printf("\n");
 
+  if (event_stats_entries) {
+    printf("EVENTS LOOP TIME PER EVENT TYPE (USEC)\n");
+    printf("------------------------------------------------------\n");
+    printf("%-26s %10s %10s %10s %10s %10s %10s %10s %12s\n",
+           "Event Type", "Count",
+           "Lag p50", "Lag p99", "Lag Max",
+           "Exec p50", "Exec p99", "Exec Max", "Exec Total s");
+    for (int i(0); i < event_stats_entries; ++i)
+      printf("%-26s %10lu %10lu %10lu %10lu %10lu %10lu %10lu %12.3f\n",
+             event_stats[i].name,
+             event_stats[i].count,
+             event_stats[i].lag[0],
+             event_stats[i].lag[2],
+             event_stats[i].lag[3],
+             event_stats[i].execution[0],
+             event_stats[i].execution[2],
+             event_stats[i].execution[3],
+             event_stats[i].total_execution / 1000000.0);
+    printf("\n");
+  }
+
   /*
     printf("CURRENT COMMENT DATA\n");
     printf("----------------------------------------------------\n");
@@ -939,6 +1009,46 @@ int read_status_file() {
           used_external_command_buffer_slots = atoi(val);
         else if (!strcmp(var, "high_external_command_buffer_slots"))
           high_external_command_buffer_slots = atoi(val);
+        else if (!strcmp(var, "loop_events_run"))
+          loop_events_run = atoi(val);
+        else if (!strcmp(var, "loop_events_deferred"))
+          loop_events_deferred = atoi(val);
+        else if (!strcmp(var, "loop_duration"))
+          loop_duration = strtoul(val, NULL, 10);
+        else if (!strcmp(var, "loop_lag"))
+          loop_lag = strtol(val, NULL, 10);
+        else if (!strcmp(var, "queued_service_checks"))
+          queued_service_checks = atoi(val);
+        else if (!strcmp(var, "service_check_queue_delay")) {
+          if ((temp_ptr = strtok(val, ",")))
+            average_service_check_queue_delay = strtod(temp_ptr, NULL);
+          if ((temp_ptr = strtok(NULL, ",")))
+            max_service_check_queue_delay = strtod(temp_ptr, NULL);
+        }
+        else if (!strcmp(var, "projected_check_load")) {
+          if ((temp_ptr = strtok(val, ",")))
+            current_check_load = strtod(temp_ptr, NULL);
+          if ((temp_ptr = strtok(NULL, ",")))
+            average_check_load = strtod(temp_ptr, NULL);
+          if ((temp_ptr = strtok(NULL, ",")))
+            peak_check_load = strtod(temp_ptr, NULL);
+        }
+        else if (!strcmp(var, "reload_stop_the_world_time"))
+          reload_stop_the_world_time = strtod(val, NULL);
+        else if (!strcmp(var, "check_result_reaper")) {
+          if ((temp_ptr = strtok(val, ",")))
+            check_result_backlog = atoi(temp_ptr);
+          if ((temp_ptr = strtok(NULL, ",")))
+            check_result_reap_rate = strtod(temp_ptr, NULL);
+        }
+        else if (!strcmp(var, "host_check_cache")) {
+          if ((temp_ptr = strtok(val, ",")))
+            host_check_cache_hits = strtoul(temp_ptr, NULL, 10);
+          if ((temp_ptr = strtok(NULL, ",")))
+            host_check_cache_misses = strtoul(temp_ptr, NULL, 10);
+        }
+        else if (!strcmp(var, "event_stats"))
+          read_event_stats(val);
         else if (!strcmp(var, "nagios_pid"))
           nagios_pid = strtoul(val, NULL, 10);
         else if (!strcmp(var, "active_scheduled_host_check_stats")) {
@@ -1130,6 +1240,46 @@ int read_stats_file() {
       used_external_command_buffer_slots = atoi(val);
     else if (!strcmp(var, "high_external_command_buffer_slots"))
       high_external_command_buffer_slots = atoi(val);
+    else if (!strcmp(var, "loop_events_run"))
+      loop_events_run = atoi(val);
+    else if (!strcmp(var, "loop_events_deferred"))
+      loop_events_deferred = atoi(val);
+    else if (!strcmp(var, "loop_duration"))
+      loop_duration = strtoul(val, NULL, 10);
+    else if (!strcmp(var, "loop_lag"))
+      loop_lag = strtol(val, NULL, 10);
+    else if (!strcmp(var, "queued_service_checks"))
+      queued_service_checks = atoi(val);
+    else if (!strcmp(var, "service_check_queue_delay")) {
+      if ((temp_ptr = strtok(val, ",")))
+        average_service_check_queue_delay = strtod(temp_ptr, NULL);
+      if ((temp_ptr = strtok(NULL, ",")))
+        max_service_check_queue_delay = strtod(temp_ptr, NULL);
+    }
+    else if (!strcmp(var, "projected_check_load")) {
+      if ((temp_ptr = strtok(val, ",")))
+        current_check_load = strtod(temp_ptr, NULL);
+      if ((temp_ptr = strtok(NULL, ",")))
+        average_check_load = strtod(temp_ptr, NULL);
+      if ((temp_ptr = strtok(NULL, ",")))
+        peak_check_load = strtod(temp_ptr, NULL);
+    }
+    else if (!strcmp(var, "reload_stop_the_world_time"))
+      reload_stop_the_world_time = strtod(val, NULL);
+    else if (!strcmp(var, "check_result_reaper")) {
+      if ((temp_ptr = strtok(val, ",")))
+        check_result_backlog = atoi(temp_ptr);
+      if ((temp_ptr = strtok(NULL, ",")))
+        check_result_reap_rate = strtod(temp_ptr, NULL);
+    }
+    else if (!strcmp(var, "host_check_cache")) {
+      if ((temp_ptr = strtok(val, ",")))
+        host_check_cache_hits = strtoul(temp_ptr, NULL, 10);
+      if ((temp_ptr = strtok(NULL, ",")))
+        host_check_cache_misses = strtoul(temp_ptr, NULL, 10);
+    }
+    else if (!strcmp(var, "event_stats"))
+      read_event_stats(val);
     else if (!strcmp(var, "nagios_pid"))
       nagios_pid = strtoul(val, NULL, 10);
     else if (!strcmp(var, "active_scheduled_host_check_stats")) {
@@ -1419,6 +1569,29 @@ int read_stats_file() {
   return (OK);
 }
 
+/* read the events loop statistics of one event type */
+void read_event_stats(char* val) {
+  if (event_stats_entries >= MAX_EVENT_STATS)
+    return;
+  char* temp_ptr(strtok(val, ","));
+  if (temp_ptr == NULL)
+    return;
+  event_stat& stat(event_stats[event_stats_entries++]);
+  memset(&stat, 0, sizeof(stat));
+  strncpy(stat.name, temp_ptr, sizeof(stat.name) - 1);
+  if ((temp_ptr = strtok(NULL, ",")))
+    stat.count = strtoul(temp_ptr, NULL, 10);
+  for (int i(0); i < 4; ++i)
+    if ((temp_ptr = strtok(NULL, ",")))
+      stat.lag[i] = strtoul(temp_ptr, NULL, 10);
+  for (int i(0); i < 4; ++i)
+    if ((temp_ptr = strtok(NULL, ",")))
+      stat.execution[i] = strtoul(temp_ptr, NULL, 10);
+  if ((temp_ptr = strtok(NULL, ",")))
+    stat.total_execution = strtoull(temp_ptr, NULL, 10);
+  return;
+}
+
 /* strip newline, carriage return, and tab characters from beginning and end of a string */
 void strip(char* buffer) {
   int x;
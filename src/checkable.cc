@@ -20,6 +20,7 @@
 #include <sstream>
 #include "com/centreon/engine/checkable.hh"
 #include "com/centreon/engine/error.hh"
+#include "com/centreon/engine/events/monotonic_clock.hh"
 #include "com/centreon/engine/logging/logger.hh"
 
 using namespace com::centreon::engine;
@@ -61,6 +62,7 @@ checkable::checkable(std::string const& display_name,
       _icon_image_alt{icon_image_alt},
       _notes{notes},
       _notes_url{notes_url},
+      _perf_data_parsed{true},
       _flap_detection_enabled{flap_detection_enabled},
       _low_flap_threshold{low_flap_threshold},
       _high_flap_threshold{high_flap_threshold},
@@ -224,6 +226,23 @@ std::string const& checkable::get_perf_data() const { return _perf_data; }
 
 void checkable::set_perf_data(std::string const& perf_data) {
   _perf_data = perf_data;
+  _perf_data_metrics.clear();
+  _perf_data_parsed = false;
+}
+
+void checkable::set_perf_data(std::string&& perf_data, perfdata&& metrics) {
+  _perf_data = std::move(perf_data);
+  _perf_data_metrics = std::move(metrics);
+  _perf_data_parsed = true;
+}
+
+perfdata const& checkable::get_perf_data_metrics() const {
+  // Performance data not set from a check result are parsed on demand.
+  if (!_perf_data_parsed) {
+    _perf_data_metrics.parse(_perf_data);
+    _perf_data_parsed = true;
+  }
+  return _perf_data_metrics;
 }
 
 bool checkable::get_flap_detection_enabled(void) const {
@@ -349,10 +368,20 @@ double checkable::get_latency() const { return _latency; }
 
 void checkable::set_latency(double latency) { _latency = latency; }
 
-std::time_t checkable::get_next_check() const { return _next_check; }
+/**
+ *  Get the next check time. It is kept on the monotonic clock so that
+ *  it follows wall clock changes without being rewritten.
+ *
+ *  @return Next check time on the wall clock, 0 if none.
+ */
+std::time_t checkable::get_next_check() const {
+  return _next_check ? events::monotonic_clock::to_wall(_next_check) : 0;
+}
 
 void checkable::set_next_check(std::time_t next_check) {
-  _next_check = next_check;
+  _next_check = next_check
+    ? events::monotonic_clock::to_monotonic(next_check)
+    : 0;
 }
 
 enum checkable::state_type checkable::get_state_type() const {
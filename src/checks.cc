@@ -17,19 +17,21 @@
 ** <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <dirent.h>
 #include <fcntl.h>
-#include <mmap.h>
 #include <string>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <utility>
 #include "com/centreon/engine/checks.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/spool_watcher.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/utils.hh"
 
 using namespace com::centreon::engine;
 
@@ -46,7 +48,8 @@ check_result::check_result()
     _early_timeout{false},
     _exited_ok{false},
     _return_code{0},
-    _output{""}
+    _output{""},
+    _output_parsed{false}
 {
   timeval tv{0, 0};
   _start_time = tv;
@@ -66,7 +69,12 @@ check_result::check_result(check_result const& other)
       _early_timeout{other._early_timeout},
       _exited_ok{other._exited_ok},
       _return_code{other._return_code},
-      _output{other._output} {}
+      _output{other._output},
+      _output_parsed{other._output_parsed},
+      _plugin_output{other._plugin_output},
+      _long_plugin_output{other._long_plugin_output},
+      _perf_data{other._perf_data},
+      _perf_data_metrics{other._perf_data_metrics} {}
 
 check_result& check_result::operator=(check_result const& other) {
   if (this != &other) {
@@ -83,6 +91,35 @@ check_result& check_result::operator=(check_result const& other) {
     _exited_ok = other._exited_ok;
     _return_code = other._return_code;
     _output = other._output;
+    _output_parsed = other._output_parsed;
+    _plugin_output = other._plugin_output;
+    _long_plugin_output = other._long_plugin_output;
+    _perf_data = other._perf_data;
+    _perf_data_metrics = other._perf_data_metrics;
+  }
+  return *this;
+}
+
+check_result& check_result::operator=(check_result&& other) {
+  if (this != &other) {
+    _object_check_type = other._object_check_type;
+    _host_id = other._host_id;
+    _service_id = other._service_id;
+    _check_type = other._check_type;
+    _check_options = other._check_options;
+    _reschedule_check = other._reschedule_check;
+    _latency = other._latency;
+    _start_time = other._start_time;
+    _finish_time = other._finish_time;
+    _early_timeout = other._early_timeout;
+    _exited_ok = other._exited_ok;
+    _return_code = other._return_code;
+    _output = std::move(other._output);
+    _output_parsed = other._output_parsed;
+    _plugin_output = std::move(other._plugin_output);
+    _long_plugin_output = std::move(other._long_plugin_output);
+    _perf_data = std::move(other._perf_data);
+    _perf_data_metrics = std::move(other._perf_data_metrics);
   }
   return *this;
 }
@@ -100,7 +137,12 @@ check_result::check_result(check_result&& other)
       _early_timeout{other._early_timeout},
       _exited_ok{other._exited_ok},
       _return_code{other._return_code},
-      _output{std::move(other._output)} {}
+      _output{std::move(other._output)},
+      _output_parsed{other._output_parsed},
+      _plugin_output{std::move(other._plugin_output)},
+      _long_plugin_output{std::move(other._long_plugin_output)},
+      _perf_data{std::move(other._perf_data)},
+      _perf_data_metrics{std::move(other._perf_data_metrics)} {}
 
 check_result::check_result(enum check_source object_check_type,
                            uint64_t host_id,
@@ -127,7 +169,8 @@ check_result::check_result(enum check_source object_check_type,
     _early_timeout{early_timeout},
     _exited_ok{exited_ok},
     _return_code{return_code},
-    _output{output} {}
+    _output{output},
+    _output_parsed{false} {}
 
 enum check_source check_result::get_object_check_type() const {
   return _object_check_type;
@@ -191,6 +234,12 @@ std::string const& check_result::get_output() const {
 
 void check_result::set_output(std::string const& output) {
   _output = output;
+  _output_parsed = false;
+}
+
+void check_result::set_output(std::string&& output) {
+  _output = std::move(output);
+  _output_parsed = false;
 }
 
 bool check_result::get_exited_ok() const {
@@ -233,6 +282,73 @@ void check_result::set_check_options(int check_options) {
   _check_options = check_options;
 }
 
+bool check_result::get_output_parsed() const {
+  return _output_parsed;
+}
+
+/**
+ *  Split the output in plugin output, long plugin output and perfdata,
+ *  and parse the metrics of the perfdata. Semicolons of the plugin
+ *  output are replaced with colons. It only works on this result, and
+ *  can therefore be done by any thread before the result is handled.
+ */
+void check_result::parse_output() {
+  _plugin_output.clear();
+  _long_plugin_output.clear();
+  _perf_data.clear();
+  parse_check_output(
+    _output,
+    _plugin_output,
+    _long_plugin_output,
+    _perf_data,
+    true,
+    true);
+  std::replace(_plugin_output.begin(), _plugin_output.end(), ';', ':');
+  _perf_data_metrics.parse(_perf_data);
+  _output_parsed = true;
+}
+
+/**
+ *  Get the parsed output, parsing it first if it was not yet.
+ *
+ *  @param[out] plugin_output       Plugin output.
+ *  @param[out] long_plugin_output  Long plugin output.
+ *  @param[out] perf_data           Perfdata.
+ */
+void check_result::take_parsed_output(std::string& plugin_output,
+                                      std::string& long_plugin_output,
+                                      std::string& perf_data) {
+  if (!_output_parsed)
+    parse_output();
+  plugin_output = std::move(_plugin_output);
+  long_plugin_output = std::move(_long_plugin_output);
+  perf_data = std::move(_perf_data);
+  _perf_data_metrics.clear();
+  _output_parsed = false;
+}
+
+/**
+ *  Get the parsed output and the metrics of its perfdata, parsing it
+ *  first if it was not yet.
+ *
+ *  @param[out] plugin_output       Plugin output.
+ *  @param[out] long_plugin_output  Long plugin output.
+ *  @param[out] perf_data           Perfdata.
+ *  @param[out] metrics             Metrics of perf_data.
+ */
+void check_result::take_parsed_output(std::string& plugin_output,
+                                      std::string& long_plugin_output,
+                                      std::string& perf_data,
+                                      perfdata& metrics) {
+  if (!_output_parsed)
+    parse_output();
+  plugin_output = std::move(_plugin_output);
+  long_plugin_output = std::move(_long_plugin_output);
+  perf_data = std::move(_perf_data);
+  metrics = std::move(_perf_data_metrics);
+  _output_parsed = false;
+}
+
 /**
  *  Reads check result(s) from a file.
  *
@@ -249,178 +365,28 @@ bool check_result::process_check_result_file(std::string const& fname) {
   logger(logging::dbg_checks, logging::more)
     << "Processing check result file: '" << fname << "'";
 
-  // Open the file for reading.
-  mmapfile* thefile(nullptr);
-  if ((thefile = mmap_fopen(fname.c_str())) == nullptr) {
-    // Try removing the file - zero length files can't be mmap()'ed,
-    // so it might exist.
+  // Read all results of the file.
+  std::list<checks::spool_watcher::record> records;
+  if (!checks::spool_watcher::read_file(
+         fname,
+         time(nullptr),
+         config->max_check_result_file_age(),
+         records)) {
     remove(fname.c_str());
     return false;
   }
 
-  time_t current_time(time(nullptr));
-
-  // Read in all lines from the file.
-  char* input(nullptr);
-  check_result* new_cr(nullptr);
-  char* v1(nullptr);
-  char* v2(nullptr);
-  char* var(nullptr);
-  char* val(nullptr);
-
-  std::string hostname;
-  std::string service_description;
-  while (true) {
-    // Free memory.
-    delete[] input;
-
-    // Read the next line.
-    if ((input = mmap_fgets_multiline(thefile)) == nullptr)
-      break;
-
-    // Skip comments.
-    if (input[0] == '#')
-      continue;
-
-      // Empty line indicates end of record.
-    else if (input[0] == '\n') {
-      // We have something...
-      if (new_cr) {
-        // Do we have the minimum amount of data?
-        if (new_cr->get_host_id() && !new_cr->get_output().empty()) {
-          // Add check result to list in memory.
-          checks::checker::instance().push_check_result(new_cr);
-
-          // Reset pointer.
-          delete new_cr;
-          new_cr = nullptr;
-        }
-          // Discard partial input.
-        else {
-          timeval tv{0, 0};
-
-          new_cr->set_object_check_type(host_check);
-          new_cr->set_host_id(0);
-          new_cr->set_service_id(0);
-          new_cr->set_check_type(checkable::check_active);
-          new_cr->set_check_options(CHECK_OPTION_NONE);
-          new_cr->set_reschedule_check(false);
-          new_cr->set_latency(0.0);
-          new_cr->set_start_time(tv);
-          new_cr->set_finish_time(tv);
-          new_cr->set_early_timeout(false);
-          new_cr->set_exited_ok(true);
-          new_cr->set_return_code(0);
-          new_cr->set_output("");
-        }
-      }
-    }
-    if ((var = my_strtok(input, "=")) == nullptr)
-      continue;
-    if ((val = my_strtok(nullptr, "\n")) == nullptr)
-      continue;
-
-    // if file is too old, remove it.
-    if (!strcmp(var, "file_time")
-      && config->max_check_result_file_age() > 0) {
-      unsigned long diff(current_time - strtoul(val, nullptr, 0));
-      if (diff > config->max_check_result_file_age()) {
-        delete new_cr;
-        new_cr = nullptr;
-        break;
-      }
-    }
-
-    // Allocate new check result if necessary.
-    if (!new_cr) {
-      new_cr = new check_result;
-    }
-
-    // Process variable.
-    if (!strcmp(var, "host_name")) {
-      hostname = val;
-      host_map::const_iterator it{host::hosts.find(hostname)};
-      if (it != host::hosts.end())
-        new_cr->set_host_id(it->second->get_host_id());
-    }
-    else if (!strcmp(var, "service_description")) {
-      service_description = val;
-      new_cr->set_object_check_type(service_check);
-    }
-    else if (!strcmp(var, "check_type"))
-      new_cr->set_check_type(static_cast<enum checkable::check_type>(strtol(val, nullptr, 0)));
-    else if (!strcmp(var, "check_options"))
-      new_cr->set_check_options(strtol(val, nullptr, 0));
-    else if (!strcmp(var, "scheduled_check"))
-      ;/*new_cr->set_scheduled_check(strtol(val, nullptr, 0));*/
-    else if (!strcmp(var, "reschedule_check"))
-      new_cr->set_reschedule_check(strtol(val, nullptr, 0));
-    else if (!strcmp(var, "latency"))
-      new_cr->set_latency(strtod(val, nullptr));
-    else if (!strcmp(var, "start_time")) {
-      if ((v1 = strtok(val, ".")) == nullptr)
-        continue;
-      if ((v2 = strtok(nullptr, "\n")) == nullptr)
-        continue;
-      timeval tv;
-      tv.tv_sec = strtoul(v1, nullptr, 0);
-      tv.tv_usec = strtoul(v2, nullptr, 0);
-      new_cr->set_start_time(tv);
-    }
-    else if (!strcmp(var, "finish_time")) {
-      if ((v1 = strtok(val, ".")) == nullptr)
-        continue;
-      if ((v2 = strtok(nullptr, "\n")) == nullptr)
-        continue;
-      timeval tv;
-      tv.tv_sec = strtoul(v1, nullptr, 0);
-      tv.tv_usec = strtoul(v2, nullptr, 0);
-      new_cr->set_finish_time(tv);
-    }
-    else if (!strcmp(var, "early_timeout"))
-      new_cr->set_early_timeout(strtol(val, nullptr, 0));
-    else if (!strcmp(var, "exited_ok"))
-      new_cr->set_exited_ok(strtol(val, nullptr, 0));
-    else if (!strcmp(var, "return_code"))
-      new_cr->set_return_code(strtol(val, nullptr, 0));
-    else if (!strcmp(var, "output"))
-      new_cr->set_output(val);
-  }
-
-  // We have something.
-  if (new_cr) {
-    if (!service_description.empty() && !hostname.empty()) {
-      service_map::const_iterator it{service::services.find({hostname, service_description})};
-      if (it != service::services.end())
-        new_cr->set_service_id(it->second->get_service_id());
-    }
+  // Add check results to list in memory.
+  for (std::list<checks::spool_watcher::record>::iterator
+         it(records.begin()),
+         end(records.end());
+       it != end;
+       ++it)
+    if (checks::spool_watcher::resolve(*it))
+      checks::checker::instance().push_check_result(std::move(it->result));
 
-    // Do we have the minimum amount of data?
-    if (new_cr->get_host_id() && !new_cr->get_output().empty()) {
-      // Add check result to list in memory.
-      checks::checker::instance().push_check_result(new_cr);
-
-      // Reset pointer.
-      delete new_cr;
-      new_cr = nullptr;
-    }
-
-      // Discard partial input and free memory for current check result
-      // record.
-    else
-      delete new_cr;
-  }
-
-  // Free memory and close file.
-  delete[] input;
-  mmap_fclose(thefile);
-
-  // Delete the file (as well its ok-to-go file) if it's too old.
-  // Other (current) files are deleted later (when results are
-  // processed).
+  // Delete the file (as well its ok-to-go file).
   remove(fname.c_str());
-
-  // Delete the ok-to-go file.
   remove(std::string(fname).append(".ok").c_str());
 
   return true;
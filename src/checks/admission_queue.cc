@@ -0,0 +1,235 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <functional>
+#include "com/centreon/engine/checks/admission_queue.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/globals.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::checks;
+
+/**
+ *  Default constructor.
+ */
+admission_queue::admission_queue()
+  : _admitted(0),
+    _delay_sum(0.0),
+    _max_delay(0.0) {}
+
+/**
+ *  Destructor.
+ */
+admission_queue::~admission_queue() throw () {}
+
+/**
+ *  Get the average time checks spent in the queue.
+ *
+ *  @return Average delay in seconds.
+ */
+double admission_queue::average_delay() const throw () {
+  return _admitted ? _delay_sum / _admitted : 0.0;
+}
+
+/**
+ *  Check if a service check can be run now.
+ *
+ *  @param[in] host_id  Host of the service.
+ *  @param[in] command  Check command name.
+ *
+ *  @return True if no limit is reached.
+ */
+bool admission_queue::can_run(
+       uint64_t host_id,
+       std::string const& command) const {
+  if (!_global_slot_free())
+    return false;
+  unsigned int per_host(config->max_parallel_checks_per_host());
+  if (per_host) {
+    std::unordered_map<uint64_t, unsigned int>::const_iterator
+      it(_running_per_host.find(host_id));
+    if ((it != _running_per_host.end()) && (it->second >= per_host))
+      return false;
+  }
+  unsigned int per_command(config->max_parallel_checks_per_command());
+  if (per_command) {
+    std::unordered_map<std::string, unsigned int>::const_iterator
+      it(_running_per_command.find(command));
+    if ((it != _running_per_command.end()) && (it->second >= per_command))
+      return false;
+  }
+  return true;
+}
+
+/**
+ *  Remove all queued checks and forget running ones.
+ */
+void admission_queue::clear() {
+  _queued.clear();
+  _queue.clear();
+  _running.clear();
+  _running_per_command.clear();
+  _running_per_host.clear();
+}
+
+/**
+ *  Check if the queue is empty.
+ *
+ *  @return True if no check is waiting.
+ */
+bool admission_queue::empty() const throw () {
+  return _queue.empty();
+}
+
+/**
+ *  Notify the queue that a service check finished, freeing its slot.
+ *
+ *  @param[in] host_id     Host ID.
+ *  @param[in] service_id  Service ID.
+ */
+void admission_queue::finished(uint64_t host_id, uint64_t service_id) {
+  std::unordered_map<id, std::pair<uint64_t, std::string>, id_hash>::iterator
+    it(_running.find(id(host_id, service_id)));
+  if (it != _running.end()) {
+    std::unordered_map<uint64_t, unsigned int>::iterator
+      hst(_running_per_host.find(it->second.first));
+    if ((hst != _running_per_host.end()) && !--hst->second)
+      _running_per_host.erase(hst);
+    std::unordered_map<std::string, unsigned int>::iterator
+      cmd(_running_per_command.find(it->second.second));
+    if ((cmd != _running_per_command.end()) && !--cmd->second)
+      _running_per_command.erase(cmd);
+    _running.erase(it);
+  }
+
+  // Let the events loop release waiting checks.
+  if (!_queue.empty())
+    events::loop::wakeup();
+}
+
+/**
+ *  Get the longest time a check spent in the queue.
+ *
+ *  @return Maximum delay in seconds.
+ */
+double admission_queue::max_delay() const throw () {
+  return _max_delay;
+}
+
+/**
+ *  Remove the first check that can be run from the queue.
+ *
+ *  @param[out] e  The check.
+ *
+ *  @return True if a check was removed, false if none can run now.
+ */
+bool admission_queue::pop(entry& e) {
+  if (_queue.empty() || !_global_slot_free())
+    return false;
+  for (entry_list::iterator it(_queue.begin()), end(_queue.end());
+       it != end;
+       ++it)
+    if (can_run(it->host_id, it->command)) {
+      double delay(std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - it->queued).count());
+      ++_admitted;
+      _delay_sum += delay;
+      if (delay > _max_delay)
+        _max_delay = delay;
+      e = *it;
+      _queued.erase(id(it->host_id, it->service_id));
+      _queue.erase(it);
+      return true;
+    }
+  return false;
+}
+
+/**
+ *  Queue a service check. If the service is already queued, check
+ *  options are merged and the check keeps its place.
+ *
+ *  @param[in] e  The check.
+ *
+ *  @return True if the check was queued, false if it was merged.
+ */
+bool admission_queue::push(entry const& e) {
+  id key(e.host_id, e.service_id);
+  std::unordered_map<id, entry_list::iterator, id_hash>::iterator
+    it(_queued.find(key));
+  if (it != _queued.end()) {
+    it->second->check_options |= e.check_options;
+    return false;
+  }
+  _queued[key] = _queue.insert(_queue.end(), e);
+  return true;
+}
+
+/**
+ *  Get the number of queued checks.
+ *
+ *  @return Number of checks waiting for a slot.
+ */
+size_t admission_queue::size() const throw () {
+  return _queue.size();
+}
+
+/**
+ *  Notify the queue that a service check started.
+ *
+ *  @param[in] host_id     Host ID.
+ *  @param[in] service_id  Service ID.
+ *  @param[in] command     Check command name.
+ */
+void admission_queue::started(
+       uint64_t host_id,
+       uint64_t service_id,
+       std::string const& command) {
+  std::pair<uint64_t, std::string>& running(
+    _running[id(host_id, service_id)]);
+  if (!running.second.empty())
+    return ;
+  running.first = host_id;
+  running.second = command;
+  ++_running_per_host[host_id];
+  ++_running_per_command[command];
+}
+
+/**
+ *  Hash a service ID.
+ *
+ *  @param[in] i  Host and service IDs.
+ *
+ *  @return Hash value.
+ */
+size_t admission_queue::id_hash::operator()(id const& i) const throw () {
+  size_t h(std::hash<uint64_t>()(i.first));
+  return (h ^ (std::hash<uint64_t>()(i.second)
+               + 0x9e3779b9 + (h << 6) + (h >> 2)));
+}
+
+/**
+ *  Check if the global limit of parallel service checks is reached.
+ *
+ *  @return True if a service check can be started.
+ */
+bool admission_queue::_global_slot_free() const {
+  return (!config->max_parallel_service_checks()
+          || (currently_running_service_checks
+              < config->max_parallel_service_checks()));
+}
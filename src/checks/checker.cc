@@ -23,14 +23,17 @@
 #include <cstring>
 #include <sstream>
 #include <sys/time.h>
-#include "com/centreon/concurrency/locker.hh"
 #include "com/centreon/exceptions/interruption.hh"
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/host_cache.hh"
 #include "com/centreon/engine/checks/viability_failure.hh"
 #include "com/centreon/engine/commands/command.hh"
 #include "com/centreon/engine/error.hh"
+#include "com/centreon/engine/events/load_leveler.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/events/monotonic_clock.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/neberrors.hh"
@@ -52,6 +55,15 @@ static checker* _instance = nullptr;
 *                                     *
 **************************************/
 
+/**
+ *  Get the queue of service checks waiting for an execution slot.
+ *
+ *  @return The admission queue.
+ */
+admission_queue& checker::admission() throw () {
+  return _admission;
+}
+
 /**
  *  Get instance of the checker singleton.
  *
@@ -76,8 +88,7 @@ void checker::load() {
  *  @param[in] result The check_result to process later.
  */
 void checker::push_check_result(check_result&& result) {
-  concurrency::locker lock(&_mut_reap);
-  _to_reap.push(result);
+  _queue_result(std::move(result));
 }
 
 /**
@@ -86,9 +97,7 @@ void checker::push_check_result(check_result&& result) {
  *  @param[in] result The check_result to process later.
  */
 void checker::push_check_result(check_result const* result) {
-  check_result res{*result};
-  concurrency::locker lock(&_mut_reap);
-  _to_reap.push(res);
+  _queue_result(check_result(*result));
 }
 
 /**
@@ -100,80 +109,69 @@ void checker::reap() {
   logger(dbg_checks, basic)
     << "Starting to reap check results.";
 
-  // Time to start reaping.
+  // Time to start reaping. With a budget, reaping is limited in
+  // microseconds on the monotonic clock and host results are reaped
+  // first, otherwise in whole seconds of wall clock.
   time_t reaper_start_time;
   time(&reaper_start_time);
-
-  if (config->use_check_result_path()) {
-    std::string const& path(config->check_result_path());
-    check_result::process_check_result_queue(path);
+  int64_t reaper_start_us(events::monotonic_clock::now_us());
+  unsigned int budget(config->check_reaper_budget());
+
+  // Result files are read by the spool watcher if the spool directory
+  // can be watched, otherwise the directory is polled.
+  if (config->use_check_result_path()
+      && config->watch_check_result_path()
+      && _spool.watch(
+           config->check_result_path(),
+           config->max_check_result_file_age())) {
+    std::list<spool_watcher::record> records;
+    _spool.take(records);
+    for (std::list<spool_watcher::record>::iterator
+           it(records.begin()),
+           end(records.end());
+         it != end;
+         ++it)
+      if (spool_watcher::resolve(*it))
+        _queue_result(std::move(it->result));
+  }
+  else {
+    _spool.stop();
+    if (config->use_check_result_path()) {
+      std::string const& path(config->check_result_path());
+      check_result::process_check_result_queue(path);
+    }
   }
 
   // Keep compatibility with old check result list.
   if (!check_result::results.empty()) {
-    concurrency::locker lock(&_mut_reap);
-    check_result* cr(nullptr);
     for (check_result_list::iterator
            it(check_result::results.begin()),
            end(check_result::results.end());
          it != end;
-         ++it) {
-      _to_reap.push(*it);
-      delete cr;
-    }
+         ++it)
+      _queue_result(std::move(*it));
+    check_result::results.clear();
   }
 
+  // Results can be prepared by worker threads.
+  _workers.resize(config->check_result_workers());
+
   // Reap check results.
   unsigned int reaped_checks(0);
-  { // Scope to release mutex in all termination cases.
-    concurrency::locker lock(&_mut_reap);
-
-    // Merge partial check results.
-    while (!_to_reap_partial.empty()) {
-      // Find the two parts.
-      std::unordered_map<uint64_t, check_result>::iterator
-        it_partial(_to_reap_partial.begin());
-      std::unordered_map<uint64_t, check_result>::iterator
-        it_id(_list_id.find(it_partial->first));
-      if (_list_id.end() == it_id) {
-        logger(log_runtime_warning, basic)
-          << "command ID '" << it_partial->first << "' not found";
-      }
-      else {
-        // Extract base part.
-        logger(dbg_checks, basic)
-          << "command ID (" << it_partial->first << ") executed";
-        check_result result{std::move(it_id->second)};
-        _list_id.erase(it_id);
-
-        // Merge check result.
-        result.set_finish_time(it_partial->second.get_finish_time());
-        result.set_early_timeout(it_partial->second.get_early_timeout());
-        result.set_return_code(it_partial->second.get_return_code());
-        result.set_exited_ok(it_partial->second.get_exited_ok());
-        result.set_output(it_partial->second.get_output());
-
-        // Push back in reap list.
-        _to_reap.push(result);
-      }
-      _to_reap_partial.erase(it_partial);
-    }
-
-    // Process check results.
-    while (!_to_reap.empty()) {
+  {
+    check_result result;
+    while (_next_result(result, budget)) {
       // Get result host or service check.
       logger(dbg_checks, basic)
         << "Found a check result (#" << ++reaped_checks
         << ") to handle...";
-      check_result result(_to_reap.front());
-      _to_reap.pop();
-      lock.unlock();
 
       // Service check result.
       if (service_check == result.get_object_check_type()) {
         service_id_map::iterator it = service::services_by_id.find(
             {result.get_host_id(), result.get_service_id()});
         if (it == service::services_by_id.end()) {
+          _admission.finished(result.get_host_id(), result.get_service_id());
           logger(log_runtime_error, basic)
               << "Warning: Check result queue contained results for service "
               << result.get_host_id() << "/" << result.get_service_id()
@@ -222,15 +220,27 @@ void checker::reap() {
         }
       }
 
-      // Check if reaping has timed out.
-      time_t current_time;
-      time(&current_time);
-      if ((current_time - reaper_start_time)
-          > static_cast<time_t>(config->max_check_reaper_time())) {
-        logger(dbg_checks, basic)
-          << "Breaking out of check result reaper: "
-          << "max reaper time exceeded";
-        break;
+      // Check if reaping has timed out. The events loop will run due
+      // events before reaping the next slice.
+      if (budget) {
+        if (events::monotonic_clock::now_us() - reaper_start_us
+            >= static_cast<int64_t>(budget)) {
+          logger(dbg_checks, basic)
+            << "Breaking out of check result reaper: "
+            << "reaper budget exhausted";
+          break;
+        }
+      }
+      else {
+        time_t current_time;
+        time(&current_time);
+        if ((current_time - reaper_start_time)
+            > static_cast<time_t>(config->max_check_reaper_time())) {
+          logger(dbg_checks, basic)
+            << "Breaking out of check result reaper: "
+            << "max reaper time exceeded";
+          break;
+        }
       }
 
       // Caught signal, need to break.
@@ -239,25 +249,44 @@ void checker::reap() {
           << "Breaking out of check result reaper: signal encountered";
         break;
       }
-
-      // Mutex needed to access list.
-      lock.relock();
     }
   }
 
   // Reaping finished.
+  _reaped_results += reaped_checks;
+  _reap_time += events::monotonic_clock::now_us() - reaper_start_us;
   logger(dbg_checks, basic)
     << "Finished reaping " << reaped_checks << " check results";
 }
 
+/**
+ *  Get the rate at which results are reaped, that is the number of
+ *  results handled per second spent in the reaper.
+ *
+ *  @return Results per second, 0 if nothing was reaped yet.
+ */
+double checker::reap_rate() const throw () {
+  return (_reap_time > 0)
+         ? _reaped_results * 1000000.0 / _reap_time
+         : 0.0;
+}
+
+/**
+ *  Get the number of results waiting to be reaped.
+ *
+ *  @return Number of results.
+ */
+size_t checker::reaper_backlog() const throw () {
+  return _to_reap.size() + _reaped.size() + _reaped_hosts.size();
+}
+
 /**
  *  Check if the reaper queue is empty.
  *
  *  @return True if the reper queue is empty, otherwise false.
  */
 bool checker::reaper_is_empty() {
-  concurrency::locker lock(&_mut_reap);
-  return _to_reap.empty();
+  return _to_reap.empty() && _reaped.empty() && _reaped_hosts.empty();
 }
 
 /**
@@ -472,7 +501,7 @@ void checker::run(host* hst,
                               macros,
                               config->host_check_timeout()));
       if (id != 0)
-        _list_id[id] = check_result_info;
+        _list_id[id] = std::move(check_result_info);
     }
     catch (com::centreon::exceptions::interruption const& e) {
       (void)e;
@@ -492,8 +521,7 @@ void checker::run(host* hst,
       check_result_info.set_output("(Execute command failed)");
 
       // Queue check result.
-      concurrency::locker lock(&_mut_reap);
-      _to_reap.push(check_result_info);
+      _queue_result(std::move(check_result_info));
 
       logger(log_runtime_warning, basic)
         << "Error: Host check command execution failed: " << e.what();
@@ -627,6 +655,10 @@ void checker::run(
 
   // Update the number of running service checks.
   ++currently_running_service_checks;
+  _admission.started(
+    svc->get_host_id(),
+    svc->get_service_id(),
+    svc->get_check_command_ptr()->get_name());
 
   // Set the execution flag.
   svc->set_is_executing(true);
@@ -700,7 +732,7 @@ void checker::run(
                               macros,
                               config->service_check_timeout()));
       if (id != 0)
-        _list_id[id] = check_result_info;
+        _list_id[id] = std::move(check_result_info);
     }
     catch (com::centreon::exceptions::interruption const& e) {
       (void)e;
@@ -722,8 +754,7 @@ void checker::run(
       check_result_info.set_output("(Execute command failed)");
 
       // Queue check result.
-      concurrency::locker lock(&_mut_reap);
-      _to_reap.push(check_result_info);
+      _queue_result(std::move(check_result_info));
 
       logger(log_runtime_warning, basic)
         << "Error: Service check command execution failed: " << e.what();
@@ -785,10 +816,10 @@ void checker::run_sync(
   if (use_cached_result
       && !(check_options & CHECK_OPTION_FORCE_EXECUTION)) {
     // We can used the cached result, so return it and get out of here.
-    if (hst->get_has_been_checked()
-        && (static_cast<unsigned long>(
-              start_time.tv_sec - hst->get_last_check())
-            <= check_timestamp_horizon)) {
+    if (host_cache::instance().lookup(
+          *hst,
+          start_time.tv_sec,
+          check_timestamp_horizon)) {
       if (check_result_code)
         *check_result_code = hst->get_current_state();
       logger(dbg_checks, more)
@@ -929,22 +960,14 @@ void checker::unload() {
  *  Default constructor.
  */
 checker::checker()
-  : commands::command_listener() {
-
-}
+  : commands::command_listener(),
+    _reap_time(0),
+    _reaped_results(0) {}
 
 /**
  *  Default destructor.
  */
-checker::~checker() throw () {
-  try {
-    concurrency::locker lock(&_mut_reap);
-    while (!_to_reap.empty()) {
-      _to_reap.pop();
-    }
-  }
-  catch (...) {}
-}
+checker::~checker() throw () {}
 
 /**
  *  Slot to catch the result of the execution and add to the reap queue.
@@ -970,9 +993,106 @@ void checker::finished(commands::result const& res) throw () {
                       || (res.exit_status == process::timeout));
   result.set_output(res.output);
 
-  // Queue check result.
-  concurrency::locker lock(&_mut_reap);
-  _to_reap_partial[res.command_id] = result;
+  // Queue check result, it will be merged with its base part by the
+  // reaper.
+  try {
+    _queue_result(std::move(result), res.command_id);
+  }
+  catch (...) {}
+}
+
+/**
+ *  Get the next result to handle, from the current batch if any. When
+ *  this batch is empty and worker threads are enabled or host results
+ *  go first, a new batch is popped from the reaper queue. Its host
+ *  results are set apart to be handled first, then the batch is
+ *  prepared by worker threads.
+ *
+ *  @param[out] result       Next result.
+ *  @param[in]  hosts_first  True to handle host results of a batch
+ *                           before its service results.
+ *
+ *  @return True if a result was available.
+ */
+bool checker::_next_result(check_result& result, bool hosts_first) {
+  if (_reaped.empty() && _reaped_hosts.empty()
+      && (hosts_first || _workers.size())) {
+    size_t batch_size((_workers.size() ? _workers.size() : 1) * 256);
+    check_result popped;
+    while ((_reaped.size() + _reaped_hosts.size() < batch_size)
+           && _pop_result(popped)) {
+      if (hosts_first && (popped.get_object_check_type() == host_check))
+        _reaped_hosts.push_back(std::move(popped));
+      else
+        _reaped.push_back(std::move(popped));
+    }
+    if (_workers.size()) {
+      if (!_reaped_hosts.empty())
+        _workers.prepare(_reaped_hosts);
+      if (!_reaped.empty())
+        _workers.prepare(_reaped);
+    }
+  }
+  std::deque<check_result>&
+    batch(_reaped_hosts.empty() ? _reaped : _reaped_hosts);
+  if (!batch.empty()) {
+    result = std::move(batch.front());
+    batch.pop_front();
+    return true;
+  }
+  return _pop_result(result);
+}
+
+/**
+ *  Pop the next complete result from the reaper queue. The execution
+ *  part of results is merged with its base part, both being only
+ *  handled by the events loop thread no lock is needed.
+ *
+ *  @param[out] result  Next result.
+ *
+ *  @return True if a result was available.
+ */
+bool checker::_pop_result(check_result& result) {
+  reaper_queue::entry e;
+  while (_to_reap.pop(e)) {
+    if (e.command_id) {
+      std::unordered_map<uint64_t, check_result>::iterator
+        it_id(_list_id.find(e.command_id));
+      if (_list_id.end() == it_id) {
+        logger(log_runtime_warning, basic)
+          << "command ID '" << e.command_id << "' not found";
+        continue ;
+      }
+      logger(dbg_checks, basic)
+        << "command ID (" << e.command_id << ") executed";
+      check_result const& base(it_id->second);
+      e.result.set_object_check_type(base.get_object_check_type());
+      e.result.set_host_id(base.get_host_id());
+      e.result.set_service_id(base.get_service_id());
+      e.result.set_check_type(base.get_check_type());
+      e.result.set_check_options(base.get_check_options());
+      e.result.set_reschedule_check(base.get_reschedule_check());
+      e.result.set_latency(base.get_latency());
+      e.result.set_start_time(base.get_start_time());
+      _list_id.erase(it_id);
+    }
+    result = std::move(e.result);
+    return true;
+  }
+  return false;
+}
+
+/**
+ *  Queue a result and wake the events loop up if the reaper queue
+ *  was empty, results already queued having done it.
+ *
+ *  @param[in] result      Result to queue.
+ *  @param[in] command_id  ID of the command that produced a partial
+ *                         result, 0 for a complete result.
+ */
+void checker::_queue_result(check_result&& result, uint64_t command_id) {
+  if (_to_reap.push(std::move(result), command_id))
+    events::loop::wakeup(events::loop::wakeup_check_result);
 }
 
 /**
@@ -1183,6 +1303,7 @@ com::centreon::engine::host::host_state checker::_execute_sync(host* hst) {
   // Update values.
   hst->set_execution_time(execution_time);
   hst->set_check_type(checkable::check_active);
+  events::load_leveler::instance().learn(hst, execution_time);
 
   // Get plugin output.
   std::string pl_output;
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/checks/host_cache.hh"
+#include "com/centreon/engine/host.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::checks;
+
+/**
+ *  Default constructor.
+ */
+host_cache::host_cache() : _hits(0), _misses(0) {}
+
+/**
+ *  Destructor.
+ */
+host_cache::~host_cache() throw () {}
+
+/**
+ *  Forget horizons and invalidations of all hosts.
+ */
+void host_cache::clear() {
+  _entries.clear();
+}
+
+/**
+ *  Forget the horizon and invalidation of a host.
+ *
+ *  @param[in] host_id  Host ID.
+ */
+void host_cache::forget(uint64_t host_id) {
+  _entries.erase(host_id);
+}
+
+/**
+ *  Get the number of lookups that reused the state of a host.
+ *
+ *  @return Number of hits.
+ */
+uint64_t host_cache::hits() const throw () {
+  return _hits;
+}
+
+/**
+ *  Get the horizon used for a host.
+ *
+ *  @param[in] hst              Host.
+ *  @param[in] default_horizon  Horizon requested by the caller.
+ *
+ *  @return Horizon of the host in seconds if it has one, otherwise
+ *          default_horizon.
+ */
+unsigned long host_cache::horizon(
+                host const& hst,
+                unsigned long default_horizon) const {
+  std::unordered_map<uint64_t, entry>::const_iterator
+    it(_entries.find(hst.get_host_id()));
+  if (it != _entries.end() && it->second.has_horizon)
+    return it->second.horizon;
+  return default_horizon;
+}
+
+/**
+ *  Get the host cache.
+ *
+ *  @return Singleton instance.
+ */
+host_cache& host_cache::instance() {
+  static host_cache instance;
+  return instance;
+}
+
+/**
+ *  Invalidate the cached state of hosts whose state was determined from
+ *  the state of a host: its children and the hosts depending on it.
+ *
+ *  @param[in] hst   Host that changed state.
+ *  @param[in] when  Time of the state change.
+ */
+void host_cache::invalidate_dependents(host const& hst, time_t when) {
+  for (host_map_unsafe::const_iterator
+         it(hst.child_hosts.begin()),
+         end(hst.child_hosts.end());
+       it != end;
+       ++it)
+    _invalidate(it->second, when);
+
+  for (host_map_unsafe::const_iterator
+         it(hst.dependent_hosts.begin()),
+         end(hst.dependent_hosts.end());
+       it != end;
+       ++it)
+    _invalidate(it->second, when);
+}
+
+/**
+ *  Check if the state of a host can be reused, without counting it.
+ *
+ *  @param[in] hst      Host.
+ *  @param[in] now      Current time.
+ *  @param[in] horizon  Horizon requested by the caller, in seconds.
+ *
+ *  @return True if the host was checked within its horizon and since
+ *          its last invalidation.
+ */
+bool host_cache::is_fresh(
+                   host const& hst,
+                   time_t now,
+                   unsigned long horizon) const {
+  if (!hst.get_has_been_checked())
+    return false;
+
+  std::unordered_map<uint64_t, entry>::const_iterator
+    it(_entries.find(hst.get_host_id()));
+  if (it != _entries.end()) {
+    if (it->second.has_horizon)
+      horizon = it->second.horizon;
+    if (it->second.valid_since
+        && hst.get_last_check() <= it->second.valid_since)
+      return false;
+  }
+  return static_cast<unsigned long>(now - hst.get_last_check()) <= horizon;
+}
+
+/**
+ *  Check if the state of a host can be reused instead of checking it.
+ *
+ *  @param[in] hst      Host.
+ *  @param[in] now      Current time.
+ *  @param[in] horizon  Horizon requested by the caller, in seconds.
+ *
+ *  @return True if the state of the host can be reused.
+ */
+bool host_cache::lookup(
+                   host const& hst,
+                   time_t now,
+                   unsigned long horizon) {
+  if (is_fresh(hst, now, horizon)) {
+    ++_hits;
+    return true;
+  }
+  ++_misses;
+  return false;
+}
+
+/**
+ *  Get the number of lookups that required a new check of the host.
+ *
+ *  @return Number of misses.
+ */
+uint64_t host_cache::misses() const throw () {
+  return _misses;
+}
+
+/**
+ *  Reset hit and miss counters.
+ */
+void host_cache::reset_stats() throw () {
+  _hits = 0;
+  _misses = 0;
+}
+
+/**
+ *  Set the horizon of a host.
+ *
+ *  @param[in] host_id  Host ID.
+ *  @param[in] horizon  Horizon in seconds.
+ */
+void host_cache::set_horizon(uint64_t host_id, unsigned long horizon) {
+  entry& e(_entries[host_id]);
+  e.has_horizon = true;
+  e.horizon = horizon;
+}
+
+/**
+ *  Use the horizon requested by callers for a host.
+ *
+ *  @param[in] host_id  Host ID.
+ */
+void host_cache::unset_horizon(uint64_t host_id) {
+  std::unordered_map<uint64_t, entry>::iterator
+    it(_entries.find(host_id));
+  if (it != _entries.end())
+    it->second.has_horizon = false;
+}
+
+/**
+ *  Default constructor.
+ */
+host_cache::entry::entry()
+  : has_horizon(false), horizon(0), valid_since(0) {}
+
+/**
+ *  Invalidate the cached state of a host.
+ *
+ *  @param[in] hst   Host, can be null.
+ *  @param[in] when  Time from which the state of the host must have
+ *                   been checked again.
+ */
+void host_cache::_invalidate(host const* hst, time_t when) {
+  if (hst)
+    _entries[hst->get_host_id()].valid_since = when;
+}
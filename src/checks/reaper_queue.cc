@@ -0,0 +1,110 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <utility>
+#include "com/centreon/engine/checks/reaper_queue.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::checks;
+
+/**
+ *  Default constructor.
+ */
+reaper_queue::reaper_queue() : _size(0) {
+  _tail = new node;
+  _tail->next.store(nullptr, std::memory_order_relaxed);
+  _tail->value.command_id = 0;
+  _head.store(_tail, std::memory_order_relaxed);
+}
+
+/**
+ *  Destructor. Results still queued are dropped.
+ */
+reaper_queue::~reaper_queue() throw () {
+  while (_tail) {
+    node* next(_tail->next.load(std::memory_order_relaxed));
+    delete _tail;
+    _tail = next;
+  }
+}
+
+/**
+ *  Check if the queue is empty.
+ *
+ *  @return True if no result is queued.
+ */
+bool reaper_queue::empty() const throw () {
+  return !size();
+}
+
+/**
+ *  Pop the oldest result. Only the consumer thread can call it.
+ *
+ *  A producer may have reserved its place without having linked its
+ *  node yet, in which case false is returned while size() is not 0.
+ *  The consumer just has to try again later.
+ *
+ *  @param[out] e  Oldest result.
+ *
+ *  @return True if a result was popped.
+ */
+bool reaper_queue::pop(entry& e) {
+  node* next(_tail->next.load(std::memory_order_acquire));
+  if (!next)
+    return false;
+  e.command_id = next->value.command_id;
+  e.result = std::move(next->value.result);
+  delete _tail;
+  _tail = next;
+  _size.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ *  Push a result. Any thread can call it.
+ *
+ *  @param[in] result      Result, moved into the queue.
+ *  @param[in] command_id  ID of the command that produced a partial
+ *                         result, 0 for a complete one.
+ *
+ *  @return True if the queue was empty, the consumer should then be
+ *          woken up.
+ */
+bool reaper_queue::push(check_result&& result, uint64_t command_id) {
+  node* n(new node);
+  n->next.store(nullptr, std::memory_order_relaxed);
+  n->value.command_id = command_id;
+  n->value.result = std::move(result);
+
+  // Account the node before linking it, size() is never less than
+  // the number of poppable results.
+  bool was_empty(!_size.fetch_add(1, std::memory_order_relaxed));
+  node* prev(_head.exchange(n, std::memory_order_acq_rel));
+  prev->next.store(n, std::memory_order_release);
+  return was_empty;
+}
+
+/**
+ *  Get the number of queued results.
+ *
+ *  @return Number of results, including those being pushed.
+ */
+size_t reaper_queue::size() const throw () {
+  return _size.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/checks/result_workers.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/service.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::checks;
+
+/**
+ *  Default constructor. The pool has no thread.
+ */
+result_workers::result_workers()
+  : _batch(nullptr), _generation(0), _pending(0), _quit(false) {}
+
+/**
+ *  Destructor.
+ */
+result_workers::~result_workers() throw () {
+  _stop();
+}
+
+/**
+ *  Prepare a batch of results and wait for the end of the work. Without
+ *  thread, results are prepared by the calling thread.
+ *
+ *  @param[in,out] results  Results to prepare.
+ */
+void result_workers::prepare(std::deque<check_result>& results) {
+  if (_threads.empty()) {
+    for (std::deque<check_result>::iterator
+           it(results.begin()),
+           end(results.end());
+         it != end;
+         ++it)
+      it->parse_output();
+    return ;
+  }
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _batch = &results;
+  _pending = _threads.size();
+  ++_generation;
+  _cv_work.notify_all();
+  _cv_done.wait(lock, [this]() { return !_pending; });
+  _batch = nullptr;
+}
+
+/**
+ *  Set the number of threads of the pool. Must not be called while a
+ *  batch is prepared.
+ *
+ *  @param[in] count  Number of threads, 0 to prepare results serially.
+ */
+void result_workers::resize(unsigned int count) {
+  if (count == _threads.size())
+    return ;
+  _stop();
+  for (unsigned int i(0); i < count; ++i)
+    _threads.push_back(std::thread(&result_workers::_work, this, i));
+}
+
+/**
+ *  Get the number of threads of the pool.
+ *
+ *  @return Number of threads.
+ */
+unsigned int result_workers::size() const throw () {
+  return _threads.size();
+}
+
+/**
+ *  Prepare the flap detection of the objects of a result. The host of
+ *  a service is prepared too, its flapping being checked along. Objects
+ *  of a shard are only modified by its thread, while the events loop
+ *  waits for the end of the batch.
+ *
+ *  @param[in] result  Check result.
+ */
+void result_workers::_prepare_flapping(check_result const& result) {
+  host_id_map::const_iterator
+    hst(host::hosts_by_id.find(result.get_host_id()));
+  if (hst != host::hosts_by_id.end() && hst->second)
+    hst->second->prepare_flapping();
+  if (result.get_object_check_type() == service_check) {
+    service_id_map::const_iterator
+      svc(service::services_by_id.find(
+            std::make_pair(result.get_host_id(), result.get_service_id())));
+    if (svc != service::services_by_id.end() && svc->second)
+      svc->second->prepare_flapping();
+  }
+}
+
+/**
+ *  Stop and join all threads.
+ */
+void result_workers::_stop() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _quit = true;
+  }
+  _cv_work.notify_all();
+  for (std::vector<std::thread>::iterator
+         it(_threads.begin()),
+         end(_threads.end());
+       it != end;
+       ++it)
+    it->join();
+  _threads.clear();
+  _quit = false;
+}
+
+/**
+ *  Thread body: prepare the results of hosts of a shard for each
+ *  batch.
+ *
+ *  @param[in] shard  Shard of this thread.
+ */
+void result_workers::_work(unsigned int shard) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  uint64_t generation(_generation);
+  for (;;) {
+    _cv_work.wait(lock, [this, generation]() {
+      return _quit || (_generation != generation);
+    });
+    if (_quit)
+      break ;
+    generation = _generation;
+    std::deque<check_result>& results(*_batch);
+    unsigned int shards(_threads.size());
+    lock.unlock();
+
+    for (std::deque<check_result>::iterator
+           it(results.begin()),
+           end(results.end());
+         it != end;
+         ++it)
+      if (it->get_host_id() % shards == shard) {
+        // Results that could not be parsed here will be parsed by the
+        // events loop.
+        try {
+          it->parse_output();
+        }
+        catch (...) {}
+        _prepare_flapping(*it);
+      }
+
+    lock.lock();
+    if (!--_pending)
+      _cv_done.notify_one();
+  }
+}
@@ -0,0 +1,468 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "com/centreon/engine/checks/spool_watcher.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/service.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::checks;
+using namespace com::centreon::engine::logging;
+
+/**
+ *  Check if a file name is the one of a check result file.
+ *
+ *  @param[in] name  File name.
+ *  @param[in] len   Length of the name.
+ *
+ *  @return True for check result files (cXXXXXX).
+ */
+static bool is_result_file(char const* name, size_t len) {
+  return len == 7 && name[0] == 'c';
+}
+
+/**
+ *  Get the next line of a check result file. A line ending with a
+ *  backslash goes on with the next line, without its leading blanks. A
+ *  line ending with two backslashes ends with one backslash.
+ *
+ *  @param[in,out] pos   Current position, moved after the line.
+ *  @param[in]     end   End of data.
+ *  @param[out]    line  Line, without end of line characters.
+ *
+ *  @return False at the end of data.
+ */
+static bool next_line(
+              char const*& pos,
+              char const* end,
+              std::string& line) {
+  if (pos >= end)
+    return false;
+  line.clear();
+  bool continued(false);
+  while (pos < end) {
+    char const* start(pos);
+    if (continued)
+      while (start < end && (*start == ' ' || *start == '\t'))
+        ++start;
+    char const* eol(static_cast<char const*>(
+                      memchr(start, '\n', end - start)));
+    char const* stop(eol ? eol : end);
+    pos = eol ? eol + 1 : end;
+    if (eol && stop > start && stop[-1] == '\r')
+      --stop;
+    line.append(start, stop);
+
+    size_t len(line.size());
+    if (len >= 2 && line[len - 1] == '\\' && line[len - 2] == '\\') {
+      line.resize(len - 1);
+      break;
+    }
+    else if (len && line[len - 1] == '\\') {
+      line.resize(len - 1);
+      continued = true;
+    }
+    else
+      break;
+  }
+  return true;
+}
+
+/**
+ *  Parse a "seconds.microseconds" time.
+ *
+ *  @param[in]  value  Value.
+ *  @param[out] tv     Parsed time.
+ *
+ *  @return False if the value is not a valid time.
+ */
+static bool parse_time(char const* value, timeval& tv) {
+  char const* dot(strchr(value, '.'));
+  if (!dot || dot == value || !dot[1])
+    return false;
+  tv.tv_sec = strtoul(value, nullptr, 0);
+  tv.tv_usec = strtoul(dot + 1, nullptr, 0);
+  return true;
+}
+
+/**
+ *  Default constructor.
+ */
+spool_watcher::spool_watcher()
+  : _failed(false), _inotify_fd(-1), _max_file_age(0) {
+  _wake_fds[0] = -1;
+  _wake_fds[1] = -1;
+}
+
+/**
+ *  Destructor.
+ */
+spool_watcher::~spool_watcher() throw () {
+  stop();
+}
+
+/**
+ *  Parse the content of a check result file. Results are separated by
+ *  empty lines, results without host name or output are discarded.
+ *
+ *  @param[in]  data          File content.
+ *  @param[in]  size          Content size.
+ *  @param[in]  now           Current time.
+ *  @param[in]  max_file_age  Results of files whose file_time is older
+ *                            than this (in seconds) are discarded, 0
+ *                            to keep them all.
+ *  @param[out] records       Parsed results are appended here.
+ */
+void spool_watcher::parse(
+                      char const* data,
+                      size_t size,
+                      time_t now,
+                      unsigned long max_file_age,
+                      std::list<record>& records) {
+  char const* pos(data);
+  char const* end(data + size);
+  std::string line;
+  record current;
+  while (true) {
+    bool more(next_line(pos, end, line));
+
+    // An empty line (or the end of file) ends a result.
+    if (!more || line.empty()) {
+      if (!current.host_name.empty()
+          && !current.result.get_output().empty())
+        records.push_back(std::move(current));
+      current = record();
+      if (!more)
+        break;
+      continue;
+    }
+
+    // Skip comments.
+    if (line[0] == '#')
+      continue;
+
+    size_t eq(line.find('='));
+    if (eq == std::string::npos || eq + 1 == line.size())
+      continue;
+    line[eq] = '\0';
+    char const* var(line.c_str());
+    char const* val(var + eq + 1);
+
+    // If the file is too old, ignore the rest of it.
+    if (!strcmp(var, "file_time") && max_file_age > 0) {
+      unsigned long diff(now - strtoul(val, nullptr, 0));
+      if (diff > max_file_age)
+        break;
+    }
+    else if (!strcmp(var, "host_name"))
+      current.host_name = val;
+    else if (!strcmp(var, "service_description")) {
+      current.service_description = val;
+      current.result.set_object_check_type(service_check);
+    }
+    else if (!strcmp(var, "check_type"))
+      current.result.set_check_type(
+        static_cast<enum checkable::check_type>(strtol(val, nullptr, 0)));
+    else if (!strcmp(var, "check_options"))
+      current.result.set_check_options(strtol(val, nullptr, 0));
+    else if (!strcmp(var, "reschedule_check"))
+      current.result.set_reschedule_check(strtol(val, nullptr, 0));
+    else if (!strcmp(var, "latency"))
+      current.result.set_latency(strtod(val, nullptr));
+    else if (!strcmp(var, "start_time")) {
+      timeval tv;
+      if (parse_time(val, tv))
+        current.result.set_start_time(tv);
+    }
+    else if (!strcmp(var, "finish_time")) {
+      timeval tv;
+      if (parse_time(val, tv))
+        current.result.set_finish_time(tv);
+    }
+    else if (!strcmp(var, "early_timeout"))
+      current.result.set_early_timeout(strtol(val, nullptr, 0));
+    else if (!strcmp(var, "exited_ok"))
+      current.result.set_exited_ok(strtol(val, nullptr, 0));
+    else if (!strcmp(var, "return_code"))
+      current.result.set_return_code(strtol(val, nullptr, 0));
+    else if (!strcmp(var, "output"))
+      current.result.set_output(std::string(val));
+  }
+}
+
+/**
+ *  Read and parse a check result file with a single read.
+ *
+ *  @param[in]  path          File path.
+ *  @param[in]  now           Current time.
+ *  @param[in]  max_file_age  See parse().
+ *  @param[out] records       Parsed results are appended here.
+ *
+ *  @return False if the file could not be read.
+ */
+bool spool_watcher::read_file(
+                      std::string const& path,
+                      time_t now,
+                      unsigned long max_file_age,
+                      std::list<record>& records) {
+  int fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return false;
+  }
+
+  std::string content(static_cast<size_t>(st.st_size), '\0');
+  size_t size(0);
+  while (size < content.size()) {
+    ssize_t rb(read(fd, &content[size], content.size() - size));
+    if (rb < 0 && errno == EINTR)
+      continue;
+    if (rb <= 0)
+      break;
+    size += rb;
+  }
+  close(fd);
+
+  parse(content.data(), size, now, max_file_age, records);
+  return true;
+}
+
+/**
+ *  Resolve the host and service of a record. Must be called by the
+ *  events loop.
+ *
+ *  @param[in,out] r  Record whose result gets its host and service IDs.
+ *
+ *  @return False if the host does not exist.
+ */
+bool spool_watcher::resolve(record& r) {
+  host_map::const_iterator hst(host::hosts.find(r.host_name));
+  if (hst == host::hosts.end())
+    return false;
+  r.result.set_host_id(hst->second->get_host_id());
+
+  if (!r.service_description.empty()) {
+    service_map::const_iterator
+      svc(service::services.find({r.host_name, r.service_description}));
+    if (svc != service::services.end())
+      r.result.set_service_id(svc->second->get_service_id());
+  }
+  return true;
+}
+
+/**
+ *  Stop watching the spool directory. Results already read can still
+ *  be taken.
+ */
+void spool_watcher::stop() {
+  if (_thread.joinable()) {
+    char c(0);
+    while (write(_wake_fds[1], &c, 1) < 0 && errno == EINTR)
+      ;
+    _thread.join();
+  }
+  if (_inotify_fd >= 0) {
+    close(_inotify_fd);
+    _inotify_fd = -1;
+  }
+  for (unsigned int i(0); i < 2; ++i)
+    if (_wake_fds[i] >= 0) {
+      close(_wake_fds[i]);
+      _wake_fds[i] = -1;
+    }
+  _dir.clear();
+  _failed = false;
+}
+
+/**
+ *  Take the results read since the last call.
+ *
+ *  @param[out] records  Results are appended here.
+ */
+void spool_watcher::take(std::list<record>& records) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  records.splice(records.end(), _records);
+}
+
+/**
+ *  Watch a spool directory, or keep on watching it.
+ *
+ *  @param[in] dir           Spool directory.
+ *  @param[in] max_file_age  See parse().
+ *
+ *  @return True if the directory is watched, false if inotify could
+ *          not be used. In this case, it is not tried again until the
+ *          directory changes.
+ */
+bool spool_watcher::watch(
+                      std::string const& dir,
+                      unsigned long max_file_age) {
+  // Read by the watcher thread, which is not restarted for this.
+  _max_file_age.store(max_file_age);
+  if (dir == _dir)
+    return !_failed;
+
+  stop();
+  _dir = dir;
+  if (pipe2(_wake_fds, O_CLOEXEC | O_NONBLOCK)
+      || (_inotify_fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK)) < 0
+      || inotify_add_watch(
+           _inotify_fd,
+           dir.c_str(),
+           IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    char const* msg(strerror(errno));
+    logger(log_runtime_warning, basic)
+      << "Warning: Could not watch check result queue directory '"
+      << dir << "', it will be polled: " << msg;
+    _failed = true;
+    return false;
+  }
+
+  logger(dbg_checks, basic)
+    << "Watching check result queue directory '" << dir << "'.";
+  _thread = std::thread(&spool_watcher::_run, this);
+  return true;
+}
+
+/**
+ *  Read and remove a check result file.
+ *
+ *  @param[in]  name     Name of the file in the spool directory.
+ *  @param[out] records  Parsed results are appended here.
+ */
+void spool_watcher::_process(
+                      std::string const& name,
+                      std::list<record>& records) {
+  std::string file(_dir);
+  file.append("/").append(name);
+
+  // A file already processed has been removed.
+  if (read_file(file, time(nullptr), _max_file_age.load(), records)) {
+    remove(file.c_str());
+    remove(file.append(".ok").c_str());
+  }
+}
+
+/**
+ *  Make results available to the reaper and wake the events loop up.
+ *
+ *  @param[in,out] records  Results, moved out.
+ */
+void spool_watcher::_publish(std::list<record>& records) {
+  if (records.empty())
+    return ;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _records.splice(_records.end(), records);
+  }
+  events::loop::wakeup(events::loop::wakeup_check_result);
+}
+
+/**
+ *  Watcher thread: handle files already in the directory, then wait
+ *  for ok-to-go files. All files notified by a single read of inotify
+ *  events are published at once.
+ */
+void spool_watcher::_run() {
+  std::list<record> records;
+  _scan(records);
+  _publish(records);
+
+  pollfd fds[2];
+  fds[0].fd = _inotify_fd;
+  fds[0].events = POLLIN;
+  fds[1].fd = _wake_fds[0];
+  fds[1].events = POLLIN;
+  alignas(inotify_event) char buffer[64 * 1024];
+  while (true) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    if (fds[1].revents)
+      break;
+
+    ssize_t rb(read(_inotify_fd, buffer, sizeof(buffer)));
+    if (rb <= 0)
+      continue;
+    bool overflow(false);
+    for (char* ptr(buffer); ptr < buffer + rb;) {
+      inotify_event const* event(reinterpret_cast<inotify_event*>(ptr));
+      ptr += sizeof(*event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW)
+        overflow = true;
+      else if (event->len) {
+        // Result files are ready once their ok-to-go file is here.
+        size_t len(strlen(event->name));
+        if (len > 3
+            && !strcmp(event->name + len - 3, ".ok")
+            && is_result_file(event->name, len - 3))
+          _process(std::string(event->name, len - 3), records);
+      }
+    }
+
+    // Events were lost, look at the whole directory.
+    if (overflow)
+      _scan(records);
+    _publish(records);
+  }
+}
+
+/**
+ *  Handle all ready result files of the spool directory.
+ *
+ *  @param[out] records  Parsed results are appended here.
+ */
+void spool_watcher::_scan(std::list<record>& records) {
+  DIR* dirp(opendir(_dir.c_str()));
+  if (!dirp) {
+    logger(log_runtime_warning, basic)
+      << "Warning: Could not open check result queue directory '"
+      << _dir << "' for reading.";
+    return ;
+  }
+  dirent* entry;
+  while ((entry = readdir(dirp))) {
+    size_t len(strlen(entry->d_name));
+    if (!is_result_file(entry->d_name, len))
+      continue;
+    std::string ok(_dir);
+    ok.append("/").append(entry->d_name).append(".ok");
+    if (!access(ok.c_str(), F_OK))
+      _process(entry->d_name, records);
+  }
+  closedir(dirp);
+}
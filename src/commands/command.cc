@@ -46,7 +46,8 @@ commands::command::command(
                      command_listener* listener)
   : _command_line(command_line),
     _listener(listener),
-    _name(name) {
+    _name(name),
+    _template(command_line) {
   if (_name.empty())
     throw (engine_error()
       << "Could not create a command with an empty name");
@@ -105,6 +106,7 @@ std::string const& commands::command::get_name() const throw() {
 void commands::command::set_command_line(
                           std::string const& command_line) {
   _command_line = command_line;
+  _template.compile(command_line);
   return;
 }
 
@@ -140,6 +142,7 @@ commands::command& commands::command::operator=(commands::command const& right)
     _command_line = right._command_line;
     _listener = right._listener;
     _name = right._name;
+    _template = right._template;
   }
   return *this;
 }
@@ -153,7 +156,7 @@ commands::command& commands::command::operator=(commands::command const& right)
  */
 std::string commands::command::process_cmd(nagios_macros* macros) const {
   std::string command_line;
-  process_macros_r(macros, _command_line, command_line, 0);
+  _template.expand(macros, command_line);
   return command_line;
 }
 
@@ -36,6 +36,13 @@ using namespace com::centreon::engine::commands;
 **************************************/
 
 connector_map connector::connectors;
+thread_local bool connector::_batching(false);
+std::unordered_set<connector*> connector::_pending;
+std::mutex connector::_pending_lock;
+
+// Queued queries are written without waiting for the end of the
+// events loop iteration beyond this size.
+static size_t const _max_pending_size(64 * 1024);
 
 /**
  *  Constructor.
@@ -48,22 +55,20 @@ connector::connector(
              std::string const& connector_name,
              std::string const& connector_line,
              command_listener* listener)
-  : command(connector_name, connector_line, listener),
-    process_listener(),
-    _is_running(false),
-    _query_quit_ok(false),
-    _query_version_ok(false),
-    _process(this),
-    _restart(this),
-    _try_to_restart(true) {
-  // Disable stderr.
-  _process.enable_stream(process::err, false);
-  // Set use setpgid.
-  _process.setpgid_on_exec(config->use_setpgid());
-
+  : connector(connector_name, connector_line, listener, nullptr) {
   if (config->enable_environment_macros())
     logger(log_runtime_warning, basic)
       << "Warning: Connector does not enable environment macros";
+
+  // Start a pool of connector processes.
+  unsigned int instances(config->connector_instances());
+  if (instances > 1)
+    for (unsigned int i(0); i < instances; ++i)
+      _members.emplace_back(new connector(
+                                  connector_name,
+                                  connector_line,
+                                  nullptr,
+                                  this));
 }
 
 /**
@@ -74,20 +79,78 @@ connector::connector(
 connector::connector(connector const& right)
   : command(right),
     process_listener(right),
+    _pool(nullptr),
     _restart(this) {
   _internal_copy(right);
+  for (unsigned int i(0); i < right._members.size(); ++i)
+    _members.emplace_back(new connector(
+                                _name,
+                                _command_line,
+                                nullptr,
+                                this));
 }
 
 /**
  *  Destructor.
  */
 connector::~connector() noexcept {
+  // Close pool members.
+  _members.clear();
+  // Queued queries are written by _connector_close().
+  {
+    std::lock_guard<std::mutex> lock(_pending_lock);
+    _pending.erase(this);
+  }
   // Wait restart thread.
   _restart.wait();
   // Close connector properly.
   _connector_close();
 }
 
+/**
+ *  Constructor of a connector process.
+ *
+ *  @param[in] connector_name  The connector name.
+ *  @param[in] connector_line  The connector command line.
+ *  @param[in] listener        The listener who catch events.
+ *  @param[in] pool            The pool this connector is a member of,
+ *                             results are forwarded to its listener.
+ */
+connector::connector(
+             std::string const& connector_name,
+             std::string const& connector_line,
+             command_listener* listener,
+             connector* pool)
+  : command(connector_name, connector_line, listener),
+    process_listener(),
+    _flush_scheduled(false),
+    _is_running(false),
+    _query_quit_ok(false),
+    _query_version_ok(false),
+    _pool(pool),
+    _process(this),
+    _restart(this),
+    _try_to_restart(true) {
+  // Disable stderr.
+  _process.enable_stream(process::err, false);
+  // Set use setpgid.
+  _process.setpgid_on_exec(config->use_setpgid());
+}
+
+/**
+ *  Enable or disable batching of the execution queries sent by the
+ *  calling thread. Queries that are still queued when batching is
+ *  disabled are written.
+ *
+ *  @param[in] enable  true to queue execution queries until
+ *                     flush_queries() is called.
+ */
+void connector::batch_queries(bool enable) {
+  _batching = enable;
+  if (!enable)
+    flush_queries();
+}
+
 /**
  *  Get a pointer on a copy of the same object.
  *
@@ -97,6 +160,36 @@ com::centreon::engine::commands::command* connector::clone() const {
   return new connector(*this);
 }
 
+/**
+ *  Write the queued queries of all connectors.
+ *
+ *  Connectors are only destroyed while the configuration is applied,
+ *  this method must be called from the thread applying it or while
+ *  holding the configuration lock.
+ */
+void connector::flush_queries() {
+  std::unordered_set<connector*> pending;
+  {
+    std::lock_guard<std::mutex> lock(_pending_lock);
+    pending.swap(_pending);
+  }
+  for (std::unordered_set<connector*>::iterator
+         it(pending.begin()), end(pending.end());
+       it != end;
+       ++it) {
+    try {
+      concurrency::locker lock(&(*it)->_lock);
+      (*it)->_flush_scheduled = false;
+      (*it)->_flush_queries();
+    }
+    catch (std::exception const& e) {
+      logger(log_runtime_warning, basic)
+        << "Warning: Connector '" << (*it)->_name << "' error: "
+        << e.what();
+    }
+  }
+}
+
 /**
  *  Run a command.
  *
@@ -110,7 +203,8 @@ unsigned long connector::run(
                            std::string const& processed_cmd,
                            nagios_macros& macros,
                            unsigned int timeout) {
-  (void)macros;
+  if (!_members.empty())
+    return _least_loaded()->run(processed_cmd, macros, timeout);
 
   logger(dbg_commands, basic)
     << "connector::run: connector='" << _name
@@ -152,6 +246,7 @@ unsigned long connector::run(
           command_id,
           info->start_time,
           info->timeout);
+        _schedule_flush();
         _queries[command_id] = info;
       }
     }
@@ -180,7 +275,10 @@ void connector::run(
                   nagios_macros& macros,
                   unsigned int timeout,
                   result& res) {
-  (void)macros;
+  if (!_members.empty()) {
+    _least_loaded()->run(processed_cmd, macros, timeout, res);
+    return;
+  }
 
   logger(dbg_commands, basic)
     << "connector::run: connector='" << _name
@@ -217,6 +315,7 @@ void connector::run(
         command_id,
         info->start_time,
         info->timeout);
+      _flush_queries();
       _queries[command_id] = info;
     }
 
@@ -258,6 +357,13 @@ void connector::set_command_line(std::string const& command_line) {
       command::set_command_line(command_line);
     }
 
+    // Change command line of pool members.
+    for (std::vector<std::unique_ptr<connector> >::iterator
+           it(_members.begin()), end(_members.end());
+         it != end;
+         ++it)
+      (*it)->set_command_line(command_line);
+
     // Close connector properly.
     _connector_close();
 }
@@ -293,26 +399,17 @@ void connector::data_is_available(process& p) throw () {
     // Split outpout into queries responses.
     std::list<std::string> responses;
     {
-      std::string ending(_query_ending());
-      ending.append("\0", 1);
-
-      {
-        concurrency::locker lock(&_lock);
-        _data_available.append(data);
-        while (_data_available.size() > 0) {
-          size_t pos(_data_available.find(ending));
-          if (pos == std::string::npos)
-            break;
-          responses.push_back(_data_available.substr(0, pos));
-          _data_available.erase(0, pos + ending.size());
-        }
-      }
-
-      logger(dbg_commands, basic)
-        << "connector::data_is_available: responses.size="
-        << responses.size();
+      concurrency::locker lock(&_lock);
+      _responses.append(data);
+      std::string response;
+      while (_responses.pop(response))
+        responses.push_back(std::move(response));
     }
 
+    logger(dbg_commands, basic)
+      << "connector::data_is_available: responses.size="
+      << responses.size();
+
     // Parse queries responses.
     for (std::list<std::string>::const_iterator
            it(responses.begin()), end(responses.end());
@@ -363,7 +460,8 @@ void connector::finished(process& p) throw () {
 
     concurrency::locker lock(&_lock);
     _is_running = false;
-    _data_available.clear();
+    _pending_queries.clear();
+    _responses.clear();
 
     // The connector is stop, restart it if necessary.
     if (_try_to_restart) {
@@ -441,6 +539,7 @@ void connector::_connector_start() {
     concurrency::locker lock(&_lock);
 
     // Reset variables.
+    _pending_queries.clear();
     _query_quit_ok = false;
     _query_version_ok = false;
     _is_running = false;
@@ -493,9 +592,21 @@ void connector::_connector_start() {
         info->start_time,
         info->timeout);
     }
+    _flush_queries();
   }
 }
 
+/**
+ *  Forward a result of an asynchronous query to the listener.
+ *
+ *  @param[in] res  The result.
+ */
+void connector::_forward(result const& res) {
+  command_listener* listener(_pool ? _pool->_listener : _listener);
+  if (listener)
+    (listener->finished)(res);
+}
+
 /**
  *  Internal copy.
  *
@@ -504,16 +615,64 @@ void connector::_connector_start() {
 void connector::_internal_copy(connector const& right) {
   if (this != &right) {
     command::operator=(right);
-    _data_available.clear();
+    _flush_scheduled = false;
     _is_running = false;
+    _pending_queries.clear();
     _queries.clear();
     _query_quit_ok = false;
     _query_version_ok = false;
+    _responses.clear();
     _results.clear();
     _try_to_restart = true;
   }
 }
 
+/**
+ *  Write the queued queries to the connector. The connector lock must
+ *  be held.
+ */
+void connector::_flush_queries() {
+  if (_pending_queries.empty())
+    return;
+  std::string data;
+  data.swap(_pending_queries);
+  char const* ptr(data.data());
+  size_t remaining(data.size());
+  while (remaining) {
+    unsigned int written(_process.write(ptr, remaining));
+    ptr += written;
+    remaining -= written;
+  }
+}
+
+/**
+ *  Get the pool member with the fewest outstanding queries. Members
+ *  that failed to restart are skipped unless all of them failed.
+ *
+ *  @return Pool member.
+ */
+connector* connector::_least_loaded() {
+  connector* selected(nullptr);
+  size_t selected_load(0);
+  for (std::vector<std::unique_ptr<connector> >::iterator
+         it(_members.begin()), end(_members.end());
+       it != end;
+       ++it) {
+    size_t load;
+    {
+      concurrency::locker lock(&(*it)->_lock);
+      if (!(*it)->_is_running && !(*it)->_try_to_restart)
+        continue;
+      load = (*it)->_queries.size();
+    }
+    if (!selected || load < selected_load) {
+      selected = it->get();
+      selected_load = load;
+    }
+  }
+  return selected ? selected : _members.front().get();
+}
+
 /**
  *  Get the ending string for connector protocole.
  *
@@ -650,11 +809,9 @@ void connector::_recv_query_execute(char const* data) {
       "exit_status=" << res.exit_status << ", "
       "output='" << res.output << "'";
 
-    if (!info->waiting_result) {
+    if (!info->waiting_result)
       // Forward result to the listener.
-      if (_listener)
-        (_listener->finished)(res);
-    }
+      _forward(res);
     else {
       concurrency::locker lock(&_lock);
       // Push result into list of results.
@@ -727,7 +884,21 @@ void connector::_recv_query_version(char const* data) {
 }
 
 /**
- *  Send query execute. To ask connector to execute.
+ *  Write the queued queries now or at the end of the events loop
+ *  iteration. The connector lock must be held.
+ */
+void connector::_schedule_flush() {
+  if (!_batching || _pending_queries.size() >= _max_pending_size)
+    _flush_queries();
+  else if (!_flush_scheduled) {
+    _flush_scheduled = true;
+    std::lock_guard<std::mutex> lock(_pending_lock);
+    _pending.insert(this);
+  }
+}
+
+/**
+ *  Queue query execute. To ask connector to execute.
  *
  *  @param[in]  cmdline     The command to execute.
  *  @param[in]  command_id  The command id.
@@ -753,7 +924,7 @@ void connector::_send_query_execute(
       << start.to_seconds() << '\0'
       << cmdline << '\0'
       << _query_ending();
-  _process.write(oss.str());
+  _pending_queries.append(oss.str());
 }
 
 /**
@@ -763,8 +934,9 @@ void connector::_send_query_quit() {
   logger(dbg_commands, basic)
     << "connector::_send_query_quit";
 
-  std::string query("4\0", 2);
-  _process.write(query + _query_ending());
+  _pending_queries.append("4\0", 2);
+  _pending_queries.append(_query_ending());
+  _flush_queries();
 }
 
 /**
@@ -774,8 +946,9 @@ void connector::_send_query_version() {
   logger(dbg_commands, basic)
     << "connector::_send_query_version";
 
-  std::string query("0\0", 2);
-  _process.write(query + _query_ending());
+  _pending_queries.append("0\0", 2);
+  _pending_queries.append(_query_ending());
+  _flush_queries();
 }
 
 /**
@@ -839,11 +1012,9 @@ void connector::restart::_run() {
         "exit_status=" << res.exit_status << ", "
         "output='" << res.output << "'";
 
-      if (!info->waiting_result) {
+      if (!info->waiting_result)
         // Forward result to the listener.
-        if (_c->_listener)
-          (_c->_listener->finished)(res);
-      }
+        _c->_forward(res);
       else {
         concurrency::locker lock(&_c->_lock);
         // Push result into list of results.
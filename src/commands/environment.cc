@@ -19,6 +19,7 @@
 */
 
 #include <cstring>
+#include <functional>
 #include "com/centreon/engine/commands/environment.hh"
 #include "com/centreon/engine/error.hh"
 
@@ -48,7 +49,9 @@ environment::environment(char** env)
  *
  *  @param[in] right  The object to copy.
  */
-environment::environment(environment const& right) {
+environment::environment(environment const& right)
+  : _buffer(nullptr),
+    _env(nullptr) {
   _internal_copy(right);
 }
 
@@ -82,6 +85,7 @@ environment& environment::operator=(environment const& right) {
 bool environment::operator==(environment const& right) const throw () {
   return (_pos_buffer == right._pos_buffer
           && _pos_env == right._pos_env
+          && _fragments == right._fragments
           && !strncmp(_buffer, right._buffer, _pos_buffer));
 }
 
@@ -206,6 +210,29 @@ void environment::add(
   return;
 }
 
+/**
+ *  Add all variables of an environment fragment. Variables are not
+ *  copied, the fragment is kept alive and must not be modified.
+ *
+ *  @param[in] fragment  The environment to reference.
+ */
+void environment::add(
+                    std::shared_ptr<environment const> const& fragment) {
+  if (!fragment || !fragment->_pos_env)
+    return;
+  unsigned int new_pos(_pos_env + fragment->_pos_env);
+  if (new_pos >= _size_env)
+    _realoc_env(new_pos + EXTRA_SIZE_ENV);
+  memcpy(
+    _env + _pos_env,
+    fragment->_env,
+    sizeof(*_env) * fragment->_pos_env);
+  _pos_env = new_pos;
+  _env[_pos_env] = nullptr;
+  _fragments.push_back(fragment);
+  return;
+}
+
 /**
  *  Get environement.
  */
@@ -222,14 +249,22 @@ void environment::_internal_copy(environment const& right) {
   if (this != &right) {
     delete[] _buffer;
     delete[] _env;
-     _pos_buffer = right._pos_buffer;
-     _pos_env = right._pos_env;
-     _size_buffer = right._size_buffer;
-     _size_env = right._size_env;
-     _buffer = new char[_size_buffer];
-     _env = new char*[_size_env];
-     memcpy(_buffer, right._buffer, _pos_buffer);
-     _rebuild_env();
+    _buffer = nullptr;
+    _env = nullptr;
+    _pos_buffer = right._pos_buffer;
+    _pos_env = right._pos_env;
+    _size_buffer = right._size_buffer;
+    _size_env = right._size_env;
+    if (_size_buffer) {
+      _buffer = new char[_size_buffer];
+      memcpy(_buffer, right._buffer, _pos_buffer);
+    }
+    if (_size_env) {
+      _env = new char*[_size_env];
+      memcpy(_env, right._env, sizeof(*_env) * (_pos_env + 1));
+      _relocate(right._buffer);
+    }
+    _fragments = right._fragments;
   }
   return;
 }
@@ -248,9 +283,10 @@ void environment::_realoc_buffer(unsigned int size) {
   if (_buffer)
     memcpy(new_buffer, _buffer, _pos_buffer);
   _size_buffer = size;
-  delete[] _buffer;
+  char* old_buffer(_buffer);
   _buffer = new_buffer;
-  _rebuild_env();
+  _relocate(old_buffer);
+  delete[] old_buffer;
   return;
 }
 
@@ -274,15 +310,18 @@ void environment::_realoc_env(unsigned int size) {
 }
 
 /**
- *  Rebuild environement array.
+ *  Move the variables stored in an old buffer to the internal buffer.
+ *  Variables of fragments are left untouched.
+ *
+ *  @param[in] old_buffer  The buffer previously holding variables.
  */
-void environment::_rebuild_env() {
-  if (!_env)
+void environment::_relocate(char const* old_buffer) throw () {
+  if (!_env || !old_buffer)
     return;
-  for (unsigned int i(0), pos(0); i < _pos_env; ++i) {
-    _env[i] = _buffer + pos;
-    pos += strlen(_buffer + pos + 1) + 2;
-  }
-  _env[_pos_env] = nullptr;
+  std::less<char const*> before;
+  for (unsigned int i(0); i < _pos_env; ++i)
+    if (!before(_env[i], old_buffer)
+        && before(_env[i], old_buffer + _pos_buffer))
+      _env[i] = _buffer + (_env[i] - old_buffer);
   return;
 }
@@ -0,0 +1,340 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <sstream>
+#include "com/centreon/engine/commands/environment_cache.hh"
+#include "com/centreon/engine/contact.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/macros.hh"
+#include "com/centreon/engine/service.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+
+// Macros that only depend on the configuration of their object.
+static unsigned int const contact_macros[] = {
+  MACRO_CONTACTNAME,
+  MACRO_CONTACTALIAS,
+  MACRO_CONTACTEMAIL,
+  MACRO_CONTACTPAGER,
+  MACRO_CONTACTGROUPNAMES,
+  MACRO_CONTACTTIMEZONE
+};
+static unsigned int const global_macros[] = {
+  MACRO_ADMINEMAIL,
+  MACRO_ADMINPAGER,
+  MACRO_MAINCONFIGFILE,
+  MACRO_STATUSDATAFILE,
+  MACRO_RETENTIONDATAFILE,
+  MACRO_OBJECTCACHEFILE,
+  MACRO_TEMPFILE,
+  MACRO_LOGFILE,
+  MACRO_RESOURCEFILE,
+  MACRO_COMMANDFILE,
+  MACRO_HOSTPERFDATAFILE,
+  MACRO_SERVICEPERFDATAFILE,
+  MACRO_TEMPPATH
+};
+static unsigned int const host_macros[] = {
+  MACRO_HOSTNAME,
+  MACRO_HOSTALIAS,
+  MACRO_HOSTADDRESS,
+  MACRO_HOSTDISPLAYNAME,
+  MACRO_HOSTCHECKCOMMAND,
+  MACRO_MAXHOSTATTEMPTS,
+  MACRO_HOSTGROUPNAMES,
+  MACRO_HOSTPARENTS,
+  MACRO_HOSTCHILDREN,
+  MACRO_HOSTID,
+  MACRO_HOSTTIMEZONE
+};
+static unsigned int const service_macros[] = {
+  MACRO_SERVICEDESC,
+  MACRO_SERVICEDISPLAYNAME,
+  MACRO_SERVICECHECKCOMMAND,
+  MACRO_MAXSERVICEATTEMPTS,
+  MACRO_SERVICEISVOLATILE,
+  MACRO_SERVICEGROUPNAMES,
+  MACRO_SERVICEID,
+  MACRO_SERVICETIMEZONE
+};
+
+/**
+ *  Add custom variables to an environment.
+ *
+ *  @param[out] env     The environment to fill.
+ *  @param[in]  prefix  Prefix of variable names (_HOST, _SERVICE, ...).
+ *  @param[in]  vars    Custom variables.
+ */
+static void add_custom_variables(
+              environment& env,
+              char const* prefix,
+              map_customvar const& vars) {
+  for (map_customvar::const_iterator it(vars.begin()), end(vars.end());
+       it != end;
+       ++it)
+    if (!it->first.empty()) {
+      std::string line(MACRO_ENV_VAR_PREFIX);
+      line.append(prefix);
+      line.append(it->first);
+      line.append("=");
+      line.append(clean_macro_chars(
+                    it->second.get_value(),
+                    STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS));
+      env.add(line);
+    }
+}
+
+/**
+ *  Get the environment fragment of a contact.
+ *
+ *  @param[in] cntct  The contact, nullptr for empty contact macros.
+ *
+ *  @return Contact macros, custom variables and addresses.
+ */
+environment_cache::fragment environment_cache::contact(
+                              engine::contact* cntct) {
+  return _get(kind_contact, cntct);
+}
+
+/**
+ *  Get the current generation of fragments.
+ *
+ *  @return Generation, incremented by invalidate().
+ */
+uint64_t environment_cache::generation() const {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _generation;
+}
+
+/**
+ *  Get the environment fragment of global macros.
+ *
+ *  @return Global macros, such as $ADMINEMAIL$ or $LOGFILE$.
+ */
+environment_cache::fragment environment_cache::global() {
+  return _get(kind_global, nullptr);
+}
+
+/**
+ *  Get the environment fragment of a host.
+ *
+ *  @param[in] hst  The host, nullptr for empty host macros.
+ *
+ *  @return Host macros and custom variables.
+ */
+environment_cache::fragment environment_cache::host(engine::host* hst) {
+  return _get(kind_host, hst);
+}
+
+/**
+ *  Get the environment cache.
+ *
+ *  @return Singleton instance.
+ */
+environment_cache& environment_cache::instance() {
+  static environment_cache instance;
+  return instance;
+}
+
+/**
+ *  Drop all fragments. This must be called when objects are modified
+ *  or deleted, that is when a configuration or a retention is applied.
+ */
+void environment_cache::invalidate() {
+  std::lock_guard<std::mutex> lock(_lock);
+  ++_generation;
+  _entries.clear();
+}
+
+/**
+ *  Drop the fragment of an object. This must be called when a cached
+ *  macro or a custom variable of the object is modified at runtime.
+ *
+ *  @param[in] object  The host, service or contact.
+ */
+void environment_cache::invalidate(void const* object) {
+  std::lock_guard<std::mutex> lock(_lock);
+  _entries.erase(object);
+}
+
+/**
+ *  Check if a macro is part of the fragments.
+ *
+ *  @param[in] macro  The macro index (MACRO_HOSTNAME, ...).
+ *
+ *  @return True if the macro is cached, false if it must be computed
+ *          for each command.
+ */
+bool environment_cache::is_cached(unsigned int macro) throw () {
+  static struct cached_macros {
+    cached_macros() {
+      for (unsigned int i(0); i < MACRO_X_COUNT; ++i)
+        x[i] = false;
+      for (unsigned int i(0);
+           i < sizeof(contact_macros) / sizeof(*contact_macros);
+           ++i)
+        x[contact_macros[i]] = true;
+      for (unsigned int i(0);
+           i < sizeof(global_macros) / sizeof(*global_macros);
+           ++i)
+        x[global_macros[i]] = true;
+      for (unsigned int i(0);
+           i < sizeof(host_macros) / sizeof(*host_macros);
+           ++i)
+        x[host_macros[i]] = true;
+      for (unsigned int i(0);
+           i < sizeof(service_macros) / sizeof(*service_macros);
+           ++i)
+        x[service_macros[i]] = true;
+    }
+    bool x[MACRO_X_COUNT];
+  } const cached;
+  return (macro < MACRO_X_COUNT) && cached.x[macro];
+}
+
+/**
+ *  Get the environment fragment of a service.
+ *
+ *  @param[in] svc  The service, nullptr for empty service macros.
+ *
+ *  @return Service macros and custom variables.
+ */
+environment_cache::fragment environment_cache::service(
+                              engine::service* svc) {
+  return _get(kind_service, svc);
+}
+
+/**
+ *  Default constructor.
+ */
+environment_cache::environment_cache() : _generation(1) {}
+
+/**
+ *  Destructor.
+ */
+environment_cache::~environment_cache() throw () {}
+
+/**
+ *  Build the fragment of an object.
+ *
+ *  @param[in] k       Kind of object.
+ *  @param[in] object  The object, nullptr to get empty values.
+ *
+ *  @return New fragment.
+ */
+environment_cache::fragment environment_cache::_build(
+                              kind k,
+                              void* object) {
+  nagios_macros mac;
+  unsigned int const* macros;
+  unsigned int count;
+  switch (k) {
+   case kind_contact:
+    mac.contact_ptr = static_cast<engine::contact*>(object);
+    macros = contact_macros;
+    count = sizeof(contact_macros) / sizeof(*contact_macros);
+    break;
+   case kind_host:
+    mac.host_ptr = static_cast<engine::host*>(object);
+    macros = host_macros;
+    count = sizeof(host_macros) / sizeof(*host_macros);
+    break;
+   case kind_service:
+    mac.service_ptr = static_cast<engine::service*>(object);
+    macros = service_macros;
+    count = sizeof(service_macros) / sizeof(*service_macros);
+    break;
+   default:
+    macros = global_macros;
+    count = sizeof(global_macros) / sizeof(*global_macros);
+  }
+
+  std::shared_ptr<environment> env(new environment);
+
+  // Standard macros, empty when there is no object.
+  for (unsigned int i(0); i < count; ++i) {
+    if (macro_x_names[macros[i]].empty())
+      continue ;
+    std::string value;
+    if (object || (k == kind_global)) {
+      int release_memory(0);
+      grab_macrox_value_r(
+        &mac,
+        macros[i],
+        "",
+        "",
+        value,
+        &release_memory);
+    }
+    std::string line(MACRO_ENV_VAR_PREFIX);
+    line.append(macro_x_names[macros[i]]);
+    line.append("=");
+    line.append(value);
+    env->add(line);
+  }
+
+  // Custom variables and contact addresses.
+  if (mac.contact_ptr) {
+    add_custom_variables(
+      *env,
+      "_CONTACT",
+      mac.contact_ptr->get_custom_variables());
+    std::vector<std::string> const&
+      addresses(mac.contact_ptr->get_addresses());
+    for (unsigned int i(0); i < addresses.size(); ++i) {
+      std::ostringstream oss;
+      oss << MACRO_ENV_VAR_PREFIX "CONTACTADDRESS" << i
+          << "=" << addresses[i];
+      env->add(oss.str());
+    }
+  }
+  else if (mac.host_ptr)
+    add_custom_variables(*env, "_HOST", mac.host_ptr->custom_variables);
+  else if (mac.service_ptr)
+    add_custom_variables(
+      *env,
+      "_SERVICE",
+      mac.service_ptr->custom_variables);
+  return env;
+}
+
+/**
+ *  Get the fragment of an object, building it if it is older than the
+ *  current generation.
+ *
+ *  @param[in] k       Kind of object.
+ *  @param[in] object  The object, nullptr to get empty values.
+ *
+ *  @return Fragment.
+ */
+environment_cache::fragment environment_cache::_get(
+                              kind k,
+                              void* object) {
+  std::lock_guard<std::mutex> lock(_lock);
+  // Objects are only deleted when a configuration is applied, which
+  // invalidates the cache, so their address is a safe key.
+  entry& e(object ? _entries[object] : _empty[k]);
+  if (e.generation != _generation) {
+    e.env = _build(k, object);
+    e.generation = _generation;
+  }
+  return e.env;
+}
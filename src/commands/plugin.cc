@@ -0,0 +1,197 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <condition_variable>
+#include <mutex>
+#include "com/centreon/engine/commands/command_listener.hh"
+#include "com/centreon/engine/commands/plugin.hh"
+#include "com/centreon/engine/commands/plugin_module.hh"
+#include "com/centreon/engine/commands/plugin_pool.hh"
+#include "com/centreon/engine/error.hh"
+#include "com/centreon/engine/logging/logger.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+using namespace com::centreon::engine::logging;
+
+namespace {
+  /**
+   *  Wait for the result of a synchronous check.
+   */
+  class          sync_listener : public command_listener {
+  public:
+                 sync_listener(result& res) : _done(false), _res(res) {}
+                 ~sync_listener() throw () override {}
+    void         finished(result const& res) throw () override {
+      std::lock_guard<std::mutex> lock(_lock);
+      _res = res;
+      _done = true;
+      _cv.notify_all();
+    }
+    void         wait() {
+      std::unique_lock<std::mutex> lock(_lock);
+      while (!_done)
+        _cv.wait(lock);
+    }
+
+  private:
+    std::condition_variable
+                 _cv;
+    bool         _done;
+    std::mutex   _lock;
+    result&      _res;
+  };
+}
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] name          The command name.
+ *  @param[in] command_line  The command line.
+ *  @param[in] library       Path of the check plugin shared object.
+ *  @param[in] listener      The listener who catch events.
+ */
+plugin::plugin(
+          std::string const& name,
+          std::string const& command_line,
+          std::string const& library,
+          command_listener* listener)
+  : command(name, command_line, listener),
+    _library(library) {
+  if (_command_line.empty())
+    throw (engine_error()
+      << "Could not create '"
+      << _name << "' command: command line is empty");
+  _module = plugin_module::load(_library);
+}
+
+/**
+ *  Copy constructor. Both commands share the same plugin.
+ *
+ *  @param[in] right  Object to copy.
+ */
+plugin::plugin(plugin const& right)
+  : command(right),
+    _library(right._library),
+    _module(right._module) {}
+
+/**
+ *  Destructor. The plugin is unloaded once its last check completed.
+ */
+plugin::~plugin() throw () {}
+
+/**
+ *  Assignment operator.
+ *
+ *  @param[in] right  Object to copy.
+ *
+ *  @return This object.
+ */
+plugin& plugin::operator=(plugin const& right) {
+  if (this != &right) {
+    command::operator=(right);
+    _library = right._library;
+    _module = right._module;
+  }
+  return (*this);
+}
+
+/**
+ *  Get a pointer on a copy of the same object.
+ *
+ *  @return Return a pointer on a copy object.
+ */
+commands::command* plugin::clone() const {
+  return (new plugin(*this));
+}
+
+/**
+ *  Get the path of the check plugin shared object.
+ *
+ *  @return Library path.
+ */
+std::string const& plugin::get_library() const throw () {
+  return _library;
+}
+
+/**
+ *  Run a command.
+ *
+ *  @param[in] processed_cmd  The command line with its macros replaced.
+ *  @param[in] macros         Unused, plugins do not get an environment.
+ *  @param[in] timeout        The command timeout.
+ *
+ *  @return The command id.
+ */
+unsigned long plugin::run(
+                        std::string const& processed_cmd,
+                        nagios_macros& macros,
+                        unsigned int timeout) {
+  (void)macros;
+  logger(dbg_commands, basic)
+    << "plugin::run: plugin='" << _library << "', cmd='"
+    << processed_cmd << "', timeout=" << timeout;
+
+  unsigned long command_id(get_uniq_id());
+  plugin_pool::instance().run(
+    _module,
+    command_id,
+    processed_cmd,
+    timeout,
+    _listener);
+  return (command_id);
+}
+
+/**
+ *  Run a command and wait the result.
+ *
+ *  @param[in]  processed_cmd  The command line with its macros
+ *                             replaced.
+ *  @param[in]  macros         Unused, plugins do not get an
+ *                             environment.
+ *  @param[in]  timeout        The command timeout.
+ *  @param[out] res            The result of the command.
+ */
+void plugin::run(
+               std::string const& processed_cmd,
+               nagios_macros& macros,
+               unsigned int timeout,
+               result& res) {
+  (void)macros;
+  logger(dbg_commands, basic)
+    << "plugin::run: plugin='" << _library << "', cmd='"
+    << processed_cmd << "', timeout=" << timeout;
+
+  unsigned long command_id(get_uniq_id());
+  sync_listener listener(res);
+  plugin_pool::instance().run(
+    _module,
+    command_id,
+    processed_cmd,
+    timeout,
+    &listener);
+  listener.wait();
+
+  logger(dbg_commands, basic)
+    << "plugin::run: end check: "
+    "id=" << command_id << ", "
+    "exit_code=" << res.exit_code << ", "
+    "exit_status=" << res.exit_status << ", "
+    "output='" << res.output << "'";
+}
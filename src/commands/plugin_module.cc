@@ -0,0 +1,136 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/commands/plugin_module.hh"
+#include "com/centreon/engine/error.hh"
+#include "com/centreon/engine/logging/logger.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+using namespace com::centreon::engine::logging;
+
+std::unordered_map<std::string, std::weak_ptr<plugin_module> >
+  plugin_module::_modules;
+std::mutex plugin_module::_modules_lock;
+
+/**
+ *  Destructor. The plugin is destroyed and its shared object
+ *  unloaded.
+ */
+plugin_module::~plugin_module() throw () {
+  logger(dbg_commands, basic)
+    << "plugin_module: destroying '" << _library.filename() << "'";
+  try {
+    _destroy(_instance);
+    _library.unload();
+  }
+  catch (std::exception const& e) {
+    logger(log_runtime_error, basic)
+      << "Error: could not unload check plugin '"
+      << _library.filename() << "': " << e.what();
+  }
+  std::lock_guard<std::mutex> lock(_modules_lock);
+  std::unordered_map<std::string, std::weak_ptr<plugin_module> >::iterator
+    it(_modules.find(_library.filename()));
+  if ((it != _modules.end()) && it->second.expired())
+    _modules.erase(it);
+}
+
+/**
+ *  Get the file name of the shared object.
+ *
+ *  @return File name.
+ */
+std::string const& plugin_module::filename() const throw () {
+  return _library.filename();
+}
+
+/**
+ *  Get a shared object, loaded and initialized if no command uses it
+ *  yet.
+ *
+ *  @param[in] filename  Path of the shared object.
+ *
+ *  @return Loaded shared object.
+ */
+std::shared_ptr<plugin_module> plugin_module::load(
+                                 std::string const& filename) {
+  std::lock_guard<std::mutex> lock(_modules_lock);
+  std::weak_ptr<plugin_module>& loaded(_modules[filename]);
+  std::shared_ptr<plugin_module> module(loaded.lock());
+  if (!module) {
+    module.reset(new plugin_module(filename));
+    loaded = module;
+  }
+  return module;
+}
+
+/**
+ *  Start a check.
+ *
+ *  @param[in] args     Processed command line.
+ *  @param[in] timeout  Check timeout in seconds.
+ *  @param[in] done     Completion function.
+ *  @param[in] context  Context given to the completion function.
+ *
+ *  @return 0 if the check was started.
+ */
+int plugin_module::run(
+                     char const* args,
+                     unsigned int timeout,
+                     cce_plugin_done done,
+                     void* context) {
+  return _run(_instance, args, timeout, done, context);
+}
+
+/**
+ *  Load and initialize a shared object.
+ *
+ *  @param[in] filename  Path of the shared object.
+ */
+plugin_module::plugin_module(std::string const& filename)
+  : _destroy(nullptr), _instance(nullptr), _library(filename),
+    _run(nullptr) {
+  logger(dbg_commands, basic)
+    << "plugin_module: loading '" << filename << "'";
+  try {
+    _library.load();
+    int api_version(*static_cast<int*>(
+          _library.resolve("__cce_plugin_api_version")));
+    if (api_version != CURRENT_CCE_PLUGIN_API_VERSION)
+      throw (engine_error() << "it is using an old or unspecified "
+             "version of the check plugin API");
+
+    cce_plugin_init_func init(
+      (cce_plugin_init_func)_library.resolve_proc("cce_plugin_init"));
+    _run = (cce_plugin_run_func)_library.resolve_proc("cce_plugin_run");
+    _destroy = (cce_plugin_destroy_func)_library.resolve_proc(
+                                          "cce_plugin_destroy");
+    if (init(&_instance))
+      throw (engine_error() << "function cce_plugin_init "
+             "returned an error");
+  }
+  catch (std::exception const& e) {
+    if (_library.is_loaded())
+      _library.unload();
+    throw (engine_error() << "Could not load check plugin '"
+           << filename << "': " << e.what());
+  }
+}
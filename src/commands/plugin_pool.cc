@@ -0,0 +1,305 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include "com/centreon/engine/commands/plugin_pool.hh"
+#include "com/centreon/engine/commands/result.hh"
+#include "com/centreon/engine/events/monotonic_clock.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/service.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+using namespace com::centreon::engine::logging;
+
+/**
+ *  Get the pool of check plugin threads.
+ *
+ *  @return Singleton instance.
+ */
+plugin_pool& plugin_pool::instance() {
+  static plugin_pool instance;
+  return instance;
+}
+
+/**
+ *  Set the number of threads of the pool. Queued checks are kept.
+ *
+ *  @param[in] count  Number of threads.
+ */
+void plugin_pool::resize(unsigned int count) {
+  if (count == _threads.size())
+    return ;
+  _stop();
+  for (unsigned int i(0); i < count; ++i)
+    _threads.push_back(std::thread(&plugin_pool::_work, this));
+}
+
+/**
+ *  Queue a check. Its result will be handed to the listener from a
+ *  thread of the pool or of the plugin.
+ *
+ *  @param[in] module      Shared object of the plugin.
+ *  @param[in] command_id  Command ID of the check.
+ *  @param[in] args        Processed command line.
+ *  @param[in] timeout     Check timeout in seconds, 0 for none.
+ *  @param[in] listener    Listener of the result.
+ */
+void plugin_pool::run(
+                    std::shared_ptr<plugin_module> const& module,
+                    unsigned long command_id,
+                    std::string const& args,
+                    unsigned int timeout,
+                    command_listener* listener) {
+  resize(config->check_plugin_threads());
+
+  std::unique_ptr<query> q(new query);
+  q->args = args;
+  q->command_id = command_id;
+  q->expired = false;
+  q->listener = listener;
+  q->module = module;
+  q->pool = this;
+  q->timeout = timeout;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    q->deadline = _deadlines.end();
+    _queue.push_back(q.get());
+  }
+  q.release();
+  _cv.notify_one();
+}
+
+/**
+ *  Get the number of threads of the pool.
+ *
+ *  @return Number of threads.
+ */
+unsigned int plugin_pool::size() const {
+  return _threads.size();
+}
+
+/**
+ *  Default constructor. Threads are started by the first check.
+ */
+plugin_pool::plugin_pool() : _quit(false) {}
+
+/**
+ *  Destructor. Checks still queued are dropped.
+ */
+plugin_pool::~plugin_pool() throw () {
+  _stop();
+  for (std::deque<query*>::iterator
+         it(_queue.begin()), end(_queue.end());
+       it != end;
+       ++it)
+    delete *it;
+  _queue.clear();
+}
+
+/**
+ *  Hand the result of a check to its listener.
+ *
+ *  @param[in] command_id   Command ID of the check.
+ *  @param[in] listener     Listener of the result.
+ *  @param[in] start_time   Time the check was started.
+ *  @param[in] exit_code    Exit code of the check.
+ *  @param[in] exit_status  Normal, crash or timeout.
+ *  @param[in] output       Output of the check.
+ */
+void plugin_pool::_deliver(
+                    unsigned long command_id,
+                    command_listener* listener,
+                    timestamp const& start_time,
+                    int exit_code,
+                    process::status exit_status,
+                    std::string const& output) {
+  result res;
+  res.command_id = command_id;
+  res.start_time = start_time;
+  res.end_time = timestamp::now();
+  res.exit_code = exit_code;
+  res.exit_status = exit_status;
+  res.output = output;
+  if ((res.exit_code < -1) || (res.exit_code > 3))
+    res.exit_code = service::state_unknown;
+
+  logger(dbg_commands, basic)
+    << "plugin_pool: id=" << command_id << ", exit_code="
+    << res.exit_code << ", exit_status=" << res.exit_status;
+
+  if (listener)
+    listener->finished(res);
+}
+
+/**
+ *  Completion function given to plugins, called once per started
+ *  check from any thread.
+ *
+ *  @param[in] context    Query of the check.
+ *  @param[in] exit_code  Exit code of the check.
+ *  @param[in] output     Output of the check.
+ */
+void plugin_pool::_done(
+                    void* context,
+                    int exit_code,
+                    char const* output) {
+  query* q(static_cast<query*>(context));
+  plugin_pool& pool(*q->pool);
+  bool expired;
+  {
+    std::lock_guard<std::mutex> lock(pool._lock);
+    expired = q->expired;
+    if (!expired && (q->deadline != pool._deadlines.end()))
+      pool._deadlines.erase(q->deadline);
+    // The shared object cannot be destroyed from its own completion.
+    pool._released.push_back(q->module);
+    q->module.reset();
+  }
+  pool._cv.notify_one();
+
+  // Checks that timed out were already reported.
+  if (!expired)
+    _deliver(
+      q->command_id,
+      q->listener,
+      q->start_time,
+      exit_code,
+      process::normal,
+      output ? output : "");
+  delete q;
+}
+
+/**
+ *  Stop and join all threads.
+ */
+void plugin_pool::_stop() {
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    _quit = true;
+  }
+  _cv.notify_all();
+  for (std::vector<std::thread>::iterator
+         it(_threads.begin()), end(_threads.end());
+       it != end;
+       ++it)
+    it->join();
+  _threads.clear();
+  _released.clear();
+  _quit = false;
+}
+
+/**
+ *  Thread body: release shared objects, report checks that timed out
+ *  and start queued checks.
+ */
+void plugin_pool::_work() {
+  std::unique_lock<std::mutex> lock(_lock);
+  while (!_quit) {
+    // Release shared objects whose last check completed.
+    if (!_released.empty()) {
+      std::vector<std::shared_ptr<plugin_module> > released;
+      released.swap(_released);
+      lock.unlock();
+      released.clear();
+      lock.lock();
+      continue ;
+    }
+
+    // Report checks that timed out, their query is deleted by their
+    // late completion.
+    int64_t now(events::monotonic_clock::now_us());
+    if (!_deadlines.empty() && (_deadlines.begin()->first <= now)) {
+      query* q(_deadlines.begin()->second);
+      _deadlines.erase(_deadlines.begin());
+      q->expired = true;
+      unsigned long command_id(q->command_id);
+      command_listener* listener(q->listener);
+      timestamp start_time(q->start_time);
+      lock.unlock();
+      _deliver(
+        command_id,
+        listener,
+        start_time,
+        service::state_unknown,
+        process::timeout,
+        "(Process Timeout)");
+      lock.lock();
+      continue ;
+    }
+
+    // Start the next queued check. The query can be deleted by the
+    // plugin as soon as it is started.
+    if (!_queue.empty()) {
+      query* q(_queue.front());
+      _queue.pop_front();
+      q->start_time = timestamp::now();
+      if (q->timeout)
+        q->deadline = _deadlines.insert(std::make_pair(
+                        now + q->timeout * INT64_C(1000000),
+                        q));
+      std::shared_ptr<plugin_module> module(q->module);
+      std::string args(q->args);
+      unsigned int timeout(q->timeout);
+      lock.unlock();
+
+      logger(dbg_commands, basic)
+        << "plugin_pool: starting id=" << q->command_id << " with '"
+        << module->filename() << "'";
+      int ret;
+      try {
+        ret = module->run(args.c_str(), timeout, &plugin_pool::_done, q);
+      }
+      catch (...) {
+        ret = -1;
+      }
+
+      // The check was not started, the plugin will not complete it.
+      if (ret) {
+        lock.lock();
+        bool expired(q->expired);
+        if (!expired && (q->deadline != _deadlines.end()))
+          _deadlines.erase(q->deadline);
+        lock.unlock();
+        if (!expired)
+          _deliver(
+            q->command_id,
+            q->listener,
+            q->start_time,
+            service::state_unknown,
+            process::crash,
+            "(Could not start check plugin)");
+        delete q;
+      }
+      module.reset();
+      lock.lock();
+      continue ;
+    }
+
+    // Wait for a check or for the next timeout.
+    if (_deadlines.empty())
+      _cv.wait(lock);
+    else
+      _cv.wait_for(
+        lock,
+        std::chrono::microseconds(_deadlines.begin()->first - now));
+  }
+}
@@ -20,10 +20,12 @@
 #include "com/centreon/concurrency/locker.hh"
 #include "com/centreon/engine/commands/raw.hh"
 #include "com/centreon/engine/commands/environment.hh"
+#include "com/centreon/engine/commands/environment_cache.hh"
 #include "com/centreon/engine/error.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/macros.hh"
+#include "com/centreon/engine/string.hh"
 
 using namespace com::centreon;
 using namespace com::centreon::engine;
@@ -47,11 +49,15 @@ raw::raw(
        std::string const& name,
        std::string const& command_line,
        command_listener* listener)
-  : command(name, command_line, listener), process_listener() {
+  : command(name, command_line, listener),
+    process_listener(),
+    _launcher(launcher_default),
+    _spawned_busy(0) {
   if (_command_line.empty())
     throw (engine_error()
       << "Could not create '"
       << _name << "' command: command line is empty");
+  _parse_env_macros(_command_line, _env_macros);
 }
 
 /**
@@ -59,7 +65,13 @@ raw::raw(
  *
  *  @param[in] right Object to copy.
  */
-raw::raw(raw const& right) : command(right), process_listener(right) {}
+raw::raw(raw const& right)
+  : command(right),
+    process_listener(right),
+    spawner::listener(right),
+    _env_macros(right._env_macros),
+    _launcher(right._launcher),
+    _spawned_busy(0) {}
 
 /**
  *  Destructor.
@@ -67,6 +79,8 @@ raw::raw(raw const& right) : command(right), process_listener(right) {}
 raw::~raw() throw () {
   try {
     concurrency::locker lock(&_lock);
+    while (_spawned_busy)
+      _cv_spawned.wait(&_lock);
     while (!_processes_busy.empty()) {
       process* p(_processes_busy.begin()->first);
       lock.unlock();
@@ -93,8 +107,11 @@ raw::~raw() throw () {
  *  @return This object.
  */
 raw& raw::operator=(raw const& right) {
-  if (this != &right)
+  if (this != &right) {
     command::operator=(right);
+    _env_macros = right._env_macros;
+    _launcher = right._launcher;
+  }
   return (*this);
 }
 
@@ -107,6 +124,15 @@ commands::command* raw::clone() const {
   return (new raw(*this));
 }
 
+/**
+ *  Get the launcher of this command.
+ *
+ *  @return Launcher, launcher_default for command_launcher.
+ */
+raw::launcher_type raw::get_launcher() const throw () {
+  return _launcher;
+}
+
 /**
  *  Run a command.
  *
@@ -123,9 +149,40 @@ unsigned long raw::run(
   logger(dbg_commands, basic)
     << "raw::run: cmd='" << processed_cmd << "', timeout=" << timeout;
 
+  unsigned long command_id(get_uniq_id());
+
+  // Start process from the spawner.
+  if (_use_spawner()) {
+    logger(dbg_commands, basic)
+      << "raw::run: id=" << command_id << ", spawned";
+    environment env;
+    _build_environment_macros(macros, env);
+    {
+      concurrency::locker lock(&_lock);
+      ++_spawned_busy;
+    }
+    try {
+      spawner::instance().run(
+        this,
+        command_id,
+        processed_cmd,
+        env.data(),
+        timeout,
+        config->use_setpgid());
+    }
+    catch (...) {
+      logger(dbg_commands, basic)
+        << "raw::run: spawn process failed: id=" << command_id;
+      concurrency::locker lock(&_lock);
+      --_spawned_busy;
+      _cv_spawned.wake_all();
+      throw;
+    }
+    return (command_id);
+  }
+
   // Get process and put into the busy list.
   process* p(nullptr);
-  unsigned long command_id(get_uniq_id());
   {
     concurrency::locker lock(&_lock);
     p = _get_free_process();
@@ -173,9 +230,33 @@ void raw::run(
   logger(dbg_commands, basic)
     << "raw::run: cmd='" << processed_cmd << "', timeout=" << timeout;
 
+  unsigned long command_id(get_uniq_id());
+
+  // Start process from the spawner and wait for its result.
+  if (_use_spawner()) {
+    logger(dbg_commands, basic)
+      << "raw::run: id=" << command_id << ", spawned";
+    environment env;
+    _build_environment_macros(macros, env);
+    spawner::instance().run(
+      command_id,
+      processed_cmd,
+      env.data(),
+      timeout,
+      config->use_setpgid(),
+      res);
+    _check_exit(res);
+    logger(dbg_commands, basic)
+      << "raw::run: end process: "
+      "id=" << command_id << ", "
+      "exit_code=" << res.exit_code << ", "
+      "exit_status=" << res.exit_status << ", "
+      "output='" << res.output << "'";
+    return ;
+  }
+
   // Get process.
   process p;
-  unsigned long command_id(get_uniq_id());
 
   logger(dbg_commands, basic)
     << "raw::run: id=" << command_id << ", process=" << &p;
@@ -208,15 +289,7 @@ void raw::run(
   res.end_time = p.end_time();
   res.exit_code = p.exit_code();
   res.exit_status = p.exit_status();
-
-  if (res.exit_status == process::timeout) {
-    res.exit_code = service::state_unknown;
-    res.output = "(Process Timeout)";
-  }
-  else if ((res.exit_status == process::crash)
-           || (res.exit_code < -1)
-           || (res.exit_code > 3))
-    res.exit_code = service::state_unknown;
+  _check_exit(res);
 
   logger(dbg_commands, basic)
     << "raw::run: end process: "
@@ -228,6 +301,25 @@ void raw::run(
     "output='" << res.output << "'";
 }
 
+/**
+ *  Set the command line and find the macros it references.
+ *
+ *  @param[in] command_line  The new command line.
+ */
+void raw::set_command_line(std::string const& command_line) {
+  command::set_command_line(command_line);
+  _parse_env_macros(_command_line, _env_macros);
+}
+
+/**
+ *  Set the launcher of this command.
+ *
+ *  @param[in] launcher  Launcher, launcher_default for command_launcher.
+ */
+void raw::set_launcher(launcher_type launcher) throw () {
+  _launcher = launcher;
+}
+
 /**************************************
 *                                     *
 *           Private Methods           *
@@ -305,15 +397,7 @@ void raw::finished(process& p) throw () {
     res.end_time = p.end_time();
     res.exit_code = p.exit_code();
     res.exit_status = p.exit_status();
-
-    if (res.exit_status == process::timeout) {
-      res.exit_code = service::state_unknown;
-      res.output = "(Process Timeout)";
-    }
-    else if ((res.exit_status == process::crash)
-             || (res.exit_code < -1)
-             || (res.exit_code > 3))
-      res.exit_code = service::state_unknown;
+    _check_exit(res);
 
     logger(dbg_commands, basic)
       << "raw::finished: "
@@ -340,210 +424,221 @@ void raw::finished(process& p) throw () {
 }
 
 /**
- *  Build argv macro environment variables.
+ *  Provide by spawner::listener interface. Call at the end of the
+ *  execution of a spawned process.
  *
- *  @param[in]  macros  The macros data struct.
- *  @param[out] env     The environment to fill.
+ *  @param[in] res  The result of the process.
  */
-void raw::_build_argv_macro_environment(
-            nagios_macros const& macros,
-            environment& env) {
-  for (unsigned int i(0); i < MAX_COMMAND_ARGUMENTS; ++i) {
-    std::ostringstream oss;
-    oss << MACRO_ENV_VAR_PREFIX "ARG" << (i + 1) << "=" << macros.argv[i];
-    env.add(oss.str());
+void raw::spawned(result& res) throw () {
+  try {
+    _check_exit(res);
+
+    logger(dbg_commands, basic)
+      << "raw::spawned: "
+      "id=" << res.command_id << ", "
+      "start_time=" << res.start_time.to_mseconds() << ", "
+      "end_time=" << res.end_time.to_mseconds() << ", "
+      "exit_code=" << res.exit_code << ", "
+      "exit_status=" << res.exit_status << ", "
+      "output='" << res.output << "'";
+
+    // Forward result to the listener.
+    if (_listener)
+      _listener->finished(res);
   }
+  catch (std::exception const& e) {
+    logger(log_runtime_warning, basic)
+      << "Warning: Raw spawned process termination routine failed: "
+      << e.what();
+  }
+
+  concurrency::locker lock(&_lock);
+  --_spawned_busy;
+  _cv_spawned.wake_all();
 }
 
 /**
- *  Build contact address environment variables.
+ *  Build argv macro environment variables.
  *
  *  @param[in]  macros  The macros data struct.
  *  @param[out] env     The environment to fill.
  */
-void raw::_build_contact_address_environment(
+void raw::_build_argv_macro_environment(
             nagios_macros const& macros,
             environment& env) {
-  if (!macros.contact_ptr)
-    return ;
-  std::vector<std::string> const& address(macros.contact_ptr->get_addresses());
-  for (unsigned int i(0); i < address.size(); ++i) {
+  for (unsigned int i(0); i < MAX_COMMAND_ARGUMENTS; ++i) {
     std::ostringstream oss;
-    oss << MACRO_ENV_VAR_PREFIX "CONTACTADDRESS" << i << "=" << address[i];
+    oss << MACRO_ENV_VAR_PREFIX "ARG" << (i + 1) << "=" << macros.argv[i];
     env.add(oss.str());
   }
 }
 
 /**
- *  Build custom contact macro environment variables.
+ *  Build all macro environemnt variable.
+ *
+ *  Macros that only depend on the configuration are referenced from
+ *  the environment cache, others are computed for each command.
  *
  *  @param[in,out] macros  The macros data struct.
  *  @param[out]    env     The environment to fill.
  */
-void raw::_build_custom_contact_macro_environment(
+void raw::_build_environment_macros(
             nagios_macros& macros,
-            environment& env) {
-  // Build custom contact variable.
-  contact* cntct(macros.contact_ptr);
-  if (cntct) {
-    for (auto const& cv : cntct->get_custom_variables()) {
-      if (!cv.first.empty()) {
-        std::string name("_CONTACT");
-        name.append(cv.first);
-        macros.custom_contact_vars[name] =  cv.second;
-      }
-    }
-  }
-  // Set custom contact variable into the environement
-  for (auto const& cv : macros.custom_contact_vars) {
-    if (!cv.first.empty()) {
-      std::string value(clean_macro_chars(
-            cv.second.get_value(),
-            STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS));
-      std::string line;
-      line.append(MACRO_ENV_VAR_PREFIX);
-      line.append(cv.first);
-      line.append("=");
-      line.append(value);
-      env.add(line);
-    }
+            environment& env) const {
+  if (!config->enable_environment_macros())
+    return ;
+  if (config->environment_macros_mode()
+      == configuration::state::environment_macros_referenced)
+    _build_referenced_environment(macros, env);
+  else {
+    environment_cache& cache(environment_cache::instance());
+    env.add(cache.global());
+    env.add(cache.host(macros.host_ptr));
+    env.add(cache.service(macros.service_ptr));
+    env.add(cache.contact(macros.contact_ptr));
+    _build_macrosx_environment(macros, env);
+    _build_argv_macro_environment(macros, env);
   }
 }
 
 /**
- *  Build custom host macro environment variables.
+ *  Build macrox environment variables that are not cached.
  *
  *  @param[in,out] macros  The macros data struct.
  *  @param[out]    env     The environment to fill.
  */
-void raw::_build_custom_host_macro_environment(
+void raw::_build_macrosx_environment(
             nagios_macros& macros,
             environment& env) {
-  // Build custom host variable.
-  host* hst(macros.host_ptr);
-  if (hst) {
-    for (auto const& cv : hst->custom_variables) {
-      if (!cv.first.empty()) {
-        std::string name("_HOST");
-        name.append(cv.first);
-        macros.custom_host_vars[name] = cv.second;
-      }
-    }
-  }
-  // Set custom host variable into the environement
-  for (auto const& cv : macros.custom_host_vars) {
-    if (!cv.first.empty()) {
-      std::string value(clean_macro_chars(
-            cv.second.get_value(),
-            STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS));
-      std::string line;
-      line.append(MACRO_ENV_VAR_PREFIX);
-      line.append(cv.first);
-      line.append("=");
-      line.append(value);
-      env.add(line);
-    }
-  }
+  for (unsigned int i(0); i < MACRO_X_COUNT; ++i)
+    if (!environment_cache::is_cached(i))
+      _build_macrox_environment(macros, i, env);
 }
 
 /**
- *  Build custom service macro environment variables.
+ *  Build one macrox environment variable.
  *
  *  @param[in,out] macros  The macros data struct.
+ *  @param[in]     macro   The macro index.
  *  @param[out]    env     The environment to fill.
  */
-void raw::_build_custom_service_macro_environment(
+void raw::_build_macrox_environment(
             nagios_macros& macros,
+            unsigned int macro,
             environment& env) {
-  // Build custom service variable.
-  service* svc(macros.service_ptr);
-  if (svc) {
-    for (auto const& cv : svc->custom_variables) {
-      if (!cv.first.empty()) {
-        std::string name("_SERVICE");
-        name.append(cv.first);
-        macros.custom_service_vars[name] = cv.second;
-      }
+  int release_memory(0);
+
+  // Need to grab macros?
+  if (macros.x[macro].empty()) {
+    // Skip summary macro in lage instalation tweaks.
+    if ((macro < MACRO_TOTALHOSTSUP)
+        || (macro > MACRO_TOTALSERVICEPROBLEMSUNHANDLED)
+        || !config->use_large_installation_tweaks()) {
+      grab_macrox_value_r(
+        &macros,
+        macro,
+        "",
+        "",
+        macros.x[macro],
+        &release_memory);
     }
   }
-  // Set custom service variable into the environement
-  for (auto const& cv : macros.custom_service_vars) {
-    if (!cv.first.empty()) {
-      std::string value(clean_macro_chars(
-            cv.second.get_value(),
-            STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS));
-      std::string line;
-      line.append(MACRO_ENV_VAR_PREFIX);
-      line.append(cv.first);
-      line.append("=");
-      line.append(value);
-      env.add(line);
-    }
+
+  // Add into the environment.
+  if (!macro_x_names[macro].empty()) {
+    std::string line;
+    line.append(MACRO_ENV_VAR_PREFIX);
+    line.append(macro_x_names[macro]);
+    line.append("=");
+    line.append(macros.x[macro]);
+    env.add(line);
   }
-}
 
-/**
- *  Build all macro environemnt variable.
- *
- *  @param[in,out] macros  The macros data struct.
- *  @param[out]    env     The environment to fill.
- */
-void raw::_build_environment_macros(
-            nagios_macros& macros,
-            environment& env) {
-  if (config->enable_environment_macros()) {
-    _build_macrosx_environment(macros, env);
-    _build_argv_macro_environment(macros, env);
-    _build_custom_host_macro_environment(macros, env);
-    _build_custom_service_macro_environment(macros, env);
-    _build_custom_contact_macro_environment(macros, env);
-    _build_contact_address_environment(macros, env);
+  // Release memory if necessary.
+  if (release_memory) {
+    macros.x[macro] = "";
   }
 }
 
 /**
- *  Build macrox environment variables.
+ *  Build environment variables of the macros referenced by the command
+ *  line only.
  *
  *  @param[in,out] macros  The macros data struct.
  *  @param[out]    env     The environment to fill.
  */
-void raw::_build_macrosx_environment(
+void raw::_build_referenced_environment(
             nagios_macros& macros,
-            environment& env) {
-  for (unsigned int i(0); i < MACRO_X_COUNT; ++i) {
-    int release_memory(0);
-
-    // Need to grab macros?
-    if (macros.x[i].empty()) {
-      // Skip summary macro in lage instalation tweaks.
-      if ((i < MACRO_TOTALHOSTSUP)
-          || (i > MACRO_TOTALSERVICEPROBLEMSUNHANDLED)
-          || !config->use_large_installation_tweaks()) {
-        grab_macrox_value_r(
-          &macros,
-          i,
-          "",
-          "",
-          macros.x[i],
-          &release_memory);
+            environment& env) const {
+  for (std::vector<env_macro>::const_iterator
+         it(_env_macros.begin()), end(_env_macros.end());
+       it != end;
+       ++it) {
+    if (it->type == env_macro::standard)
+      _build_macrox_environment(macros, it->index, env);
+    else if (it->type == env_macro::argv) {
+      std::ostringstream oss;
+      oss << MACRO_ENV_VAR_PREFIX "ARG" << (it->index + 1)
+          << "=" << macros.argv[it->index];
+      env.add(oss.str());
+    }
+    else if (it->type == env_macro::contact_address) {
+      if (macros.contact_ptr
+          && (it->index < macros.contact_ptr->get_addresses().size())) {
+        std::ostringstream oss;
+        oss << MACRO_ENV_VAR_PREFIX "CONTACTADDRESS" << it->index
+            << "=" << macros.contact_ptr->get_address(it->index);
+        env.add(oss.str());
       }
     }
-
-    // Add into the environment.
-    if (!macro_x_names[i].empty()) {
-      std::string line;
-      line.append(MACRO_ENV_VAR_PREFIX);
-      line.append(macro_x_names[i]);
-      line.append("=");
-      line.append(macros.x[i]);
-      env.add(line);
+    else {
+      map_customvar const* vars(nullptr);
+      char const* prefix;
+      if (it->type == env_macro::custom_host) {
+        prefix = "_HOST";
+        if (macros.host_ptr)
+          vars = &macros.host_ptr->custom_variables;
+      }
+      else if (it->type == env_macro::custom_service) {
+        prefix = "_SERVICE";
+        if (macros.service_ptr)
+          vars = &macros.service_ptr->custom_variables;
+      }
+      else {
+        prefix = "_CONTACT";
+        if (macros.contact_ptr)
+          vars = &macros.contact_ptr->get_custom_variables();
+      }
+      map_customvar::const_iterator var;
+      if (vars && ((var = vars->find(it->name)) != vars->end())) {
+        std::string line(MACRO_ENV_VAR_PREFIX);
+        line.append(prefix);
+        line.append(it->name);
+        line.append("=");
+        line.append(clean_macro_chars(
+                      var->second.get_value(),
+                      STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS));
+        env.add(line);
+      }
     }
+  }
+}
 
-    // Release memory if necessary.
-    if (release_memory) {
-      macros.x[i] = "";
-    }
+/**
+ *  Set the exit code of a result from its status: timeouts, crashes
+ *  and out of bounds codes are unknown states.
+ *
+ *  @param[in,out] res  The result.
+ */
+void raw::_check_exit(result& res) {
+  if (res.exit_status == process::timeout) {
+    res.exit_code = service::state_unknown;
+    res.output = "(Process Timeout)";
   }
+  else if ((res.exit_status == process::crash)
+           || (res.exit_code < -1)
+           || (res.exit_code > 3))
+    res.exit_code = service::state_unknown;
 }
 
 /**
@@ -565,3 +660,95 @@ process* raw::_get_free_process() {
   _processes_free.pop_front();
   return p;
 }
+
+/**
+ *  Find the macros referenced by a command line that can be exported
+ *  in the environment. On-demand macros, user macros and unknown
+ *  macros are ignored.
+ *
+ *  @param[in]  command_line  The command line.
+ *  @param[out] macros        The referenced macros.
+ */
+void raw::_parse_env_macros(
+            std::string const& command_line,
+            std::vector<env_macro>& macros) {
+  macros.clear();
+  size_t pos(0);
+  for (;;) {
+    size_t start(command_line.find('$', pos));
+    if (start == std::string::npos)
+      break ;
+    size_t end(command_line.find('$', start + 1));
+    if (end == std::string::npos)
+      break ;
+    pos = end + 1;
+    std::string name(command_line, start + 1, end - start - 1);
+    if (name.empty() || (name.find(':') != std::string::npos))
+      continue ;
+
+    env_macro m;
+    m.index = 0;
+    unsigned int number;
+    if (!name.compare(0, 5, "_HOST")) {
+      m.type = env_macro::custom_host;
+      m.name = name.substr(5);
+    }
+    else if (!name.compare(0, 8, "_SERVICE")) {
+      m.type = env_macro::custom_service;
+      m.name = name.substr(8);
+    }
+    else if (!name.compare(0, 8, "_CONTACT")) {
+      m.type = env_macro::custom_contact;
+      m.name = name.substr(8);
+    }
+    else if (!name.compare(0, 3, "ARG")
+             && string::to(name.c_str() + 3, number)
+             && (number >= 1)
+             && (number <= MAX_COMMAND_ARGUMENTS)) {
+      m.type = env_macro::argv;
+      m.index = number - 1;
+    }
+    else if (!name.compare(0, 14, "CONTACTADDRESS")
+             && (name.size() > 14)
+             && string::to(name.c_str() + 14, number)
+             && (number < MAX_CONTACT_ADDRESSES)) {
+      m.type = env_macro::contact_address;
+      m.index = number;
+    }
+    else {
+      m.type = env_macro::standard;
+      while ((m.index < MACRO_X_COUNT) && (macro_x_names[m.index] != name))
+        ++m.index;
+      if (m.index == MACRO_X_COUNT)
+        continue ;
+    }
+
+    // Export each macro once.
+    bool found(false);
+    for (std::vector<env_macro>::const_iterator
+           it(macros.begin()), end(macros.end());
+         !found && (it != end);
+         ++it)
+      found = ((it->type == m.type)
+               && (it->index == m.index)
+               && (it->name == m.name));
+    if (!found)
+      macros.push_back(m);
+  }
+}
+
+/**
+ *  Check if processes of this command are started by the spawner,
+ *  starting it if necessary.
+ *
+ *  @return True to use the spawner, false to fork with clib.
+ */
+bool raw::_use_spawner() const {
+  if ((_launcher == launcher_fork)
+      || ((_launcher == launcher_default)
+          && (config->command_launcher()
+              != configuration::state::launcher_spawn)))
+    return false;
+  spawner& s(spawner::instance());
+  return s.is_running() || s.start();
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "com/centreon/engine/commands/response_buffer.hh"
+
+using namespace com::centreon::engine::commands;
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] capacity  Initial capacity, rounded up to a power of two.
+ */
+response_buffer::response_buffer(size_t capacity)
+  : _capacity(16), _data(nullptr), _head(0), _nuls(0), _scanned(0), _size(0) {
+  while (_capacity < capacity)
+    _capacity <<= 1;
+  _data = new char[_capacity];
+}
+
+/**
+ *  Copy constructor.
+ *
+ *  @param[in] right  Object to copy.
+ */
+response_buffer::response_buffer(response_buffer const& right)
+  : _capacity(0), _data(nullptr), _head(0), _nuls(0), _scanned(0), _size(0) {
+  _internal_copy(right);
+}
+
+/**
+ *  Destructor.
+ */
+response_buffer::~response_buffer() throw () {
+  delete [] _data;
+}
+
+/**
+ *  Assignment operator.
+ *
+ *  @param[in] right  Object to copy.
+ *
+ *  @return This object.
+ */
+response_buffer& response_buffer::operator=(response_buffer const& right) {
+  if (this != &right)
+    _internal_copy(right);
+  return *this;
+}
+
+/**
+ *  Append connector output.
+ *
+ *  @param[in] data  Output.
+ *  @param[in] size  Output size.
+ */
+void response_buffer::append(char const* data, size_t size) {
+  if (!size)
+    return;
+  if (_size + size > _capacity)
+    _grow(_size + size);
+  size_t tail((_head + _size) & (_capacity - 1));
+  size_t first(std::min(size, _capacity - tail));
+  memcpy(_data + tail, data, first);
+  memcpy(_data, data + first, size - first);
+  _size += size;
+}
+
+/**
+ *  Append connector output.
+ *
+ *  @param[in] data  Output.
+ */
+void response_buffer::append(std::string const& data) {
+  append(data.data(), data.size());
+}
+
+/**
+ *  Get the buffer capacity.
+ *
+ *  @return Number of bytes that can be held without growing.
+ */
+size_t response_buffer::capacity() const throw () {
+  return _capacity;
+}
+
+/**
+ *  Drop all buffered output.
+ */
+void response_buffer::clear() throw () {
+  _head = 0;
+  _nuls = 0;
+  _scanned = 0;
+  _size = 0;
+}
+
+/**
+ *  Extract the next complete response.
+ *
+ *  Fields are NUL terminated and responses end with three more NULs.
+ *  A run of NULs therefore ends a response when it is at least four
+ *  characters long and it is complete when it is followed by another
+ *  character or by the end of the buffered output (connectors write
+ *  whole responses). The response is returned with its fields NUL
+ *  terminated.
+ *
+ *  @param[out] response  Response.
+ *
+ *  @return true if a response was extracted, false if no complete
+ *          response is buffered.
+ */
+bool response_buffer::pop(std::string& response) {
+  size_t mask(_capacity - 1);
+  while (_scanned < _size) {
+    size_t pos((_head + _scanned) & mask);
+    char const* begin(_data + pos);
+
+    // NULs received after a response was extracted belong to it.
+    if (!_scanned && !*begin) {
+      _head = (_head + 1) & mask;
+      --_size;
+      continue;
+    }
+
+    // Search the next NUL, then count consecutive NULs.
+    if (!_nuls) {
+      size_t contiguous(std::min(_size - _scanned, _capacity - pos));
+      char const* nul(static_cast<char const*>(
+                        memchr(begin, '\0', contiguous)));
+      if (!nul)
+        _scanned += contiguous;
+      else {
+        _scanned += nul - begin + 1;
+        _nuls = 1;
+      }
+    }
+    else if (!*begin) {
+      ++_scanned;
+      ++_nuls;
+    }
+    else if (_nuls < terminator_size) {
+      ++_scanned;
+      _nuls = 0;
+    }
+    else {
+      _extract(response);
+      return true;
+    }
+  }
+  if (_nuls >= terminator_size) {
+    _extract(response);
+    return true;
+  }
+  return false;
+}
+
+/**
+ *  Get the number of buffered bytes.
+ *
+ *  @return Buffered bytes.
+ */
+size_t response_buffer::size() const throw () {
+  return _size;
+}
+
+/**
+ *  Extract the scanned response.
+ *
+ *  @param[out] response  Response.
+ */
+void response_buffer::_extract(std::string& response) {
+  size_t length(_scanned - (terminator_size - 1));
+  size_t first(std::min(length, _capacity - _head));
+  response.assign(_data + _head, first);
+  if (length > first)
+    response.append(_data, length - first);
+  _head = (_head + _scanned) & (_capacity - 1);
+  _size -= _scanned;
+  if (!_size)
+    _head = 0;
+  _nuls = 0;
+  _scanned = 0;
+}
+
+/**
+ *  Grow the ring, keeping buffered output.
+ *
+ *  @param[in] size  Minimum capacity.
+ */
+void response_buffer::_grow(size_t size) {
+  size_t capacity(_capacity ? _capacity : 16);
+  while (capacity < size)
+    capacity <<= 1;
+  char* data(new char[capacity]);
+  size_t first(std::min(_size, _capacity - _head));
+  if (first)
+    memcpy(data, _data + _head, first);
+  if (_size > first)
+    memcpy(data + first, _data, _size - first);
+  delete [] _data;
+  _capacity = capacity;
+  _data = data;
+  _head = 0;
+}
+
+/**
+ *  Copy internal data members.
+ *
+ *  @param[in] right  Object to copy.
+ */
+void response_buffer::_internal_copy(response_buffer const& right) {
+  char* data(new char[right._capacity]);
+  memcpy(data, right._data, right._capacity);
+  delete [] _data;
+  _capacity = right._capacity;
+  _data = data;
+  _head = right._head;
+  _nuls = right._nuls;
+  _scanned = right._scanned;
+  _size = right._size;
+}
@@ -0,0 +1,756 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <list>
+#include <poll.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <sys/prctl.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "com/centreon/engine/commands/spawner.hh"
+#include "com/centreon/engine/error.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/misc/command_line.hh"
+
+extern char** environ;
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+using namespace com::centreon::engine::logging;
+
+namespace {
+  // Command sent to the helper, followed by its arguments and its
+  // environment as NUL-terminated strings. An empty environment means
+  // the environment of the helper.
+  struct request_header {
+    uint64_t id;
+    uint32_t timeout;
+    uint32_t setpgid;
+    uint32_t argc;
+    uint32_t envc;
+    uint32_t size;
+  };
+
+  // Result sent back by the helper, followed by the output.
+  struct response_header {
+    uint64_t id;
+    int64_t  start_time;
+    int64_t  end_time;
+    int32_t  exit_code;
+    uint32_t exit_status;
+    uint32_t size;
+  };
+
+  /**
+   *  Process started by the helper.
+   */
+  struct child {
+    int64_t     deadline;
+    int64_t     end_time;
+    bool        exited;
+    int         fd;
+    uint64_t    id;
+    std::string output;
+    pid_t       pid;
+    bool        setpgid;
+    int64_t     start_time;
+    int         status;
+    bool        timed_out;
+  };
+
+  /**
+   *  Wait for the result of one command.
+   */
+  class waiter : public spawner::listener {
+  public:
+                 waiter(result& res) : _done(false), _res(res) {}
+    void         spawned(result& res) throw () override {
+      std::lock_guard<std::mutex> lock(_lock);
+      _res = res;
+      _done = true;
+      _cv.notify_all();
+    }
+    void         wait() {
+      std::unique_lock<std::mutex> lock(_lock);
+      _cv.wait(lock, [this] { return _done; });
+    }
+
+  private:
+    std::condition_variable
+                 _cv;
+    bool         _done;
+    std::mutex   _lock;
+    result&      _res;
+  };
+
+  int64_t now_microseconds() {
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    return tv.tv_sec * 1000000ll + tv.tv_usec;
+  }
+
+  int64_t monotonic_milliseconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000ll + ts.tv_nsec / 1000000;
+  }
+
+  /**
+   *  Read the available output of a child, closing its pipe on EOF.
+   */
+  void read_output(child& c) {
+    char buffer[4096];
+    while (c.fd >= 0) {
+      ssize_t r(read(c.fd, buffer, sizeof(buffer)));
+      if (r > 0)
+        c.output.append(buffer, r);
+      else if (r < 0 && errno == EINTR)
+        continue;
+      else {
+        if (r == 0 || errno != EAGAIN) {
+          close(c.fd);
+          c.fd = -1;
+        }
+        break;
+      }
+    }
+  }
+
+  /**
+   *  Start a process with posix_spawn(), with its standard output
+   *  redirected to a pipe.
+   *
+   *  @return Process ID, -1 on error.
+   */
+  pid_t spawn_child(char** argv, char** env, bool setpgid, int& fd) {
+    int p[2];
+    if (pipe2(p, O_CLOEXEC))
+      return -1;
+    fcntl(p[0], F_SETFL, O_NONBLOCK);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, p[1], 1);
+    posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t signals;
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attr, &signals);
+    sigfillset(&signals);
+    posix_spawnattr_setsigdefault(&attr, &signals);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setflags(
+      &attr,
+      (setpgid ? POSIX_SPAWN_SETPGROUP : 0)
+      | POSIX_SPAWN_SETSIGDEF
+      | POSIX_SPAWN_SETSIGMASK);
+
+    pid_t pid;
+    int rc(posix_spawnp(&pid, argv[0], &actions, &attr, argv, env));
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    close(p[1]);
+    if (rc) {
+      close(p[0]);
+      return -1;
+    }
+    fd = p[0];
+    return pid;
+  }
+
+  /**
+   *  Start the command of a request.
+   */
+  void start_child(
+         request_header const& h,
+         char* data,
+         std::list<child>& children) {
+    child c;
+    c.deadline = h.timeout
+      ? monotonic_milliseconds() + h.timeout * 1000ll
+      : 0;
+    c.exited = false;
+    c.fd = -1;
+    c.id = h.id;
+    c.pid = -1;
+    c.setpgid = h.setpgid;
+    c.start_time = now_microseconds();
+    c.status = 0;
+    c.timed_out = false;
+
+    // Split the strings, the block must end with a NUL.
+    std::vector<char*> argv;
+    std::vector<char*> envp;
+    if (h.size && !data[h.size - 1]) {
+      char* it(data);
+      char* end(data + h.size);
+      while (it != end) {
+        if (argv.size() < h.argc)
+          argv.push_back(it);
+        else
+          envp.push_back(it);
+        it += strlen(it) + 1;
+      }
+    }
+    if (!argv.empty() && (argv.size() == h.argc) && (envp.size() == h.envc)) {
+      argv.push_back(nullptr);
+      envp.push_back(nullptr);
+      c.pid = spawn_child(
+                &argv[0],
+                h.envc ? &envp[0] : environ,
+                c.setpgid,
+                c.fd);
+    }
+
+    // Could not start the command: it ends like a missing plugin.
+    if (c.pid < 0) {
+      c.end_time = c.start_time;
+      c.exited = true;
+      c.status = 127 << 8;
+    }
+    children.push_back(c);
+  }
+
+  /**
+   *  Queue the result of a finished child.
+   */
+  void append_response(child const& c, std::string& out) {
+    response_header h;
+    h.id = c.id;
+    h.start_time = c.start_time;
+    h.end_time = c.end_time;
+    if (c.timed_out) {
+      h.exit_code = -1;
+      h.exit_status = process::timeout;
+    }
+    else if (WIFEXITED(c.status)) {
+      h.exit_code = WEXITSTATUS(c.status);
+      h.exit_status = process::normal;
+    }
+    else {
+      h.exit_code = -1;
+      h.exit_status = process::crash;
+    }
+    h.size = c.output.size();
+    out.append(reinterpret_cast<char const*>(&h), sizeof(h));
+    out.append(c.output);
+  }
+
+  /**
+   *  Main loop of the helper process. It runs until the engine closes
+   *  its end of the socket, then kills the remaining processes.
+   *
+   *  @param[in] sock  Socket connected to the engine.
+   */
+  void helper_main(int sock) {
+#ifdef PR_SET_NAME
+    prctl(PR_SET_NAME, "centengine-spwn", 0, 0, 0);
+#endif // PR_SET_NAME
+
+    // Standard descriptors must never be used by pipes.
+    int null_fd;
+    while (((null_fd = open("/dev/null", O_RDWR)) >= 0) && (null_fd <= 2))
+      ;
+    if (null_fd > 2)
+      close(null_fd);
+
+    // Signal handlers of the engine are meaningless here.
+    signal(SIGHUP, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGQUIT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGUSR1, SIG_DFL);
+    signal(SIGPIPE, SIG_IGN);
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    int sfd(signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC));
+    fcntl(sock, F_SETFL, O_NONBLOCK);
+
+    std::list<child> children;
+    std::vector<pollfd> fds;
+    std::vector<child*> polled;
+    std::string in;
+    std::string out;
+    bool engine_gone(false);
+    while (!engine_gone) {
+      // Kill processes that timed out.
+      int64_t now(monotonic_milliseconds());
+      int wait(-1);
+      for (std::list<child>::iterator
+             it(children.begin()), end(children.end());
+           it != end;
+           ++it)
+        if (it->deadline && !it->exited && !it->timed_out) {
+          if (it->deadline <= now) {
+            kill(it->setpgid ? -it->pid : it->pid, SIGKILL);
+            it->timed_out = true;
+          }
+          else if ((wait < 0) || (it->deadline - now < wait))
+            wait = it->deadline - now;
+        }
+
+      fds.clear();
+      polled.clear();
+      pollfd pfd;
+      pfd.fd = sock;
+      pfd.events = POLLIN | (out.empty() ? 0 : POLLOUT);
+      pfd.revents = 0;
+      fds.push_back(pfd);
+      pfd.fd = sfd;
+      pfd.events = POLLIN;
+      fds.push_back(pfd);
+      for (std::list<child>::iterator
+             it(children.begin()), end(children.end());
+           it != end;
+           ++it)
+        if (it->fd >= 0) {
+          pfd.fd = it->fd;
+          fds.push_back(pfd);
+          polled.push_back(&*it);
+        }
+      if ((poll(&fds[0], fds.size(), wait) < 0) && (errno != EINTR))
+        break;
+
+      // Read and start commands.
+      if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+        char buffer[16384];
+        for (;;) {
+          ssize_t r(recv(sock, buffer, sizeof(buffer), 0));
+          if (r > 0)
+            in.append(buffer, r);
+          else if (r < 0 && errno == EINTR)
+            continue;
+          else {
+            if (r == 0 || errno != EAGAIN)
+              engine_gone = true;
+            break;
+          }
+        }
+        size_t pos(0);
+        request_header h;
+        while ((in.size() - pos >= sizeof(h))
+               && (memcpy(&h, in.data() + pos, sizeof(h)),
+                   in.size() - pos - sizeof(h) >= h.size)) {
+          start_child(h, &in[pos + sizeof(h)], children);
+          pos += sizeof(h) + h.size;
+        }
+        in.erase(0, pos);
+      }
+
+      // Read outputs.
+      for (unsigned int i(0); i < polled.size(); ++i)
+        if (fds[i + 2].revents)
+          read_output(*polled[i]);
+
+      // Reap processes.
+      if (fds[1].revents & POLLIN) {
+        signalfd_siginfo info;
+        while (read(sfd, &info, sizeof(info)) > 0)
+          ;
+      }
+      int status;
+      pid_t pid;
+      while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+        for (std::list<child>::iterator
+               it(children.begin()), end(children.end());
+             it != end;
+             ++it)
+          if (it->pid == pid) {
+            it->end_time = now_microseconds();
+            it->exited = true;
+            it->status = status;
+            break;
+          }
+
+      // Send results. Output written by a process before it exited is
+      // in its pipe, descendants are not waited for.
+      for (std::list<child>::iterator it(children.begin());
+           it != children.end();)
+        if (it->exited) {
+          read_output(*it);
+          if (it->fd >= 0)
+            close(it->fd);
+          append_response(*it, out);
+          it = children.erase(it);
+        }
+        else
+          ++it;
+      while (!out.empty()) {
+        ssize_t w(send(sock, out.data(), out.size(), MSG_NOSIGNAL));
+        if (w > 0)
+          out.erase(0, w);
+        else if (w < 0 && errno == EINTR)
+          continue;
+        else {
+          if (w < 0 && errno != EAGAIN)
+            engine_gone = true;
+          break;
+        }
+      }
+    }
+
+    for (std::list<child>::iterator
+           it(children.begin()), end(children.end());
+         it != end;
+         ++it)
+      if (!it->exited)
+        kill(it->setpgid ? -it->pid : it->pid, SIGKILL);
+  }
+}
+
+/**
+ *  Default constructor.
+ */
+spawner::spawner()
+  : _fd(-1),
+    _helper(-1),
+    _last_start(0),
+    _running(false),
+    _stopping(false) {}
+
+/**
+ *  Destructor.
+ */
+spawner::~spawner() throw () {
+  try {
+    stop();
+  }
+  catch (...) {}
+}
+
+/**
+ *  Get the process spawner.
+ *
+ *  @return Singleton instance.
+ */
+spawner& spawner::instance() {
+  static spawner instance;
+  return instance;
+}
+
+/**
+ *  Check if the helper process is running.
+ *
+ *  @return True if commands can be run.
+ */
+bool spawner::is_running() const {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _running;
+}
+
+/**
+ *  Run a command. This method returns as soon as the command was sent
+ *  to the helper process.
+ *
+ *  @param[in] l           Listener that will get the result.
+ *  @param[in] command_id  Command ID, used as the result ID.
+ *  @param[in] cmd         Command line.
+ *  @param[in] env         Environment, nullptr to inherit it.
+ *  @param[in] timeout     Timeout in seconds, 0 for none.
+ *  @param[in] setpgid     Run the process in its own process group.
+ */
+void spawner::run(
+                listener* l,
+                unsigned long command_id,
+                std::string const& cmd,
+                char** env,
+                unsigned int timeout,
+                bool setpgid) {
+  misc::command_line cmdline(cmd);
+  int argc(cmdline.get_argc());
+  char** argv(cmdline.get_argv());
+  if (!argc)
+    throw (engine_error() << "Could not spawn '" << cmd
+           << "': command line is empty");
+
+  request_header h;
+  h.id = command_id;
+  h.timeout = timeout;
+  h.setpgid = setpgid;
+  h.argc = argc;
+  h.envc = 0;
+  h.size = 0;
+  std::string frame(sizeof(h), '\0');
+  for (int i(0); i < argc; ++i)
+    frame.append(argv[i], strlen(argv[i]) + 1);
+  if (env)
+    for (; env[h.envc]; ++h.envc)
+      frame.append(env[h.envc], strlen(env[h.envc]) + 1);
+  h.size = frame.size() - sizeof(h);
+  memcpy(&frame[0], &h, sizeof(h));
+
+  int fd;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (!_running)
+      throw (engine_error() << "Could not spawn '" << cmd
+             << "': process spawner is not running");
+    fd = _fd;
+    _pending[command_id] = l;
+  }
+
+  int error(0);
+  {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    char const* data(frame.data());
+    size_t size(frame.size());
+    while (size) {
+      ssize_t w(send(fd, data, size, MSG_NOSIGNAL));
+      if (w > 0) {
+        data += w;
+        size -= w;
+      }
+      else if (errno != EINTR) {
+        error = errno;
+        break;
+      }
+    }
+  }
+
+  // The result was not delivered yet by a failing helper.
+  if (error) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_pending.erase(command_id))
+      throw (engine_error() << "Could not spawn '" << cmd
+             << "': " << strerror(error));
+  }
+}
+
+/**
+ *  Run a command and wait for its result.
+ *
+ *  @param[in]  command_id  Command ID, used as the result ID.
+ *  @param[in]  cmd         Command line.
+ *  @param[in]  env         Environment, nullptr to inherit it.
+ *  @param[in]  timeout     Timeout in seconds, 0 for none.
+ *  @param[in]  setpgid     Run the process in its own process group.
+ *  @param[out] res         Result of the command.
+ */
+void spawner::run(
+                unsigned long command_id,
+                std::string const& cmd,
+                char** env,
+                unsigned int timeout,
+                bool setpgid,
+                result& res) {
+  waiter w(res);
+  run(&w, command_id, cmd, env, timeout, setpgid);
+  w.wait();
+}
+
+/**
+ *  Fork the helper process. This should be done while the engine is
+ *  still small. A failed start is not retried before 30 seconds.
+ *
+ *  @return True if the helper is running.
+ */
+bool spawner::start() {
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_running)
+      return true;
+    time_t now(time(nullptr));
+    if (_last_start && (now - _last_start < 30) && (now >= _last_start))
+      return false;
+    _last_start = now;
+  }
+
+  // Clean up a dead helper.
+  if (_reader.joinable())
+    _reader.join();
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+  if (_helper > 0) {
+    waitpid(_helper, nullptr, WNOHANG);
+    _helper = -1;
+  }
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds)) {
+    char const* msg(strerror(errno));
+    logger(log_runtime_error, basic)
+      << "Error: Could not start process spawner: " << msg;
+    return false;
+  }
+  pid_t pid(fork());
+  if (pid < 0) {
+    char const* msg(strerror(errno));
+    close(fds[0]);
+    close(fds[1]);
+    logger(log_runtime_error, basic)
+      << "Error: Could not start process spawner: " << msg;
+    return false;
+  }
+  if (!pid) {
+    close(fds[0]);
+    helper_main(fds[1]);
+    _exit(EXIT_SUCCESS);
+  }
+  close(fds[1]);
+
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    _fd = fds[0];
+    _helper = pid;
+    _running = true;
+  }
+  _reader = std::thread(&spawner::_read_results, this);
+  logger(log_info_message, basic)
+    << "Process spawner started (pid " << pid << ")";
+  return true;
+}
+
+/**
+ *  Stop the helper process. Its running processes are killed and their
+ *  commands end as crashed.
+ */
+void spawner::stop() {
+  int fd;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    fd = _fd;
+    _stopping = true;
+  }
+  if (fd >= 0)
+    shutdown(fd, SHUT_RDWR);
+  if (_reader.joinable())
+    _reader.join();
+  if (fd >= 0)
+    close(fd);
+  if (_helper > 0)
+    while ((waitpid(_helper, nullptr, 0) < 0) && (errno == EINTR))
+      ;
+
+  std::lock_guard<std::mutex> lock(_lock);
+  _fd = -1;
+  _helper = -1;
+  _last_start = 0;
+  _running = false;
+  _stopping = false;
+}
+
+/**
+ *  Forward a result to the listener of its command.
+ *
+ *  @param[in] res  Result.
+ */
+void spawner::_dispatch(result& res) {
+  listener* l(nullptr);
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    std::unordered_map<unsigned long, listener*>::iterator
+      it(_pending.find(res.command_id));
+    if (it != _pending.end()) {
+      l = it->second;
+      _pending.erase(it);
+    }
+  }
+  if (l)
+    l->spawned(res);
+}
+
+/**
+ *  End all pending commands as crashed.
+ */
+void spawner::_fail_pending() {
+  std::unordered_map<unsigned long, listener*> pending;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    pending.swap(_pending);
+  }
+  for (std::unordered_map<unsigned long, listener*>::const_iterator
+         it(pending.begin()), end(pending.end());
+       it != end;
+       ++it) {
+    result res;
+    res.command_id = it->first;
+    res.start_time = timestamp::now();
+    res.end_time = res.start_time;
+    res.exit_code = -1;
+    res.exit_status = process::crash;
+    res.output = "(Process spawner failed)";
+    it->second->spawned(res);
+  }
+}
+
+/**
+ *  Read results sent by the helper, until it stops.
+ */
+void spawner::_read_results() {
+  std::string buffer;
+  char chunk[16384];
+  for (;;) {
+    ssize_t r(recv(_fd, chunk, sizeof(chunk), 0));
+    if (r < 0 && errno == EINTR)
+      continue;
+    if (r <= 0)
+      break;
+    buffer.append(chunk, r);
+
+    size_t pos(0);
+    response_header h;
+    while ((buffer.size() - pos >= sizeof(h))
+           && (memcpy(&h, buffer.data() + pos, sizeof(h)),
+               buffer.size() - pos - sizeof(h) >= h.size)) {
+      result res;
+      res.command_id = h.id;
+      res.start_time = timestamp(
+                         h.start_time / 1000000,
+                         h.start_time % 1000000);
+      res.end_time = timestamp(h.end_time / 1000000, h.end_time % 1000000);
+      res.exit_code = h.exit_code;
+      res.exit_status = static_cast<process::status>(h.exit_status);
+      res.output.assign(buffer.data() + pos + sizeof(h), h.size);
+      pos += sizeof(h) + h.size;
+      _dispatch(res);
+    }
+    buffer.erase(0, pos);
+  }
+
+  bool stopping;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    _running = false;
+    stopping = _stopping;
+  }
+  if (!stopping)
+    logger(log_runtime_warning, basic)
+      << "Warning: Process spawner died, pending commands failed";
+  _fail_pending();
+}
@@ -0,0 +1,368 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/commands/system_runner.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/service.hh"
+#include "com/centreon/timestamp.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+using namespace com::centreon::engine::logging;
+
+/**
+ *  Call the start callback of a command, if any.
+ *
+ *  @param[in] started  Start callback.
+ */
+static void notify_started(system_runner::start_callback const& started) {
+  if (!started)
+    return;
+  try {
+    started();
+  }
+  catch (std::exception const& e) {
+    logger(log_runtime_error, basic)
+      << "Error: system command start callback failed: " << e.what();
+  }
+}
+
+/**
+ *  Cancel waiting commands and wait until every running command
+ *  finished and its callback was called. This blocks at most for the
+ *  timeouts of the running commands.
+ */
+void system_runner::drain() {
+  std::deque<job> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    cancelled.swap(_waiting);
+  }
+  if (!cancelled.empty())
+    logger(log_runtime_warning, basic)
+      << "Warning: " << cancelled.size()
+      << " waiting system commands are not run";
+  for (std::deque<job>::iterator
+         it(cancelled.begin()), end(cancelled.end());
+       it != end;
+       ++it) {
+    notify_started(it->started);
+    std::lock_guard<std::mutex> lock(_lock);
+    _fail(it->cb, "system command cancelled");
+  }
+
+  for (;;) {
+    reap();
+    {
+      std::lock_guard<std::mutex> lock(_lock);
+      if (_running.empty() && !_starting && _failed.empty())
+        break;
+      // Failed commands are handled by the next reap.
+      if (!_failed.empty())
+        continue;
+    }
+    std::unique_lock<std::mutex> lock(_results_lock);
+    _results_cv.wait(lock, [this] { return !_results.empty(); });
+  }
+
+  // Commands whose slot was released by the last reap are cancelled
+  // as well.
+  if (!empty())
+    drain();
+}
+
+/**
+ *  Check if commands are running, waiting or not reaped yet.
+ *
+ *  @return True if no command is pending.
+ */
+bool system_runner::empty() const {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _running.empty()
+         && !_starting
+         && _waiting.empty()
+         && _failed.empty();
+}
+
+/**
+ *  Get the system command runner.
+ *
+ *  @return Singleton instance.
+ */
+system_runner& system_runner::instance() {
+  static system_runner instance;
+  return instance;
+}
+
+/**
+ *  Build a completion: a shared handle whose last copy calls a
+ *  function when it is released. Callbacks of commands that belong to
+ *  a same operation keep a copy, so that the operation is completed
+ *  after all its commands, or immediately if none was run.
+ *
+ *  @param[in] f  Function called on completion.
+ *
+ *  @return Completion handle.
+ */
+system_runner::completion system_runner::make_completion(
+                            std::function<void ()> const& f) {
+  return completion(
+           nullptr,
+           [f](void*) {
+             try {
+               f();
+             }
+             catch (std::exception const& e) {
+               logger(log_runtime_error, basic)
+                 << "Error: system command completion failed: "
+                 << e.what();
+             }
+           });
+}
+
+/**
+ *  Call the callbacks of finished commands and start waiting
+ *  commands. This must be called from the events loop thread.
+ */
+void system_runner::reap() {
+  std::deque<result> results;
+  {
+    std::lock_guard<std::mutex> lock(_results_lock);
+    results.swap(_results);
+  }
+
+  std::deque<std::pair<callback, result> > done;
+  std::deque<job> ready;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    done.swap(_failed);
+    for (std::deque<result>::iterator
+           it(results.begin()), end(results.end());
+         it != end;
+         ++it) {
+      std::unordered_map<unsigned long, callback>::iterator
+        running(_running.find(it->command_id));
+      if (running == _running.end()) {
+        logger(log_runtime_warning, basic)
+          << "Warning: result of unknown system command "
+          << it->command_id << " ignored";
+        continue;
+      }
+      done.push_back(std::make_pair(std::move(running->second), *it));
+      _running.erase(running);
+    }
+
+    // Slots were released, reserve them for waiting commands.
+    while (!_waiting.empty() && _has_free_slot()) {
+      ready.push_back(std::move(_waiting.front()));
+      _waiting.pop_front();
+      ++_starting;
+    }
+  }
+
+  // Callbacks are released as soon as they were called, so that the
+  // completions they hold are called in order.
+  while (!done.empty()) {
+    std::pair<callback, result> completed(std::move(done.front()));
+    done.pop_front();
+    try {
+      completed.first(completed.second);
+    }
+    catch (std::exception const& e) {
+      logger(log_runtime_error, basic)
+        << "Error: system command callback failed: " << e.what();
+    }
+  }
+
+  // Then start waiting commands in the slots reserved for them.
+  while (!ready.empty()) {
+    job j(std::move(ready.front()));
+    ready.pop_front();
+    _start(j.cmd, *j.macros, j.timeout, j.cb, j.started);
+  }
+}
+
+/**
+ *  Run a command asynchronously. Its callback is called by reap() once
+ *  the command finished, timed out or could not be started.
+ *
+ *  @param[in] cmd      Processed command line.
+ *  @param[in] macros   Macros of the command, copied if the command
+ *                      has to wait for a free slot.
+ *  @param[in] timeout  Command timeout in seconds.
+ *  @param[in] cb       Completion callback.
+ *  @param[in] started  Called when the command is actually started,
+ *                      once it got a free slot.
+ */
+void system_runner::run(
+                      std::string const& cmd,
+                      nagios_macros& macros,
+                      unsigned int timeout,
+                      callback const& cb,
+                      start_callback const& started) {
+  bool full(false);
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_waiting.empty() && _has_free_slot())
+      ++_starting;
+    else {
+      unsigned int max(config->max_queued_system_commands());
+      if (!max || (_waiting.size() < max)) {
+        logger(dbg_commands, more)
+          << "Too many running system commands, command '" << cmd
+          << "' is queued";
+        job j;
+        j.cb = cb;
+        j.cmd = cmd;
+        j.macros.reset(new nagios_macros(macros));
+        j.started = started;
+        j.timeout = timeout;
+        _waiting.push_back(std::move(j));
+        return;
+      }
+
+      full = true;
+    }
+  }
+
+  if (!full)
+    _start(cmd, macros, timeout, cb, started);
+  else {
+    // The queue is full, the command fails as soon as it is started.
+    logger(log_runtime_warning, basic)
+      << "Warning: too many system commands waiting, command '"
+      << cmd << "' is not run";
+    notify_started(started);
+    std::lock_guard<std::mutex> lock(_lock);
+    _fail(cb, "too many system commands waiting");
+  }
+}
+
+/**
+ *  Get the number of running commands.
+ *
+ *  @return Number of commands started and not reaped yet.
+ */
+unsigned int system_runner::running() const {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _running.size();
+}
+
+/**
+ *  Get the number of commands waiting for a free slot.
+ *
+ *  @return Number of waiting commands.
+ */
+unsigned int system_runner::waiting() const {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _waiting.size();
+}
+
+/**
+ *  Default constructor.
+ */
+system_runner::system_runner()
+  : _raw("system", "system", this), _starting(0) {}
+
+/**
+ *  Destructor.
+ */
+system_runner::~system_runner() throw () {}
+
+/**
+ *  Receive the result of a command, from the process thread.
+ *
+ *  @param[in] res  Command result.
+ */
+void system_runner::finished(result const& res) throw () {
+  try {
+    {
+      std::lock_guard<std::mutex> lock(_results_lock);
+      _results.push_back(res);
+    }
+    _results_cv.notify_all();
+    events::loop::wakeup(events::loop::wakeup_system_command);
+  }
+  catch (...) {}
+}
+
+/**
+ *  Complete a command that could not be run with an error, from the
+ *  next reap(). _lock must be held.
+ *
+ *  @param[in] cb     Completion callback.
+ *  @param[in] error  Error message, used as output.
+ */
+void system_runner::_fail(callback const& cb, std::string const& error) {
+  result res;
+  res.start_time = timestamp::now();
+  res.end_time = res.start_time;
+  res.exit_code = service::state_unknown;
+  res.exit_status = process::crash;
+  res.output = error;
+  _failed.push_back(std::make_pair(cb, res));
+  events::loop::wakeup(events::loop::wakeup_system_command);
+}
+
+/**
+ *  Check if a command can be started. _lock must be held.
+ *
+ *  @return True if less than max_concurrent_system_commands commands
+ *          are running or starting.
+ */
+bool system_runner::_has_free_slot() const {
+  unsigned int max(config->max_concurrent_system_commands());
+  return !max || _running.size() + _starting < max;
+}
+
+/**
+ *  Start a command whose slot was reserved. The start callback is
+ *  called without _lock, which is then held while the command is run,
+ *  so that its result cannot be reaped before its callback is
+ *  registered.
+ *
+ *  @param[in] cmd      Processed command line.
+ *  @param[in] macros   Macros of the command.
+ *  @param[in] timeout  Command timeout in seconds.
+ *  @param[in] cb       Completion callback.
+ *  @param[in] started  Start callback, may be empty.
+ */
+void system_runner::_start(
+                      std::string const& cmd,
+                      nagios_macros& macros,
+                      unsigned int timeout,
+                      callback const& cb,
+                      start_callback const& started) {
+  notify_started(started);
+  std::lock_guard<std::mutex> lock(_lock);
+  --_starting;
+  try {
+    unsigned long command_id(_raw.run(cmd, macros, timeout));
+    _running[command_id] = cb;
+  }
+  catch (std::exception const& e) {
+    logger(log_runtime_error, basic)
+      << "Error: can't execute system command '" << cmd << "' : "
+      << e.what();
+    _fail(cb, e.what());
+  }
+}
@@ -22,6 +22,7 @@
 #include "com/centreon/engine/checks/checker.hh"
 #include "com/centreon/engine/commands/connector.hh"
 #include "com/centreon/engine/commands/forward.hh"
+#include "com/centreon/engine/commands/plugin.hh"
 #include "com/centreon/engine/commands/raw.hh"
 #include "com/centreon/engine/configuration/applier/command.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
@@ -55,9 +56,18 @@ void applier::command::add_object(configuration::command const& obj) {
   // Add command to the global configuration set.
   config->commands().insert(obj);
 
-  if (obj.connector().empty()) {
+  if (!obj.plugin().empty()) {
+    std::shared_ptr<commands::plugin> plugin{
+      new commands::plugin(obj.command_name(), obj.command_line(), obj.plugin(), &checks::checker::instance())};
+    commands::command::commands[plugin->get_name()] = plugin;
+  }
+  else if (obj.connector().empty()) {
     std::shared_ptr<commands::raw> raw{
       new commands::raw(obj.command_name(), obj.command_line(), &checks::checker::instance())};
+    if (obj.launcher() == "fork")
+      raw->set_launcher(commands::raw::launcher_fork);
+    else if (obj.launcher() == "spawn")
+      raw->set_launcher(commands::raw::launcher_spawn);
     commands::command::commands[raw->get_name()] = raw;
   }
   else {
@@ -124,9 +134,18 @@ void applier::command::modify_object(
   // not create dangling pointers since commands::command object are
   // not referenced anywhere, only ::command objects are.
   commands::command::commands.erase(obj.command_name());
-  if (obj.connector().empty()) {
+  if (!obj.plugin().empty()) {
+    std::shared_ptr<commands::plugin> plugin{
+      new commands::plugin(obj.command_name(), obj.command_line(), obj.plugin(), &checks::checker::instance())};
+    commands::command::commands[plugin->get_name()] = plugin;
+  }
+  else if (obj.connector().empty()) {
     std::shared_ptr<commands::raw> raw{
       new commands::raw(obj.command_name(), obj.command_line(), &checks::checker::instance())};
+    if (obj.launcher() == "fork")
+      raw->set_launcher(commands::raw::launcher_fork);
+    else if (obj.launcher() == "spawn")
+      raw->set_launcher(commands::raw::launcher_spawn);
     commands::command::commands[raw->get_name()] = raw;
   }
   else {
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/checks/host_cache.hh"
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/config.hh"
 #include "com/centreon/engine/configuration/applier/host.hh"
@@ -136,6 +137,10 @@ void applier::host::add_object(
   h->set_acknowledgement_timeout(obj.get_acknowledgement_timeout() *
                                  config->interval_length());
   h->set_last_acknowledgement(0);
+  if (obj.have_cached_check_horizon())
+    checks::host_cache::instance().set_horizon(
+      obj.host_id(),
+      obj.cached_check_horizon());
 
   // Contacts
   for (set_string::const_iterator
@@ -352,6 +357,12 @@ void applier::host::modify_object(
   it_obj->second->set_acknowledgement_timeout(obj.get_acknowledgement_timeout() *
                                  config->interval_length());
   it_obj->second->set_recovery_notification_delay(obj.recovery_notification_delay());
+  if (obj.have_cached_check_horizon())
+    checks::host_cache::instance().set_horizon(
+      obj.host_id(),
+      obj.cached_check_horizon());
+  else
+    checks::host_cache::instance().unset_horizon(obj.host_id());
 
   // Contacts.
   if (obj.contacts() != obj_old.contacts()) {
@@ -495,6 +506,9 @@ void applier::host::remove_object(configuration::host const& obj) {
       MODATTR_ALL,
       &tv);
 
+    // Forget the cache horizon of the host.
+    checks::host_cache::instance().forget(obj.host_id());
+
     // Erase host object (will effectively delete the object).
     engine::host::hosts.erase(it->second->get_name());
     engine::host::hosts_by_id.erase(it);
@@ -516,14 +530,17 @@ void applier::host::resolve_object(
     << "Resolving host '" << obj.host_name() << "'.";
 
   // If it is the very first host to be resolved,
-  // remove all the child backlinks of all the hosts.
+  // remove all the child and dependent backlinks of all the hosts.
   // It is necessary to do it only once to prevent the removal
-  // of valid child backlinks.
+  // of valid backlinks. Dependent backlinks are added back when host
+  // dependencies are resolved.
   if (obj == *config->hosts().begin()) {
     for (host_map::iterator
          it(engine::host::hosts.begin()),
-         end(engine::host::hosts.end()); it != end; ++it)
+         end(engine::host::hosts.end()); it != end; ++it) {
       it->second->child_hosts.clear();
+      it->second->dependent_hosts.clear();
+    }
   }
 
   // Find host.
@@ -28,6 +28,7 @@
 #include "com/centreon/engine/deleter/timedevent.hh"
 #include "com/centreon/engine/error.hh"
 #include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/load_leveler.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/statusdata.hh"
@@ -245,12 +246,10 @@ applier::scheduler::scheduler()
     _evt_hfreshness_check(NULL),
     _evt_host_perfdata(NULL),
     _evt_orphan_check(NULL),
-    _evt_reschedule_checks(NULL),
     _evt_retention_save(NULL),
     _evt_sfreshness_check(NULL),
     _evt_service_perfdata(NULL),
     _evt_status_save(NULL),
-    _old_auto_rescheduling_interval(0),
     _old_check_reaper_interval(0),
     _old_command_check_interval(0),
     _old_host_freshness_check_interval(0),
@@ -348,22 +347,6 @@ void applier::scheduler::_apply_misc_event() {
                             DEFAULT_ORPHAN_CHECK_INTERVAL);
   }
 
-  // Remove and add a host and service check rescheduling event.
-  if ((!_evt_reschedule_checks && _config->auto_reschedule_checks())
-      || (_evt_reschedule_checks && !_config->auto_reschedule_checks())
-      || (_old_auto_rescheduling_interval
-          != _config->auto_rescheduling_interval())) {
-    _remove_misc_event(_evt_reschedule_checks);
-    if (_config->auto_reschedule_checks())
-      _evt_reschedule_checks
-        = _create_misc_event(
-            EVENT_RESCHEDULE_CHECKS,
-            now + _config->auto_rescheduling_interval(),
-            _config->auto_rescheduling_interval());
-    _old_auto_rescheduling_interval
-      = _config->auto_rescheduling_interval();
-  }
-
   // Remove and add a retention data save event if needed.
   if ((!_evt_retention_save && _config->retain_state_information())
       || (_evt_retention_save && !_config->retain_state_information())
@@ -943,13 +926,26 @@ void applier::scheduler::_schedule_host_events(
     ++mult_factor;
   }
 
-  // Need to optimize add_event insert.
-  std::multimap<time_t, com::centreon::engine::host*> hosts_to_schedule;
+  // Collect host check events, they are added to the event list at
+  // once.
+  std::vector<timed_event*> events;
+  events.reserve(end);
 
   // add scheduled host checks to event queue.
   for (unsigned int i(0); i < end; ++i) {
     com::centreon::engine::host& hst(*hosts[i]);
 
+    // account the check load, regular checks can be postponed to a
+    // less loaded second.
+    if (hst.get_should_be_scheduled())
+      hst.set_next_check(events::load_leveler::instance().place(
+                           &hst,
+                           hst.get_next_check(),
+                           (hst.get_check_options()
+                            & CHECK_OPTION_FORCE_EXECUTION)
+                           ? 0
+                           : events::load_leveler::max_delay(hst)));
+
     // update status of all hosts (scheduled or not).
     hst.update_status(false);
 
@@ -962,29 +958,22 @@ void applier::scheduler::_schedule_host_events(
             && (hst.get_check_options() & CHECK_OPTION_FORCE_EXECUTION)))
         continue;
     }
-    hosts_to_schedule.insert(std::make_pair(hst.get_next_check(), &hst));
+
+    // Create a new host check event.
+    events.push_back(new timed_event(
+                           EVENT_HOST_CHECK,
+                           hst.get_next_check(),
+                           false,
+                           0,
+                           nullptr,
+                           true,
+                           (void*)&hst,
+                           NULL,
+                           hst.get_check_options()));
   }
 
   // Schedule events list.
-  for (std::multimap<time_t, com::centreon::engine::host*>::const_iterator
-         it(hosts_to_schedule.begin()), end(hosts_to_schedule.end());
-       it != end;
-       ++it) {
-    com::centreon::engine::host& hst(*it->second);
-
-    // Schedule a new host check event.
-    timed_event* evt = new timed_event(
-              EVENT_HOST_CHECK,
-              hst.get_next_check(),
-              false,
-              0,
-              nullptr,
-              true,
-              (void*)&hst,
-              NULL,
-              hst.get_check_options());
-    evt->schedule(false);
-  }
+  add_events(events, timed_event::low);
 
   // Schedule acknowledgement expirations.
   logger(dbg_events, most)
@@ -1065,13 +1054,26 @@ void applier::scheduler::_schedule_service_events(
     }
   }
 
-  // Need to optimize add_event insert.
-  std::multimap<time_t, engine::service*> services_to_schedule;
+  // Collect service check events, they are added to the event list at
+  // once.
+  std::vector<timed_event*> events;
+  events.reserve(end);
 
   // add scheduled service checks to event queue.
   for (unsigned int i(0); i < end; ++i) {
     engine::service& svc(*services[i]);
 
+    // account the check load, regular checks can be postponed to a
+    // less loaded second.
+    if (svc.get_should_be_scheduled())
+      svc.set_next_check(events::load_leveler::instance().place(
+                           &svc,
+                           svc.get_next_check(),
+                           (svc.get_check_options()
+                            & CHECK_OPTION_FORCE_EXECUTION)
+                           ? 0
+                           : events::load_leveler::max_delay(svc)));
+
     // update status of all services (scheduled or not).
     svc.update_status(false);
 
@@ -1084,30 +1086,23 @@ void applier::scheduler::_schedule_service_events(
             && (svc.get_check_options() & CHECK_OPTION_FORCE_EXECUTION)))
         continue;
     }
-    services_to_schedule.insert(std::make_pair(svc.get_next_check(), &svc));
-  }
 
-  // Schedule events list.
-  for (std::multimap<time_t, engine::service*>::const_iterator
-         it(services_to_schedule.begin()),
-         end(services_to_schedule.end());
-       it != end;
-       ++it) {
-    engine::service& svc(*it->second);
     // Create a new service check event.
-    timed_event* evt(new timed_event(
-              EVENT_SERVICE_CHECK,
-              svc.get_next_check(),
-              false,
-              0,
-              nullptr,
-              true,
-              (void*)&svc,
-              nullptr,
-              svc.get_check_options()));
-    evt->schedule(false);
+    events.push_back(new timed_event(
+                           EVENT_SERVICE_CHECK,
+                           svc.get_next_check(),
+                           false,
+                           0,
+                           nullptr,
+                           true,
+                           (void*)&svc,
+                           nullptr,
+                           svc.get_check_options()));
   }
 
+  // Schedule events list.
+  add_events(events, timed_event::low);
+
   // Schedule acknowledgement expirations.
   logger(dbg_events, most)
     << "Scheduling service acknowledgement expirations...";
@@ -1130,6 +1125,7 @@ void applier::scheduler::_unschedule_host_events(
          end(hosts.end());
        it != end;
        ++it) {
+    events::load_leveler::instance().forget(*it);
     timed_event* evt(NULL);
     while ((evt = timed_event::find_event(timed_event::low,
                                           EVENT_HOST_CHECK,
@@ -1159,6 +1155,7 @@ void applier::scheduler::_unschedule_service_events(
          end(services.end());
        it != end;
        ++it) {
+    events::load_leveler::instance().forget(*it);
     timed_event* evt(NULL);
     while ((evt = timed_event::find_event(timed_event::low,
                                           EVENT_SERVICE_CHECK,
@@ -21,10 +21,13 @@
 #include <unistd.h>
 #include <array>
 #include <cassert>
+#include <chrono>
 #include <unordered_map>
 #include "com/centreon/concurrency/locker.hh"
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/commands/connector.hh"
+#include "com/centreon/engine/commands/environment_cache.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/config.hh"
 #include "com/centreon/engine/configuration/applier/command.hh"
 #include "com/centreon/engine/configuration/applier/connector.hh"
@@ -63,6 +66,42 @@ using namespace com::centreon::engine::logging;
 static bool            has_already_been_loaded(false);
 static applier::state* _instance(nullptr);
 
+/**
+ *  Differences between the current configuration and a new one.
+ */
+struct applier::state::delta {
+  std::unique_ptr<configuration::state>
+                         cfg;
+  std::unique_ptr<configuration::state>
+                         save;
+  difference<set_command>
+                         commands;
+  difference<set_connector>
+                         connectors;
+  difference<set_contactgroup>
+                         contactgroups;
+  difference<set_contact>
+                         contacts;
+  difference<set_hostdependency>
+                         hostdependencies;
+  difference<set_hostescalation>
+                         hostescalations;
+  difference<set_hostgroup>
+                         hostgroups;
+  difference<set_host>   hosts;
+  difference<set_servicedependency>
+                         servicedependencies;
+  difference<set_serviceescalation>
+                         serviceescalations;
+  difference<set_servicegroup>
+                         servicegroups;
+  difference<set_service>
+                         services;
+  difference<set_timeperiod>
+                         timeperiods;
+  struct timeval         tv[5];
+};
+
 /**
  *  Apply new configuration.
  *
@@ -127,6 +166,47 @@ void applier::state::apply(
   }
 }
 
+/**
+ *  Apply the configuration prepared by prepare(), if any. This must
+ *  be called from the events loop thread, which is stopped while the
+ *  differences are applied.
+ *
+ *  @return True if a prepared configuration was applied.
+ */
+bool applier::state::apply_prepared() {
+  std::unique_ptr<delta> d;
+  {
+    std::lock_guard<std::mutex> locker(_prepared_lock);
+    d.swap(_prepared);
+  }
+  if (!d)
+    return false;
+
+  std::chrono::steady_clock::time_point
+    start(std::chrono::steady_clock::now());
+  try {
+    _processing_state = state_ready;
+    _commit(*d->cfg, *d, nullptr);
+  }
+  catch (std::exception const& e) {
+    logger(log_config_error, basic)
+      << "Error: Could not apply new configuration: " << e.what();
+
+    // Check if we need to restore old configuration.
+    if (_processing_state == state_error) {
+      logger(dbg_config, more)
+        << "configuration: try to restore old configuration";
+      _processing(*d->save);
+    }
+  }
+  _stop_the_world_time = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start).count();
+  logger(log_info_message, basic)
+    << "Configuration applied, events loop stopped for "
+    << _stop_the_world_time << " s";
+  return true;
+}
+
 /**
  *  Get the singleton instance of state applier.
  *
@@ -146,6 +226,42 @@ void applier::state::load() {
   }
 }
 
+/**
+ *  Prepare a configuration reload. The new configuration is expanded
+ *  and its differences with the current configuration are computed.
+ *  The events loop is not stopped, the prepared configuration being
+ *  applied later by apply_prepared(). A configuration already
+ *  prepared but not applied yet is replaced.
+ *
+ *  The current configuration is modified by the events loop (external
+ *  commands for example), it is therefore copied under the apply lock
+ *  and the differences are computed against this copy.
+ *
+ *  @param[in] new_cfg  The new configuration.
+ */
+void applier::state::prepare(
+       std::unique_ptr<configuration::state> new_cfg) {
+  std::unique_ptr<delta> d(new delta);
+  {
+    std::lock_guard<std::mutex> locker(_apply_lock);
+    d->save.reset(new configuration::state(*config));
+  }
+  _prepare(*new_cfg, *d->save, *d);
+  d->cfg = std::move(new_cfg);
+  std::lock_guard<std::mutex> locker(_prepared_lock);
+  _prepared = std::move(d);
+}
+
+/**
+ *  Get the time the events loop was stopped by the last configuration
+ *  applied by apply_prepared().
+ *
+ *  @return Duration in seconds.
+ */
+double applier::state::stop_the_world_time() const throw () {
+  return _stop_the_world_time;
+}
+
 /**
  *  Unload state applier singleton.
  */
@@ -159,7 +275,8 @@ void applier::state::unload() {
  */
 applier::state::state()
   : _config(nullptr),
-    _processing_state(state_ready) {
+    _processing_state(state_ready),
+    _stop_the_world_time(0.0) {
   applier::logging::load();
   applier::globals::load();
   applier::macros::load();
@@ -170,6 +287,10 @@ applier::state::state()
  *  Destructor.
  */
 applier::state::~state() throw() {
+  try {
+    commands::system_runner::instance().drain();
+  }
+  catch (...) {}
   engine::contact::contacts.clear();
   engine::contactgroup::contactgroups.clear();
   engine::servicegroup::servicegroups.clear();
@@ -187,6 +308,7 @@ applier::state::~state() throw() {
   engine::timeperiod::timeperiods.clear();
   engine::comment::comments.clear();
   engine::comment::set_next_comment_id(1llu);
+  engine::commands::environment_cache::instance().invalidate();
 
   xpddefault_cleanup_performance_data();
   applier::scheduler::unload();
@@ -314,12 +436,17 @@ void applier::state::_apply(configuration::state const& new_cfg) {
   config->check_host_freshness(new_cfg.check_host_freshness());
   config->check_orphaned_hosts(new_cfg.check_orphaned_hosts());
   config->check_orphaned_services(new_cfg.check_orphaned_services());
+  config->check_plugin_threads(new_cfg.check_plugin_threads());
+  config->check_reaper_budget(new_cfg.check_reaper_budget());
   config->check_reaper_interval(new_cfg.check_reaper_interval());
   if (config->check_result_path() != new_cfg.check_result_path())
     config->check_result_path(new_cfg.check_result_path());
+  config->check_result_workers(new_cfg.check_result_workers());
   config->check_service_freshness(new_cfg.check_service_freshness());
   config->command_check_interval(new_cfg.command_check_interval(),
                                  new_cfg.command_check_interval_is_seconds());
+  config->command_launcher(new_cfg.command_launcher());
+  config->connector_instances(new_cfg.connector_instances());
   config->date_format(new_cfg.date_format());
   config->debug_file(new_cfg.debug_file());
   config->debug_level(new_cfg.debug_level());
@@ -330,8 +457,12 @@ void applier::state::_apply(configuration::state const& new_cfg) {
   config->enable_notifications(new_cfg.enable_notifications());
   config->enable_predictive_host_dependency_checks(new_cfg.enable_predictive_host_dependency_checks());
   config->enable_predictive_service_dependency_checks(new_cfg.enable_predictive_service_dependency_checks());
+  config->environment_macros_mode(new_cfg.environment_macros_mode());
+  config->event_batch_size(new_cfg.event_batch_size());
+  config->event_batch_time(new_cfg.event_batch_time());
   config->event_broker_options(new_cfg.event_broker_options());
   config->event_handler_timeout(new_cfg.event_handler_timeout());
+  config->event_scheduler(new_cfg.event_scheduler());
   config->execute_host_checks(new_cfg.execute_host_checks());
   config->execute_service_checks(new_cfg.execute_service_checks());
   config->global_host_event_handler(new_cfg.global_host_event_handler());
@@ -362,10 +493,14 @@ void applier::state::_apply(configuration::state const& new_cfg) {
   config->max_check_reaper_time(new_cfg.max_check_reaper_time());
   if (config->max_check_result_file_age() != new_cfg.max_check_result_file_age())
     config->max_check_result_file_age(new_cfg.max_check_result_file_age());
+  config->max_concurrent_system_commands(new_cfg.max_concurrent_system_commands());
   config->max_debug_file_size(new_cfg.max_debug_file_size());
   config->max_host_check_spread(new_cfg.max_host_check_spread());
   config->max_log_file_size(new_cfg.max_log_file_size());
+  config->max_parallel_checks_per_command(new_cfg.max_parallel_checks_per_command());
+  config->max_parallel_checks_per_host(new_cfg.max_parallel_checks_per_host());
   config->max_parallel_service_checks(new_cfg.max_parallel_service_checks());
+  config->max_queued_system_commands(new_cfg.max_queued_system_commands());
   config->max_service_check_spread(new_cfg.max_service_check_spread());
   config->notification_timeout(new_cfg.notification_timeout());
   config->obsess_over_hosts(new_cfg.obsess_over_hosts());
@@ -412,6 +547,7 @@ void applier::state::_apply(configuration::state const& new_cfg) {
   config->use_syslog(new_cfg.use_syslog());
   config->use_true_regexp_matching(new_cfg.use_true_regexp_matching());
   config->user(new_cfg.user());
+  config->watch_check_result_path(new_cfg.watch_check_result_path());
 
   // Set this variable just the first time.
   if (!has_already_been_loaded) {
@@ -981,183 +1117,17 @@ void applier::state::_apply(
 }
 
 /**
- *  Expand objects.
- *
- *  @param[in,out] new_state New configuration state.
- *  @param[in,out] cfg       Configuration objects.
- */
-template <typename ConfigurationType, typename ApplierType>
-void applier::state::_expand(configuration::state& new_state) {
-  ApplierType aplyr;
-  try {
-    aplyr.expand_objects(new_state);
-  }
-  catch (std::exception const& e) {
-    if (verify_config) {
-      ++config_errors;
-      logger(log_info_message, basic) << e.what();
-    }
-    else
-      throw ;
-  }
-}
-
-/**
- *  Process new configuration and apply it.
+ *  Apply the differences between the current configuration and a new
+ *  one.
  *
- *  @param[in] new_cfg        The new configuration.
- *  @param[in] state          The retention to use.
+ *  @param[in] new_cfg  The new configuration.
+ *  @param[in] d        Differences computed by _prepare().
+ *  @param[in] state    The retention to use.
  */
-void applier::state::_processing(
+void applier::state::_commit(
        configuration::state& new_cfg,
+       delta& d,
        retention::state* state) {
-  // Timing.
-  struct timeval tv[5];
-
-  // Call prelauch broker event the first time to run applier state.
-  if (!has_already_been_loaded)
-    broker_program_state(
-      NEBTYPE_PROCESS_PRELAUNCH,
-      NEBFLAG_NONE,
-      NEBATTR_NONE,
-      nullptr);
-
-  //
-  // Expand all objects.
-  //
-  gettimeofday(tv, nullptr);
-
-  // Expand timeperiods.
-  _expand<configuration::timeperiod, applier::timeperiod>(new_cfg);
-
-  // Expand connectors.
-  _expand<configuration::connector, applier::connector>(new_cfg);
-
-  // Expand commands.
-  _expand<configuration::command, applier::command>(new_cfg);
-
-  // Expand contacts.
-  _expand<configuration::contact, applier::contact>(new_cfg);
-
-  // Expand contactgroups.
-  _expand<configuration::contactgroup, applier::contactgroup>(new_cfg);
-
-  // Expand hosts.
-  _expand<configuration::host, applier::host>(new_cfg);
-
-  // Expand hostgroups.
-  _expand<configuration::hostgroup, applier::hostgroup>(
-    new_cfg);
-
-  // Expand services.
-  _expand<configuration::service, applier::service>(
-    new_cfg);
-
-  // Expand servicegroups.
-  _expand<configuration::servicegroup, applier::servicegroup>(
-    new_cfg);
-
-  // Expand hostdependencies.
-  _expand<configuration::hostdependency, applier::hostdependency>(
-    new_cfg);
-
-  // Expand servicedependencies.
-  _expand<configuration::servicedependency, applier::servicedependency>(
-    new_cfg);
-
-  // Expand hostescalations.
-  _expand<configuration::hostescalation, applier::hostescalation>(
-    new_cfg);
-
-  // Expand serviceescalations.
-  _expand<configuration::serviceescalation, applier::serviceescalation>(
-    new_cfg);
-
-  //
-  //  Build difference for all objects.
-  //
-
-  // Build difference for timeperiods.
-  difference<set_timeperiod> diff_timeperiods;
-  diff_timeperiods.parse(
-    config->timeperiods(),
-    new_cfg.timeperiods());
-
-  // Build difference for connectors.
-  difference<set_connector> diff_connectors;
-  diff_connectors.parse(
-    config->connectors(),
-    new_cfg.connectors());
-
-  // Build difference for commands.
-  difference<set_command> diff_commands;
-  diff_commands.parse(
-    config->commands(),
-    new_cfg.commands());
-
-  // Build difference for contacts.
-  difference<set_contact> diff_contacts;
-  diff_contacts.parse(
-    config->contacts(),
-    new_cfg.contacts());
-
-  // Build difference for contactgroups.
-  difference<set_contactgroup> diff_contactgroups;
-  diff_contactgroups.parse(
-    config->contactgroups(),
-    new_cfg.contactgroups());
-
-  // Build difference for hosts.
-  difference<set_host> diff_hosts;
-  diff_hosts.parse(
-    config->hosts(),
-    new_cfg.hosts());
-
-  // Build difference for hostgroups.
-  difference<set_hostgroup> diff_hostgroups;
-  diff_hostgroups.parse(
-    config->hostgroups(),
-    new_cfg.hostgroups());
-
-  // Build difference for services.
-  difference<set_service> diff_services;
-  diff_services.parse(
-    config->services(),
-    new_cfg.services());
-
-  // Build difference for servicegroups.
-  difference<set_servicegroup> diff_servicegroups;
-  diff_servicegroups.parse(
-    config->servicegroups(),
-    new_cfg.servicegroups());
-
-  // Build difference for hostdependencies.
-  difference<set_hostdependency> diff_hostdependencies;
-  diff_hostdependencies.parse(
-    config->hostdependencies(),
-    new_cfg.hostdependencies());
-
-  // Build difference for servicedependencies.
-  difference<set_servicedependency> diff_servicedependencies;
-  diff_servicedependencies.parse(
-    config->servicedependencies(),
-    new_cfg.servicedependencies());
-
-  // Build difference for hostescalations.
-  difference<set_hostescalation> diff_hostescalations;
-  diff_hostescalations.parse(
-    config->hostescalations(),
-    new_cfg.hostescalations());
-
-  // Build difference for serviceescalations.
-  difference<set_serviceescalation> diff_serviceescalations;
-  diff_serviceescalations.parse(
-    config->serviceescalations(),
-    new_cfg.serviceescalations());
-
-  // Timing.
-  gettimeofday(tv + 1, nullptr);
-
   try {
     std::lock_guard<std::mutex> locker(_apply_lock);
 
@@ -1171,7 +1141,7 @@ void applier::state::_processing(
     applier::macros::instance().apply(new_cfg);
 
     // Timing.
-    gettimeofday(tv + 2, nullptr);
+    gettimeofday(d.tv + 2, nullptr);
 
     if (!has_already_been_loaded
         && !verify_config
@@ -1195,27 +1165,27 @@ void applier::state::_processing(
 
     // Apply timeperiods.
     _apply<configuration::timeperiod, applier::timeperiod>(
-      diff_timeperiods);
+      d.timeperiods);
     _resolve<configuration::timeperiod, applier::timeperiod>(
       config->timeperiods());
 
     // Apply connectors.
     _apply<configuration::connector, applier::connector>(
-      diff_connectors);
+      d.connectors);
     _resolve<configuration::connector, applier::connector>(
       config->connectors());
 
     // Apply commands.
     _apply<configuration::command, applier::command>(
-      diff_commands);
+      d.commands);
     _resolve<configuration::command, applier::command>(
       config->commands());
 
     // Apply contacts and contactgroups.
     _apply<configuration::contact, applier::contact>(
-      diff_contacts);
+      d.contacts);
     _apply<configuration::contactgroup, applier::contactgroup>(
-      diff_contactgroups);
+      d.contactgroups);
     _resolve<configuration::contactgroup, applier::contactgroup>(
       config->contactgroups());
     _resolve<configuration::contact, applier::contact>(
@@ -1223,15 +1193,15 @@ void applier::state::_processing(
 
     // Apply hosts and hostgroups.
     _apply<configuration::host, applier::host>(
-      diff_hosts);
+      d.hosts);
     _apply<configuration::hostgroup, applier::hostgroup>(
-      diff_hostgroups);
+      d.hostgroups);
 
     // Apply services and servicegroups.
     _apply<configuration::service, applier::service>(
-      diff_services);
+      d.services);
     _apply<configuration::servicegroup, applier::servicegroup>(
-      diff_servicegroups);
+      d.servicegroups);
 
     // Resolve hosts, services, host groups and service groups.
     _resolve<configuration::host, applier::host>(
@@ -1245,25 +1215,25 @@ void applier::state::_processing(
 
     // Apply host dependencies.
     _apply<configuration::hostdependency, applier::hostdependency>(
-      diff_hostdependencies);
+      d.hostdependencies);
     _resolve<configuration::hostdependency, applier::hostdependency>(
       config->hostdependencies());
 
     // Apply service dependencies.
     _apply<configuration::servicedependency, applier::servicedependency>(
-      diff_servicedependencies);
+      d.servicedependencies);
     _resolve<configuration::servicedependency, applier::servicedependency>(
       config->servicedependencies());
 
     // Apply host escalations.
     _apply<configuration::hostescalation, applier::hostescalation>(
-      diff_hostescalations);
+      d.hostescalations);
     _resolve<configuration::hostescalation, applier::hostescalation>(
       config->hostescalations());
 
     // Apply service escalations.
     _apply<configuration::serviceescalation, applier::serviceescalation>(
-      diff_serviceescalations);
+      d.serviceescalations);
     _resolve<configuration::serviceescalation, applier::serviceescalation>(
       config->serviceescalations());
 
@@ -1288,8 +1258,8 @@ void applier::state::_processing(
     if (!verify_config)
       applier::scheduler::instance().apply(
         new_cfg,
-        diff_hosts,
-        diff_services);
+        d.hosts,
+        d.services);
 
     // Apply new global on the current state.
     if (!verify_config)
@@ -1306,7 +1276,7 @@ void applier::state::_processing(
     }
 
     // Timing.
-    gettimeofday(tv + 3, nullptr);
+    gettimeofday(d.tv + 3, nullptr);
 
     // Check for circular paths between hosts.
     pre_flight_circular_check(&config_warnings, &config_errors);
@@ -1327,8 +1297,8 @@ void applier::state::_processing(
     // Print initial states of new hosts and services.
     if (!verify_config && !test_scheduling) {
       for (set_host::iterator
-             it(diff_hosts.added().begin()),
-             end(diff_hosts.added().end());
+             it(d.hosts.added().begin()),
+             end(d.hosts.added().end());
            it != end;
            ++it) {
         host_id_map::const_iterator
@@ -1337,8 +1307,8 @@ void applier::state::_processing(
           log_host_state(INITIAL_STATES, hst->second.get());
       }
       for (set_service::iterator
-             it(diff_services.added().begin()),
-             end(diff_services.added().end());
+             it(d.services.added().begin()),
+             end(d.services.added().end());
            it != end;
            ++it) {
         service_id_map::const_iterator
@@ -1351,15 +1321,15 @@ void applier::state::_processing(
     }
 
     // Timing.
-    gettimeofday(tv + 4, nullptr);
+    gettimeofday(d.tv + 4, nullptr);
     if (test_scheduling) {
       double runtimes[5];
       runtimes[4] = 0.0;
       for (unsigned int i(0);
            i < (sizeof(runtimes) / sizeof(*runtimes) - 1);
            ++i) {
-        runtimes[i] = tv[i + 1].tv_sec - tv[i].tv_sec
-          + (tv[i + 1].tv_usec - tv[i].tv_usec) / 1000000.0;
+        runtimes[i] = d.tv[i + 1].tv_sec - d.tv[i].tv_sec
+          + (d.tv[i + 1].tv_usec - d.tv[i].tv_usec) / 1000000.0;
         runtimes[4] += runtimes[i];
       }
       logger(log_info_message, basic)
@@ -1378,13 +1348,197 @@ void applier::state::_processing(
   }
   catch (...) {
     _processing_state = state_error;
+    commands::environment_cache::instance().invalidate();
     throw;
   }
 
+  // Objects were modified, cached environments are outdated.
+  commands::environment_cache::instance().invalidate();
+
   has_already_been_loaded = true;
   _processing_state = state_ready;
 }
 
+/**
+ *  Expand objects.
+ *
+ *  @param[in,out] new_state New configuration state.
+ *  @param[in,out] cfg       Configuration objects.
+ */
+template <typename ConfigurationType, typename ApplierType>
+void applier::state::_expand(configuration::state& new_state) {
+  ApplierType aplyr;
+  try {
+    aplyr.expand_objects(new_state);
+  }
+  catch (std::exception const& e) {
+    if (verify_config) {
+      ++config_errors;
+      logger(log_info_message, basic) << e.what();
+    }
+    else
+      throw ;
+  }
+}
+
+/**
+ *  Expand a new configuration and compute its differences with the
+ *  current one. Engine objects are not modified.
+ *
+ *  @param[in]  new_cfg  The new configuration.
+ *  @param[in]  current  The current configuration.
+ *  @param[out] d        Differences.
+ */
+void applier::state::_prepare(
+       configuration::state& new_cfg,
+       configuration::state const& current,
+       delta& d) {
+  //
+  // Expand all objects.
+  //
+  gettimeofday(d.tv, nullptr);
+
+  // Expand timeperiods.
+  _expand<configuration::timeperiod, applier::timeperiod>(new_cfg);
+
+  // Expand connectors.
+  _expand<configuration::connector, applier::connector>(new_cfg);
+
+  // Expand commands.
+  _expand<configuration::command, applier::command>(new_cfg);
+
+  // Expand contacts.
+  _expand<configuration::contact, applier::contact>(new_cfg);
+
+  // Expand contactgroups.
+  _expand<configuration::contactgroup, applier::contactgroup>(new_cfg);
+
+  // Expand hosts.
+  _expand<configuration::host, applier::host>(new_cfg);
+
+  // Expand hostgroups.
+  _expand<configuration::hostgroup, applier::hostgroup>(
+    new_cfg);
+
+  // Expand services.
+  _expand<configuration::service, applier::service>(
+    new_cfg);
+
+  // Expand servicegroups.
+  _expand<configuration::servicegroup, applier::servicegroup>(
+    new_cfg);
+
+  // Expand hostdependencies.
+  _expand<configuration::hostdependency, applier::hostdependency>(
+    new_cfg);
+
+  // Expand servicedependencies.
+  _expand<configuration::servicedependency, applier::servicedependency>(
+    new_cfg);
+
+  // Expand hostescalations.
+  _expand<configuration::hostescalation, applier::hostescalation>(
+    new_cfg);
+
+  // Expand serviceescalations.
+  _expand<configuration::serviceescalation, applier::serviceescalation>(
+    new_cfg);
+
+  //
+  //  Build difference for all objects.
+  //
+
+  // Build difference for timeperiods.
+  d.timeperiods.parse(
+    current.timeperiods(),
+    new_cfg.timeperiods());
+
+  // Build difference for connectors.
+  d.connectors.parse(
+    current.connectors(),
+    new_cfg.connectors());
+
+  // Build difference for commands.
+  d.commands.parse(
+    current.commands(),
+    new_cfg.commands());
+
+  // Build difference for contacts.
+  d.contacts.parse(
+    current.contacts(),
+    new_cfg.contacts());
+
+  // Build difference for contactgroups.
+  d.contactgroups.parse(
+    current.contactgroups(),
+    new_cfg.contactgroups());
+
+  // Build difference for hosts.
+  d.hosts.parse(
+    current.hosts(),
+    new_cfg.hosts());
+
+  // Build difference for hostgroups.
+  d.hostgroups.parse(
+    current.hostgroups(),
+    new_cfg.hostgroups());
+
+  // Build difference for services.
+  d.services.parse(
+    current.services(),
+    new_cfg.services());
+
+  // Build difference for servicegroups.
+  d.servicegroups.parse(
+    current.servicegroups(),
+    new_cfg.servicegroups());
+
+  // Build difference for hostdependencies.
+  d.hostdependencies.parse(
+    current.hostdependencies(),
+    new_cfg.hostdependencies());
+
+  // Build difference for servicedependencies.
+  d.servicedependencies.parse(
+    current.servicedependencies(),
+    new_cfg.servicedependencies());
+
+  // Build difference for hostescalations.
+  d.hostescalations.parse(
+    current.hostescalations(),
+    new_cfg.hostescalations());
+
+  // Build difference for serviceescalations.
+  d.serviceescalations.parse(
+    current.serviceescalations(),
+    new_cfg.serviceescalations());
+
+  // Timing.
+  gettimeofday(d.tv + 1, nullptr);
+}
+
+/**
+ *  Process new configuration and apply it.
+ *
+ *  @param[in] new_cfg        The new configuration.
+ *  @param[in] state          The retention to use.
+ */
+void applier::state::_processing(
+       configuration::state& new_cfg,
+       retention::state* state) {
+  // Call prelauch broker event the first time to run applier state.
+  if (!has_already_been_loaded)
+    broker_program_state(
+      NEBTYPE_PROCESS_PRELAUNCH,
+      NEBFLAG_NONE,
+      NEBATTR_NONE,
+      nullptr);
+
+  delta d;
+  _prepare(new_cfg, *config, d);
+  _commit(new_cfg, d, state);
+}
+
 /**
  *  Resolve objects.
  *
@@ -30,7 +30,9 @@ using namespace com::centreon::engine::configuration;
 std::unordered_map<std::string, command::setter_func> const command::_setters{
   { "command_line", SETTER(std::string const&, _set_command_line) },
   { "command_name", SETTER(std::string const&, _set_command_name) },
-  { "connector",    SETTER(std::string const&, _set_connector) }
+  { "connector",    SETTER(std::string const&, _set_connector) },
+  { "launcher",     SETTER(std::string const&, _set_launcher) },
+  { "plugin",       SETTER(std::string const&, _set_plugin) }
 };
 
 /**
@@ -70,6 +72,8 @@ command& command::operator=(command const& right) {
     _command_line = right._command_line;
     _command_name = right._command_name;
     _connector = right._connector;
+    _launcher = right._launcher;
+    _plugin = right._plugin;
   }
   return (*this);
 }
@@ -85,7 +89,9 @@ bool command::operator==(command const& right) const throw () {
   return (object::operator==(right)
           && _command_line == right._command_line
           && _command_name == right._command_name
-          && _connector == right._connector);
+          && _connector == right._connector
+          && _launcher == right._launcher
+          && _plugin == right._plugin);
 }
 
 /**
@@ -124,6 +130,9 @@ void command::check_validity() const {
   if (_command_line.empty())
     throw (engine_error() << "Command '" << _command_name
            << "' has no command line (property 'command_line')");
+  if (!_plugin.empty() && !_connector.empty())
+    throw (engine_error() << "Command '" << _command_name
+           << "' cannot use both a plugin and a connector");
   return ;
 }
 
@@ -150,6 +159,8 @@ void command::merge(object const& obj) {
   MRG_DEFAULT(_command_line);
   MRG_DEFAULT(_command_name);
   MRG_DEFAULT(_connector);
+  MRG_DEFAULT(_launcher);
+  MRG_DEFAULT(_plugin);
 }
 
 /**
@@ -195,6 +206,25 @@ std::string const& command::connector() const throw () {
   return (_connector);
 }
 
+/**
+ *  Get launcher.
+ *
+ *  @return The launcher, empty for the default one.
+ */
+std::string const& command::launcher() const throw () {
+  return (_launcher);
+}
+
+/**
+ *  Get plugin.
+ *
+ *  @return The shared object of the in-process plugin, empty for
+ *          other commands.
+ */
+std::string const& command::plugin() const throw () {
+  return (_plugin);
+}
+
 /**
  *  Set command_line value.
  *
@@ -230,3 +260,29 @@ bool command::_set_connector(std::string const& value) {
   _connector = value;
   return (true);
 }
+
+/**
+ *  Set launcher value.
+ *
+ *  @param[in] value The new launcher value, 'fork' or 'spawn'.
+ *
+ *  @return True on success, otherwise false.
+ */
+bool command::_set_launcher(std::string const& value) {
+  if ((value != "fork") && (value != "spawn"))
+    return (false);
+  _launcher = value;
+  return (true);
+}
+
+/**
+ *  Set plugin value.
+ *
+ *  @param[in] value The new plugin value.
+ *
+ *  @return True on success, otherwise false.
+ */
+bool command::_set_plugin(std::string const& value) {
+  _plugin = value;
+  return (true);
+}
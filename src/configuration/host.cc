@@ -67,6 +67,7 @@ std::unordered_map<std::string, host::setter_func> const host::_setters{
   { "retry_check_interval",         SETTER(unsigned int, _set_retry_interval) },
   { "recovery_notification_delay",  SETTER(unsigned int, _set_recovery_notification_delay) },
   { "max_check_attempts",           SETTER(unsigned int, _set_max_check_attempts) },
+  { "cached_check_horizon",         SETTER(unsigned int, _set_cached_check_horizon) },
   { "checks_enabled",               SETTER(bool, _set_checks_active) },
   { "active_checks_enabled",        SETTER(bool, _set_checks_active) },
   { "passive_checks_enabled",       SETTER(bool, _set_checks_passive) },
@@ -180,6 +181,7 @@ host& host::operator=(host const& other) {
     _action_url = other._action_url;
     _address = other._address;
     _alias = other._alias;
+    _cached_check_horizon = other._cached_check_horizon;
     _checks_active = other._checks_active;
     _checks_passive = other._checks_passive;
     _check_command = other._check_command;
@@ -241,6 +243,7 @@ bool host::operator==(host const& other) const throw () {
           && _action_url == other._action_url
           && _address == other._address
           && _alias == other._alias
+          && _cached_check_horizon == other._cached_check_horizon
           && _checks_active == other._checks_active
           && _checks_passive == other._checks_passive
           && _check_command == other._check_command
@@ -320,6 +323,8 @@ bool host::operator<(host const& other) const throw () {
     return _address < other._address;
   else if (_alias != other._alias)
     return _alias < other._alias;
+  else if (_cached_check_horizon != other._cached_check_horizon)
+    return _cached_check_horizon < other._cached_check_horizon;
   else if (_checks_active != other._checks_active)
     return _checks_active < other._checks_active;
   else if (_checks_passive != other._checks_passive)
@@ -468,6 +473,7 @@ void host::merge(object const& obj) {
   MRG_DEFAULT(_action_url);
   MRG_DEFAULT(_address);
   MRG_DEFAULT(_alias);
+  MRG_OPTION(_cached_check_horizon);
   MRG_OPTION(_checks_active);
   MRG_OPTION(_checks_passive);
   MRG_DEFAULT(_check_command);
@@ -565,6 +571,15 @@ std::string const& host::alias() const throw () {
   return _alias;
 }
 
+/**
+ *  Get cached_check_horizon.
+ *
+ *  @return The cached_check_horizon.
+ */
+unsigned int host::cached_check_horizon() const throw () {
+  return _cached_check_horizon;
+}
+
 /**
  *  Get checks_active.
  *
@@ -736,6 +751,15 @@ unsigned int host::freshness_threshold() const throw () {
   return _freshness_threshold;
 }
 
+/**
+ *  Get if host has its own cached check horizon.
+ *
+ *  @return True if cached_check_horizon is set, otherwise false.
+ */
+bool host::have_cached_check_horizon() const throw () {
+  return _cached_check_horizon.is_set();
+}
+
 /**
  *  Get if host has coords 2d.
  *
@@ -1065,6 +1089,18 @@ bool host::_set_alias(std::string const& value) {
   return true;
 }
 
+/**
+ *  Set cached_check_horizon value.
+ *
+ *  @param[in] value The new cached_check_horizon value, in seconds.
+ *
+ *  @return True on success, otherwise false.
+ */
+bool host::_set_cached_check_horizon(unsigned int value) {
+  _cached_check_horizon = value;
+  return true;
+}
+
 /**
  *  Set checks_active value.
  *
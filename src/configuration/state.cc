@@ -58,13 +58,18 @@ std::unordered_map<std::string, state::setter_func> const state::_setters{
   { "check_for_orphaned_services",                 SETTER(bool, check_orphaned_services) },
   { "check_for_updates",                           SETTER(std::string const&, _set_check_for_updates) },
   { "check_host_freshness",                        SETTER(bool, check_host_freshness) },
+  { "check_plugin_threads",                        SETTER(unsigned int, check_plugin_threads) },
+  { "check_reaper_budget",                         SETTER(unsigned int, check_reaper_budget) },
   { "check_result_path",                           SETTER(std::string const&, _set_check_result_path) },
   { "check_result_reaper_frequency",               SETTER(unsigned int, check_reaper_interval) },
+  { "check_result_workers",                        SETTER(unsigned int, check_result_workers) },
   { "check_service_freshness",                     SETTER(bool, check_service_freshness) },
   { "child_processes_fork_twice",                  SETTER(std::string const&, _set_child_processes_fork_twice) },
   { "command_check_interval",                      SETTER(std::string const&, _set_command_check_interval) },
   { "command_file",                                SETTER(std::string const&, command_file) },
+  { "command_launcher",                            SETTER(std::string const&, _set_command_launcher) },
   { "comment_file",                                SETTER(std::string const&, _set_comment_file) },
+  { "connector_instances",                         SETTER(unsigned int, connector_instances) },
   { "daemon_dumps_core",                           SETTER(std::string const&, _set_daemon_dumps_core) },
   { "date_format",                                 SETTER(std::string const&, _set_date_format) },
   { "debug_file",                                  SETTER(std::string const&, debug_file) },
@@ -80,8 +85,12 @@ std::unordered_map<std::string, state::setter_func> const state::_setters{
   { "enable_notifications",                        SETTER(bool, enable_notifications) },
   { "enable_predictive_host_dependency_checks",    SETTER(bool, enable_predictive_host_dependency_checks) },
   { "enable_predictive_service_dependency_checks", SETTER(bool, enable_predictive_service_dependency_checks) },
+  { "environment_macros_mode",                     SETTER(std::string const&, _set_environment_macros_mode) },
+  { "event_batch_size",                            SETTER(unsigned int, event_batch_size) },
+  { "event_batch_time",                            SETTER(unsigned int, event_batch_time) },
   { "event_broker_options",                        SETTER(std::string const&, _set_event_broker_options) },
   { "event_handler_timeout",                       SETTER(unsigned int, event_handler_timeout) },
+  { "event_scheduler",                             SETTER(std::string const&, _set_event_scheduler) },
   { "execute_host_checks",                         SETTER(bool, execute_host_checks) },
   { "execute_service_checks",                      SETTER(bool, execute_service_checks) },
   { "external_command_buffer_slots",               SETTER(int, external_command_buffer_slots) },
@@ -120,9 +129,13 @@ std::unordered_map<std::string, state::setter_func> const state::_setters{
   { "max_check_result_file_age",                   SETTER(unsigned long, max_check_result_file_age) },
   { "max_check_result_reaper_time",                SETTER(unsigned int, max_check_reaper_time) },
   { "max_concurrent_checks",                       SETTER(unsigned int, max_parallel_service_checks) },
+  { "max_concurrent_system_commands",              SETTER(unsigned int, max_concurrent_system_commands) },
   { "max_debug_file_size",                         SETTER(unsigned long, max_debug_file_size) },
   { "max_host_check_spread",                       SETTER(unsigned int, max_host_check_spread) },
   { "max_log_file_size",                           SETTER(unsigned long, max_log_file_size) },
+  { "max_parallel_checks_per_command",             SETTER(unsigned int, max_parallel_checks_per_command) },
+  { "max_parallel_checks_per_host",                SETTER(unsigned int, max_parallel_checks_per_host) },
+  { "max_queued_system_commands",                  SETTER(unsigned int, max_queued_system_commands) },
   { "max_service_check_spread",                    SETTER(unsigned int, max_service_check_spread) },
   { "nagios_group",                                SETTER(std::string const&, _set_nagios_group) },
   { "nagios_user",                                 SETTER(std::string const&, _set_nagios_user) },
@@ -181,6 +194,7 @@ std::unordered_map<std::string, state::setter_func> const state::_setters{
   { "use_syslog",                                  SETTER(bool, use_syslog) },
   { "use_timezone",                                SETTER(std::string const&, use_timezone) },
   { "use_true_regexp_matching",                    SETTER(bool, use_true_regexp_matching) },
+  { "watch_check_result_path",                     SETTER(bool, watch_check_result_path) },
   { "xcddefault_comment_file",                     SETTER(std::string const&, _set_comment_file) },
   { "xdddefault_downtime_file",                    SETTER(std::string const&, _set_downtime_file) }
 };
@@ -202,11 +216,16 @@ static bool const                      default_check_external_commands(true);
 static bool const                      default_check_host_freshness(false);
 static bool const                      default_check_orphaned_hosts(true);
 static bool const                      default_check_orphaned_services(true);
+static unsigned int const              default_check_plugin_threads(4);
+static unsigned int const              default_check_reaper_budget(0);
 static unsigned int const              default_check_reaper_interval(10);
 static std::string const               default_check_result_path(DEFAULT_CHECK_RESULT_PATH);
+static unsigned int const              default_check_result_workers(0);
 static bool const                      default_check_service_freshness(true);
 static int const                       default_command_check_interval(-1);
 static std::string const               default_command_file(DEFAULT_COMMAND_FILE);
+static state::launcher_type const      default_command_launcher(state::launcher_fork);
+static unsigned int const              default_connector_instances(1);
 static state::date_type const          default_date_format(state::us);
 static std::string const               default_debug_file(DEFAULT_DEBUG_FILE);
 static unsigned long long const        default_debug_level(0);
@@ -218,8 +237,12 @@ static bool const                      default_enable_macros_filter(false);
 static bool const                      default_enable_notifications(true);
 static bool const                      default_enable_predictive_host_dependency_checks(true);
 static bool const                      default_enable_predictive_service_dependency_checks(true);
+static state::environment_macros_mode_type const default_environment_macros_mode(state::environment_macros_all);
+static unsigned int const              default_event_batch_size(1);
+static unsigned int const              default_event_batch_time(0);
 static unsigned long const             default_event_broker_options(std::numeric_limits<unsigned long>::max());
 static unsigned int const              default_event_handler_timeout(30);
+static state::event_scheduler_type const default_event_scheduler(state::scheduler_heap);
 static bool const                      default_execute_host_checks(true);
 static bool const                      default_execute_service_checks(true);
 static int const                       default_external_command_buffer_slots(4096);
@@ -248,10 +271,14 @@ static float const                     default_low_host_flap_threshold(20.0);
 static float const                     default_low_service_flap_threshold(20.0);
 static unsigned int const              default_max_check_reaper_time(30);
 static unsigned long const             default_max_check_result_file_age(3600);
+static unsigned int const              default_max_concurrent_system_commands(64);
 static unsigned long const             default_max_debug_file_size(1000000);
 static unsigned int const              default_max_host_check_spread(5);
 static unsigned long const             default_max_log_file_size(0);
+static unsigned int const              default_max_parallel_checks_per_command(0);
+static unsigned int const              default_max_parallel_checks_per_host(0);
 static unsigned int const              default_max_parallel_service_checks(0);
+static unsigned int const              default_max_queued_system_commands(10000);
 static unsigned int const              default_max_service_check_spread(5);
 static unsigned int const              default_notification_timeout(30);
 static bool const                      default_obsess_over_hosts(false);
@@ -294,6 +321,7 @@ static bool const                      default_use_setpgid(true);
 static bool const                      default_use_syslog(true);
 static std::string const               default_use_timezone("");
 static bool const                      default_use_true_regexp_matching(false);
+static bool const                      default_watch_check_result_path(false);
 
 /**
  *  Default constructor.
@@ -314,12 +342,17 @@ state::state()
     _check_host_freshness(default_check_host_freshness),
     _check_orphaned_hosts(default_check_orphaned_hosts),
     _check_orphaned_services(default_check_orphaned_services),
+    _check_plugin_threads(default_check_plugin_threads),
+    _check_reaper_budget(default_check_reaper_budget),
     _check_reaper_interval(default_check_reaper_interval),
     _check_result_path(default_check_result_path),
+    _check_result_workers(default_check_result_workers),
     _check_service_freshness(default_check_service_freshness),
     _command_check_interval(default_command_check_interval),
     _command_check_interval_is_seconds(false),
     _command_file(default_command_file),
+    _command_launcher(default_command_launcher),
+    _connector_instances(default_connector_instances),
     _date_format(default_date_format),
     _debug_file(default_debug_file),
     _debug_level(default_debug_level),
@@ -331,8 +364,12 @@ state::state()
     _enable_notifications(default_enable_notifications),
     _enable_predictive_host_dependency_checks(default_enable_predictive_host_dependency_checks),
     _enable_predictive_service_dependency_checks(default_enable_predictive_service_dependency_checks),
+    _environment_macros_mode(default_environment_macros_mode),
+    _event_batch_size(default_event_batch_size),
+    _event_batch_time(default_event_batch_time),
     _event_broker_options(default_event_broker_options),
     _event_handler_timeout(default_event_handler_timeout),
+    _event_scheduler(default_event_scheduler),
     _execute_host_checks(default_execute_host_checks),
     _execute_service_checks(default_execute_service_checks),
     _external_command_buffer_slots(default_external_command_buffer_slots),
@@ -361,10 +398,14 @@ state::state()
     _low_service_flap_threshold(default_low_service_flap_threshold),
     _max_check_reaper_time(default_max_check_reaper_time),
     _max_check_result_file_age(default_max_check_result_file_age),
+    _max_concurrent_system_commands(default_max_concurrent_system_commands),
     _max_debug_file_size(default_max_debug_file_size),
     _max_host_check_spread(default_max_host_check_spread),
     _max_log_file_size(default_max_log_file_size),
+    _max_parallel_checks_per_command(default_max_parallel_checks_per_command),
+    _max_parallel_checks_per_host(default_max_parallel_checks_per_host),
     _max_parallel_service_checks(default_max_parallel_service_checks),
+    _max_queued_system_commands(default_max_queued_system_commands),
     _max_service_check_spread(default_max_service_check_spread),
     _notification_timeout(default_notification_timeout),
     _obsess_over_hosts(default_obsess_over_hosts),
@@ -406,7 +447,8 @@ state::state()
     _use_setpgid(default_use_setpgid),
     _use_syslog(default_use_syslog),
     _use_timezone(default_use_timezone),
-    _use_true_regexp_matching(default_use_true_regexp_matching) {}
+    _use_true_regexp_matching(default_use_true_regexp_matching),
+    _watch_check_result_path(default_watch_check_result_path) {}
 
 /**
  *  Copy constructor.
@@ -447,13 +489,18 @@ state& state::operator=(state const& right) {
     _check_host_freshness = right._check_host_freshness;
     _check_orphaned_hosts = right._check_orphaned_hosts;
     _check_orphaned_services = right._check_orphaned_services;
+    _check_plugin_threads = right._check_plugin_threads;
+    _check_reaper_budget = right._check_reaper_budget;
     _check_reaper_interval = right._check_reaper_interval;
     _check_result_path = right._check_result_path;
+    _check_result_workers = right._check_result_workers;
     _check_service_freshness = right._check_service_freshness;
+    _command_launcher = right._command_launcher;
     _commands = right._commands;
     _command_check_interval = right._command_check_interval;
     _command_check_interval_is_seconds = right._command_check_interval_is_seconds;
     _command_file = right._command_file;
+    _connector_instances = right._connector_instances;
     _connectors = right._connectors;
     _contactgroups = right._contactgroups;
     _contacts = right._contacts;
@@ -468,8 +515,12 @@ state& state::operator=(state const& right) {
     _enable_notifications = right._enable_notifications;
     _enable_predictive_host_dependency_checks = right._enable_predictive_host_dependency_checks;
     _enable_predictive_service_dependency_checks = right._enable_predictive_service_dependency_checks;
+    _environment_macros_mode = right._environment_macros_mode;
+    _event_batch_size = right._event_batch_size;
+    _event_batch_time = right._event_batch_time;
     _event_broker_options = right._event_broker_options;
     _event_handler_timeout = right._event_handler_timeout;
+    _event_scheduler = right._event_scheduler;
     _execute_host_checks = right._execute_host_checks;
     _execute_service_checks = right._execute_service_checks;
     _external_command_buffer_slots = right._external_command_buffer_slots;
@@ -506,10 +557,14 @@ state& state::operator=(state const& right) {
     _macros_filter = right._macros_filter;
     _max_check_reaper_time = right._max_check_reaper_time;
     _max_check_result_file_age = right._max_check_result_file_age;
+    _max_concurrent_system_commands = right._max_concurrent_system_commands;
     _max_debug_file_size = right._max_debug_file_size;
     _max_host_check_spread = right._max_host_check_spread;
     _max_log_file_size = right._max_log_file_size;
+    _max_parallel_checks_per_command = right._max_parallel_checks_per_command;
+    _max_parallel_checks_per_host = right._max_parallel_checks_per_host;
     _max_parallel_service_checks = right._max_parallel_service_checks;
+    _max_queued_system_commands = right._max_queued_system_commands;
     _max_service_check_spread = right._max_service_check_spread;
     _notification_timeout = right._notification_timeout;
     _obsess_over_hosts = right._obsess_over_hosts;
@@ -561,6 +616,7 @@ state& state::operator=(state const& right) {
     _use_syslog = right._use_syslog;
     _use_timezone = right._use_timezone;
     _use_true_regexp_matching = right._use_true_regexp_matching;
+    _watch_check_result_path = right._watch_check_result_path;
   }
   return *this;
 }
@@ -589,13 +645,18 @@ bool state::operator==(state const& right) const throw () {
           && _check_host_freshness == right._check_host_freshness
           && _check_orphaned_hosts == right._check_orphaned_hosts
           && _check_orphaned_services == right._check_orphaned_services
+          && _check_plugin_threads == right._check_plugin_threads
+          && _check_reaper_budget == right._check_reaper_budget
           && _check_reaper_interval == right._check_reaper_interval
           && _check_result_path == right._check_result_path
+          && _check_result_workers == right._check_result_workers
           && _check_service_freshness == right._check_service_freshness
+          && _command_launcher == right._command_launcher
           && _commands == right._commands
           && _command_check_interval == right._command_check_interval
           && _command_check_interval_is_seconds == right._command_check_interval_is_seconds
           && _command_file == right._command_file
+          && _connector_instances == right._connector_instances
           && _connectors == right._connectors
           && _contactgroups == right._contactgroups
           && _contacts == right._contacts
@@ -610,8 +671,12 @@ bool state::operator==(state const& right) const throw () {
           && _enable_notifications == right._enable_notifications
           && _enable_predictive_host_dependency_checks == right._enable_predictive_host_dependency_checks
           && _enable_predictive_service_dependency_checks == right._enable_predictive_service_dependency_checks
+          && _environment_macros_mode == right._environment_macros_mode
+          && _event_batch_size == right._event_batch_size
+          && _event_batch_time == right._event_batch_time
           && _event_broker_options == right._event_broker_options
           && _event_handler_timeout == right._event_handler_timeout
+          && _event_scheduler == right._event_scheduler
           && _execute_host_checks == right._execute_host_checks
           && _execute_service_checks == right._execute_service_checks
           && _external_command_buffer_slots == right._external_command_buffer_slots
@@ -648,10 +713,14 @@ bool state::operator==(state const& right) const throw () {
           && _macros_filter == right._macros_filter
           && _max_check_reaper_time == right._max_check_reaper_time
           && _max_check_result_file_age == right._max_check_result_file_age
+          && _max_concurrent_system_commands == right._max_concurrent_system_commands
           && _max_debug_file_size == right._max_debug_file_size
           && _max_host_check_spread == right._max_host_check_spread
           && _max_log_file_size == right._max_log_file_size
+          && _max_parallel_checks_per_command == right._max_parallel_checks_per_command
+          && _max_parallel_checks_per_host == right._max_parallel_checks_per_host
           && _max_parallel_service_checks == right._max_parallel_service_checks
+          && _max_queued_system_commands == right._max_queued_system_commands
           && _max_service_check_spread == right._max_service_check_spread
           && _notification_timeout == right._notification_timeout
           && _obsess_over_hosts == right._obsess_over_hosts
@@ -702,7 +771,8 @@ bool state::operator==(state const& right) const throw () {
           && _use_setpgid == right._use_setpgid
           && _use_syslog == right._use_syslog
           && _use_timezone == right._use_timezone
-          && _use_true_regexp_matching == right._use_true_regexp_matching);
+          && _use_true_regexp_matching == right._use_true_regexp_matching
+          && _watch_check_result_path == right._watch_check_result_path);
 }
 
 /**
@@ -1069,6 +1139,44 @@ bool state::check_orphaned_services() const throw () {
   return _check_orphaned_services;
 }
 
+/**
+ *  Get check_plugin_threads value.
+ *
+ *  @return The check_plugin_threads value.
+ */
+unsigned int state::check_plugin_threads() const throw () {
+  return _check_plugin_threads;
+}
+
+/**
+ *  Set check_plugin_threads value.
+ *
+ *  @param[in] value The new check_plugin_threads value.
+ */
+void state::check_plugin_threads(unsigned int value) {
+  if (!value)
+    throw (engine_error() << "check_plugin_threads cannot be 0");
+  _check_plugin_threads = value;
+}
+
+/**
+ *  Get check_reaper_budget value.
+ *
+ *  @return The check_reaper_budget value.
+ */
+unsigned int state::check_reaper_budget() const throw () {
+  return _check_reaper_budget;
+}
+
+/**
+ *  Set check_reaper_budget value.
+ *
+ *  @param[in] value The new check_reaper_budget value.
+ */
+void state::check_reaper_budget(unsigned int value) {
+  _check_reaper_budget = value;
+}
+
 /**
  *  Get check_reaper_interval value.
  *
@@ -1110,6 +1218,24 @@ void state::check_result_path(std::string const& value) {
   ++config_warnings;
 }
 
+/**
+ *  Get check_result_workers value.
+ *
+ *  @return The check_result_workers value.
+ */
+unsigned int state::check_result_workers() const throw () {
+  return _check_result_workers;
+}
+
+/**
+ *  Set check_result_workers value.
+ *
+ *  @param[in] value The new check_result_workers value.
+ */
+void state::check_result_workers(unsigned int value) {
+  _check_result_workers = value;
+}
+
 /**
  *  Get check_service_freshness value.
  *
@@ -1434,6 +1560,44 @@ set_contactgroup const& state::contactgroups() const throw () {
   return _contactgroups;
 }
 
+/**
+ *  Get command_launcher value.
+ *
+ *  @return The command_launcher value.
+ */
+state::launcher_type state::command_launcher() const throw () {
+  return _command_launcher;
+}
+
+/**
+ *  Set command_launcher value.
+ *
+ *  @param[in] value The new command_launcher value.
+ */
+void state::command_launcher(launcher_type value) {
+  _command_launcher = value;
+}
+
+/**
+ *  Get connector_instances value.
+ *
+ *  @return The connector_instances value.
+ */
+unsigned int state::connector_instances() const throw () {
+  return _connector_instances;
+}
+
+/**
+ *  Set connector_instances value.
+ *
+ *  @param[in] value The new connector_instances value.
+ */
+void state::connector_instances(unsigned int value) {
+  if (!value)
+    throw (engine_error() << "connector_instances cannot be 0");
+  _connector_instances = value;
+}
+
 /**
  *  Get date_format value.
  *
@@ -1621,6 +1785,60 @@ void state::enable_predictive_service_dependency_checks(bool value) {
   _enable_predictive_service_dependency_checks = value;
 }
 
+/**
+ *  Get environment_macros_mode value.
+ *
+ *  @return The environment_macros_mode value.
+ */
+state::environment_macros_mode_type state::environment_macros_mode() const throw () {
+  return _environment_macros_mode;
+}
+
+/**
+ *  Set environment_macros_mode value.
+ *
+ *  @param[in] value The new environment_macros_mode value.
+ */
+void state::environment_macros_mode(environment_macros_mode_type value) {
+  _environment_macros_mode = value;
+}
+
+/**
+ *  Get event_batch_size value.
+ *
+ *  @return The event_batch_size value.
+ */
+unsigned int state::event_batch_size() const throw () {
+  return _event_batch_size;
+}
+
+/**
+ *  Set event_batch_size value.
+ *
+ *  @param[in] value The new event_batch_size value.
+ */
+void state::event_batch_size(unsigned int value) {
+  _event_batch_size = value;
+}
+
+/**
+ *  Get event_batch_time value.
+ *
+ *  @return The event_batch_time value.
+ */
+unsigned int state::event_batch_time() const throw () {
+  return _event_batch_time;
+}
+
+/**
+ *  Set event_batch_time value.
+ *
+ *  @param[in] value The new event_batch_time value.
+ */
+void state::event_batch_time(unsigned int value) {
+  _event_batch_time = value;
+}
+
 /**
  *  Get event_broker_options value.
  *
@@ -1660,6 +1878,24 @@ void state::event_handler_timeout(unsigned int value) {
   _event_handler_timeout = value;
 }
 
+/**
+ *  Get event_scheduler value.
+ *
+ *  @return The event_scheduler value.
+ */
+state::event_scheduler_type state::event_scheduler() const throw () {
+  return _event_scheduler;
+}
+
+/**
+ *  Set event_scheduler value.
+ *
+ *  @param[in] value The new event_scheduler value.
+ */
+void state::event_scheduler(event_scheduler_type value) {
+  _event_scheduler = value;
+}
+
 /**
  *  Get execute_host_checks value.
  *
@@ -2410,6 +2646,24 @@ void state::max_check_result_file_age(unsigned long value) {
   ++config_warnings;
 }
 
+/**
+ *  Get max_concurrent_system_commands value.
+ *
+ *  @return The max_concurrent_system_commands value.
+ */
+unsigned int state::max_concurrent_system_commands() const throw () {
+  return _max_concurrent_system_commands;
+}
+
+/**
+ *  Set max_concurrent_system_commands value.
+ *
+ *  @param[in] value The new max_concurrent_system_commands value.
+ */
+void state::max_concurrent_system_commands(unsigned int value) {
+  _max_concurrent_system_commands = value;
+}
+
 /**
  *  Get max_debug_file_size value.
  *
@@ -2466,6 +2720,42 @@ void state::max_log_file_size(unsigned long value) {
   _max_log_file_size = value;
 }
 
+/**
+ *  Get max_parallel_checks_per_command value.
+ *
+ *  @return The max_parallel_checks_per_command value.
+ */
+unsigned int state::max_parallel_checks_per_command() const throw () {
+  return _max_parallel_checks_per_command;
+}
+
+/**
+ *  Set max_parallel_checks_per_command value.
+ *
+ *  @param[in] value The new max_parallel_checks_per_command value.
+ */
+void state::max_parallel_checks_per_command(unsigned int value) {
+  _max_parallel_checks_per_command = value;
+}
+
+/**
+ *  Get max_parallel_checks_per_host value.
+ *
+ *  @return The max_parallel_checks_per_host value.
+ */
+unsigned int state::max_parallel_checks_per_host() const throw () {
+  return _max_parallel_checks_per_host;
+}
+
+/**
+ *  Set max_parallel_checks_per_host value.
+ *
+ *  @param[in] value The new max_parallel_checks_per_host value.
+ */
+void state::max_parallel_checks_per_host(unsigned int value) {
+  _max_parallel_checks_per_host = value;
+}
+
 /**
  *  Get max_parallel_service_checks value.
  *
@@ -2484,6 +2774,24 @@ void state::max_parallel_service_checks(unsigned int value) {
   _max_parallel_service_checks = value;
 }
 
+/**
+ *  Get max_queued_system_commands value.
+ *
+ *  @return The max_queued_system_commands value.
+ */
+unsigned int state::max_queued_system_commands() const throw () {
+  return _max_queued_system_commands;
+}
+
+/**
+ *  Set max_queued_system_commands value.
+ *
+ *  @param[in] value The new max_queued_system_commands value.
+ */
+void state::max_queued_system_commands(unsigned int value) {
+  _max_queued_system_commands = value;
+}
+
 /**
  *  Get max_service_check_spread value.
  *
@@ -3623,6 +3931,24 @@ void state::use_true_regexp_matching(bool value) {
   _use_true_regexp_matching = value;
 }
 
+/**
+ *  Get watch_check_result_path value.
+ *
+ *  @return The watch_check_result_path value.
+ */
+bool state::watch_check_result_path() const throw () {
+  return _watch_check_result_path;
+}
+
+/**
+ *  Set watch_check_result_path value.
+ *
+ *  @param[in] value The new watch_check_result_path value.
+ */
+void state::watch_check_result_path(bool value) {
+  _watch_check_result_path = value;
+}
+
 /**
  *  Unused variable aggregate_status_updates.
  *
@@ -3748,6 +4074,21 @@ void state::_set_command_check_interval(std::string const& value) {
   setter<int, &state::command_check_interval>::generic(*this, val.c_str());
 }
 
+/**
+ *  Set command_launcher.
+ *
+ *  @param[in] value The new command launcher.
+ */
+void state::_set_command_launcher(std::string const& value) {
+  if (value == "fork")
+    _command_launcher = launcher_fork;
+  else if (value == "spawn")
+    _command_launcher = launcher_spawn;
+  else
+    throw (engine_error()
+           << "command_launcher must be either 'fork' or 'spawn'");
+}
+
 /**
  *  Unused variable comment_file.
  *
@@ -3825,6 +4166,22 @@ void state::_set_enable_failure_prediction(std::string const& value) {
   return ;
 }
 
+/**
+ *  Set environment_macros_mode.
+ *
+ *  @param[in] value The new environment macros mode.
+ */
+void state::_set_environment_macros_mode(std::string const& value) {
+  if (value == "all")
+    _environment_macros_mode = environment_macros_all;
+  else if (value == "referenced")
+    _environment_macros_mode = environment_macros_referenced;
+  else
+    throw (engine_error()
+           << "environment_macros_mode must be either 'all' or "
+           "'referenced'");
+}
+
 /**
  *  Set event_broker_options.
  *
@@ -3838,6 +4195,21 @@ void state::_set_event_broker_options(std::string const& value) {
     }
 }
 
+/**
+ *  Set event_scheduler.
+ *
+ *  @param[in] value The new event scheduler.
+ */
+void state::_set_event_scheduler(std::string const& value) {
+  if (value == "heap")
+    _event_scheduler = scheduler_heap;
+  else if (value == "wheel")
+    _event_scheduler = scheduler_wheel;
+  else
+    throw (engine_error()
+           << "event_scheduler must be either 'heap' or 'wheel'");
+}
+
 /**
  *  Unused variable free_child_process_memory.
  *
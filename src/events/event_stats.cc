@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/events/event_stats.hh"
+#include "com/centreon/engine/events/timed_event.hh"
+
+using namespace com::centreon::engine::events;
+
+/**
+ *  Default constructor.
+ */
+event_stats::event_stats() {}
+
+/**
+ *  Destructor.
+ */
+event_stats::~event_stats() throw () {}
+
+/**
+ *  Write the statistics of event types that were handled, one
+ *  event_stats=<type>,<count>,<lag p50,p90,p99,max>,<execution p50,
+ *  p90,p99,max>,<total execution> line per type, in microseconds.
+ *
+ *  @param[out] os      Output stream.
+ *  @param[in]  prefix  Prefix of every line.
+ */
+void event_stats::dump(std::ostream& os, char const* prefix) const {
+  for (unsigned int i(0); i <= EVENT_USER_FUNCTION; ++i) {
+    entry const* e(find(i));
+    if (!e || !e->execution.count())
+      continue;
+    os << prefix << "event_stats=" << name(i) << ","
+       << e->execution.count() << ","
+       << e->lag.percentile(50) << ","
+       << e->lag.percentile(90) << ","
+       << e->lag.percentile(99) << ","
+       << e->lag.max() << ","
+       << e->execution.percentile(50) << ","
+       << e->execution.percentile(90) << ","
+       << e->execution.percentile(99) << ","
+       << e->execution.max() << ","
+       << e->execution.total() << "\n";
+  }
+}
+
+/**
+ *  Get the statistics of an event type.
+ *
+ *  @param[in] event_type  Event type.
+ *
+ *  @return Statistics, nullptr if this event type is not tracked.
+ */
+event_stats::entry const* event_stats::find(
+                            uint32_t event_type) const throw () {
+  int slot(_slot(event_type));
+  return (slot < 0) ? nullptr : _entries + slot;
+}
+
+/**
+ *  Get the event statistics of the events loop.
+ *
+ *  @return Singleton instance.
+ */
+event_stats& event_stats::instance() {
+  static event_stats instance;
+  return instance;
+}
+
+/**
+ *  Record the handling of an event.
+ *
+ *  @param[in] event_type  Event type.
+ *  @param[in] lag         Dispatch lag in microseconds.
+ *  @param[in] execution   Handler duration in microseconds.
+ */
+void event_stats::record(
+       uint32_t event_type,
+       uint64_t lag,
+       uint64_t execution) throw () {
+  int slot(_slot(event_type));
+  if (slot >= 0) {
+    _entries[slot].lag.record(lag);
+    _entries[slot].execution.record(execution);
+  }
+}
+
+/**
+ *  Forget all recorded statistics.
+ */
+void event_stats::reset() throw () {
+  for (unsigned int i(0); i < types; ++i) {
+    _entries[i].execution.reset();
+    _entries[i].lag.reset();
+  }
+}
+
+/**
+ *  Get the slot of an event type.
+ *
+ *  @param[in] event_type  Event type.
+ *
+ *  @return Slot, -1 if this event type is not tracked.
+ */
+int event_stats::_slot(uint32_t event_type) throw () {
+  if (event_type <= EVENT_EXPIRE_SERVICE_ACK)
+    return static_cast<int>(event_type);
+  if (event_type == EVENT_USER_FUNCTION)
+    return types - 1;
+  return -1;
+}
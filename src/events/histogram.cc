@@ -0,0 +1,193 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <cstring>
+#include "com/centreon/engine/events/histogram.hh"
+
+using namespace com::centreon::engine::events;
+
+/**
+ *  Default constructor.
+ */
+histogram::histogram() {
+  reset();
+}
+
+/**
+ *  Copy constructor.
+ *
+ *  @param[in] right  Object to copy.
+ */
+histogram::histogram(histogram const& right) {
+  operator=(right);
+}
+
+/**
+ *  Destructor.
+ */
+histogram::~histogram() throw () {}
+
+/**
+ *  Assignment operator.
+ *
+ *  @param[in] right  Object to copy.
+ *
+ *  @return This object.
+ */
+histogram& histogram::operator=(histogram const& right) {
+  if (this != &right) {
+    memcpy(_buckets, right._buckets, sizeof(_buckets));
+    _count = right._count;
+    _max = right._max;
+    _min = right._min;
+    _total = right._total;
+  }
+  return *this;
+}
+
+/**
+ *  Get the number of recorded values.
+ *
+ *  @return Number of values.
+ */
+uint64_t histogram::count() const throw () {
+  return _count;
+}
+
+/**
+ *  Get the largest recorded value.
+ *
+ *  @return Largest value, 0 if none was recorded.
+ */
+uint64_t histogram::max() const throw () {
+  return _max;
+}
+
+/**
+ *  Get the average of recorded values.
+ *
+ *  @return Average value, 0 if none was recorded.
+ */
+double histogram::mean() const throw () {
+  return _count ? static_cast<double>(_total) / _count : 0.0;
+}
+
+/**
+ *  Get the smallest recorded value.
+ *
+ *  @return Smallest value, 0 if none was recorded.
+ */
+uint64_t histogram::min() const throw () {
+  return _count ? _min : 0;
+}
+
+/**
+ *  Get a percentile of recorded values.
+ *
+ *  @param[in] p  Percentile, between 0 and 100.
+ *
+ *  @return Upper bound of the bucket holding the percentile, never
+ *          more than the largest recorded value.
+ */
+uint64_t histogram::percentile(double p) const throw () {
+  if (!_count)
+    return 0;
+  if (p < 0.0)
+    p = 0.0;
+  else if (p > 100.0)
+    p = 100.0;
+  uint64_t rank(static_cast<uint64_t>(p / 100.0 * _count + 0.5));
+  if (!rank)
+    rank = 1;
+  uint64_t seen(0);
+  for (unsigned int i(0); i < buckets; ++i) {
+    seen += _buckets[i];
+    if (seen >= rank) {
+      uint64_t bound(_upper_bound(i));
+      return (bound < _max) ? bound : _max;
+    }
+  }
+  return _max;
+}
+
+/**
+ *  Record a value.
+ *
+ *  @param[in] value  Value.
+ */
+void histogram::record(uint64_t value) throw () {
+  ++_buckets[_index(value)];
+  if (!_count || (value < _min))
+    _min = value;
+  if (value > _max)
+    _max = value;
+  ++_count;
+  _total += value;
+}
+
+/**
+ *  Forget all recorded values.
+ */
+void histogram::reset() throw () {
+  memset(_buckets, 0, sizeof(_buckets));
+  _count = 0;
+  _max = 0;
+  _min = 0;
+  _total = 0;
+}
+
+/**
+ *  Get the sum of recorded values.
+ *
+ *  @return Sum of values.
+ */
+uint64_t histogram::total() const throw () {
+  return _total;
+}
+
+/**
+ *  Get the bucket of a value.
+ *
+ *  @param[in] value  Value.
+ *
+ *  @return Bucket index.
+ */
+unsigned int histogram::_index(uint64_t value) throw () {
+  if (value < sub_buckets)
+    return static_cast<unsigned int>(value);
+  unsigned int shift(63 - __builtin_clzll(value) - sub_bucket_bits);
+  return ((shift + 1) * sub_buckets
+          + static_cast<unsigned int>((value >> shift) - sub_buckets));
+}
+
+/**
+ *  Get the largest value of a bucket.
+ *
+ *  @param[in] index  Bucket index.
+ *
+ *  @return Largest value counted in this bucket.
+ */
+uint64_t histogram::_upper_bound(unsigned int index) throw () {
+  if (index < sub_buckets)
+    return index;
+  unsigned int shift(index / sub_buckets - 1);
+  uint64_t lower(static_cast<uint64_t>(sub_buckets + index % sub_buckets)
+                 << shift);
+  return lower + ((static_cast<uint64_t>(1) << shift) - 1);
+}
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <algorithm>
+#include "com/centreon/engine/checkable.hh"
+#include "com/centreon/engine/events/load_leveler.hh"
+#include "com/centreon/engine/events/monotonic_clock.hh"
+#include "com/centreon/engine/globals.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::events;
+
+// Cost of a check that never ran (was projected_*_check_overhead).
+static double const _initial_cost(0.1);
+// Minimal cost of a check, starting a process is never free.
+static double const _min_cost(0.01);
+// Weight of the last execution time in the expected cost.
+static double const _learning_rate(0.3);
+
+/**
+ *  Default constructor.
+ */
+load_leveler::load_leveler()
+  : _learned_costs(0.0),
+    _learned_count(0),
+    _load(horizon, 0.0),
+    _origin(monotonic_clock::now()) {}
+
+/**
+ *  Destructor.
+ */
+load_leveler::~load_leveler() throw () {}
+
+/**
+ *  Get the average projected load of the next seconds.
+ *
+ *  @param[in] seconds  Number of seconds.
+ *
+ *  @return Average expected execution time of the checks starting
+ *          each second.
+ */
+double load_leveler::average_load(unsigned int seconds) const {
+  _advance(monotonic_clock::now());
+  if (!seconds)
+    return 0.0;
+  if (seconds > horizon)
+    seconds = horizon;
+  double total(0.0);
+  for (unsigned int i(0); i < seconds; ++i)
+    total += _load[_slot(_origin + i)];
+  return total / seconds;
+}
+
+/**
+ *  Forget every reservation and learned cost.
+ */
+void load_leveler::clear() {
+  std::fill(_load.begin(), _load.end(), 0.0);
+  _reservations.clear();
+  _learned_costs = 0.0;
+  _learned_count = 0;
+}
+
+/**
+ *  Get the expected execution time of a check.
+ *
+ *  @param[in] check  The host or service.
+ *
+ *  @return Expected execution time in seconds.
+ */
+double load_leveler::expected_cost(void const* check) const {
+  std::unordered_map<void const*, reservation>::const_iterator
+    it(_reservations.find(check));
+  if ((it == _reservations.end()) || !it->second.learned)
+    return _default_cost();
+  return it->second.cost;
+}
+
+/**
+ *  Forget a check, when it is removed for example.
+ *
+ *  @param[in] check  The host or service.
+ */
+void load_leveler::forget(void const* check) {
+  std::unordered_map<void const*, reservation>::iterator
+    it(_reservations.find(check));
+  if (it == _reservations.end())
+    return ;
+  _advance(monotonic_clock::now());
+  _release(it->second);
+  if (it->second.learned) {
+    _learned_costs -= it->second.cost;
+    --_learned_count;
+  }
+  _reservations.erase(it);
+}
+
+/**
+ *  Get the load leveler used by the engine.
+ *
+ *  @return Load leveler.
+ */
+load_leveler& load_leveler::instance() {
+  static load_leveler instance;
+  return instance;
+}
+
+/**
+ *  Learn the execution time of a check that completed. The reservation
+ *  of its next execution keeps the cost it was placed with.
+ *
+ *  @param[in] check           The host or service.
+ *  @param[in] execution_time  Execution time of the check in seconds.
+ */
+void load_leveler::learn(void const* check, double execution_time) {
+  if (execution_time <= 0.0)
+    return ;
+  reservation& r(_reservations[check]);
+  if (r.learned)
+    _learned_costs -= r.cost;
+  else {
+    r.cost = execution_time;
+    r.learned = true;
+    ++_learned_count;
+  }
+  r.cost = std::max(
+             r.cost + _learning_rate * (execution_time - r.cost),
+             _min_cost);
+  _learned_costs += r.cost;
+}
+
+/**
+ *  Get the projected load of some second.
+ *
+ *  @param[in] when  Wall clock time.
+ *
+ *  @return Expected execution time of the checks starting at when,
+ *          0 if when is not within the projection.
+ */
+double load_leveler::load(time_t when) const {
+  _advance(monotonic_clock::now());
+  time_t monotonic(monotonic_clock::to_monotonic(when));
+  if ((monotonic < _origin) || (monotonic >= _origin + horizon))
+    return 0.0;
+  return _load[_slot(monotonic)];
+}
+
+/**
+ *  Get how long a check can be postponed when it is placed.
+ *
+ *  @param[in] check  The host or service.
+ *
+ *  @return Maximum delay in seconds, 0 if checks must not be moved.
+ */
+time_t load_leveler::max_delay(checkable const& check) {
+  if (!config->auto_reschedule_checks())
+    return 0;
+  // A check can be postponed by a tenth of its shortest interval.
+  double interval(std::min(
+                    static_cast<double>(check.get_check_interval()),
+                    check.get_retry_interval()));
+  time_t delay(static_cast<time_t>(
+                 interval * config->interval_length() / 10));
+  time_t window(config->auto_rescheduling_window());
+  return std::min(delay, window);
+}
+
+/**
+ *  Get the highest projected load of the next seconds.
+ *
+ *  @param[in] seconds  Number of seconds.
+ *
+ *  @return Highest expected execution time of the checks starting in
+ *          the same second.
+ */
+double load_leveler::peak_load(unsigned int seconds) const {
+  _advance(monotonic_clock::now());
+  if (seconds > horizon)
+    seconds = horizon;
+  double peak(0.0);
+  for (unsigned int i(0); i < seconds; ++i)
+    peak = std::max(peak, _load[_slot(_origin + i)]);
+  return peak;
+}
+
+/**
+ *  Reserve the execution of a check. Its previous reservation, if any,
+ *  is released.
+ *
+ *  @param[in] check      The host or service.
+ *  @param[in] when       Wall clock time the check is due.
+ *  @param[in] max_delay  How many seconds the check can be postponed
+ *                        to a less loaded second.
+ *
+ *  @return Wall clock time the check should run at.
+ */
+time_t load_leveler::place(
+         void const* check,
+         time_t when,
+         time_t max_delay) {
+  _advance(monotonic_clock::now());
+
+  reservation& r(_reservations[check]);
+  _release(r);
+
+  // Checks farther than the projection are not accounted.
+  time_t start(std::max(monotonic_clock::to_monotonic(when), _origin));
+  if (start >= _origin + horizon)
+    return when;
+
+  // Find the least loaded second.
+  time_t end(std::min(start + std::max(max_delay, static_cast<time_t>(0)),
+                      _origin + horizon - 1));
+  time_t best(start);
+  for (time_t t(start + 1); t <= end; ++t)
+    if (_load[_slot(t)] < _load[_slot(best)])
+      best = t;
+
+  r.when = best;
+  r.reserved = r.learned ? r.cost : _default_cost();
+  _load[_slot(best)] += r.reserved;
+  return (best == start) ? when : monotonic_clock::to_wall(best);
+}
+
+/**
+ *  Check if the execution of a check is reserved.
+ *
+ *  @param[in] check  The host or service.
+ *
+ *  @return True if a reservation exists and is not past.
+ */
+bool load_leveler::placed(void const* check) const {
+  std::unordered_map<void const*, reservation>::const_iterator
+    it(_reservations.find(check));
+  return ((it != _reservations.end())
+          && (it->second.reserved > 0.0)
+          && (it->second.when >= monotonic_clock::now()));
+}
+
+/**
+ *  Drop the load of elapsed seconds.
+ *
+ *  @param[in] now  Current time on the monotonic clock.
+ */
+void load_leveler::_advance(time_t now) const {
+  if (now <= _origin)
+    return ;
+  if (now - _origin >= horizon)
+    std::fill(_load.begin(), _load.end(), 0.0);
+  else
+    for (time_t t(_origin); t < now; ++t)
+      _load[_slot(t)] = 0.0;
+  _origin = now;
+}
+
+/**
+ *  Get the cost of checks that never ran.
+ *
+ *  @return Average learned cost, or a default cost if nothing was
+ *          learned yet.
+ */
+double load_leveler::_default_cost() const throw () {
+  return _learned_count ? _learned_costs / _learned_count : _initial_cost;
+}
+
+/**
+ *  Release a reservation.
+ *
+ *  @param[in,out] r  Reservation.
+ */
+void load_leveler::_release(reservation& r) {
+  double reserved(r.reserved);
+  r.reserved = 0.0;
+  if ((reserved <= 0.0)
+      || (r.when < _origin)
+      || (r.when >= _origin + horizon))
+    return ;
+  double& load(_load[_slot(r.when)]);
+  load -= reserved;
+  if (load < 0.0)
+    load = 0.0;
+}
+
+/**
+ *  Get the slot of a second.
+ *
+ *  @param[in] when  Time on the monotonic clock.
+ *
+ *  @return Slot index.
+ */
+size_t load_leveler::_slot(time_t when) const throw () {
+  return static_cast<uint64_t>(when) & (horizon - 1);
+}
@@ -21,17 +21,31 @@
 
 #include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <future>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "com/centreon/concurrency/thread.hh"
 #include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/commands/connector.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/configuration/parser.hh"
 #include "com/centreon/engine/events/defines.hh"
 #include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/events/monotonic_clock.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/statusdata.hh"
+#include "com/centreon/engine/string.hh"
 #include "com/centreon/logging/engine.hh"
 
 using namespace com::centreon::engine;
@@ -40,6 +54,14 @@ using namespace com::centreon::engine::logging;
 
 static loop* _instance = nullptr;
 
+// Wakeup channel of the loop, usable from any thread.
+static std::atomic<int> _wakeup_fd{-1};
+static std::atomic<unsigned int> _wakeup_reasons{0};
+
+// Maximum time (in milliseconds) the loop stays idle, to keep
+// periodic duties such as status updates running.
+static int const _max_wait = 1000;
+
 /**************************************
 *                                     *
 *           Public Methods            *
@@ -56,6 +78,15 @@ loop& loop::instance() {
   return *_instance;
 }
 
+/**
+ *  Get the counters of the last loop iteration that handled events.
+ *
+ *  @return Iteration counters.
+ */
+loop::iteration const& loop::last_iteration() const throw () {
+  return _last_iteration;
+}
+
 /**
  *  Load singleton.
  */
@@ -81,7 +112,7 @@ void loop::run() {
 
   // Initialize fake "sleep" event.
   _sleep_event.event_type = EVENT_SLEEP;
-  _sleep_event.run_time = _last_time;
+  _sleep_event.set_run_time(_last_time);
   _sleep_event.recurring = false;
   _sleep_event.event_interval = 0L;
   _sleep_event.compensate_for_time_change = false;
@@ -90,7 +121,14 @@ void loop::run() {
   _sleep_event.event_args = nullptr;
   _sleep_event.event_options = 0;
 
+  // Queries sent to connectors are written once per iteration.
+  commands::connector::batch_queries(true);
   _dispatching();
+  commands::connector::batch_queries(false);
+
+  // Complete notifications, event handlers, ... still running before
+  // objects are destroyed.
+  commands::system_runner::instance().drain();
 }
 
 /**
@@ -101,6 +139,22 @@ void loop::unload() {
   _instance = nullptr;
 }
 
+/**
+ *  Wake the events loop up. This method can be called from any thread
+ *  and from signal handlers, whether the loop is running or not.
+ *
+ *  @param[in] reasons  Mask of wakeup_reason.
+ */
+void loop::wakeup(unsigned int reasons) throw () {
+  _wakeup_reasons.fetch_or(reasons);
+  int fd(_wakeup_fd);
+  if (fd >= 0) {
+    uint64_t one(1);
+    ssize_t ret(write(fd, &one, sizeof(one)));
+    (void)ret;
+  }
+}
+
 /**************************************
 *                                     *
 *           Private Methods           *
@@ -111,42 +165,448 @@ void loop::unload() {
  *  Default constructor.
  */
 loop::loop()
-  : _need_reload(0),
-    _reload_running(false) {}
+  : _need_reload(0) {
+  _last_iteration.events_run = 0;
+  _last_iteration.events_deferred = 0;
+  _last_iteration.duration = 0;
+  _last_iteration.lag = 0;
+  int fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+  if (fd < 0) {
+    char const* msg(strerror(errno));
+    logger(log_runtime_warning, basic)
+      << "Warning: could not create events loop wakeup channel, "
+      << "events will be polled every sleep_time: " << msg;
+  }
+  _wakeup_fd = fd;
+}
 
 /**
  *  Destructor.
  */
-loop::~loop() throw () {}
+loop::~loop() throw () {
+  int fd(_wakeup_fd.exchange(-1));
+  if (fd >= 0)
+    close(fd);
+}
 
-static void apply_conf(std::atomic<bool>* reloading) {
+/**
+ *  Parse the configuration and prepare its application. This runs
+ *  off the events loop thread, which is woken up once the prepared
+ *  configuration is published and applies it.
+ *
+ *  @param[in] path  Main configuration file, read on the loop thread.
+ */
+static void prepare_conf(std::string const& path) {
   logger(log_info_message, more)
     << "Starting to reload configuration.";
   try {
-    configuration::state config;
+    std::unique_ptr<configuration::state> config(new configuration::state);
     {
       configuration::parser p;
-      std::string path(::config->cfg_main());
-      p.parse(path, config);
+      p.parse(path, *config);
     }
-    configuration::applier::state::instance().apply(config);
-    logger(log_info_message, basic)
-      << "Configuration reloaded, main loop continuing.";
+    configuration::applier::state::instance().prepare(std::move(config));
+    logger(log_info_message, more)
+      << "Configuration prepared, waiting for the main loop to apply it.";
   }
   catch (std::exception const& e) {
     logger(log_config_error, most)
       << "Error: " << e.what();
+    return ;
   }
-  *reloading = false;
-  logger(log_info_message, more)
-    << "Reload configuration finished.";
+  loop::wakeup();
+}
+
+/**
+ *  Run the first due event, if any.
+ *
+ *  @param[in] now  Current time on the monotonic clock.
+ *
+ *  @return event_run if an event was run, event_deferred if a due
+ *          event was rescheduled instead, event_none if no event is
+ *          due.
+ */
+loop::dispatch_status loop::_dispatch_event(time_t now) {
+  // Handle high priority events.
+  bool run_event(true);
+  if (!timed_event::event_list_high.empty()
+      && (now >= timed_event::event_list_high.front()->monotonic_time())) {
+    // Remove the first event from the timing loop.
+    timed_event* temp_event(timed_event::event_list_high.front());
+
+    timed_event::event_list_high.pop_front();
+    // We may have just removed the only item from the list.
+
+    // Handle the event.
+    handle_timed_event(temp_event);
+
+    // Reschedule the event if necessary.
+    if (temp_event->recurring)
+      reschedule_event(temp_event, timed_event::high);
+    // Else free memory associated with the event.
+    else
+      delete temp_event;
+    return event_run;
+  }
+  // Handle low priority events.
+  else if (!timed_event::event_list_low.empty()
+           && (now >= timed_event::event_list_low.front()->monotonic_time())) {
+    // Default action is to execute the event.
+    run_event = true;
+
+    // Run a few checks before executing a service check...
+    if (timed_event::event_list_low.front()->event_type == EVENT_SERVICE_CHECK) {
+      service* temp_service(
+                 static_cast<service*>(timed_event::event_list_low.front()->event_data));
+
+      // Don't run a service check if we're already maxed out on the
+      // number of parallel service checks, wait for a free slot.
+      if (config->execute_service_checks()
+          && !(temp_service->get_check_options()
+               & CHECK_OPTION_FORCE_EXECUTION)
+          && _queue_check(temp_service))
+        return event_deferred;
+
+      // Don't run a service check if active checks are disabled.
+      if (!config->execute_service_checks()) {
+        logger(dbg_events | dbg_checks, more)
+          << "We're not executing service checks right now, "
+          << "so we'll skip this event.";
+        run_event = false;
+      }
+
+      // Forced checks override normal check logic.
+      if (temp_service->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
+        run_event = true;
+
+      // Reschedule the check if we can't run it now.
+      if (!run_event) {
+        // Remove the service check from the event queue and
+        // reschedule it for a later time. Since event was not
+        // executed, it needs to be remove()'ed to maintain sync with
+        // event broker modules.
+        timed_event* temp_event{timed_event::event_list_low.front()};
+        remove_event(temp_event, timed_event::low);
+
+        // Reschedule (TODO: This should be smarter as it doesn't
+        // consider its timeperiod).
+        if (notifier::soft == temp_service->get_state_type() &&
+            temp_service->get_current_state() != service::state_ok)
+          temp_service->set_next_check(
+              (time_t)(temp_service->get_next_check() +
+                       temp_service->get_retry_interval() *
+                           config->interval_length()));
+        else
+          temp_service->set_next_check(
+              (time_t)(temp_service->get_next_check() +
+                       (temp_service->get_check_interval() *
+                        config->interval_length())));
+        temp_event->set_run_time(temp_service->get_next_check());
+        reschedule_event(temp_event, timed_event::low);
+        temp_service->update_status(false);
+        run_event = false;
+      }
+    }
+    // Run a few checks before executing a host check...
+    else if (EVENT_HOST_CHECK == timed_event::event_list_low.front()->event_type) {
+      // Default action is to execute the event.
+      run_event = true;
+      host* temp_host(static_cast<host*>(timed_event::event_list_low.front()->event_data));
+
+      // Don't run a host check if active checks are disabled.
+      if (!config->execute_host_checks()) {
+        logger(dbg_events | dbg_checks, more)
+          << "We're not executing host checks right now, "
+          << "so we'll skip this event.";
+        run_event = false;
+      }
+
+      // Forced checks override normal check logic.
+      if (temp_host->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
+        run_event = true;
+
+      // Reschedule the host check if we can't run it right now.
+      if (!run_event) {
+        // Remove the host check from the event queue and reschedule
+        // it for a later time. Since event was not executed, it needs
+        // to be remove()'ed to maintain sync with event broker
+        // modules.
+        timed_event* temp_event(timed_event::event_list_low.front());
+        remove_event(temp_event, timed_event::low);
+
+        // Reschedule.
+        if ((notifier::soft == temp_host->get_state_type())
+            && (temp_host->get_current_state() != host::state_up))
+          temp_host->set_next_check(
+            (time_t)(temp_host->get_next_check()
+                       + (temp_host->get_retry_interval()
+                          * config->interval_length())));
+        else
+          temp_host->set_next_check(
+            (time_t)(temp_host->get_next_check()
+                       + (temp_host->get_check_interval()
+                          * config->interval_length())));
+        temp_event->set_run_time(temp_host->get_next_check());
+        reschedule_event(temp_event, timed_event::low);
+        temp_host->update_status(false);
+        run_event = false;
+      }
+    }
+
+    // Run the event.
+    if (run_event) {
+      // Remove the first event from the timing loop.
+      timed_event* temp_event(timed_event::event_list_low.front());
+      timed_event::event_list_low.pop_front();
+      // We may have just removed the only item from the list.
+
+      // Handle the event.
+      logger(dbg_events, more)
+        << "Running event...";
+      handle_timed_event(temp_event);
+
+      // Reschedule the event if necessary.
+      if (temp_event->recurring)
+        reschedule_event(temp_event, timed_event::low);
+      // Else free memory associated with the event.
+      else
+        delete temp_event;
+    }
+    // The event was rescheduled, go on with the next one.
+    else {
+      logger(dbg_events, most)
+        << "Did not execute scheduled event.";
+      return event_deferred;
+    }
+    return event_run;
+  }
+  return event_none;
+}
+
+/**
+ *  Process what producers woke the loop up for.
+ *
+ *  @param[in] reasons  Mask of wakeup_reason.
+ */
+void loop::_handle_wakeup(unsigned int reasons) {
+  // Handle check results as soon as they are available.
+  if (reasons & wakeup_check_result) {
+    logger(dbg_events, most)
+      << "Check results are available, reaping them...";
+    try {
+      checks::checker::instance().reap();
+    }
+    catch (std::exception const& e) {
+      logger(log_runtime_error, basic)
+        << "Error: " << e.what();
+    }
+    // The reaper may have stopped before the end of the queue.
+    if (!checks::checker::instance().reaper_is_empty())
+      _wakeup_reasons.fetch_or(wakeup_check_result);
+  }
+
+  // Complete notifications, event handlers, ... whose command ended.
+  if (reasons & wakeup_system_command) {
+    logger(dbg_events, most)
+      << "System commands finished, completing them...";
+    commands::system_runner::instance().reap();
+  }
+
+  // Let the external command module process its buffer.
+  if (reasons & wakeup_external_command) {
+    logger(dbg_events, most)
+      << "External commands are available, processing them...";
+    broker_external_command(
+      NEBTYPE_EXTERNALCOMMAND_CHECK,
+      NEBFLAG_NONE,
+      NEBATTR_NONE,
+      CMD_NONE,
+      time(nullptr),
+      nullptr,
+      nullptr,
+      nullptr);
+  }
+}
+
+/**
+ *  Get how late the dispatching of events is.
+ *
+ *  @param[in] now  Current time on the monotonic clock.
+ *
+ *  @return Number of seconds since the earliest due event should have
+ *          run, 0 if no event is due.
+ */
+time_t loop::_lag(time_t now) const {
+  time_t lag(0);
+  timed_event* evt(timed_event::event_list_high.front());
+  if (evt && (now - evt->monotonic_time() > lag))
+    lag = now - evt->monotonic_time();
+  evt = timed_event::event_list_low.front();
+  if (evt && (now - evt->monotonic_time() > lag))
+    lag = now - evt->monotonic_time();
+  return lag;
+}
+
+/**
+ *  Queue the due check of a service if it cannot run now because of
+ *  the parallel checks limits. Its event is then removed.
+ *
+ *  @param[in] svc  Service whose check event is due.
+ *
+ *  @return True if the check was queued.
+ */
+bool loop::_queue_check(service* svc) {
+  checks::admission_queue&
+    admission(checks::checker::instance().admission());
+  std::string const& command(svc->get_check_command_ptr()
+                             ? svc->get_check_command_ptr()->get_name()
+                             : svc->get_check_command());
+
+  // Checks already waiting go first.
+  if (!admission.empty())
+    _release_checks();
+  if (admission.empty()
+      && admission.can_run(svc->get_host_id(), command))
+    return false;
+
+  timed_event* temp_event(timed_event::event_list_low.front());
+  if (admission.empty())
+    logger(log_runtime_warning, basic)
+      << "Warning: Max concurrent service checks ("
+      << currently_running_service_checks << "/"
+      << config->max_parallel_service_checks()
+      << ") or per host/command limit has been reached, "
+      << "queuing service checks";
+
+  // Scheduling latency, time spent in the queue is accounted apart.
+  checks::admission_queue::entry e;
+  e.host_id = svc->get_host_id();
+  e.service_id = svc->get_service_id();
+  e.command = command;
+  e.check_options = temp_event->event_options;
+  e.latency = monotonic_clock::now_us() / 1000000.0
+              - temp_event->monotonic_time();
+  e.queued = std::chrono::steady_clock::now();
+  admission.push(e);
+  logger(dbg_events | dbg_checks, more)
+    << "Queuing check of service '" << svc->get_description()
+    << "' on host '" << svc->get_hostname() << "' ("
+    << admission.size() << " checks waiting)";
+
+  // The check will run from the queue. Since event was not executed,
+  // it needs to be remove()'ed to maintain sync with event broker
+  // modules.
+  remove_event(temp_event, timed_event::low);
+  delete temp_event;
+  return true;
+}
+
+/**
+ *  Run the queued service checks for which a slot is free.
+ */
+void loop::_release_checks() {
+  checks::admission_queue&
+    admission(checks::checker::instance().admission());
+  checks::admission_queue::entry e;
+  while (admission.pop(e)) {
+    service_id_map::iterator it(
+      service::services_by_id.find({e.host_id, e.service_id}));
+    if (it == service::services_by_id.end())
+      continue ;
+    logger(dbg_events | dbg_checks, more)
+      << "Running queued check of service '"
+      << it->second->get_description() << "' on host '"
+      << it->second->get_hostname() << "'";
+    it->second->run_scheduled_check(e.check_options, e.latency);
+  }
+}
+
+/**
+ *  Switch event lists to the configured scheduler if needed, and
+ *  notify them of the current time.
+ *
+ *  @param[in] now  Current time on the monotonic clock.
+ */
+void loop::_update_scheduler(time_t now) {
+  timed_event_list::scheduler_type type(
+    (config->event_scheduler() == configuration::state::scheduler_wheel)
+    ? timed_event_list::wheel
+    : timed_event_list::heap);
+  for (unsigned int i(0); i < timed_event::priority_num; ++i) {
+    timed_event_list& list(i == timed_event::high
+                           ? timed_event::event_list_high
+                           : timed_event::event_list_low);
+    if (list.get_scheduler() != type) {
+      logger(dbg_events, basic)
+        << "Switching " << (i == timed_event::high ? "high" : "low")
+        << " priority events to the "
+        << (type == timed_event_list::wheel ? "wheel" : "heap")
+        << " scheduler";
+      list.set_scheduler(type);
+    }
+    list.advance(now);
+  }
+}
+
+/**
+ *  Block until the timeout expires or until the loop is woken up.
+ *
+ *  @param[in] timeout  Timeout in milliseconds.
+ */
+void loop::_wait(int timeout) {
+  // Something happened while we were busy.
+  if (_wakeup_reasons)
+    return ;
+
+  int fd(_wakeup_fd);
+  if (fd < 0) {
+    if (timeout > 0)
+      concurrency::thread::nsleep(timeout * 1000000ul);
+    return ;
+  }
+
+  pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (poll(&pfd, 1, timeout) > 0) {
+    uint64_t count;
+    ssize_t ret(read(fd, &count, sizeof(count)));
+    (void)ret;
+  }
+}
+
+/**
+ *  Get the time until the next event must run.
+ *
+ *  @return Timeout in milliseconds.
+ */
+int loop::_wait_timeout() const {
+  // Without wakeup channel, we can only poll.
+  if (_wakeup_fd < 0)
+    return static_cast<int>(config->sleep_time() * 1000);
+
+  timed_event* next(timed_event::event_list_high.front());
+  timed_event* low(timed_event::event_list_low.front());
+  if (!next || (low && (low->monotonic_time() < next->monotonic_time())))
+    next = low;
+  if (!next)
+    return _max_wait;
+
+  // Run times have a one second granularity, round the delay up so
+  // that we do not wake up right before the event is due.
+  long long delay(next->monotonic_time() * 1000000ll
+                  - monotonic_clock::now_us());
+  if (delay <= 0)
+    return 0;
+  delay = (delay + 999) / 1000;
+  return (delay > _max_wait) ? _max_wait : static_cast<int>(delay);
 }
 
 /**
  *  Slot to dispatch Centreon Engine events.
  */
 void loop::_dispatching() {
-  std::atomic<bool> reloading{false};
   while (true) {
     // See if we should exit or restart (a signal was encountered).
     if (sigshutdown)
@@ -166,15 +626,24 @@ void loop::_dispatching() {
       sighup = false;
     }
 
+    // The previous reload is over once its configuration is prepared
+    // (or failed to be).
+    if (_reload.valid()
+        && (_reload.wait_for(std::chrono::seconds(0))
+            == std::future_status::ready))
+      _reload.get();
+
     // Start reload configuration.
     if (_need_reload) {
       logger(log_info_message, most)
         << "Need reload.";
-      if (!reloading) {
+      if (!_reload.valid()) {
         logger(log_info_message, most)
           << "Reloading...";
-        reloading = true;
-        std::async(std::launch::async, apply_conf, &reloading);
+        _reload = std::async(
+                    std::launch::async,
+                    prepare_conf,
+                    ::config->cfg_main());
       }
       else
         logger(log_info_message, most)
@@ -183,42 +652,67 @@ void loop::_dispatching() {
       _need_reload = 0;
     }
 
-    // Get the current time.
+    // Apply the configuration prepared off this thread as soon as it
+    // is published, the reload thread wakes us up right after. The
+    // loop is only stopped while differences are applied.
+    try {
+      if (configuration::applier::state::instance().apply_prepared()) {
+        logger(log_info_message, basic)
+          << "Configuration reloaded, main loop continuing.";
+        logger(log_info_message, more)
+          << "Reload configuration finished.";
+      }
+    }
+    catch (std::exception const& e) {
+      logger(log_config_error, most)
+        << "Error: " << e.what();
+    }
+
+    // Get the current time, events are scheduled on the monotonic
+    // clock.
     time_t current_time;
     time(&current_time);
+    time_t now(monotonic_clock::now());
 
     configuration::applier::state::instance().lock();
 
-    // Hey, wait a second...  we traveled back in time!
-    if (current_time < _last_time)
-      compensate_for_system_time_change(
-        static_cast<unsigned long>(_last_time),
-        static_cast<unsigned long>(current_time));
-    // Else if the time advanced over the specified threshold,
-    // try and compensate...
-    else if ((current_time - _last_time)
-             >= static_cast<time_t>(config->time_change_threshold()))
+    // Hey, wait a second...  the system time changed! Scheduling is
+    // not affected, only wall clock times must be adjusted.
+    time_t time_change(monotonic_clock::sync());
+    if (time_change)
       compensate_for_system_time_change(
         static_cast<unsigned long>(_last_time),
-        static_cast<unsigned long>(current_time));
+        static_cast<unsigned long>(_last_time + time_change));
 
     // Keep track of the last time.
     _last_time = current_time;
 
+    // Use the configured event scheduler and let it know the time.
+    _update_scheduler(now);
+
+    // Handle what producers woke us up for.
+    unsigned int reasons(_wakeup_reasons.exchange(0));
+    if (reasons)
+      _handle_wakeup(reasons);
+
+    // Run queued checks that can now be executed.
+    if (!checks::checker::instance().admission().empty())
+      _release_checks();
+
     // Log messages about event lists.
     logger(dbg_events, more)
       << "** Event Check Loop";
     if (!timed_event::event_list_high.empty())
       logger(dbg_events, more)
         << "Next High Priority Event Time: "
-        << my_ctime(&(*timed_event::event_list_high.begin())->run_time);
+        << string::ctime(timed_event::event_list_high.front()->get_run_time());
     else
       logger(dbg_events, more)
         << "No high priority events are scheduled...";
     if (!timed_event::event_list_low.empty())
       logger(dbg_events, more)
         << "Next Low Priority Event Time:  "
-        << my_ctime(&(*timed_event::event_list_low.begin())->run_time);
+        << string::ctime(timed_event::event_list_low.front()->get_run_time());
     else
       logger(dbg_events, more)
         << "No low priority events are scheduled...";
@@ -234,192 +728,47 @@ void loop::_dispatching() {
       update_program_status(false);
     }
 
-    // Handle high priority events.
-    bool run_event(true);
-    if (!timed_event::event_list_high.empty()
-        && (current_time >= (*timed_event::event_list_high.begin())->run_time)) {
-      // Remove the first event from the timing loop.
-      timed_event* temp_event(*timed_event::event_list_high.begin());
-
-      timed_event::event_list_high.pop_front();
-      // We may have just removed the only item from the list.
-
-      // Handle the event.
-      handle_timed_event(temp_event);
-
-      // Reschedule the event if necessary.
-      if (temp_event->recurring)
-        reschedule_event(temp_event, timed_event::high);
-      // Else free memory associated with the event.
+    // Handle due events, several of them at once in batched mode.
+    int idle_timeout(-1);
+    iteration stats;
+    stats.events_run = 0;
+    stats.events_deferred = 0;
+    stats.lag = _lag(now);
+    unsigned int max_events(config->event_batch_size());
+    std::chrono::microseconds max_duration(config->event_batch_time());
+    std::chrono::steady_clock::time_point
+      batch_start(std::chrono::steady_clock::now());
+    dispatch_status status;
+    while ((status = _dispatch_event(now)) != event_none) {
+      if (status == event_run)
+        ++stats.events_run;
       else
-        delete temp_event;
+        ++stats.events_deferred;
+      if ((max_events
+           && (stats.events_run + stats.events_deferred >= max_events))
+          || sigshutdown)
+        break ;
+      if (max_duration.count()
+          && (std::chrono::steady_clock::now() - batch_start
+              >= max_duration))
+        break ;
     }
-    // Handle low priority events.
-    else if (!timed_event::event_list_low.empty()
-             && (current_time >= (*timed_event::event_list_low.begin())->run_time)) {
-      // Default action is to execute the event.
-      run_event = true;
-
-      // Run a few checks before executing a service check...
-      if ((*timed_event::event_list_low.begin())->event_type == EVENT_SERVICE_CHECK) {
-        int nudge_seconds(0);
-        service* temp_service(
-                   static_cast<service*>((*timed_event::event_list_low.begin())->event_data));
-
-        // Don't run a service check if we're already maxed out on the
-        // number of parallel service checks...
-        if (config->max_parallel_service_checks() != 0
-            && (currently_running_service_checks
-                >= config->max_parallel_service_checks())) {
-          // Move it at least 5 seconds (to overcome the current peak),
-          // with a random 10 seconds (to spread the load).
-          nudge_seconds = 5 + (rand() % 10);
-          logger(dbg_events | dbg_checks, basic)
-            << "**WARNING** Max concurrent service checks ("
-            << currently_running_service_checks << "/"
-            << config->max_parallel_service_checks()
-            << ") has been reached!  Nudging "
-            << temp_service->get_hostname() << ":"
-            << temp_service->get_description() << " by "
-            << nudge_seconds << " seconds...";
-          logger(log_runtime_warning, basic)
-            << "\tMax concurrent service checks ("
-            << currently_running_service_checks << "/"
-            << config->max_parallel_service_checks()
-            << ") has been reached.  Nudging "
-            << temp_service->get_hostname() << ":"
-            << temp_service->get_description() << " by "
-            << nudge_seconds << " seconds...";
-          run_event = false;
-        }
-
-        // Don't run a service check if active checks are disabled.
-        if (!config->execute_service_checks()) {
-          logger(dbg_events | dbg_checks, more)
-            << "We're not executing service checks right now, "
-            << "so we'll skip this event.";
-          run_event = false;
-        }
-
-        // Forced checks override normal check logic.
-        if (temp_service->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
-          run_event = true;
-
-        // Reschedule the check if we can't run it now.
-        if (!run_event) {
-          // Remove the service check from the event queue and
-          // reschedule it for a later time. Since event was not
-          // executed, it needs to be remove()'ed to maintain sync with
-          // event broker modules.
-          timed_event* temp_event{*timed_event::event_list_low.begin()};
-          remove_event(temp_event, timed_event::low);
-
-          // We nudge the next check time when it is
-          // due to too many concurrent service checks.
-          if (nudge_seconds)
-            temp_service->set_next_check(
-              (time_t)(temp_service->get_next_check() + nudge_seconds));
-          // Otherwise reschedule (TODO: This should be smarter as it
-          // doesn't consider its timeperiod).
-          else {
-            if (notifier::soft == temp_service->get_state_type() &&
-                temp_service->get_current_state() != service::state_ok)
-              temp_service->set_next_check(
-                  (time_t)(temp_service->get_next_check() +
-                           temp_service->get_retry_interval() *
-                               config->interval_length()));
-            else
-              temp_service->set_next_check(
-                  (time_t)(temp_service->get_next_check() +
-                           (temp_service->get_check_interval() *
-                            config->interval_length())));
-          }
-          temp_event->run_time = temp_service->get_next_check();
-          reschedule_event(temp_event, timed_event::low);
-          temp_service->update_status(false);
-          run_event = false;
-        }
-      }
-      // Run a few checks before executing a host check...
-      else if (EVENT_HOST_CHECK == (*timed_event::event_list_low.begin())->event_type) {
-        // Default action is to execute the event.
-        run_event = true;
-        host* temp_host(static_cast<host*>((*timed_event::event_list_low.begin())->event_data));
-
-        // Don't run a host check if active checks are disabled.
-        if (!config->execute_host_checks()) {
-          logger(dbg_events | dbg_checks, more)
-            << "We're not executing host checks right now, "
-            << "so we'll skip this event.";
-          run_event = false;
-        }
-
-        // Forced checks override normal check logic.
-        if (temp_host->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
-          run_event = true;
-
-        // Reschedule the host check if we can't run it right now.
-        if (!run_event) {
-          // Remove the host check from the event queue and reschedule
-          // it for a later time. Since event was not executed, it needs
-          // to be remove()'ed to maintain sync with event broker
-          // modules.
-          timed_event* temp_event(*timed_event::event_list_low.begin());
-          remove_event(temp_event, timed_event::low);
-
-          // Reschedule.
-          if ((notifier::soft == temp_host->get_state_type())
-              && (temp_host->get_current_state() != host::state_up))
-            temp_host->set_next_check(
-              (time_t)(temp_host->get_next_check()
-                         + (temp_host->get_retry_interval()
-                            * config->interval_length())));
-          else
-            temp_host->set_next_check(
-              (time_t)(temp_host->get_next_check()
-                         + (temp_host->get_check_interval()
-                            * config->interval_length())));
-          temp_event->run_time = temp_host->get_next_check();
-          reschedule_event(temp_event, timed_event::low);
-          temp_host->update_status(false);
-          run_event = false;
-        }
-      }
-
-      // Run the event.
-      if (run_event) {
-        // Remove the first event from the timing loop.
-        timed_event* temp_event(*timed_event::event_list_low.begin());
-        timed_event::event_list_low.pop_front();
-        // We may have just removed the only item from the list.
-
-        // Handle the event.
-        logger(dbg_events, more)
-          << "Running event...";
-        handle_timed_event(temp_event);
-
-        // Reschedule the event if necessary.
-        if (temp_event->recurring)
-          reschedule_event(temp_event, timed_event::low);
-        // Else free memory associated with the event.
-        else
-          delete temp_event;
-      }
-      // Wait a while so we don't hog the CPU...
-      else {
-        logger(dbg_events, most)
-          << "Did not execute scheduled event. Idling for a bit...";
-        concurrency::thread::nsleep(
-          (unsigned long)(config->sleep_time() * 1000000000l));
-      }
+    stats.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - batch_start).count();
+    if (stats.events_run || stats.events_deferred) {
+      _last_iteration = stats;
+      logger(dbg_events, more)
+        << "Loop iteration: " << stats.events_run << " events run, "
+        << stats.events_deferred << " deferred in " << stats.duration
+        << " us, lag " << stats.lag << " s";
     }
     // We don't have anything to do at this moment in time...
-    else if ((timed_event::event_list_high.empty() ||
-              current_time <
-               (*timed_event::event_list_high.begin())->run_time) &&
+    if ((timed_event::event_list_high.empty() ||
+              now <
+               timed_event::event_list_high.front()->monotonic_time()) &&
              (timed_event::event_list_low.empty() ||
-              current_time <
-               (*timed_event::event_list_low.begin())->run_time)) {
+              now <
+               timed_event::event_list_low.front()->monotonic_time())) {
       logger(dbg_events, most)
           << "No events to execute at the moment. Idling for a bit...";
 
@@ -432,25 +781,31 @@ void loop::_dispatching() {
                                 nullptr, nullptr);
       }
 
-      // Set time to sleep so we don't hog the CPU...
+      // Sleep until the next event is due or until we are woken up.
+      idle_timeout = _wait_timeout();
       timespec sleep_time;
-      sleep_time.tv_sec = (time_t)config->sleep_time();
-      sleep_time.tv_nsec =
-          (long)((config->sleep_time() - (double)sleep_time.tv_sec) *
-                 1000000000ull);
+      sleep_time.tv_sec = idle_timeout / 1000;
+      sleep_time.tv_nsec = (idle_timeout % 1000) * 1000000l;
 
       // Populate fake "sleep" event.
-      _sleep_event.run_time = current_time;
+      _sleep_event.set_run_time(current_time);
       _sleep_event.event_data = (void*)&sleep_time;
 
       // Send event data to broker.
       broker_timed_event(NEBTYPE_TIMEDEVENT_SLEEP, NEBFLAG_NONE, NEBATTR_NONE,
                          &_sleep_event, nullptr);
-
-      // Wait a while so we don't hog the CPU...
-      concurrency::thread::nsleep(
-          (unsigned long)(config->sleep_time() * 1000000000l));
     }
+
+    // Write the queries queued by the connectors during this iteration.
+    commands::connector::flush_queries();
     configuration::applier::state::instance().unlock();
+
+    // Wait without holding the configuration lock.
+    if (idle_timeout >= 0)
+      _wait(idle_timeout);
   }
+
+  // Do not leave a reload running behind us.
+  if (_reload.valid())
+    _reload.wait();
 }
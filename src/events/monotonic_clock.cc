@@ -0,0 +1,142 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <atomic>
+#include "com/centreon/engine/events/monotonic_clock.hh"
+
+using namespace com::centreon::engine::events;
+
+static int64_t const _ns_per_sec(1000000000ll);
+
+/**
+ *  Read a system clock.
+ *
+ *  @param[in] id  Clock ID.
+ *
+ *  @return Clock value in nanoseconds.
+ */
+static int64_t _read(clockid_t id) throw () {
+  timespec ts;
+  clock_gettime(id, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * _ns_per_sec + ts.tv_nsec;
+}
+
+/**
+ *  Round nanoseconds to the nearest second.
+ *
+ *  @param[in] ns  Duration in nanoseconds.
+ *
+ *  @return Duration in seconds.
+ */
+static time_t _round(int64_t ns) throw () {
+  return static_cast<time_t>(
+           (ns >= 0 ? ns + _ns_per_sec / 2 : ns - _ns_per_sec / 2)
+           / _ns_per_sec);
+}
+
+/**
+ *  Offsets between the wall clock and the monotonic clock, when the
+ *  engine started and after the last detected time change.
+ */
+struct                 clock_frame {
+                       clock_frame()
+    : base(_read(CLOCK_REALTIME) - _read(CLOCK_MONOTONIC)),
+      offset(base) {}
+
+  int64_t const        base;
+  std::atomic<int64_t> offset;
+};
+
+/**
+ *  Get the clock frame, initialized on first use.
+ *
+ *  @return Clock frame.
+ */
+static clock_frame& _frame() {
+  static clock_frame frame;
+  return frame;
+}
+
+/**
+ *  Get the current time.
+ *
+ *  @return Seconds on the monotonic clock.
+ */
+time_t monotonic_clock::now() throw () {
+  return static_cast<time_t>(
+           (_read(CLOCK_MONOTONIC) + _frame().base) / _ns_per_sec);
+}
+
+/**
+ *  Get the current time with a microsecond precision.
+ *
+ *  @return Microseconds on the monotonic clock.
+ */
+int64_t monotonic_clock::now_us() throw () {
+  return (_read(CLOCK_MONOTONIC) + _frame().base) / 1000;
+}
+
+/**
+ *  Get the wall clock shift since the engine started.
+ *
+ *  @return Wall clock time minus monotonic clock time, in seconds.
+ */
+time_t monotonic_clock::skew() throw () {
+  clock_frame& frame(_frame());
+  return _round(frame.offset - frame.base);
+}
+
+/**
+ *  Detect a wall clock change. Changes below one second are ignored.
+ *
+ *  @return Number of seconds the wall clock jumped (negative when it
+ *          moved backwards) since the last call, 0 if it did not.
+ */
+time_t monotonic_clock::sync() throw () {
+  clock_frame& frame(_frame());
+  int64_t offset(_read(CLOCK_REALTIME) - _read(CLOCK_MONOTONIC));
+  int64_t delta(offset - frame.offset);
+  if ((delta > -_ns_per_sec) && (delta < _ns_per_sec))
+    return 0;
+  time_t previous(skew());
+  frame.offset = offset;
+  return skew() - previous;
+}
+
+/**
+ *  Convert a wall clock time to the monotonic clock.
+ *
+ *  @param[in] wall  Wall clock time.
+ *
+ *  @return Monotonic clock time.
+ */
+time_t monotonic_clock::to_monotonic(time_t wall) throw () {
+  return wall - skew();
+}
+
+/**
+ *  Convert a monotonic clock time to the wall clock.
+ *
+ *  @param[in] monotonic  Monotonic clock time.
+ *
+ *  @return Wall clock time.
+ */
+time_t monotonic_clock::to_wall(time_t monotonic) throw () {
+  return monotonic + skew();
+}
@@ -31,185 +31,6 @@
 using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
 
-/**
- *  Adjusts scheduling of host and service checks.
- */
-void adjust_check_scheduling() {
-  static double const projected_host_check_overhead(0.1);
-  static double const projected_service_check_overhead(0.1);
-  double current_exec_time(0.0);
-  double current_exec_time_offset(0.0);
-  double exec_time_factor(0.0);
-  double inter_check_delay(0.0);
-  double last_check_exec_time(0.0);
-  double total_check_exec_time(0.0);
-  int adjust_scheduling(false);
-  int current_check(0);
-  int total_checks(0);
-  time_t last_check_time(0L);
-  host* hst(NULL);
-  com::centreon::engine::service* svc(NULL);
-
-  logger(dbg_functions, basic)
-    << "adjust_check_scheduling()";
-
-  /* TODO:
-     - Track host check overhead on a per-host basis
-     - Figure out how to calculate service check overhead
-  */
-
-  // determine our adjustment window.
-  time_t current_time(time(NULL));
-  time_t first_window_time(current_time);
-  time_t last_window_time(first_window_time + config->auto_rescheduling_window());
-
-  // get current scheduling data.
-  for (timed_event_list::iterator
-         it{timed_event::event_list_low.begin()},
-         end{timed_event::event_list_low.end()};
-       it != end;
-       ++it) {
-    // skip events outside of our current window.
-    if ((*it)->run_time <= first_window_time)
-      continue;
-    if ((*it)->run_time > last_window_time)
-      break;
-
-    if ((*it)->event_type == EVENT_HOST_CHECK) {
-
-      if (!(hst = (host*)(*it)->event_data))
-        continue;
-
-      // ignore forced checks.
-      if (hst->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
-        continue;
-
-      // does the last check "bump" into this one?
-      if ((last_check_time + last_check_exec_time) > (*it)->run_time)
-        adjust_scheduling = true;
-
-      last_check_time = (*it)->run_time;
-
-      // calculate time needed to perform check.
-      // NOTE: host check execution time is not taken into account,
-      // as scheduled host checks are run in parallel.
-      last_check_exec_time = projected_host_check_overhead;
-      total_check_exec_time += last_check_exec_time;
-    }
-
-    else if ((*it)->event_type == EVENT_SERVICE_CHECK) {
-      if (!(svc = (com::centreon::engine::service*)(*it)->event_data))
-        continue;
-
-      // ignore forced checks.
-      if (svc->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
-        continue;
-
-      // does the last check "bump" into this one?
-      if ((last_check_time + last_check_exec_time) > (*it)->run_time)
-        adjust_scheduling = true;
-
-      last_check_time = (*it)->run_time;
-
-      // calculate time needed to perform check.
-      // NOTE: service check execution time is not taken into
-      // account, as service checks are run in parallel.
-      last_check_exec_time = projected_service_check_overhead;
-      total_check_exec_time += last_check_exec_time;
-    }
-    else
-      continue;
-
-    ++total_checks;
-  }
-
-  // nothing to do...
-  if (total_checks == 0 || adjust_scheduling == false)
-    return;
-
-  if ((unsigned long)total_check_exec_time > config->auto_rescheduling_window()) {
-    inter_check_delay = 0.0;
-    exec_time_factor
-      = (double)((double)config->auto_rescheduling_window()
-                 / total_check_exec_time);
-  }
-  else {
-    inter_check_delay
-      = (double)((((double)config->auto_rescheduling_window())
-                  - total_check_exec_time) / (double)(total_checks * 1.0));
-    exec_time_factor = 1.0;
-  }
-
-  // adjust check scheduling.
-  double current_icd_offset(inter_check_delay / 2.0);
-  for (timed_event_list::iterator
-         it{timed_event::event_list_low.begin()},
-         end{timed_event::event_list_low.end()};
-       it != end;
-       ++it) {
-    // skip events outside of our current window.
-    if ((*it)->run_time <= first_window_time)
-      continue;
-    if ((*it)->run_time > last_window_time)
-      break;
-
-    if ((*it)->event_type == EVENT_HOST_CHECK) {
-
-      if (!(hst = (host*)(*it)->event_data))
-        continue;
-
-      // ignore forced checks.
-      if (hst->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
-        continue;
-
-      current_exec_time
-        = ((hst->get_execution_time()
-            + projected_host_check_overhead)
-           * exec_time_factor);
-    }
-    else if ((*it)->event_type == EVENT_SERVICE_CHECK) {
-      if (!(svc = (com::centreon::engine::service*)(*it)->event_data))
-        continue;
-
-      // ignore forced checks.
-      if (svc->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
-        continue;
-
-      // NOTE: service check execution time is not taken into
-      // account, as service checks are run in parallel.
-      current_exec_time
-        = (projected_service_check_overhead * exec_time_factor);
-    }
-    else
-      continue;
-
-    ++current_check;
-    double new_run_time_offset(current_exec_time_offset + current_icd_offset);
-    time_t new_run_time(
-             (time_t)(first_window_time
-                      + (unsigned long)new_run_time_offset));
-
-    if ((*it)->event_type == EVENT_HOST_CHECK) {
-      (*it)->run_time = new_run_time;
-      hst->set_next_check(new_run_time);
-      hst->update_status(false);
-    }
-    else {
-      (*it)->run_time = new_run_time;
-      svc->set_next_check(new_run_time);
-      svc->update_status(false);
-    }
-
-    current_icd_offset += inter_check_delay;
-    current_exec_time_offset += current_exec_time;
-  }
-
-  // resort event list (some events may be out of order at
-  // this point).
-  resort_event_list(timed_event::low);
-  return;
-}
-
 /**
  *  Displays service check scheduling information.
  */
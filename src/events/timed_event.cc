@@ -20,12 +20,15 @@
 ** <http://www.gnu.org/licenses/>.
 */
 
-#include <algorithm>
+#include <vector>
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/error.hh"
 #include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/event_stats.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/events/monotonic_clock.hh"
 #include "com/centreon/engine/events/timed_event.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
@@ -47,14 +50,21 @@ timed_event_list timed_event::event_list_low;
  */
 timed_event::timed_event() :
   event_type{0},
-  run_time{0},
   recurring{0},
   event_interval{0},
   compensate_for_time_change{false},
   timing_func{nullptr},
   event_data{nullptr},
   event_args{nullptr},
-  event_options{0}
+  event_options{0},
+  _position{0},
+  _indexed_type{0},
+  _indexed_data{nullptr},
+  _monotonic_time{0},
+  _sequence{0},
+  _wheel_next{nullptr},
+  _wheel_prev{nullptr},
+  _wheel_slot{0}
   {}
 
   /**
@@ -81,14 +91,21 @@ timed_event::timed_event(
                void* event_args,
                int32_t event_options)
 : event_type{event_type},
-  run_time{run_time},
   recurring{recurring},
   event_interval{event_interval},
   compensate_for_time_change{compensate_for_time_change},
   timing_func{timing_func},
   event_data{event_data},
   event_args{event_args},
-  event_options{event_options} {}
+  event_options{event_options},
+  _position{0},
+  _indexed_type{0},
+  _indexed_data{nullptr},
+  _monotonic_time{monotonic_clock::to_monotonic(run_time)},
+  _sequence{0},
+  _wheel_next{nullptr},
+  _wheel_prev{nullptr},
+  _wheel_slot{0} {}
 
 /**
  *  Execute service check.
@@ -101,7 +118,7 @@ static void _exec_event_service_check(timed_event* event) {
   // get check latency.
   timeval tv;
   gettimeofday(&tv, NULL);
-  double latency = (double)((double)(tv.tv_sec - event->run_time)
+  double latency = (double)((double)(tv.tv_sec - event->get_run_time())
                             + (double)(tv.tv_usec / 1000) / 1000.0);
 
   logger(dbg_events, basic)
@@ -307,7 +324,7 @@ static void _exec_event_host_check(timed_event* event) {
   // get check latency.
   timeval tv;
   gettimeofday(&tv, NULL);
-  double latency = (double)((double)(tv.tv_sec - event->run_time)
+  double latency = (double)((double)(tv.tv_sec - event->get_run_time())
                             + (double)(tv.tv_usec / 1000) / 1000.0);
 
   logger(dbg_events, basic)
@@ -343,8 +360,8 @@ static void _exec_event_reschedule_checks(timed_event* event) {
   logger(dbg_events, basic)
     << "** Reschedule Checks Event";
 
-  // adjust scheduling of host and service checks.
-  adjust_check_scheduling();
+  // checks are leveled when they are scheduled (see
+  // events::load_leveler), nothing is left to adjust.
 }
 
 /**
@@ -415,40 +432,15 @@ void add_event(
   logger(dbg_functions, basic)
     << "add_event()";
 
-  timed_event_list *list;
-
-  if (priority == timed_event::low) {
-    list = &timed_event::event_list_low;
-  } else {
-    list = &timed_event::event_list_high;
-  }
-
-  // add the event to the head of the list if there are
-  // no other events.
-  if (list->empty()) {
-    list->push_front(event);
-  }
-
-  // add event to head of the list if it should be executed first.
-  else if (event->run_time < (*list->begin())->run_time) {
-    list->push_front(event);
-  }
+  // place the event according to its next execution time.
+  timed_event_list& list(priority == timed_event::low
+                         ? timed_event::event_list_low
+                         : timed_event::event_list_high);
+  list.push(event);
 
-  // else place the event according to next execution time.
-  else {
-    // start from the end of the list, as new events are likely to
-    // be executed in the future, rather than now...
-    for(timed_event_list::reverse_iterator
-          it(list->rbegin()),
-          end(list->rend());
-        it != end;
-        ++it) {
-      if (event->run_time >= (*it)->run_time) {
-        list->insert(it.base(), event);
-        break;
-      }
-    }
-  }
+  // the events loop may be waiting for a later event.
+  if (list.front() == event)
+    events::loop::wakeup();
 
   // send event data to broker.
   broker_timed_event(
@@ -459,6 +451,47 @@ void add_event(
     nullptr);
 }
 
+/**
+ *  Add many events to the event list at once, building the schedule
+ *  in a single pass. The broker is notified of every event and the
+ *  events loop is woken up once.
+ *
+ *  @param[in] events    Events to add.
+ *  @param[in] priority  Priority of the list events are added to.
+ */
+void add_events(
+       std::vector<timed_event*> const& events,
+       timed_event::priority priority) {
+  logger(dbg_functions, basic)
+    << "add_events()";
+
+  if (events.empty())
+    return ;
+
+  timed_event_list& list(priority == timed_event::low
+                         ? timed_event::event_list_low
+                         : timed_event::event_list_high);
+  timed_event const* first(list.front());
+  list.push(events);
+
+  // the events loop may be waiting for a later event.
+  if (list.front() != first)
+    events::loop::wakeup();
+
+  // send event data to broker.
+  for (std::vector<timed_event*>::const_iterator
+         it(events.begin()),
+         end(events.end());
+       it != end;
+       ++it)
+    broker_timed_event(
+      NEBTYPE_TIMEDEVENT_ADD,
+      NEBFLAG_NONE,
+      NEBATTR_NONE,
+      *it,
+      nullptr);
+}
+
 /**
  *  Adjusts a timestamp variable in accordance with a system
  *  time change.
@@ -538,78 +571,68 @@ void compensate_for_system_time_change(
       << hours << "h " << minutes << "m " << seconds << "s.";
   }
 
-  // log the time change.
-  logger(log_process_info | log_runtime_warning, basic)
-    << "Warning: A system time change of " << days << "d "
-    << hours << "h " << minutes << "m " << seconds << "s ("
-    << (last_time > current_time ? "backwards" : "forwards")
-    << " in time) has been detected.  Compensating...";
-
-  // adjust the next run time for all high priority timed events.
-  for (timed_event_list::iterator
-         it(timed_event::event_list_high.begin()),
-         end(timed_event::event_list_high.end());
-       it != end;
-       ++it) {
-
-    // skip special events that occur at specific times...
-    if (!(*it)->compensate_for_time_change)
-      continue;
-
-    // use custom timing function.
-    if ((*it)->timing_func) {
-      union {
-        time_t (*func)(void);
-        void* data;
-      } timing;
-      timing.data = (*it)->timing_func;
-      (*it)->run_time = (*timing.func)();
-    }
-
-    // else use standard adjustment.
-    else
-      (*it)->run_time = adjust_timestamp_for_time_change(
-        last_time,
-        current_time,
-        time_difference,
-        (*it)->run_time);
-  }
-
-  // resort event list (some events may be out of order at this point).
-  resort_event_list(timed_event::high);
-
-  // adjust the next run time for all low priority timed events.
-  for (timed_event_list::iterator
-         it(timed_event::event_list_low.begin()),
-         end(timed_event::event_list_low.end());
-       it != end;
-       ++it) {
-
-    // skip special events that occur at specific times...
-    if (!(*it)->compensate_for_time_change)
-      continue;
+  // log the time change, small forward changes (NTP steps) are
+  // harmless and only logged in debug mode.
+  if ((last_time > current_time)
+      || (time_difference >= config->time_change_threshold()))
+    logger(log_process_info | log_runtime_warning, basic)
+      << "Warning: A system time change of " << days << "d "
+      << hours << "h " << minutes << "m " << seconds << "s ("
+      << (last_time > current_time ? "backwards" : "forwards")
+      << " in time) has been detected.  Compensating...";
+
+  // timed events and next check times are kept on the monotonic clock
+  // and follow the wall clock through its skew. Only events that occur
+  // at specific times or that use a timing function are moved.
+  time_t shift(static_cast<time_t>(current_time)
+               - static_cast<time_t>(last_time));
+  for (unsigned int i(0); i < timed_event::priority_num; ++i) {
+    timed_event_list& list(i == timed_event::high
+                           ? timed_event::event_list_high
+                           : timed_event::event_list_low);
+    std::vector<timed_event*> moved(
+                                list.pinned().begin(),
+                                list.pinned().end());
+    for (std::vector<timed_event*>::const_iterator
+           it(moved.begin()),
+           end(moved.end());
+         it != end;
+         ++it) {
+
+      // use custom timing function.
+      if ((*it)->timing_func) {
+        union {
+          time_t (*func)(void);
+          void* data;
+        } timing;
+        timing.data = (*it)->timing_func;
+        (*it)->set_run_time((*timing.func)());
+      }
 
-    // use custom timing function.
-    if ((*it)->timing_func) {
-      union {
-        time_t (*func)(void);
-        void* data;
-      } timing;
-      timing.data = (*it)->timing_func;
-      (*it)->run_time = (*timing.func)();
+      // special events that occur at specific times...
+      else
+        (*it)->set_run_time((*it)->get_run_time() - shift);
+
+      list.update(*it);
+      broker_timed_event(
+        NEBTYPE_TIMEDEVENT_ADD,
+        NEBFLAG_NONE,
+        NEBATTR_NONE,
+        *it,
+        nullptr);
     }
-
-    // else use standard adjustment.
-    else
-      (*it)->run_time = adjust_timestamp_for_time_change(
-        last_time,
-        current_time,
-        time_difference,
-        (*it)->run_time);
   }
 
-  // resort event list (some events may be out of order at this point).
-  resort_event_list(timed_event::low);
+  // notification times are compared with the wall clock, adjust the
+  // timestamps they depend on and recalculate next notification times.
+  // Next check times are kept on the monotonic clock.
+  auto adjust = [&](time_t ts) {
+    return adjust_timestamp_for_time_change(
+             last_time,
+             current_time,
+             time_difference,
+             ts);
+  };
 
   // adjust service timestamps.
   for (service_map::iterator
@@ -617,38 +640,17 @@ void compensate_for_system_time_change(
          end(service::services.end());
        it != end;
        ++it) {
-    it->second->set_last_notification(adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_notification()));
-    it->second->set_last_check(adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_check()));
-    it->second->set_next_check(adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_next_check()));
-    it->second->set_last_state_change(adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_state_change()));
-    it->second->set_last_hard_state_change(adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_hard_state_change()));
-
-    it->second->set_initial_notif_time(adjust_timestamp_for_time_change(
-        last_time, current_time, time_difference,
-        it->second->get_initial_notif_time()));
-    it->second->set_last_acknowledgement(adjust_timestamp_for_time_change(
-        last_time, current_time, time_difference,
-        it->second->get_last_acknowledgement()));
+    it->second->set_last_notification(
+      adjust(it->second->get_last_notification()));
+    it->second->set_last_check(adjust(it->second->get_last_check()));
+    it->second->set_last_state_change(
+      adjust(it->second->get_last_state_change()));
+    it->second->set_last_hard_state_change(
+      adjust(it->second->get_last_hard_state_change()));
+    it->second->set_initial_notif_time(
+      adjust(it->second->get_initial_notif_time()));
+    it->second->set_last_acknowledgement(
+      adjust(it->second->get_last_acknowledgement()));
 
     // recalculate next re-notification time.
     it->second->set_next_notification(
@@ -661,51 +663,24 @@ void compensate_for_system_time_change(
 
   // adjust host timestamps.
   for (host_map::iterator
-         it(com::centreon::engine::host::hosts.begin()),
-         end(com::centreon::engine::host::hosts.end());
+         it(host::hosts.begin()),
+         end(host::hosts.end());
        it != end;
        ++it) {
-    time_t last_host_notif{adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_notification())};
-    time_t last_check{adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_check())};
-    time_t next_check{adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_next_check())};
-    time_t last_state_change{adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_state_change())};
-    time_t last_hard_state_change{adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_hard_state_change())};
-    time_t last_state_history_update{adjust_timestamp_for_time_change(
-      last_time,
-      current_time,
-      time_difference,
-      it->second->get_last_state_history_update())};
-
-    it->second->set_last_notification(last_host_notif);
-    it->second->set_last_check(last_check);
-    it->second->set_next_check(next_check);
-    it->second->set_last_state_change(last_state_change);
-    it->second->set_last_hard_state_change(last_hard_state_change);
-    it->second->set_last_state_history_update(last_state_history_update);
+    it->second->set_last_notification(
+      adjust(it->second->get_last_notification()));
+    it->second->set_last_check(adjust(it->second->get_last_check()));
+    it->second->set_last_state_change(
+      adjust(it->second->get_last_state_change()));
+    it->second->set_last_hard_state_change(
+      adjust(it->second->get_last_hard_state_change()));
+    it->second->set_last_state_history_update(
+      adjust(it->second->get_last_state_history_update()));
+
     // recalculate next re-notification time.
     it->second->set_next_notification(
-    it->second->get_next_notification_time(
-      it->second->get_last_notification()));
+      it->second->get_next_notification_time(
+        it->second->get_last_notification()));
 
     // update the status data.
     it->second->update_status(false);
@@ -776,14 +751,26 @@ int handle_timed_event(timed_event* event) {
 
   logger(dbg_events, basic)
     << "** Timed Event ** Type: " << event->event_type
-    << ", Run Time: " << my_ctime(&event->run_time);
+    << ", Run Time: " << string::ctime(event->get_run_time());
+
+  // how late is the event?
+  int64_t start(events::monotonic_clock::now_us());
+  int64_t lag(start
+              - static_cast<int64_t>(event->monotonic_time()) * 1000000);
+  uint32_t event_type(event->event_type);
 
   // how should we handle the event?
-  if (event->event_type < sizeof(tab_exec_event) / sizeof(*tab_exec_event))
-    (tab_exec_event[event->event_type])(event);
-  else if (event->event_type == EVENT_USER_FUNCTION)
+  if (event_type < sizeof(tab_exec_event) / sizeof(*tab_exec_event) - 1)
+    (tab_exec_event[event_type])(event);
+  else if (event_type == EVENT_USER_FUNCTION)
     _exec_event_user_function(event);
 
+  // account the time spent by the events loop.
+  events::event_stats::instance().record(
+    event_type,
+    (lag > 0) ? lag : 0,
+    events::monotonic_clock::now_us() - start);
+
   return OK;
 }
 
@@ -811,43 +798,58 @@ void remove_event(
   if (!event)
     return;
 
-  auto eraser = [](timed_event_list& l, timed_event* event) {
-    for (auto it = l.begin(), end = l.end(); it != end; ++it) {
-      if (*it == event) {
-        l.erase(it);
-        break;
-      }
-    }
-  };
   if (priority == timed_event::low)
-    eraser(timed_event::event_list_low, event);
+    timed_event::event_list_low.erase(event);
   else
-    eraser(timed_event::event_list_high, event);
+    timed_event::event_list_high.erase(event);
 }
 
+/**
+ *  Find a scheduled event by its type and data.
+ *
+ *  @param[in] priority    Event list to search.
+ *  @param[in] event_type  Event type.
+ *  @param[in] data        Event data.
+ *
+ *  @return The matching event if found, nullptr otherwise.
+ */
 timed_event* timed_event::find_event(timed_event::priority priority, uint32_t event_type, void *data)
 {
-  timed_event_list *list;
-
   logger(dbg_functions, basic)
-    << "resort_event_list()";
+    << "find_event()";
 
-  // move current event list to temp list.
-  if (priority == timed_event::low) {
-    list = &timed_event::event_list_low;
-  } else {
-    list = &timed_event::event_list_high;
-  }
+  if (priority == timed_event::low)
+    return timed_event::event_list_low.find(event_type, data);
+  return timed_event::event_list_high.find(event_type, data);
+}
 
-  for (timed_event_list::iterator
-         it{list->begin()},
-         end{list->end()};
-       it != end;
-       ++it)
-    if ((*it)->event_type == event_type && (*it)->event_data == data)
-      return *it;
+/**
+ *  Get the time at which the event must run.
+ *
+ *  @return Run time on the wall clock, converted from the monotonic
+ *          clock with the current skew.
+ */
+time_t timed_event::get_run_time() const throw () {
+  return monotonic_clock::to_wall(_monotonic_time);
+}
 
-  return nullptr;
+/**
+ *  Get the time at which the event must run on the scheduler clock.
+ *
+ *  @return Run time on the monotonic clock.
+ */
+time_t timed_event::monotonic_time() const throw () {
+  return _monotonic_time;
+}
+
+/**
+ *  Set the time at which the event must run. The event list the event
+ *  is stored in must then be updated.
+ *
+ *  @param[in] run_time  Run time on the wall clock.
+ */
+void timed_event::set_run_time(time_t run_time) throw () {
+  _monotonic_time = monotonic_clock::to_monotonic(run_time);
 }
 
 /**
@@ -872,16 +874,17 @@ void reschedule_event(
         void* data;
       } timing;
       timing.data = event->timing_func;
-      event->run_time = (*timing.func)();
+      event->set_run_time((*timing.func)());
     }
 
     // normal recurring events.
     else {
       time_t current_time(0L);
-      event->run_time = event->run_time + event->event_interval;
+      time_t run_time(event->get_run_time() + event->event_interval);
       time(&current_time);
-      if (event->run_time < current_time)
-        event->run_time = current_time;
+      if (run_time < current_time)
+        run_time = current_time;
+      event->set_run_time(run_time);
     }
   }
 
@@ -889,11 +892,6 @@ void reschedule_event(
   add_event(event, priority);
 }
 
-static bool compare_event(timed_event* const& first, timed_event* const& second)
-{
-  return first->run_time < second->run_time;
-}
-
 /**
  *  Resorts an event list by event execution time - needed when
  *  compensating for system time changes.
@@ -907,13 +905,12 @@ void resort_event_list(timed_event::priority priority) {
   logger(dbg_functions, basic)
     << "resort_event_list()";
 
-  // move current event list to temp list.
   if (priority == timed_event::low) {
     list = &timed_event::event_list_low;
   } else {
     list = &timed_event::event_list_high;
   }
-  std::sort(list->begin(), list->end(), compare_event);
+  list->resort();
 
   // send event data to broker.
   for (timed_event_list::iterator
@@ -950,6 +947,17 @@ void timed_event::schedule(bool high_priority) {
  *  @return The event name.
  */
 std::string const& events::name(timed_event const& evt) {
+  return name(evt.event_type);
+}
+
+/**
+ *  Get the name of an event type.
+ *
+ *  @param[in] event_type  The event type.
+ *
+ *  @return The event type name.
+ */
+std::string const& events::name(uint32_t event_type) {
   static std::string const event_unknown("\"unknown\"");
   static std::string const event_sleep("EVENT_SLEEP");
   static std::string const event_user_function("EVENT_USER_FUNCTION");
@@ -974,11 +982,11 @@ std::string const& events::name(timed_event const& evt) {
     "EVENT_EXPIRE_SERVICE_ACK"
   };
 
-  if (evt.event_type < sizeof(event_names) / sizeof(event_names[0]))
-    return event_names[evt.event_type];
-  if (evt.event_type == EVENT_SLEEP)
+  if (event_type < sizeof(event_names) / sizeof(event_names[0]))
+    return event_names[event_type];
+  if (event_type == EVENT_SLEEP)
     return event_sleep;
-  if (evt.event_type == EVENT_USER_FUNCTION)
+  if (event_type == EVENT_USER_FUNCTION)
     return event_user_function;
   return event_unknown;
 }
@@ -1026,7 +1034,7 @@ bool operator==(
   else if (obj1.event_data != obj2.event_data)
     return false;
 
-  return obj1.run_time == obj2.run_time
+  return obj1.get_run_time() == obj2.get_run_time()
           && obj1.recurring == obj2.recurring
           && obj1.event_interval == obj2.event_interval
           && obj1.compensate_for_time_change == obj2.compensate_for_time_change
@@ -1060,7 +1068,7 @@ bool operator!=(
 std::ostream& operator<<(std::ostream& os, timed_event const& obj) {
   os << "timed_event {\n"
     "  event_type:                 " << events::name(obj) << "\n"
-    "  run_time:                   " << string::ctime(obj.run_time) << "\n"
+    "  run_time:                   " << string::ctime(obj.get_run_time()) << "\n"
     "  recurring:                  " << obj.recurring << "\n"
     "  event_interval:             " << obj.event_interval << "\n"
     "  compensate_for_time_change: " << obj.compensate_for_time_change << "\n"
@@ -0,0 +1,438 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <functional>
+#include "com/centreon/engine/events/monotonic_clock.hh"
+#include "com/centreon/engine/events/timed_event.hh"
+#include "com/centreon/engine/events/timed_event_list.hh"
+#include "com/centreon/engine/events/timing_wheel.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::events;
+
+/**
+ *  Default constructor.
+ */
+timed_event_list::timed_event_list()
+  : _sequence(0) {}
+
+/**
+ *  Destructor.
+ *
+ *  Events are not owned by the list and are therefore not deleted.
+ */
+timed_event_list::~timed_event_list() throw () {}
+
+/**
+ *  Notify the scheduler of the current time. With the wheel scheduler,
+ *  this moves the events that are due in front of the list.
+ *
+ *  @param[in] now  Current time on the monotonic clock.
+ */
+void timed_event_list::advance(time_t now) {
+  if (_wheel)
+    _wheel->advance(now);
+}
+
+/**
+ *  Get an iterator on the first stored event. Iteration is not ordered
+ *  by run time.
+ *
+ *  @return Iterator.
+ */
+timed_event_list::const_iterator timed_event_list::begin() const throw () {
+  return _events.begin();
+}
+
+/**
+ *  Remove all events from the list. Events are not deleted.
+ */
+void timed_event_list::clear() throw () {
+  _events.clear();
+  _index.clear();
+  _pinned.clear();
+  if (_wheel)
+    _wheel->clear();
+}
+
+/**
+ *  Check if an event is stored in this list.
+ *
+ *  @param[in] evt  Event.
+ *
+ *  @return True if evt is in this list.
+ */
+bool timed_event_list::contains(timed_event const* evt) const throw () {
+  return (evt
+          && evt->_position < _events.size()
+          && _events[evt->_position] == evt);
+}
+
+/**
+ *  Check if the list is empty.
+ *
+ *  @return True if no event is scheduled.
+ */
+bool timed_event_list::empty() const throw () {
+  return _events.empty();
+}
+
+/**
+ *  Get the past-the-end iterator.
+ *
+ *  @return Iterator.
+ */
+timed_event_list::const_iterator timed_event_list::end() const throw () {
+  return _events.end();
+}
+
+/**
+ *  Remove an event from the list. The event is not deleted.
+ *
+ *  @param[in] evt  Event to remove.
+ *
+ *  @return True if the event was found and removed.
+ */
+bool timed_event_list::erase(timed_event* evt) {
+  if (!contains(evt))
+    return false;
+  _index_erase(evt);
+  _pinned.erase(evt);
+  if (_wheel)
+    _wheel->remove(evt);
+  _remove_at(evt->_position);
+  return true;
+}
+
+/**
+ *  Find an event by its type and data.
+ *
+ *  @param[in] event_type  Event type.
+ *  @param[in] event_data  Event data.
+ *
+ *  @return The first matching event scheduled, nullptr if none match.
+ */
+timed_event* timed_event_list::find(
+               uint32_t event_type,
+               void* event_data) const {
+  std::pair<index::const_iterator, index::const_iterator>
+    range(_index.equal_range(key(event_type, event_data)));
+  timed_event* found(nullptr);
+  for (index::const_iterator it(range.first); it != range.second; ++it)
+    if (!found || _before(it->second, found))
+      found = it->second;
+  return found;
+}
+
+/**
+ *  Get the next event to run.
+ *
+ *  @return The event with the smallest run time (any due event with
+ *          the wheel scheduler), nullptr if the list is empty.
+ */
+timed_event* timed_event_list::front() const {
+  if (_wheel)
+    return _wheel->front();
+  return _events.empty() ? nullptr : _events.front();
+}
+
+/**
+ *  Get the scheduler used by this list.
+ *
+ *  @return Scheduler type.
+ */
+timed_event_list::scheduler_type timed_event_list::get_scheduler() const throw () {
+  return _wheel ? wheel : heap;
+}
+
+/**
+ *  Get the events that occur at specific wall clock times or whose run
+ *  time is computed by a timing function.
+ *
+ *  @return Events to move when the wall clock changes.
+ */
+std::unordered_set<timed_event*> const& timed_event_list::pinned() const throw () {
+  return _pinned;
+}
+
+/**
+ *  Remove the next event to run from the list.
+ *
+ *  @return The removed event, nullptr if the list is empty.
+ */
+timed_event* timed_event_list::pop_front() {
+  timed_event* evt(front());
+  if (evt)
+    erase(evt);
+  return evt;
+}
+
+/**
+ *  Add an event to the list.
+ *
+ *  @param[in] evt  Event to add. If it is already stored, it is just
+ *                  moved according to its new run time.
+ */
+void timed_event_list::push(timed_event* evt) {
+  if (contains(evt)) {
+    update(evt);
+    return;
+  }
+  _append(evt);
+  if (!_wheel)
+    _sift_up(evt->_position);
+}
+
+/**
+ *  Add many events to the list. Events sharing the same run time are
+ *  ordered like in the vector. This is how the initial scheduling
+ *  fills the list: when the batch is at least as large as the list,
+ *  the heap is built once in O(n) instead of being sifted for every
+ *  event.
+ *
+ *  @param[in] events  Events to add. Events already stored are just
+ *                     moved according to their new run time.
+ */
+void timed_event_list::push(std::vector<timed_event*> const& events) {
+  // Move stored events first, while the heap is still consistent.
+  for (std::vector<timed_event*>::const_iterator
+         it(events.begin()),
+         end(events.end());
+       it != end;
+       ++it)
+    if (contains(*it))
+      update(*it);
+
+  size_t previous(_events.size());
+  _events.reserve(previous + events.size());
+  _index.reserve(_index.size() + events.size());
+  for (std::vector<timed_event*>::const_iterator
+         it(events.begin()),
+         end(events.end());
+       it != end;
+       ++it)
+    if (!contains(*it))
+      _append(*it);
+  if (_wheel)
+    return ;
+  if (_events.size() - previous >= previous) {
+    for (size_t i(_events.size() / 2); i-- > 0;)
+      _sift_down(i);
+  }
+  else
+    for (size_t i(previous), end(_events.size()); i < end; ++i)
+      _sift_up(i);
+}
+
+/**
+ *  Restore the ordering after the run time of several events was
+ *  modified in place.
+ */
+void timed_event_list::resort() {
+  if (_wheel)
+    _wheel->reset(monotonic_clock::now());
+  else if (!_events.empty())
+    for (size_t i(_events.size() / 2); i-- > 0;)
+      _sift_down(i);
+}
+
+/**
+ *  Change the scheduler used by this list. Scheduled events are kept.
+ *
+ *  @param[in] type  New scheduler type.
+ */
+void timed_event_list::set_scheduler(scheduler_type type) {
+  if (type == get_scheduler())
+    return ;
+  if (type == wheel) {
+    _wheel.reset(new events::timing_wheel(monotonic_clock::now()));
+    for (std::vector<timed_event*>::const_iterator
+           it(_events.begin()),
+           end(_events.end());
+         it != end;
+         ++it)
+      _wheel->insert(*it);
+  }
+  else {
+    _wheel.reset();
+    resort();
+  }
+}
+
+/**
+ *  Get the number of scheduled events.
+ *
+ *  @return Number of events.
+ */
+size_t timed_event_list::size() const throw () {
+  return _events.size();
+}
+
+/**
+ *  Move an event according to its (modified) run time.
+ *
+ *  @param[in] evt  Event already stored in the list.
+ */
+void timed_event_list::update(timed_event* evt) {
+  if (!contains(evt))
+    return ;
+  // The event goes behind the ones already scheduled at the same time.
+  evt->_sequence = _sequence++;
+  if (_wheel) {
+    _wheel->remove(evt);
+    _wheel->insert(evt);
+  }
+  else {
+    _sift_up(evt->_position);
+    _sift_down(evt->_position);
+  }
+}
+
+/**
+ *  Hash an index key.
+ *
+ *  @param[in] k  Key.
+ *
+ *  @return Hash value.
+ */
+size_t timed_event_list::key_hash::operator()(key const& k) const throw () {
+  size_t h(std::hash<void*>()(k.second));
+  return (h ^ (std::hash<uint32_t>()(k.first)
+               + 0x9e3779b9 + (h << 6) + (h >> 2)));
+}
+
+/**
+ *  Store a new event at the end of the list and index it. The heap
+ *  ordering is left to the caller.
+ *
+ *  @param[in] evt  Event.
+ */
+void timed_event_list::_append(timed_event* evt) {
+  evt->_sequence = _sequence++;
+  evt->_indexed_type = evt->event_type;
+  evt->_indexed_data = evt->event_data;
+  _index.insert(std::make_pair(
+                  key(evt->_indexed_type, evt->_indexed_data),
+                  evt));
+  if (!evt->compensate_for_time_change || evt->timing_func)
+    _pinned.insert(evt);
+  _events.push_back(evt);
+  evt->_position = _events.size() - 1;
+  if (_wheel)
+    _wheel->insert(evt);
+}
+
+/**
+ *  Check whether an event must run before another.
+ *
+ *  @param[in] first   First event.
+ *  @param[in] second  Second event.
+ *
+ *  @return True if first runs before second.
+ */
+bool timed_event_list::_before(
+       timed_event const* first,
+       timed_event const* second) const throw () {
+  return ((first->_monotonic_time < second->_monotonic_time)
+          || ((first->_monotonic_time == second->_monotonic_time)
+              && (first->_sequence < second->_sequence)));
+}
+
+/**
+ *  Remove an event from the lookup index.
+ *
+ *  @param[in] evt  Event.
+ */
+void timed_event_list::_index_erase(timed_event* evt) {
+  std::pair<index::iterator, index::iterator>
+    range(_index.equal_range(key(evt->_indexed_type, evt->_indexed_data)));
+  for (index::iterator it(range.first); it != range.second; ++it)
+    if (it->second == evt) {
+      _index.erase(it);
+      break ;
+    }
+}
+
+/**
+ *  Store an event at some position.
+ *
+ *  @param[in] evt  Event.
+ *  @param[in] pos  Position.
+ */
+void timed_event_list::_place(timed_event* evt, size_t pos) throw () {
+  _events[pos] = evt;
+  evt->_position = pos;
+}
+
+/**
+ *  Remove the event stored at some position.
+ *
+ *  @param[in] pos  Position.
+ */
+void timed_event_list::_remove_at(size_t pos) {
+  timed_event* last(_events.back());
+  _events.pop_back();
+  if (pos < _events.size()) {
+    _place(last, pos);
+    // The wheel scheduler does not rely on the storage order.
+    if (!_wheel) {
+      _sift_up(pos);
+      _sift_down(last->_position);
+    }
+  }
+}
+
+/**
+ *  Move an event down the heap until the heap property is restored.
+ *
+ *  @param[in] pos  Event position.
+ */
+void timed_event_list::_sift_down(size_t pos) throw () {
+  timed_event* evt(_events[pos]);
+  size_t size(_events.size());
+  while (true) {
+    size_t child(2 * pos + 1);
+    if (child >= size)
+      break ;
+    if ((child + 1 < size) && _before(_events[child + 1], _events[child]))
+      ++child;
+    if (!_before(_events[child], evt))
+      break ;
+    _place(_events[child], pos);
+    pos = child;
+  }
+  _place(evt, pos);
+}
+
+/**
+ *  Move an event up the heap until the heap property is restored.
+ *
+ *  @param[in] pos  Event position.
+ */
+void timed_event_list::_sift_up(size_t pos) throw () {
+  timed_event* evt(_events[pos]);
+  while (pos > 0) {
+    size_t parent((pos - 1) / 2);
+    if (!_before(evt, _events[parent]))
+      break ;
+    _place(_events[parent], pos);
+    pos = parent;
+  }
+  _place(evt, pos);
+}
@@ -0,0 +1,421 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+#include "com/centreon/engine/events/timed_event.hh"
+#include "com/centreon/engine/events/timing_wheel.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::events;
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] now  Current time on the monotonic clock. Events
+ *                  scheduled before are ready.
+ */
+timing_wheel::timing_wheel(time_t now)
+  : _current(now),
+    _first_level(0),
+    _front(nullptr),
+    _ready(0),
+    _size(0) {
+  memset(_occupied, 0, sizeof(_occupied));
+  memset(_slots, 0, sizeof(_slots));
+}
+
+/**
+ *  Destructor. Events are not owned by the wheel.
+ */
+timing_wheel::~timing_wheel() throw () {}
+
+/**
+ *  Move the wheel forward, making ready every event whose run time is
+ *  lower or equal to now.
+ *
+ *  @param[in] now  Current time on the monotonic clock.
+ */
+void timing_wheel::advance(time_t now) {
+  while (_current < now) {
+    // Nothing is scheduled but ready events, jump to now.
+    if (_size == _ready) {
+      _current = now;
+      break ;
+    }
+
+    // Nothing in the first level, jump to the next cascade.
+    if (!_first_level) {
+      time_t last(_current | (first_level_slots - 1));
+      if (last >= now) {
+        _current = now;
+        break ;
+      }
+      _current = last;
+    }
+    ++_current;
+
+    // Cascade upper levels down when the first level wraps.
+    uint64_t current(_current);
+    if (!(current & (first_level_slots - 1))) {
+      uint64_t level1(current >> first_level_bits);
+      uint64_t level2(level1 >> level_bits);
+      uint64_t level3(level2 >> level_bits);
+      if (!(level1 & (level_slots - 1))) {
+        if (!(level2 & (level_slots - 1))) {
+          if (!(level3 & (level_slots - 1)))
+            _cascade(overflow_slot);
+          _cascade(first_level_slots
+                   + 2 * level_slots
+                   + (level3 & (level_slots - 1)));
+        }
+        _cascade(first_level_slots
+                 + level_slots
+                 + (level2 & (level_slots - 1)));
+      }
+      _cascade(first_level_slots + (level1 & (level_slots - 1)));
+    }
+
+    // Events of the current second are now ready, they come first.
+    unsigned int idx(current & (first_level_slots - 1));
+    slot& s(_slots[idx]);
+    if (s.head) {
+      for (timed_event* evt(s.head); evt; evt = evt->_wheel_next) {
+        evt->_wheel_slot = ready_slot;
+        --_first_level;
+        ++_ready;
+      }
+      slot& ready(_slots[ready_slot]);
+      if (ready.tail) {
+        ready.tail->_wheel_next = s.head;
+        s.head->_wheel_prev = ready.tail;
+      }
+      else
+        ready.head = s.head;
+      ready.tail = s.tail;
+      s.head = nullptr;
+      s.tail = nullptr;
+      _occupied[idx / 64] &= ~(static_cast<uint64_t>(1) << (idx % 64));
+      _front = ready.head;
+    }
+  }
+}
+
+/**
+ *  Remove all events from the wheel.
+ */
+void timing_wheel::clear() throw () {
+  memset(_occupied, 0, sizeof(_occupied));
+  memset(_slots, 0, sizeof(_slots));
+  _first_level = 0;
+  _front = nullptr;
+  _ready = 0;
+  _size = 0;
+}
+
+/**
+ *  Get the current time of the wheel.
+ *
+ *  @return Time of the last advance.
+ */
+time_t timing_wheel::current() const throw () {
+  return _current;
+}
+
+/**
+ *  Get the next event to run. Ready events come first, in FIFO order.
+ *
+ *  @return Next event, nullptr if the wheel is empty.
+ */
+timed_event* timing_wheel::front() const {
+  if (_front || !_size)
+    return _front;
+
+  // Ready events.
+  if (_slots[ready_slot].head)
+    return _front = _slots[ready_slot].head;
+
+  // Upper levels are only cascaded on their boundaries, so the first
+  // non empty slot of each level must be checked.
+  timed_event* earliest(nullptr);
+
+  // First level, all events of a slot have the same run time.
+  uint64_t current(_current);
+  if (_first_level) {
+    int i(_first_occupied(
+            0,
+            first_level_slots,
+            (current + 1) & (first_level_slots - 1)));
+    if (i >= 0)
+      earliest = _slots[i].head;
+  }
+
+  // Upper levels.
+  unsigned int offset(first_level_slots);
+  uint64_t position(current >> first_level_bits);
+  for (unsigned int level(1);
+       level < levels;
+       ++level, offset += level_slots, position >>= level_bits) {
+    int i(_first_occupied(
+            offset,
+            level_slots,
+            (position + 1) & (level_slots - 1)));
+    if (i >= 0) {
+      timed_event* evt(_earliest(offset + i));
+      if (!earliest
+          || (evt->_monotonic_time < earliest->_monotonic_time))
+        earliest = evt;
+    }
+  }
+
+  // Overflow.
+  timed_event* evt(_earliest(overflow_slot));
+  if (evt
+      && (!earliest || (evt->_monotonic_time < earliest->_monotonic_time)))
+    earliest = evt;
+
+  return _front = earliest;
+}
+
+/**
+ *  Insert an event in the wheel.
+ *
+ *  @param[in] evt  Event to insert.
+ */
+void timing_wheel::insert(timed_event* evt) {
+  // The cached front is known if set or if the wheel is empty.
+  bool known(_front || !_size);
+  unsigned int idx(_slot_of(evt->_monotonic_time));
+  _append(idx, evt);
+  ++_size;
+  if (known) {
+    if (idx == ready_slot)
+      _front = _slots[ready_slot].head;
+    else if (!_front
+             || ((_front->_wheel_slot != ready_slot)
+                 && (evt->_monotonic_time < _front->_monotonic_time)))
+      _front = evt;
+  }
+}
+
+/**
+ *  Remove an event from the wheel.
+ *
+ *  @param[in] evt  Event to remove.
+ */
+void timing_wheel::remove(timed_event* evt) {
+  _unlink(evt);
+  --_size;
+  if (_front == evt)
+    _front = nullptr;
+}
+
+/**
+ *  Place again every event, after their run time was modified in place.
+ *
+ *  @param[in] now  Current time.
+ */
+void timing_wheel::reset(time_t now) {
+  std::vector<timed_event*> events;
+  events.reserve(_size);
+  for (unsigned int i(0); i < slot_count; ++i)
+    for (timed_event* evt(_slots[i].head); evt; evt = evt->_wheel_next)
+      events.push_back(evt);
+  clear();
+  if (now < _current)
+    _current = now;
+  for (std::vector<timed_event*>::const_iterator
+         it(events.begin()),
+         end(events.end());
+       it != end;
+       ++it)
+    insert(*it);
+}
+
+/**
+ *  Get the number of events in the wheel.
+ *
+ *  @return Number of events.
+ */
+size_t timing_wheel::size() const throw () {
+  return _size;
+}
+
+/**
+ *  Append an event to a slot.
+ *
+ *  @param[in] idx  Slot index.
+ *  @param[in] evt  Event.
+ */
+void timing_wheel::_append(unsigned int idx, timed_event* evt) {
+  slot& s(_slots[idx]);
+  evt->_wheel_slot = idx;
+  evt->_wheel_next = nullptr;
+  evt->_wheel_prev = s.tail;
+  if (s.tail)
+    s.tail->_wheel_next = evt;
+  else
+    s.head = evt;
+  s.tail = evt;
+  if (idx < first_level_slots)
+    ++_first_level;
+  else if (idx == ready_slot)
+    ++_ready;
+  if (idx < overflow_slot)
+    _occupied[idx / 64] |= static_cast<uint64_t>(1) << (idx % 64);
+  if ((idx >= first_level_slots) && (idx != ready_slot)) {
+    if (s.head == evt)
+      s.earliest = evt;
+    else if (s.earliest
+             && (evt->_monotonic_time < s.earliest->_monotonic_time))
+      s.earliest = evt;
+  }
+}
+
+/**
+ *  Place again the events of an upper level slot.
+ *
+ *  @param[in] idx  Slot index.
+ */
+void timing_wheel::_cascade(unsigned int idx) {
+  timed_event* evt(_slots[idx].head);
+  if (!evt)
+    return ;
+  _slots[idx].earliest = nullptr;
+  _slots[idx].head = nullptr;
+  _slots[idx].tail = nullptr;
+  if (idx < overflow_slot)
+    _occupied[idx / 64] &= ~(static_cast<uint64_t>(1) << (idx % 64));
+  while (evt) {
+    timed_event* next(evt->_wheel_next);
+    _append(_slot_of(evt->_monotonic_time), evt);
+    evt = next;
+  }
+}
+
+/**
+ *  Get the earliest event of an upper level or overflow slot. It is
+ *  cached until removed from the slot.
+ *
+ *  @param[in] idx  Slot index.
+ *
+ *  @return Earliest event of the slot, nullptr if it is empty.
+ */
+timed_event* timing_wheel::_earliest(unsigned int idx) const {
+  slot const& s(_slots[idx]);
+  if (!s.earliest && s.head) {
+    s.earliest = s.head;
+    for (timed_event* evt(s.head->_wheel_next);
+         evt;
+         evt = evt->_wheel_next)
+      if (evt->_monotonic_time < s.earliest->_monotonic_time)
+        s.earliest = evt;
+  }
+  return s.earliest;
+}
+
+/**
+ *  Find the first non empty slot of a level, in wheel order.
+ *
+ *  @param[in] offset  Index of the first slot of the level, a multiple
+ *                     of 64.
+ *  @param[in] count   Number of slots of the level, a multiple of 64.
+ *  @param[in] from    Position in the level where the lookup starts.
+ *
+ *  @return Position of the slot in the level, -1 if the level is
+ *          empty.
+ */
+int timing_wheel::_first_occupied(
+      unsigned int offset,
+      unsigned int count,
+      unsigned int from) const throw () {
+  unsigned int words(count / 64);
+  unsigned int word(from / 64);
+  unsigned int bit(from % 64);
+  uint64_t const* occupied(_occupied + offset / 64);
+  // The starting word is visited twice: bits from the start position
+  // first, bits before it once the level wrapped.
+  for (unsigned int i(0); i <= words; ++i) {
+    uint64_t bits(occupied[word]);
+    if (!i)
+      bits &= ~static_cast<uint64_t>(0) << bit;
+    else if (i == words)
+      bits &= (static_cast<uint64_t>(1) << bit) - 1;
+    if (bits)
+      return word * 64 + __builtin_ctzll(bits);
+    word = (word + 1) % words;
+  }
+  return -1;
+}
+
+/**
+ *  Get the slot in which an event must be placed.
+ *
+ *  @param[in] when  Event run time on the monotonic clock.
+ *
+ *  @return Slot index.
+ */
+unsigned int timing_wheel::_slot_of(time_t when) const throw () {
+  if (when <= _current)
+    return ready_slot;
+  uint64_t delta(when - _current);
+  uint64_t position(when);
+  if (delta < first_level_slots)
+    return position & (first_level_slots - 1);
+  unsigned int offset(first_level_slots);
+  unsigned int bits(first_level_bits);
+  for (unsigned int level(1);
+       level < levels;
+       ++level, offset += level_slots, bits += level_bits)
+    if (delta < (static_cast<uint64_t>(1) << (bits + level_bits)))
+      return offset + ((position >> bits) & (level_slots - 1));
+  return overflow_slot;
+}
+
+/**
+ *  Unlink an event from its slot.
+ *
+ *  @param[in] evt  Event.
+ */
+void timing_wheel::_unlink(timed_event* evt) throw () {
+  slot& s(_slots[evt->_wheel_slot]);
+  if (evt->_wheel_prev)
+    evt->_wheel_prev->_wheel_next = evt->_wheel_next;
+  else
+    s.head = evt->_wheel_next;
+  if (evt->_wheel_next)
+    evt->_wheel_next->_wheel_prev = evt->_wheel_prev;
+  else
+    s.tail = evt->_wheel_prev;
+  if (!s.head) {
+    s.earliest = nullptr;
+    if (evt->_wheel_slot < overflow_slot)
+      _occupied[evt->_wheel_slot / 64]
+        &= ~(static_cast<uint64_t>(1) << (evt->_wheel_slot % 64));
+  }
+  else if (s.earliest == evt)
+    s.earliest = nullptr;
+  if (evt->_wheel_slot < first_level_slots)
+    --_first_level;
+  else if (evt->_wheel_slot == ready_slot)
+    --_ready;
+  evt->_wheel_next = nullptr;
+  evt->_wheel_prev = nullptr;
+}
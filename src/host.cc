@@ -21,11 +21,14 @@
 #include <iomanip>
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/host_cache.hh"
 #include "com/centreon/engine/checks/viability_failure.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/error.hh"
 #include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/load_leveler.hh"
 #include "com/centreon/engine/flapping.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/host.hh"
@@ -1301,6 +1304,10 @@ int host::handle_async_check_result_3x(check_result* queued_check_result) {
   /* update the execution time for this check (millisecond resolution) */
   set_execution_time(execution_time);
 
+  /* account the execution time of active checks in the load projection */
+  if (queued_check_result->get_check_type() == check_active)
+    events::load_leveler::instance().learn(this, execution_time);
+
   /* set the checked flag */
   set_has_been_checked(true);
 
@@ -1328,27 +1335,26 @@ int host::handle_async_check_result_3x(check_result* queued_check_result) {
   /* parse check output to get: (1) short output, (2) long output, (3) perf data
    */
 
-  std::string output{queued_check_result->get_output()};
+  /* semicolons in plugin output (but not performance data) are replaced
+   * with colons by the parser */
   std::string plugin_output;
   std::string long_plugin_output;
   std::string perf_data;
-  parse_check_output(output, plugin_output, long_plugin_output, perf_data, true,
-                     true);
+  perfdata metrics;
+  queued_check_result->take_parsed_output(
+    plugin_output,
+    long_plugin_output,
+    perf_data,
+    metrics);
   set_plugin_output(plugin_output);
   set_long_plugin_output(long_plugin_output);
-  set_perf_data(perf_data);
+  set_perf_data(std::move(perf_data), std::move(metrics));
 
   /* make sure we have some data */
   if (get_plugin_output().empty()) {
     set_plugin_output("(No output returned from host check)");
   }
 
-  /* replace semicolons in plugin output (but not performance data) with colons
-   */
-  std::string temp_str(get_plugin_output());
-  std::replace(temp_str.begin(), temp_str.end(), ';', ':');
-  set_plugin_output(temp_str);
-
   logger(dbg_checks, most)
       << "Parsing check output...\n"
       << "Short Output:\n"
@@ -1615,7 +1621,7 @@ void host::schedule_check(time_t check_time, int options) {
   if (temp_event != nullptr) {
     logger(dbg_checks, most)
         << "Found another host check event for this host @ "
-        << my_ctime(&temp_event->run_time);
+        << string::ctime(temp_event->get_run_time());
 
     /* use the originally scheduled check unless we decide otherwise */
     use_original_event = true;
@@ -1625,7 +1631,7 @@ void host::schedule_check(time_t check_time, int options) {
       /* the new event is also forced and its execution time is earlier than the
        * original, so use it instead */
       if ((options & CHECK_OPTION_FORCE_EXECUTION) &&
-          (check_time < temp_event->run_time)) {
+          (check_time < temp_event->get_run_time())) {
         logger(dbg_checks, most)
             << "New host check event is forced and occurs before the "
                "existing event, so the new event be used instead.";
@@ -1645,7 +1651,7 @@ void host::schedule_check(time_t check_time, int options) {
 
       /* the new event is not forced either and its execution time is earlier
          than the original, so use it instead */
-      else if (check_time < temp_event->run_time) {
+      else if (check_time < temp_event->get_run_time()) {
         use_original_event = false;
         logger(dbg_checks, most)
             << "New host check event occurs before the existing (older) "
@@ -1680,6 +1686,15 @@ void host::schedule_check(time_t check_time, int options) {
   if (!use_original_event) {
     logger(dbg_checks, most) << "Scheduling new host check event.";
 
+    /* account the check load, regular checks can be postponed to a
+       less loaded second */
+    check_time = events::load_leveler::instance().place(
+                   this,
+                   check_time,
+                   (options & CHECK_OPTION_FORCE_EXECUTION)
+                   ? 0
+                   : events::load_leveler::max_delay(*this));
+
     /* set the next host check time */
     set_next_check(check_time);
 
@@ -1688,7 +1703,7 @@ void host::schedule_check(time_t check_time, int options) {
     new_event->event_data = (void*)this;
     new_event->event_args = (void*)nullptr;
     new_event->event_options = options;
-    new_event->run_time = get_next_check();
+    new_event->set_run_time(get_next_check());
     new_event->recurring = false;
     new_event->event_interval = 0L;
     new_event->timing_func = nullptr;
@@ -1699,7 +1714,7 @@ void host::schedule_check(time_t check_time, int options) {
   else {
     /* reset the next check time (it may be out of sync) */
     if (temp_event != nullptr)
-      set_next_check(temp_event->run_time);
+      set_next_check(temp_event->get_run_time());
 
     logger(dbg_checks, most)
         << "Keeping original host check event (ignoring the new one).";
@@ -1715,17 +1730,11 @@ void host::check_for_flapping(bool update,
                               bool allow_flapstart_notification) {
   bool update_history;
   bool is_flapping = false;
-  unsigned int x = 0;
-  unsigned int y = 0;
-  int last_state_history_value = host::state_up;
   unsigned long wait_threshold = 0L;
-  double curved_changes = 0.0;
   double curved_percent_change = 0.0;
   time_t current_time = 0L;
   double low_threshold = 0.0;
   double high_threshold = 0.0;
-  double low_curve_value = 0.75;
-  double high_curve_value = 1.25;
 
   logger(dbg_functions, basic) << "host::check_for_flapping()";
 
@@ -1773,47 +1782,14 @@ void host::check_for_flapping(bool update,
                        ? config->high_host_flap_threshold()
                        : get_high_flap_threshold();
 
-  /* record current host state */
-  if (update_history) {
-    /* update the last record time */
+  /* update the last record time */
+  if (update_history)
     set_last_state_history_update(current_time);
 
-    /* record the current state in the state history */
-    get_state_history()[get_state_history_index()] = get_current_state();
-
-    /* increment state history index to next available slot */
-    set_state_history_index(get_state_history_index() + 1);
-    if (get_state_history_index() >= MAX_STATE_HISTORY_ENTRIES)
-      set_state_history_index(0);
-  }
-
-  /* calculate overall changes in state */
-  for (x = 0, y = get_state_history_index(); x < MAX_STATE_HISTORY_ENTRIES;
-       x++) {
-    if (x == 0) {
-      last_state_history_value = get_state_history()[y];
-      y++;
-      if (y >= MAX_STATE_HISTORY_ENTRIES)
-        y = 0;
-      continue;
-    }
-
-    if (last_state_history_value != get_state_history()[y])
-      curved_changes +=
-          (((double)(x - 1) * (high_curve_value - low_curve_value)) /
-           ((double)(MAX_STATE_HISTORY_ENTRIES - 2))) +
-          low_curve_value;
-
-    last_state_history_value = get_state_history()[y];
-
-    y++;
-    if (y >= MAX_STATE_HISTORY_ENTRIES)
-      y = 0;
-  }
-
-  /* calculate overall percent change in state */
-  curved_percent_change = (double)(((double)curved_changes * 100.0) /
-                                   (double)(MAX_STATE_HISTORY_ENTRIES - 1));
+  /* record current host state and calculate the curved percent state
+   * change */
+  curved_percent_change
+    = _record_state_history(update_history, get_current_state());
 
   set_percent_state_change(curved_percent_change);
 
@@ -2020,6 +1996,13 @@ int host::handle_state() {
     if (get_state_type() == hard)
       set_last_hard_state_change(current_time);
 
+    /* the cached states of children and dependent hosts were determined
+     * from the previous state of this host */
+    if (get_last_state() != get_current_state())
+      checks::host_cache::instance().invalidate_dependents(
+        *this,
+        current_time);
+
     /* update the event id */
     set_last_event_id(get_current_event_id());
     set_current_event_id(next_event_id);
@@ -2194,6 +2177,33 @@ void host::grab_macros_r(nagios_macros* mac) {
   grab_host_macros_r(mac, this);
 }
 
+/**
+ *  Find a host and a contact once one of their notification commands
+ *  completed. They may have been removed by a configuration reload in
+ *  the meantime.
+ *
+ *  @param[in]  host_id       Host ID.
+ *  @param[in]  contact_name  Contact name.
+ *  @param[out] hst           Host, if found.
+ *  @param[out] cntct         Contact, if found.
+ *
+ *  @return True if both were found.
+ */
+static bool find_notified(
+              uint64_t host_id,
+              std::string const& contact_name,
+              host*& hst,
+              contact*& cntct) {
+  host_id_map::const_iterator it_hst(host::hosts_by_id.find(host_id));
+  contact_map::const_iterator it_ctct(contact::contacts.find(contact_name));
+  if (it_hst == host::hosts_by_id.end()
+      || it_ctct == contact::contacts.end())
+    return false;
+  hst = it_hst->second.get();
+  cntct = it_ctct->second.get();
+  return true;
+}
+
 /* notify a specific contact that an entire host is down or up */
 int host::notify_contact(nagios_macros* mac,
                          contact* cntct,
@@ -2201,11 +2211,10 @@ int host::notify_contact(nagios_macros* mac,
                          std::string const& not_author,
                          std::string const& not_data,
                          int options __attribute((unused)),
-                         int escalated) {
+                         int escalated,
+                         std::shared_ptr<void> const& notification_done) {
   std::string raw_command;
   std::string processed_command;
-  int early_timeout = false;
-  double exectime;
   struct timeval start_time;
   struct timeval end_time;
   struct timeval method_start_time;
@@ -2247,6 +2256,36 @@ int host::notify_contact(nagios_macros* mac,
   else if (NEBERROR_CALLBACKOVERRIDE == neb_result)
     return OK;
 
+  /* the end of the notification of this contact is sent to the event
+     broker once all its commands completed, before the end of the
+     whole notification. The host and the contact are looked up again
+     then */
+  uint64_t host_id{_id};
+  std::string contact_name{cntct->get_name()};
+  commands::system_runner::completion contact_done{
+      commands::system_runner::make_completion(
+          [host_id, contact_name, type, not_author, not_data, escalated,
+           start_time, notification_done]() {
+            host* hst;
+            contact* cntct;
+            if (!find_notified(host_id, contact_name, hst, cntct))
+              return;
+
+            /* get end time */
+            struct timeval end_time;
+            gettimeofday(&end_time, nullptr);
+
+            /* update the contact's last host notification time */
+            cntct->set_last_host_notification(start_time.tv_sec);
+
+            /* send data to event broker */
+            broker_contact_notification_data(
+                NEBTYPE_CONTACTNOTIFICATION_END, NEBFLAG_NONE, NEBATTR_NONE,
+                host_notification, type, start_time, end_time, (void*)hst,
+                cntct, not_author.c_str(), not_data.c_str(), escalated,
+                nullptr);
+          })};
+
   /* process all the notification commands this user has */
   for (std::shared_ptr<commands::command> const& cmd :
        cntct->get_host_notification_commands()) {
@@ -2318,49 +2357,42 @@ int host::notify_contact(nagios_macros* mac,
           << cmd->get_name() << ';' << this->get_plugin_output() << info;
     }
 
-    /* run the notification command */
-    try {
-      std::string out;
-      my_system_r(mac, processed_command, config->notification_timeout(),
-                  &early_timeout, &exectime, out, 0);
-    } catch (std::exception const& e) {
-      logger(log_runtime_error, basic)
-          << "Error: can't execute host notification '" << cntct->get_name()
-          << "' : " << e.what();
-    }
-
-    /* check to see if the notification timed out */
-    if (early_timeout) {
-      logger(log_host_notification | log_runtime_warning, basic)
-          << "Warning: Contact '" << cntct->get_name()
-          << "' host notification command '" << processed_command
-          << "' timed out after " << config->notification_timeout()
-          << " seconds";
-    }
-
-    /* get end time */
-    gettimeofday(&method_end_time, nullptr);
+    /* run the notification command, the end of the method is sent to
+       the event broker once it completed */
+    std::string command_line{cmd->get_command_line()};
+    unsigned int timeout{config->notification_timeout()};
+    my_system_async_r(
+        mac, processed_command, timeout,
+        [host_id, contact_name, type, not_author, not_data, escalated,
+         method_start_time, command_line, processed_command, timeout,
+         contact_done](int, int early_timeout, double, std::string const&) {
+          /* check to see if the notification command timed out */
+          if (early_timeout) {
+            logger(log_host_notification | log_runtime_warning, basic)
+                << "Warning: Contact '" << contact_name
+                << "' host notification command '" << processed_command
+                << "' timed out after " << timeout
+                << " seconds";
+          }
 
-    /* send data to event broker */
-    broker_contact_notification_method_data(
-        NEBTYPE_CONTACTNOTIFICATIONMETHOD_END, NEBFLAG_NONE, NEBATTR_NONE,
-        host_notification, type, method_start_time, method_end_time,
-        (void*)this, cntct, cmd->get_command_line().c_str(), not_author.c_str(),
-        not_data.c_str(), escalated, nullptr);
+          host* hst;
+          contact* cntct;
+          if (!find_notified(host_id, contact_name, hst, cntct))
+            return;
+
+          /* get end time */
+          struct timeval method_end_time;
+          gettimeofday(&method_end_time, nullptr);
+
+          /* send data to event broker */
+          broker_contact_notification_method_data(
+              NEBTYPE_CONTACTNOTIFICATIONMETHOD_END, NEBFLAG_NONE,
+              NEBATTR_NONE, host_notification, type, method_start_time,
+              method_end_time, (void*)hst, cntct, command_line.c_str(),
+              not_author.c_str(), not_data.c_str(), escalated, nullptr);
+        });
   }
 
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* update the contact's last host notification time */
-  cntct->set_last_host_notification(start_time.tv_sec);
-
-  /* send data to event broker */
-  broker_contact_notification_data(
-      NEBTYPE_CONTACTNOTIFICATION_END, NEBFLAG_NONE, NEBATTR_NONE,
-      host_notification, type, start_time, end_time, (void*)this, cntct,
-      not_author.c_str(), not_data.c_str(), escalated, nullptr);
-
   return OK;
 }
 
@@ -2710,20 +2742,18 @@ int host::run_sync_check_3x(enum host::host_state* check_result_code,
 /* processes the result of a synchronous or asynchronous host check */
 int host::process_check_result_3x(enum host::host_state new_state,
                                  std::string const& old_plugin_output,
-                                 int check_options,
+                                 int check_options __attribute((unused)),
                                  int reschedule_check,
                                  int use_cached_result,
                                  unsigned long check_timestamp_horizon) {
   com::centreon::engine::host* master_host = nullptr;
   host* temp_host;
   std::list<host*> check_hostlist;
-  host::host_state parent_state =  host::state_up;
   time_t current_time = 0L;
   time_t next_check = 0L;
   time_t preferred_time = 0L;
   time_t next_valid_time = 0L;
   int run_async_check = true;
-  bool has_parent;
 
   logger(dbg_functions, basic) << "process_host_check_result_3x()";
 
@@ -2922,57 +2952,64 @@ int host::process_check_result_3x(enum host::host_state new_state,
           (unsigned long)(current_time + (get_check_interval() *
             config->interval_length()));
 
-        /* we need to run SYNCHRONOUS checks of all parent hosts to accurately
-         * determine the state of this host */
-        /* this is extremely inefficient (reminiscent of Nagios 2.x logic), but
-         * there's no other good way around it */
-        /* check all parent hosts to see if we're DOWN or UNREACHABLE */
+        /* determine whether this host is DOWN or UNREACHABLE from the state
+         * of its parents, without blocking: parents whose result is recent
+         * enough are trusted, the others are checked asynchronously and the
+         * state of this host is resolved again when their results come back
+         * (see _resolve_reachability_waiters()) */
         /* only do this for ACTIVE checks, as PASSIVE checks contain a
          * pre-determined state */
         if (get_check_type() == check_active) {
-          has_parent = false;
-
           logger(dbg_checks, more)
-            << "** WARNING: Max attempts = 1, so we have to run serial "
-               "checks of all parent hosts!";
+            << "Max attempts = 1, determining reachability from parent "
+               "hosts...";
 
+          bool fresh_parent_up(false);
+          std::list<host*> stale_parents;
           for (host_map_unsafe::iterator it{parent_hosts.begin()},
                  end{parent_hosts.end()};
                it != end; it++) {
             if (!it->second)
               continue;
 
-            has_parent = true;
-
-            logger(dbg_checks, more)
-              << "Running serial check parent host '" << it->first << "'...";
-
-            /* run an immediate check of the parent host */
-            it->second->run_sync_check_3x( &parent_state,
-                                                      check_options, use_cached_result,
-                                                      check_timestamp_horizon);
-
-            /* bail out as soon as we find one parent host that is UP */
-            if (parent_state ==  host::state_up) {
-              logger(dbg_checks, more)
-                << "Parent host is UP, so this one is DOWN.";
-
-              /* set the current state */
-              _current_state = host::state_down;
-              break;
+            if (use_cached_result
+                && checks::host_cache::instance().lookup(
+                     *it->second,
+                     current_time,
+                     check_timestamp_horizon)) {
+              /* bail out as soon as we find one parent host that is UP */
+              if (it->second->get_current_state() == host::state_up) {
+                logger(dbg_checks, more)
+                  << "Cached state of parent host '" << it->first
+                  << "' is UP, so this one is DOWN.";
+                fresh_parent_up = true;
+                break;
+              }
             }
+            else
+              stale_parents.push_back(it->second);
           }
 
-          if (!has_parent) {
-            /* host has no parents, so its up */
-            if (parent_hosts.empty()) {
-              logger(dbg_checks, more) << "Host has no parents, so it's DOWN.";
-              _current_state = host::state_down;
-            } else {
-              /* no parents were up, so this host is UNREACHABLE */
+          /* preliminary determination from the current states of the
+           * parents */
+          _current_state = new_state;
+          _current_state = fresh_parent_up
+                           ? host::state_down
+                           : determine_host_reachability();
+
+          /* check stale parents concurrently */
+          if (!fresh_parent_up) {
+            for (std::list<host*>::iterator
+                   it{stale_parents.begin()},
+                   end{stale_parents.end()};
+                 it != end;
+                 ++it) {
               logger(dbg_checks, more)
-                << "No parents were UP, so this host is UNREACHABLE.";
-              _current_state = host::state_unreachable;
+                << "Check of parent host '" << (*it)->get_name()
+                << "' queued, reachability will be resolved when its "
+                   "result comes back.";
+              (*it)->_reachability_waiters.insert(get_host_id());
+              check_hostlist.push_back(*it);
             }
           }
         }
@@ -3204,6 +3241,9 @@ int host::process_check_result_3x(enum host::host_state new_state,
    * (non-scheduled) hosts */
   update_status(false);
 
+  /* children waiting for this result to determine their state */
+  _resolve_reachability_waiters();
+
   /* run async checks of all hosts we added above */
   /* don't run a check if one is already executing or we can get by with a
    * cached state */
@@ -3219,16 +3259,21 @@ int host::process_check_result_3x(enum host::host_state new_state,
       << "ASYNC CHECK OF HOST: " << temp_host->get_name()
       << ", CURRENTTIME: " << current_time
       << ", LASTHOSTCHECK: " << temp_host->get_last_check()
-      << ", CACHEDTIMEHORIZON: " << check_timestamp_horizon
+      << ", CACHEDTIMEHORIZON: "
+      << checks::host_cache::instance().horizon(
+           *temp_host,
+           check_timestamp_horizon)
       << ", USECACHEDRESULT: " << use_cached_result
       << ", ISEXECUTING: " << temp_host->get_is_executing();
 
-    if (use_cached_result && (static_cast<unsigned long>(
-      current_time - temp_host->get_last_check()) <=
-      check_timestamp_horizon))
-      run_async_check = false;
     if (temp_host->get_is_executing())
       run_async_check = false;
+    else if (use_cached_result
+             && checks::host_cache::instance().lookup(
+                  *temp_host,
+                  current_time,
+                  check_timestamp_horizon))
+      run_async_check = false;
     if (run_async_check)
       temp_host->run_async_check(CHECK_OPTION_NONE, 0.0, false,
                                  false, nullptr, nullptr);
@@ -3236,6 +3281,53 @@ int host::process_check_result_3x(enum host::host_state new_state,
   return OK;
 }
 
+/**
+ *  Resolve again the state of a DOWN or UNREACHABLE host once results of
+ *  its parents came back. The host goes through the usual state handling
+ *  if its state changes.
+ */
+void host::_resolve_reachability() {
+  if (_current_state == host::state_up)
+    return;
+
+  enum host::host_state state(determine_host_reachability());
+  if (state == _current_state)
+    return;
+
+  logger(dbg_checks, more)
+    << "Parent hosts results came back, host '" << _name << "' is now "
+    << (state == host::state_down ? "DOWN" : "UNREACHABLE") << ".";
+
+  set_last_state(_current_state);
+  if (get_state_type() == hard)
+    set_last_hard_state(_current_state);
+  _current_state = state;
+  handle_state();
+  update_status(false);
+}
+
+/**
+ *  Resolve the state of the children that were waiting for a result of
+ *  this host.
+ */
+void host::_resolve_reachability_waiters() {
+  if (_reachability_waiters.empty())
+    return;
+
+  // Children are referenced by ID as they can be removed by a reload.
+  std::unordered_set<uint64_t> waiters;
+  waiters.swap(_reachability_waiters);
+  for (std::unordered_set<uint64_t>::const_iterator
+         it(waiters.begin()),
+         end(waiters.end());
+       it != end;
+       ++it) {
+    host_id_map::iterator child(host::hosts_by_id.find(*it));
+    if (child != host::hosts_by_id.end() && child->second)
+      child->second->_resolve_reachability();
+  }
+}
+
 /* determination of the host's state based on route availability*//* used only to determine difference between DOWN and UNREACHABLE states */
 enum host::host_state host::determine_host_reachability() {
   enum host::host_state state = host::state_down;
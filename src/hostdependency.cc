@@ -263,6 +263,11 @@ void hostdependency::resolve(int& w, int& e) {
       << "' is circular (it depends on itself)!";
     errors++;
   }
+  // Let the master host know its dependents.
+  else if (dependent_host_ptr && master_host_ptr)
+    master_host_ptr->dependent_hosts.insert({
+      dependent_host_ptr->get_name(),
+      dependent_host_ptr});
 
   // Find the timeperiod.
   if (!_dependency_period.empty()) {
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/macros.hh"
+#include "com/centreon/engine/macros/command_template.hh"
+#include "com/centreon/engine/macros/grab_value.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::logging;
+using namespace com::centreon::engine::macros;
+
+namespace {
+  /**
+   *  Value of a macro during an expansion.
+   */
+  struct resolved_macro {
+    std::string          buffer;
+    std::string const*   value;
+  };
+}
+
+/**
+ *  Default constructor.
+ */
+command_template::command_template() : _literals_size(0) {}
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] command_line  Command line to compile.
+ */
+command_template::command_template(std::string const& command_line)
+  : _literals_size(0) {
+  compile(command_line);
+}
+
+/**
+ *  Copy constructor.
+ *
+ *  @param[in] right  Object to copy.
+ */
+command_template::command_template(command_template const& right)
+  : _literals_size(right._literals_size),
+    _tokens(right._tokens),
+    _text(right._text) {}
+
+/**
+ *  Destructor.
+ */
+command_template::~command_template() throw () {}
+
+/**
+ *  Assignment operator.
+ *
+ *  @param[in] right  Object to copy.
+ *
+ *  @return This object.
+ */
+command_template& command_template::operator=(
+                    command_template const& right) {
+  if (this != &right) {
+    _literals_size = right._literals_size;
+    _tokens = right._tokens;
+    _text = right._text;
+  }
+  return *this;
+}
+
+/**
+ *  Compile a command line. Like process_macros_r(), $$ is a dollar
+ *  sign and a dollar sign without a matching one is dropped.
+ *
+ *  @param[in] command_line  Command line.
+ */
+void command_template::compile(std::string const& command_line) {
+  _literals_size = 0;
+  _tokens.clear();
+  _text.clear();
+
+  size_t size(command_line.size());
+  size_t pos(0);
+  while (pos < size) {
+    size_t dollar(command_line.find('$', pos));
+    if (dollar == std::string::npos) {
+      _add_literal(command_line.data() + pos, size - pos);
+      break;
+    }
+    _add_literal(command_line.data() + pos, dollar - pos);
+    if (dollar + 1 == size)
+      break;
+    if (command_line[dollar + 1] == '$') {
+      _add_literal("$", 1);
+      pos = dollar + 2;
+      continue;
+    }
+    size_t end(command_line.find('$', dollar + 1));
+    if (end == std::string::npos) {
+      pos = dollar + 1;
+      continue;
+    }
+    _add_macro(command_line.substr(dollar + 1, end - dollar - 1));
+    pos = end + 1;
+  }
+}
+
+/**
+ *  Expand macros of the command line.
+ *
+ *  @param[in]  mac      Macros of the command.
+ *  @param[out] output   Command line with expanded macros.
+ *  @param[in]  options  Cleaning options applied to every macro.
+ */
+void command_template::expand(
+                         nagios_macros* mac,
+                         std::string& output,
+                         int options) const {
+  static std::string const no_argument;
+
+  // Resolve macros first, to size the output.
+  std::vector<resolved_macro> macros(_tokens.size());
+  size_t size(_literals_size);
+  for (unsigned int i(0); i < _tokens.size(); ++i) {
+    token const& t(_tokens[i]);
+    resolved_macro& m(macros[i]);
+    m.value = nullptr;
+    int clean_options(t.clean_options);
+    int free_macro(false);
+    switch (t.type) {
+    case token_argv:
+      if (mac)
+        m.value = &mac->argv[t.index];
+      break;
+    case token_macrox:
+      grab_macrox_value_r(
+        mac,
+        t.index,
+        no_argument,
+        no_argument,
+        m.buffer,
+        &free_macro);
+      m.value = &m.buffer;
+      break;
+    case token_named:
+      grab_macro_value_r(
+        mac,
+        _text.substr(t.offset, t.size),
+        m.buffer,
+        &clean_options,
+        &free_macro);
+      m.value = &m.buffer;
+      break;
+    case token_user:
+      m.value = &macro_user[t.index];
+      break;
+    default:
+      continue;
+    }
+    if (!m.value || m.value->empty()) {
+      m.value = nullptr;
+      continue;
+    }
+
+    int macro_options(options | clean_options);
+    if (macro_options & URL_ENCODE_MACRO_CHARS) {
+      m.buffer = url_encode(*m.value);
+      m.value = &m.buffer;
+    }
+    if (macro_options & (STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS)) {
+      m.buffer = clean_macro_chars(*m.value, macro_options);
+      m.value = &m.buffer;
+    }
+    size += m.value->size();
+  }
+
+  // Concatenate literals and macro values.
+  output.clear();
+  output.reserve(size);
+  for (unsigned int i(0); i < _tokens.size(); ++i) {
+    token const& t(_tokens[i]);
+    if (t.type == token_literal)
+      output.append(_text, t.offset, t.size);
+    else if (macros[i].value)
+      output.append(*macros[i].value);
+  }
+
+  logger(dbg_macros, more)
+    << "command_template::expand: output='" << output << "'";
+}
+
+/**
+ *  Add a literal span.
+ *
+ *  @param[in] data  Literal text.
+ *  @param[in] size  Literal size.
+ */
+void command_template::_add_literal(char const* data, size_t size) {
+  if (!size)
+    return;
+  if (!_tokens.empty()
+      && _tokens.back().type == token_literal
+      && _tokens.back().offset + _tokens.back().size == _text.size())
+    _tokens.back().size += size;
+  else {
+    token t;
+    t.clean_options = 0;
+    t.index = 0;
+    t.offset = _text.size();
+    t.size = size;
+    t.type = token_literal;
+    _tokens.push_back(t);
+  }
+  _text.append(data, size);
+  _literals_size += size;
+}
+
+/**
+ *  Add a macro. Macros that grab_macro_value_r() would reject whatever
+ *  the context are dropped.
+ *
+ *  @param[in] name  Macro name.
+ */
+void command_template::_add_macro(std::string const& name) {
+  token t;
+  t.clean_options = 0;
+  t.index = 0;
+  t.offset = 0;
+  t.size = 0;
+
+  unsigned int x;
+  for (x = 0; x < MACRO_X_COUNT; ++x)
+    if (!macro_x_names[x].empty() && macro_x_names[x] == name)
+      break;
+  if (x < MACRO_X_COUNT) {
+    t.clean_options = grab_macrox_clean_options(x);
+    t.index = x;
+    t.type = token_macrox;
+  }
+  else if (name.size() > 3 && !strncmp(name.c_str(), "ARG", 3)) {
+    x = atoi(name.c_str() + 3);
+    if (!x || x > MAX_COMMAND_ARGUMENTS)
+      return;
+    t.index = x - 1;
+    t.type = token_argv;
+  }
+  else if (name.size() > 4 && !strncmp(name.c_str(), "USER", 4)) {
+    x = atoi(name.c_str() + 4);
+    if (!x || x > MAX_USER_MACROS)
+      return;
+    t.index = x - 1;
+    t.type = token_user;
+  }
+  else {
+    t.offset = _text.size();
+    t.size = name.size();
+    t.type = token_named;
+    _text.append(name);
+  }
+  _tokens.push_back(t);
+}
@@ -1082,17 +1082,9 @@ int grab_macro_value_r(
                  free_macro);
 
       /* post-processing */
-      /* host/service output/perfdata and author/comment macros should get cleaned */
-      if ((x >= 16 && x <= 19) || (x >= 49 && x <= 52)
-          || (x >= 99 && x <= 100) || (x >= 124 && x <= 127)) {
-        *clean_options |= (STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
-        logger(dbg_macros, most)
-          << "  New clean options: " << *clean_options;
-      }
-      /* url macros should get cleaned */
-      if ((x >= 125 && x <= 126) || (x >= 128 && x <= 129)
-          || (x >= 77 && x <= 78) || (x >= 74 && x <= 75)) {
-        *clean_options |= URL_ENCODE_MACRO_CHARS;
+      int macrox_options(grab_macrox_clean_options(x));
+      if (macrox_options) {
+        *clean_options |= macrox_options;
         logger(dbg_macros, most)
           << "  New clean options: " << *clean_options;
       }
@@ -1230,6 +1222,27 @@ int grab_macro_value_r(
   return result;
 }
 
+/**
+ *  Get the cleaning options of a macro.
+ *
+ *  @param[in] macro_type  Macro to get.
+ *
+ *  @return Cleaning options to apply to the macro value.
+ */
+int grab_macrox_clean_options(int macro_type) {
+  int x(macro_type);
+  int options(0);
+  /* host/service output/perfdata and author/comment macros should get cleaned */
+  if ((x >= 16 && x <= 19) || (x >= 49 && x <= 52)
+      || (x >= 99 && x <= 100) || (x >= 124 && x <= 127))
+    options |= (STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
+  /* url macros should get cleaned */
+  if ((x >= 125 && x <= 126) || (x >= 128 && x <= 129)
+      || (x >= 77 && x <= 78) || (x >= 74 && x <= 75))
+    options |= URL_ENCODE_MACRO_CHARS;
+  return options;
+}
+
 /**
  *  Grab a macro value.
  *
@@ -39,6 +39,7 @@
 #include "com/centreon/engine/broker/compatibility.hh"
 #include "com/centreon/engine/broker/loader.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/commands/spawner.hh"
 #include "com/centreon/engine/config.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/configuration/parser.hh"
@@ -324,6 +325,18 @@ int main(int argc, char* argv[]) {
           p.parse(config_file, config);
         }
 
+        // Start the process spawner while the engine is still small.
+        bool spawn(
+          config.command_launcher() == configuration::state::launcher_spawn);
+        for (configuration::set_command::const_iterator
+               it(config.commands().begin()),
+               end(config.commands().end());
+             !spawn && (it != end);
+             ++it)
+          spawn = (it->launcher() == "spawn");
+        if (spawn)
+          commands::spawner::instance().start();
+
         // Parse retention.
         retention::state state;
         {
@@ -457,6 +470,7 @@ int main(int argc, char* argv[]) {
   com::centreon::engine::events::loop::unload();
   com::centreon::engine::broker::compatibility::unload();
   com::centreon::engine::broker::loader::unload();
+  com::centreon::engine::commands::spawner::instance().stop();
   com::centreon::engine::configuration::applier::state::unload();
   com::centreon::engine::checks::checker::unload();
   delete config;
@@ -18,15 +18,39 @@
  */
 #include "com/centreon/engine/notification.hh"
 #include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
+#include "com/centreon/engine/host.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/macros.hh"
 #include "com/centreon/engine/macros/defines.hh"
 #include "com/centreon/engine/neberrors.hh"
 #include "com/centreon/engine/notifier.hh"
+#include "com/centreon/engine/service.hh"
 
 using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
 
+/**
+ *  Find a notifier once the commands of one of its notifications
+ *  completed. It may have been removed by a configuration reload in the
+ *  meantime.
+ *
+ *  @param[in] type  Notifier type.
+ *  @param[in] id    Host ID and service ID (0 for a host).
+ *
+ *  @return The notifier, nullptr if it does not exist anymore.
+ */
+static notifier* find_notifier(
+                   notifier::notifier_type type,
+                   std::pair<uint64_t, uint64_t> const& id) {
+  if (type == notifier::host_notification) {
+    host_id_map::const_iterator it(host::hosts_by_id.find(id.first));
+    return it != host::hosts_by_id.end() ? it->second.get() : nullptr;
+  }
+  service_id_map::const_iterator it(service::services_by_id.find(id));
+  return it != service::services_by_id.end() ? it->second.get() : nullptr;
+}
+
 notification::notification(notifier* parent,
                            notifier::reason_type type,
                            std::string const& author,
@@ -155,6 +179,40 @@ int notification::execute(std::unordered_set<contact*> const& to_notify) {
     mac.x[MACRO_SERVICENOTIFICATIONID] = std::to_string(_id);
   }
 
+  /* the end of the notification is sent to the event broker once the
+     commands of all contacts completed */
+  std::shared_ptr<uint32_t> notified{std::make_shared<uint32_t>(0)};
+  notifier::notifier_type parent_type{_parent->get_notifier_type()};
+  std::pair<uint64_t, uint64_t> parent_id;
+  if (parent_type == notifier::host_notification)
+    parent_id = {static_cast<host*>(_parent)->get_host_id(), 0};
+  else
+    parent_id = {static_cast<service*>(_parent)->get_host_id(),
+                 static_cast<service*>(_parent)->get_service_id()};
+  notifier::reason_type type{_type};
+  std::string author_name{_author};
+  std::string message{_message};
+  bool escalated{_escalated};
+  commands::system_runner::completion done{
+      commands::system_runner::make_completion(
+          [parent_type, parent_id, type, start_time, author_name, message,
+           escalated, notified]() {
+            notifier* parent{find_notifier(parent_type, parent_id)};
+            if (!parent)
+              return;
+
+            /* get the time we finished */
+            struct timeval end_time;
+            gettimeofday(&end_time, nullptr);
+
+            /* send data to event broker */
+            broker_notification_data(
+                NEBTYPE_NOTIFICATION_END, NEBFLAG_NONE, NEBATTR_NONE,
+                parent->get_notifier_type(), type, start_time, end_time,
+                (void*)parent, author_name.c_str(), message.c_str(),
+                escalated, *notified, nullptr);
+          })};
+
   for (contact* ctc : to_notify) {
     /* grab the macro variables for this contact */
     grab_contact_macros_r(&mac, ctc);
@@ -165,22 +223,14 @@ int notification::execute(std::unordered_set<contact*> const& to_notify) {
     /* notify this contact */
     int result =
         _parent->notify_contact(&mac, ctc, _type, _author.c_str(),
-                                _message.c_str(), _options, _escalated);
+                                _message.c_str(), _options, _escalated, done);
 
     /* keep track of how many contacts were notified */
     if (result == OK)
       contacts_notified++;
   }
-
-  /* get the time we finished */
-  gettimeofday(&end_time, nullptr);
-
-  /* send data to event broker */
-  broker_notification_data(NEBTYPE_NOTIFICATION_END, NEBFLAG_NONE, NEBATTR_NONE,
-                           _parent->get_notifier_type(), _type, start_time,
-                           end_time, (void*)_parent, _author.c_str(),
-                           _message.c_str(), _escalated, contacts_notified,
-                           nullptr);
+  *notified = contacts_notified;
+  done.reset();
 
   logger(dbg_notifications, basic)
       << contacts_notified << " contacts were notified.";
@@ -128,7 +128,10 @@ notifier::notifier(notifier::notifier_type notifier_type,
       _notification_number{0},
       _notification{{}},
       _state_history{{}},
-      _pending_flex_downtime{0} {
+      _pending_flex_downtime{0},
+      _prepared_percent_state_change{{}},
+      _prepared_flapping{false},
+      _prepared_state_history_index{0} {
   if (retry_interval <= 0) {
     logger(log_config_error, basic)
         << "Error: Invalid notification_interval value for notifier '"
@@ -1205,9 +1208,100 @@ std::array<int, MAX_STATE_HISTORY_ENTRIES> const& notifier::get_state_history()
 }
 
 std::array<int, MAX_STATE_HISTORY_ENTRIES>& notifier::get_state_history() {
+  // The history may be modified.
+  _prepared_flapping = false;
   return _state_history;
 }
 
+unsigned int const notifier::_prepared_states;
+
+/**
+ *  Compute the curved percent state change of a state history.
+ *
+ *  @param[in] history    State history.
+ *  @param[in] index      Index of the oldest entry.
+ *  @param[in] new_state  State recorded at index before computing,
+ *                        nullptr to compute the history as is.
+ *
+ *  @return Percent state change, recent changes weighing more.
+ */
+static double curved_percent_change(
+                std::array<int, MAX_STATE_HISTORY_ENTRIES> const& history,
+                uint32_t index,
+                int const* new_state) {
+  double const low_curve_value(0.75);
+  double const high_curve_value(1.25);
+  uint32_t oldest(
+    new_state ? (index + 1) % MAX_STATE_HISTORY_ENTRIES : index);
+  double curved_changes(0.0);
+  int last_value(0);
+  for (uint32_t x(0); x < MAX_STATE_HISTORY_ENTRIES; ++x) {
+    uint32_t y((oldest + x) % MAX_STATE_HISTORY_ENTRIES);
+    int value((new_state && (y == index)) ? *new_state : history[y]);
+    if (x && (last_value != value))
+      curved_changes +=
+          (((double)(x - 1) * (high_curve_value - low_curve_value)) /
+           ((double)(MAX_STATE_HISTORY_ENTRIES - 2))) +
+          low_curve_value;
+    last_value = value;
+  }
+  return (curved_changes * 100.0) / (double)(MAX_STATE_HISTORY_ENTRIES - 1);
+}
+
+/**
+ *  Compute ahead the percent state changes the next flap detection can
+ *  find, so that it does not walk the state history. Check result
+ *  workers call it for the objects of their shard while the events
+ *  loop waits for them.
+ */
+void notifier::prepare_flapping() {
+  if (_prepared_flapping
+      && (_prepared_state_history_index == get_state_history_index()))
+    return;
+  uint32_t index(get_state_history_index());
+  for (int state(0); state < static_cast<int>(_prepared_states); ++state)
+    _prepared_percent_state_change[state]
+      = curved_percent_change(_state_history, index, &state);
+  _prepared_percent_state_change[_prepared_states]
+    = curved_percent_change(_state_history, index, nullptr);
+  _prepared_state_history_index = index;
+  _prepared_flapping = true;
+}
+
+/**
+ *  Record a state in the state history and compute the resulting
+ *  percent state change, using the one prepared by the check result
+ *  workers if the history did not change since.
+ *
+ *  @param[in] update  True to record the state.
+ *  @param[in] state   State to record.
+ *
+ *  @return Percent state change.
+ */
+double notifier::_record_state_history(bool update, int state) {
+  uint32_t index(get_state_history_index());
+  double percent;
+  if (_prepared_flapping
+      && (_prepared_state_history_index == index)
+      && (!update
+          || ((state >= 0)
+              && (state < static_cast<int>(_prepared_states)))))
+    percent = _prepared_percent_state_change[
+                update ? state : _prepared_states];
+  else
+    percent = curved_percent_change(
+                _state_history,
+                index,
+                update ? &state : nullptr);
+
+  if (update) {
+    _state_history[index] = state;
+    set_state_history_index((index + 1) % MAX_STATE_HISTORY_ENTRIES);
+    _prepared_flapping = false;
+  }
+  return percent;
+}
+
 std::array<std::shared_ptr<notification>, 6> const&
 notifier::get_current_notifications() const {
   return _notification;
@@ -0,0 +1,415 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include "com/centreon/engine/perfdata.hh"
+
+using namespace com::centreon::engine;
+
+namespace {
+  /**
+   *  Part of the parsed string that must be interned.
+   */
+  struct span {
+    char const* data;
+    size_t      size;
+    bool        quoted;
+  };
+
+  /**
+   *  Interned strings. Entries are only weak references, they expire
+   *  with the last performance data using them and are purged once
+   *  the table doubled in size.
+   */
+  struct interned_table {
+    std::mutex  lock;
+    size_t      next_purge;
+    std::unordered_map<std::string, std::weak_ptr<std::string const> >
+                strings;
+  };
+
+  size_t const min_purge_size(1024);
+
+  interned_table& interned_strings() {
+    static interned_table table = { {}, min_purge_size, {} };
+    return table;
+  }
+
+  std::shared_ptr<std::string const> intern_unlocked(
+                                       interned_table& table,
+                                       std::string const& str) {
+    std::weak_ptr<std::string const>& entry(table.strings[str]);
+    std::shared_ptr<std::string const> shared(entry.lock());
+    if (!shared) {
+      shared = std::make_shared<std::string const>(str);
+      entry = shared;
+      if (table.strings.size() >= table.next_purge) {
+        for (std::unordered_map<
+               std::string,
+               std::weak_ptr<std::string const> >::iterator
+               it(table.strings.begin()), end(table.strings.end());
+             it != end;)
+          if (it->second.expired())
+            it = table.strings.erase(it);
+          else
+            ++it;
+        table.next_purge
+          = std::max(min_purge_size, table.strings.size() * 2);
+      }
+    }
+    return shared;
+  }
+
+  bool is_space(char c) throw () {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+  }
+
+  /**
+   *  Parse a number, with a dot or a comma as decimal separator.
+   *
+   *  @param[in]  begin  Start of the number.
+   *  @param[in]  end    End of the field holding the number.
+   *  @param[out] value  Parsed number.
+   *
+   *  @return End of the number, begin if there is no number.
+   */
+  char const* parse_number(
+                char const* begin,
+                char const* end,
+                double& value) throw () {
+    char buffer[64];
+    size_t size(end - begin);
+    if (!size || (size >= sizeof(buffer)))
+      return begin;
+    for (size_t i(0); i < size; ++i)
+      buffer[i] = (begin[i] == ',') ? '.' : begin[i];
+    buffer[size] = '\0';
+    char* stop;
+    value = strtod(buffer, &stop);
+    return begin + (stop - buffer);
+  }
+
+  /**
+   *  Parse a threshold range: [@][start:][end], '~' being -infinity.
+   *
+   *  @param[in]  begin  Start of the field.
+   *  @param[in]  end    End of the field.
+   *  @param[out] r      Parsed range, unset if invalid.
+   */
+  void parse_range(
+         char const* begin,
+         char const* end,
+         perfdata::range& r) throw () {
+    double const nan(std::numeric_limits<double>::quiet_NaN());
+    double const inf(std::numeric_limits<double>::infinity());
+    r.high = nan;
+    r.inverted = false;
+    r.low = nan;
+    if (begin == end)
+      return;
+
+    bool inverted(*begin == '@');
+    if (inverted)
+      ++begin;
+    char const* colon(
+      static_cast<char const*>(memchr(begin, ':', end - begin)));
+    double low(0.0);
+    double high(inf);
+    if (colon) {
+      if ((colon - begin == 1) && (*begin == '~'))
+        low = -inf;
+      else if ((colon != begin)
+               && (parse_number(begin, colon, low) != colon))
+        return;
+      if ((colon + 1 != end)
+          && (parse_number(colon + 1, end, high) != end))
+        return;
+    }
+    else if (parse_number(begin, end, high) != end)
+      return;
+    r.high = high;
+    r.inverted = inverted;
+    r.low = low;
+  }
+}
+
+/**
+ *  Check if the range was provided.
+ *
+ *  @return True if the range is set.
+ */
+bool perfdata::range::is_set() const throw () {
+  return !std::isnan(low);
+}
+
+/**
+ *  Default constructor.
+ */
+perfdata::perfdata() {}
+
+/**
+ *  Copy constructor.
+ *
+ *  @param[in] right  Object to copy.
+ */
+perfdata::perfdata(perfdata const& right)
+  : _metrics(right._metrics), _strings(right._strings) {}
+
+/**
+ *  Move constructor.
+ *
+ *  @param[in] right  Object to move.
+ */
+perfdata::perfdata(perfdata&& right)
+  : _metrics(std::move(right._metrics)),
+    _strings(std::move(right._strings)) {}
+
+/**
+ *  Destructor.
+ */
+perfdata::~perfdata() throw () {}
+
+/**
+ *  Assignment operator.
+ *
+ *  @param[in] right  Object to copy.
+ *
+ *  @return This object.
+ */
+perfdata& perfdata::operator=(perfdata const& right) {
+  if (this != &right) {
+    _metrics = right._metrics;
+    _strings = right._strings;
+  }
+  return *this;
+}
+
+/**
+ *  Move assignment operator.
+ *
+ *  @param[in] right  Object to move.
+ *
+ *  @return This object.
+ */
+perfdata& perfdata::operator=(perfdata&& right) {
+  if (this != &right) {
+    _metrics = std::move(right._metrics);
+    _strings = std::move(right._strings);
+  }
+  return *this;
+}
+
+/**
+ *  Remove all metrics.
+ */
+void perfdata::clear() throw () {
+  _metrics.clear();
+  _strings.clear();
+}
+
+/**
+ *  Check if there is no metric.
+ *
+ *  @return True if there is no metric.
+ */
+bool perfdata::empty() const throw () {
+  return _metrics.empty();
+}
+
+/**
+ *  Find a metric.
+ *
+ *  @param[in] label  Metric label.
+ *
+ *  @return The first metric with this label, nullptr if not found.
+ */
+perfdata::metric const* perfdata::find(std::string const& label) const {
+  for (std::vector<metric>::const_iterator
+         it(_metrics.begin()), end(_metrics.end());
+       it != end;
+       ++it)
+    if (label == it->label)
+      return &*it;
+  return nullptr;
+}
+
+/**
+ *  Get the shared copy of a string. It remains the same as long as a
+ *  reference to it is held. This method is thread-safe.
+ *
+ *  @param[in] str  String.
+ *
+ *  @return Interned string.
+ */
+std::shared_ptr<std::string const> perfdata::intern(
+                                     std::string const& str) {
+  interned_table& table(interned_strings());
+  std::lock_guard<std::mutex> lock(table.lock);
+  return intern_unlocked(table, str);
+}
+
+/**
+ *  Get the metrics.
+ *
+ *  @return Metrics, in the order of the performance data.
+ */
+std::vector<perfdata::metric> const& perfdata::metrics() const throw () {
+  return _metrics;
+}
+
+/**
+ *  Parse performance data, replacing the current metrics. Malformed
+ *  metrics are skipped. This method only locks the interned strings
+ *  once, and can be called by any thread.
+ *
+ *  @param[in] data  Performance data.
+ *
+ *  @return False if some metrics were malformed.
+ */
+bool perfdata::parse(std::string const& data) {
+  double const nan(std::numeric_limits<double>::quiet_NaN());
+  std::vector<span> names;
+  bool valid(true);
+  _metrics.clear();
+  _strings.clear();
+
+  char const* it(data.c_str());
+  char const* const end(it + data.size());
+  while (it != end) {
+    if (is_space(*it)) {
+      ++it;
+      continue;
+    }
+
+    // Label, quotes are doubled inside quoted labels.
+    span label = { it, 0, false };
+    if (*it == '\'') {
+      label.quoted = true;
+      label.data = ++it;
+      while (it != end) {
+        if (*it == '\'') {
+          if ((it + 1 == end) || (it[1] != '\''))
+            break;
+          ++it;
+        }
+        ++it;
+      }
+      label.size = it - label.data;
+      if (it != end)
+        ++it;
+    }
+    else {
+      while ((it != end) && (*it != '=') && !is_space(*it))
+        ++it;
+      label.size = it - label.data;
+    }
+
+    // Value fields.
+    char const* fields(it);
+    while ((it != end) && !is_space(*it))
+      ++it;
+    if (!label.size || (fields == it) || (*fields != '=')) {
+      valid = false;
+      continue;
+    }
+    ++fields;
+
+    char const* field_end[5];
+    char const* field_begin[5];
+    unsigned int count(0);
+    for (char const* f(fields); count < 5; ++count) {
+      char const* sep(
+        static_cast<char const*>(memchr(f, ';', it - f)));
+      field_begin[count] = f;
+      field_end[count] = sep ? sep : it;
+      if (!sep) {
+        ++count;
+        break;
+      }
+      f = sep + 1;
+    }
+    for (unsigned int i(count); i < 5; ++i)
+      field_begin[i] = field_end[i] = it;
+
+    metric m;
+    char const* unit(field_begin[0]);
+    if ((field_end[0] - field_begin[0] == 1) && (*field_begin[0] == 'U'))
+      m.value = nan;
+    else {
+      unit = parse_number(field_begin[0], field_end[0], m.value);
+      if (unit == field_begin[0]) {
+        valid = false;
+        continue;
+      }
+    }
+    parse_range(field_begin[1], field_end[1], m.warning);
+    parse_range(field_begin[2], field_end[2], m.critical);
+    if (parse_number(field_begin[3], field_end[3], m.min) != field_end[3]
+        || field_begin[3] == field_end[3])
+      m.min = nan;
+    if (parse_number(field_begin[4], field_end[4], m.max) != field_end[4]
+        || field_begin[4] == field_end[4])
+      m.max = nan;
+    m.label = nullptr;
+    m.unit = nullptr;
+    _metrics.push_back(m);
+    names.push_back(label);
+    span u = { unit, static_cast<size_t>(field_end[0] - unit), false };
+    names.push_back(u);
+  }
+
+  // Intern labels and units.
+  if (!_metrics.empty()) {
+    std::string key;
+    _strings.reserve(names.size());
+    interned_table& table(interned_strings());
+    std::lock_guard<std::mutex> lock(table.lock);
+    for (unsigned int i(0); i < _metrics.size(); ++i) {
+      span const& l(names[i * 2]);
+      key.assign(l.data, l.size);
+      if (l.quoted)
+        for (size_t pos(key.find("''"));
+             pos != std::string::npos;
+             pos = key.find("''", pos + 1))
+          key.erase(pos, 1);
+      _strings.push_back(intern_unlocked(table, key));
+      _metrics[i].label = _strings.back()->c_str();
+      span const& u(names[i * 2 + 1]);
+      key.assign(u.data, u.size);
+      _strings.push_back(intern_unlocked(table, key));
+      _metrics[i].unit = _strings.back()->c_str();
+    }
+  }
+  return valid;
+}
+
+/**
+ *  Get the number of metrics.
+ *
+ *  @return Number of metrics.
+ */
+unsigned int perfdata::size() const throw () {
+  return _metrics.size();
+}
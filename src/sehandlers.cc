@@ -43,8 +43,6 @@ using namespace com::centreon::engine::logging;
 int obsessive_compulsive_host_check_processor(com::centreon::engine::host* hst) {
   std::string raw_command;
   std::string processed_command;
-  int early_timeout = false;
-  double exectime = 0.0;
   int macro_options = STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS;
   nagios_macros mac;
 
@@ -98,30 +96,26 @@ int obsessive_compulsive_host_check_processor(com::centreon::engine::host* hst)
     "command line: " << processed_command;
 
   /* run the command */
-  try {
-    std::string tmp;
-    my_system_r(
-      &mac,
-      processed_command,
-      config->ochp_timeout(),
-      &early_timeout,
-      &exectime,
-      tmp,
-      0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-      << "Error: can't execute compulsive host processor command line '"
-      << processed_command << "' : " << e.what();
-  }
+  std::string host_name(hst->get_name());
+  unsigned int timeout(config->ochp_timeout());
+  my_system_async_r(
+    &mac,
+    processed_command,
+    timeout,
+    [host_name, processed_command, timeout](
+      int,
+      int early_timeout,
+      double,
+      std::string const&) {
+      /* check to see if the command timed out */
+      if (early_timeout == true)
+        logger(log_runtime_warning, basic)
+          << "Warning: OCHP command '" << processed_command
+          << "' for host '" << host_name << "' timed out after "
+          << timeout << " seconds";
+    });
   clear_volatile_macros_r(&mac);
 
-  /* check to see if the command timed out */
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-      << "Warning: OCHP command '" << processed_command
-      << "' for host '" << hst->get_name() << "' timed out after "
-      << config->ochp_timeout() << " seconds";
-
   return OK;
 }
 
@@ -134,7 +128,6 @@ int run_global_service_event_handler(nagios_macros* mac, com::centreon::engine::
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -230,52 +223,60 @@ int run_global_service_event_handler(nagios_macros* mac, com::centreon::engine::
     return (neb_result == NEBERROR_CALLBACKCANCEL) ? ERROR : OK;
   }
 
-  /* run the command */
-  try {
-    result = my_system_r(
-               mac,
-               processed_command,
-               config->event_handler_timeout(),
-               &early_timeout,
-               &exectime,
-               command_output,
-               0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-      << "Error: can't execute global service event handler "
-         "command line '"
-      << processed_command << "' : " << e.what();
-  }
-
-  /* check to see if the event handler timed out */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-      << "Warning: Global service event handler command '"
-      << processed_command << "' timed out after "
-      << config->event_handler_timeout() << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(
-    NEBTYPE_EVENTHANDLER_END,
-    NEBFLAG_NONE,
-    NEBATTR_NONE,
-    GLOBAL_SERVICE_EVENTHANDLER,
-    (void*)svc,
-    svc->get_current_state(),
-    svc->get_state_type(),
-    start_time,
-    end_time,
-    exectime,
-    config->event_handler_timeout(),
-    early_timeout,
-    result,
-    config->global_service_event_handler().c_str(),
-    const_cast<char *>(processed_command.c_str()),
-    const_cast<char *>(command_output.c_str()),
-    nullptr);
+  /* run the command, its end is sent to the broker once it completed.
+     The service is looked up again then, it may have been removed by a
+     configuration reload in the meantime */
+  uint64_t host_id(svc->get_host_id());
+  uint64_t service_id(svc->get_service_id());
+  int state(svc->get_current_state());
+  int state_type(svc->get_state_type());
+  std::string handler(config->global_service_event_handler());
+  unsigned int timeout(config->event_handler_timeout());
+  my_system_async_r(
+    mac,
+    processed_command,
+    timeout,
+    [host_id, service_id, state, state_type, start_time, handler,
+     processed_command, timeout](
+      int result,
+      int early_timeout,
+      double exectime,
+      std::string const& command_output) {
+      /* check to see if the event handler timed out */
+      if (early_timeout == true)
+        logger(log_event_handler | log_runtime_warning, basic)
+          << "Warning: Global service event handler command '"
+          << processed_command << "' timed out after "
+          << timeout << " seconds";
+
+      /* get end time */
+      struct timeval end_time;
+      gettimeofday(&end_time, nullptr);
+
+      /* send event data to broker */
+      service_id_map::const_iterator
+        found(service::services_by_id.find({host_id, service_id}));
+      if (found == service::services_by_id.end())
+        return;
+      broker_event_handler(
+        NEBTYPE_EVENTHANDLER_END,
+        NEBFLAG_NONE,
+        NEBATTR_NONE,
+        GLOBAL_SERVICE_EVENTHANDLER,
+        (void*)found->second.get(),
+        state,
+        state_type,
+        start_time,
+        end_time,
+        exectime,
+        timeout,
+        early_timeout,
+        result,
+        handler.c_str(),
+        const_cast<char *>(processed_command.c_str()),
+        const_cast<char *>(command_output.c_str()),
+        nullptr);
+    });
 
   return OK;
 }
@@ -285,7 +286,6 @@ int run_service_event_handler(nagios_macros* mac, com::centreon::engine::service
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -381,51 +381,60 @@ int run_service_event_handler(nagios_macros* mac, com::centreon::engine::service
     return (neb_result == NEBERROR_CALLBACKCANCEL) ? ERROR : OK;
   }
 
-  /* run the command */
-  try {
-    result = my_system_r(
-               mac,
-               processed_command,
-               config->event_handler_timeout(),
-               &early_timeout,
-               &exectime,
-               command_output,
-               0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-      << "Error: can't execute service event handler command line '"
-      << processed_command << "' : " << e.what();
-  }
-
-  /* check to see if the event handler timed out */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-      << "Warning: Service event handler command '" << processed_command
-      << "' timed out after " << config->event_handler_timeout()
-      << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(
-    NEBTYPE_EVENTHANDLER_END,
-    NEBFLAG_NONE,
-    NEBATTR_NONE,
-    SERVICE_EVENTHANDLER,
-    (void*)svc,
-    svc->get_current_state(),
-    svc->get_state_type(),
-    start_time,
-    end_time,
-    exectime,
-    config->event_handler_timeout(),
-    early_timeout,
-    result,
-    svc->get_event_handler().c_str(),
-    const_cast<char *>(processed_command.c_str()),
-    const_cast<char *>(command_output.c_str()),
-    nullptr);
+  /* run the command, its end is sent to the broker once it completed.
+     The service is looked up again then, it may have been removed by a
+     configuration reload in the meantime */
+  uint64_t host_id(svc->get_host_id());
+  uint64_t service_id(svc->get_service_id());
+  int state(svc->get_current_state());
+  int state_type(svc->get_state_type());
+  std::string handler(svc->get_event_handler());
+  unsigned int timeout(config->event_handler_timeout());
+  my_system_async_r(
+    mac,
+    processed_command,
+    timeout,
+    [host_id, service_id, state, state_type, start_time, handler,
+     processed_command, timeout](
+      int result,
+      int early_timeout,
+      double exectime,
+      std::string const& command_output) {
+      /* check to see if the event handler timed out */
+      if (early_timeout == true)
+        logger(log_event_handler | log_runtime_warning, basic)
+          << "Warning: Service event handler command '" << processed_command
+          << "' timed out after " << timeout
+          << " seconds";
+
+      /* get end time */
+      struct timeval end_time;
+      gettimeofday(&end_time, nullptr);
+
+      /* send event data to broker */
+      service_id_map::const_iterator
+        found(service::services_by_id.find({host_id, service_id}));
+      if (found == service::services_by_id.end())
+        return;
+      broker_event_handler(
+        NEBTYPE_EVENTHANDLER_END,
+        NEBFLAG_NONE,
+        NEBATTR_NONE,
+        SERVICE_EVENTHANDLER,
+        (void*)found->second.get(),
+        state,
+        state_type,
+        start_time,
+        end_time,
+        exectime,
+        timeout,
+        early_timeout,
+        result,
+        handler.c_str(),
+        const_cast<char *>(processed_command.c_str()),
+        const_cast<char *>(command_output.c_str()),
+        nullptr);
+    });
 
   return OK;
 }
@@ -493,7 +502,6 @@ int run_global_host_event_handler(nagios_macros* mac,
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -589,51 +597,59 @@ int run_global_host_event_handler(nagios_macros* mac,
     return (neb_result == NEBERROR_CALLBACKCANCEL) ? ERROR : OK;
   }
 
-  /* run the command */
-  try {
-    result = my_system_r(
-               mac,
-               processed_command,
-               config->event_handler_timeout(),
-               &early_timeout,
-               &exectime,
-               command_output,
-               0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-      << "Error: can't execute global host event handler command line '"
-      << processed_command << "' : " << e.what();
-  }
-
-  /* check for a timeout in the execution of the event handler command */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-      << "Warning: Global host event handler command '"
-      << processed_command << "' timed out after "
-      << config->event_handler_timeout() << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(
-    NEBTYPE_EVENTHANDLER_END,
-    NEBFLAG_NONE,
-    NEBATTR_NONE,
-    GLOBAL_HOST_EVENTHANDLER,
-    (void*)hst,
-    hst->get_current_state(),
-    hst->get_state_type(),
-    start_time,
-    end_time,
-    exectime,
-    config->event_handler_timeout(),
-    early_timeout,
-    result,
-    config->global_host_event_handler().c_str(),
-    const_cast<char *>(processed_command.c_str()),
-    const_cast<char *>(command_output.c_str()),
-    nullptr);
+  /* run the command, its end is sent to the broker once it completed.
+     The host is looked up again then, it may have been removed by a
+     configuration reload in the meantime */
+  uint64_t host_id(hst->get_host_id());
+  int state(hst->get_current_state());
+  int state_type(hst->get_state_type());
+  std::string handler(config->global_host_event_handler());
+  unsigned int timeout(config->event_handler_timeout());
+  my_system_async_r(
+    mac,
+    processed_command,
+    timeout,
+    [host_id, state, state_type, start_time, handler, processed_command,
+     timeout](
+      int result,
+      int early_timeout,
+      double exectime,
+      std::string const& command_output) {
+      /* check for a timeout in the execution of the event handler command */
+      if (early_timeout == true)
+        logger(log_event_handler | log_runtime_warning, basic)
+          << "Warning: Global host event handler command '"
+          << processed_command << "' timed out after "
+          << timeout << " seconds";
+
+      /* get end time */
+      struct timeval end_time;
+      gettimeofday(&end_time, nullptr);
+
+      /* send event data to broker */
+      host_id_map::const_iterator
+        found(host::hosts_by_id.find(host_id));
+      if (found == host::hosts_by_id.end())
+        return;
+      broker_event_handler(
+        NEBTYPE_EVENTHANDLER_END,
+        NEBFLAG_NONE,
+        NEBATTR_NONE,
+        GLOBAL_HOST_EVENTHANDLER,
+        (void*)found->second.get(),
+        state,
+        state_type,
+        start_time,
+        end_time,
+        exectime,
+        timeout,
+        early_timeout,
+        result,
+        handler.c_str(),
+        const_cast<char *>(processed_command.c_str()),
+        const_cast<char *>(command_output.c_str()),
+        nullptr);
+    });
 
   return OK;
 }
@@ -644,7 +660,6 @@ int run_host_event_handler(nagios_macros* mac,
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -737,51 +752,59 @@ int run_host_event_handler(nagios_macros* mac,
     return (neb_result == NEBERROR_CALLBACKCANCEL) ? ERROR : OK;
   }
 
-  /* run the command */
-  try {
-    result = my_system_r(
-               mac,
-               processed_command,
-               config->event_handler_timeout(),
-               &early_timeout,
-               &exectime,
-               command_output,
-               0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-      << "Error: can't execute host event handler command line '"
-      << processed_command << "' : " << e.what();
-  }
-
-  /* check to see if the event handler timed out */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-      << "Warning: Host event handler command '" << processed_command
-      << "' timed out after " << config->event_handler_timeout()
-      << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(
-    NEBTYPE_EVENTHANDLER_END,
-    NEBFLAG_NONE,
-    NEBATTR_NONE,
-    HOST_EVENTHANDLER,
-    (void*)hst,
-    hst->get_current_state(),
-    hst->get_state_type(),
-    start_time,
-    end_time,
-    exectime,
-    config->event_handler_timeout(),
-    early_timeout,
-    result,
-    hst->get_event_handler().c_str(),
-    const_cast<char *>(processed_command.c_str()),
-    const_cast<char *>(command_output.c_str()),
-    nullptr);
+  /* run the command, its end is sent to the broker once it completed.
+     The host is looked up again then, it may have been removed by a
+     configuration reload in the meantime */
+  uint64_t host_id(hst->get_host_id());
+  int state(hst->get_current_state());
+  int state_type(hst->get_state_type());
+  std::string handler(hst->get_event_handler());
+  unsigned int timeout(config->event_handler_timeout());
+  my_system_async_r(
+    mac,
+    processed_command,
+    timeout,
+    [host_id, state, state_type, start_time, handler, processed_command,
+     timeout](
+      int result,
+      int early_timeout,
+      double exectime,
+      std::string const& command_output) {
+      /* check to see if the event handler timed out */
+      if (early_timeout == true)
+        logger(log_event_handler | log_runtime_warning, basic)
+          << "Warning: Host event handler command '" << processed_command
+          << "' timed out after " << timeout
+          << " seconds";
+
+      /* get end time */
+      struct timeval end_time;
+      gettimeofday(&end_time, nullptr);
+
+      /* send event data to broker */
+      host_id_map::const_iterator
+        found(host::hosts_by_id.find(host_id));
+      if (found == host::hosts_by_id.end())
+        return;
+      broker_event_handler(
+        NEBTYPE_EVENTHANDLER_END,
+        NEBFLAG_NONE,
+        NEBATTR_NONE,
+        HOST_EVENTHANDLER,
+        (void*)found->second.get(),
+        state,
+        state_type,
+        start_time,
+        end_time,
+        exectime,
+        timeout,
+        early_timeout,
+        result,
+        handler.c_str(),
+        const_cast<char *>(processed_command.c_str()),
+        const_cast<char *>(command_output.c_str()),
+        nullptr);
+    });
 
   return OK;
 }
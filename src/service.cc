@@ -20,11 +20,14 @@
 #include <iomanip>
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/host_cache.hh"
 #include "com/centreon/engine/checks/viability_failure.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/deleter/listmember.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/error.hh"
 #include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/load_leveler.hh"
 #include "com/centreon/engine/flapping.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/hostdependency.hh"
@@ -982,9 +985,13 @@ int service::handle_async_check_result(check_result* queued_check_result) {
       << ", OUTPUT: " << queued_check_result->get_output();
 
   /* decrement the number of service checks still out there... */
-  if (queued_check_result->get_check_type() == check_active &&
-      currently_running_service_checks > 0)
-    currently_running_service_checks--;
+  if (queued_check_result->get_check_type() == check_active) {
+    if (currently_running_service_checks > 0)
+      currently_running_service_checks--;
+    checks::checker::instance().admission().finished(
+      get_host_id(),
+      get_service_id());
+  }
 
   /*
    * skip this service check results if its passive and we aren't accepting
@@ -1047,6 +1054,10 @@ int service::handle_async_check_result(check_result* queued_check_result) {
   if (get_execution_time() < 0.0)
     set_execution_time(0.0);
 
+  /* account the execution time of active checks in the load projection */
+  if (queued_check_result->get_check_type() == check_active)
+    events::load_leveler::instance().learn(this, get_execution_time());
+
   /* get the last check time */
   set_last_check(queued_check_result->get_start_time().tv_sec);
 
@@ -1119,24 +1130,25 @@ int service::handle_async_check_result(check_result* queued_check_result) {
      * parse check output to get: (1) short output, (2) long output,
      * (3) perf data
      */
-    std::string output{queued_check_result->get_output()};
     std::string plugin_output;
     std::string long_plugin_output;
     std::string perf_data;
-    parse_check_output(output, plugin_output, long_plugin_output, perf_data,
-                       true, true);
+    perfdata metrics;
+    queued_check_result->take_parsed_output(
+      plugin_output,
+      long_plugin_output,
+      perf_data,
+      metrics);
 
     set_long_plugin_output(long_plugin_output);
-    set_perf_data(perf_data);
+    set_perf_data(std::move(perf_data), std::move(metrics));
     /* make sure the plugin output isn't null */
     if (plugin_output.empty())
       set_plugin_output("(No output returned from plugin)");
     else {
-      std::replace(plugin_output.begin(), plugin_output.end(), ';', ':');
-
       /*
-       * replace semicolons in plugin output (but not performance data) with
-       * colons
+       * semicolons in plugin output (but not performance data) were
+       * replaced with colons by the parser
        */
       set_plugin_output(plugin_output);
     }
@@ -1379,10 +1391,10 @@ int service::handle_async_check_result(check_result* queued_check_result) {
         /* usually only use cached host state if no service state change has
          * occurred */
         if ((!state_change || state_changes_use_cached_state) &&
-            hst->get_has_been_checked() &&
-            (static_cast<unsigned long>(current_time -
-                                        hst->get_last_check()) <=
-             config->cached_host_check_horizon())) {
+            checks::host_cache::instance().lookup(
+              *hst,
+              current_time,
+              config->cached_host_check_horizon())) {
           logger(dbg_checks, more) << "* Using cached host state: "
                                    << hst->get_current_state();
           update_check_stats(ACTIVE_ONDEMAND_HOST_CHECK_STATS, current_time);
@@ -1490,10 +1502,10 @@ int service::handle_async_check_result(check_result* queued_check_result) {
         /* can we use the last cached host state? */
         /* only use cached host state if no service state change has occurred */
         if ((!state_change || state_changes_use_cached_state) &&
-            hst->get_has_been_checked() &&
-            (static_cast<unsigned long>(current_time -
-                                        hst->get_last_check()) <=
-             config->cached_host_check_horizon())) {
+            checks::host_cache::instance().lookup(
+              *hst,
+              current_time,
+              config->cached_host_check_horizon())) {
           /* use current host state as route result */
           route_result = hst->get_current_state();
           logger(dbg_checks, more) << "* Using cached host state: "
@@ -1924,15 +1936,9 @@ void service::check_for_flapping(bool update,
                                  bool allow_flapstart_notification) {
   bool update_history;
   bool is_flapping = false;
-  unsigned int x = 0;
-  unsigned int y = 0;
-  int last_state_history_value = service::state_ok;
-  double curved_changes = 0.0;
   double curved_percent_change = 0.0;
   double low_threshold = 0.0;
   double high_threshold = 0.0;
-  double low_curve_value = 0.75;
-  double high_curve_value = 1.25;
 
   /* large install tweaks skips all flap detection logic - including state
    * change calculation */
@@ -1974,44 +1980,10 @@ void service::check_for_flapping(bool update,
       update_history = false;
   }
 
-  /* record current service state */
-  if (update_history) {
-    /* record the current state in the state history */
-    get_state_history()[get_state_history_index()] = _current_state;
-
-    /* increment state history index to next available slot */
-    set_state_history_index(get_state_history_index() + 1);
-    if (get_state_history_index() >= MAX_STATE_HISTORY_ENTRIES)
-      set_state_history_index(0);
-  }
-
-  /* calculate overall and curved percent state changes */
-  for (x = 0, y = get_state_history_index(); x < MAX_STATE_HISTORY_ENTRIES;
-       x++) {
-    if (x == 0) {
-      last_state_history_value = get_state_history()[y];
-      y++;
-      if (y >= MAX_STATE_HISTORY_ENTRIES)
-        y = 0;
-      continue;
-    }
-
-    if (last_state_history_value != get_state_history()[y])
-      curved_changes +=
-          (((double)(x - 1) * (high_curve_value - low_curve_value)) /
-           ((double)(MAX_STATE_HISTORY_ENTRIES - 2))) +
-          low_curve_value;
-
-    last_state_history_value = get_state_history()[y];
-
-    y++;
-    if (y >= MAX_STATE_HISTORY_ENTRIES)
-      y = 0;
-  }
-
-  /* calculate overall percent change in state */
-  curved_percent_change = (double)(((double)curved_changes * 100.0) /
-                                   (double)(MAX_STATE_HISTORY_ENTRIES - 1));
+  /* record current service state and calculate the curved percent state
+   * change */
+  curved_percent_change
+    = _record_state_history(update_history, _current_state);
 
   set_percent_state_change(curved_percent_change);
 
@@ -2105,8 +2077,6 @@ int service::obsessive_compulsive_service_check_processor() {
   std::string raw_command;
   std::string processed_command;
   host* temp_host{get_host_ptr()};
-  int early_timeout = false;
-  double exectime = 0.0;
   int macro_options = STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS;
   nagios_macros mac;
 
@@ -2155,25 +2125,23 @@ int service::obsessive_compulsive_service_check_processor() {
                            << processed_command;
 
   /* run the command */
-  try {
-    std::string tmp;
-    my_system_r(&mac, processed_command, config->ocsp_timeout(), &early_timeout,
-                &exectime, tmp, 0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-        << "Error: can't execute compulsive service processor command line '"
-        << processed_command << "' : " << e.what();
-  }
+  std::string description{_description};
+  std::string hostname{_hostname};
+  unsigned int timeout{config->ocsp_timeout()};
+  my_system_async_r(
+      &mac, processed_command, timeout,
+      [description, hostname, processed_command, timeout](
+          int, int early_timeout, double, std::string const&) {
+        /* check to see if the command timed out */
+        if (early_timeout == true)
+          logger(log_runtime_warning, basic)
+              << "Warning: OCSP command '" << processed_command
+              << "' for service '" << description << "' on host '"
+              << hostname << "' timed out after " << timeout << " seconds";
+      });
 
   clear_volatile_macros_r(&mac);
 
-  /* check to see if the command timed out */
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-        << "Warning: OCSP command '" << processed_command << "' for service '"
-        << _description << "' on host '" << _hostname
-        << "' timed out after " << config->ocsp_timeout() << " seconds";
-
   return OK;
 }
 
@@ -2339,7 +2307,7 @@ void service::schedule_check(time_t check_time, int options) {
   if (temp_event) {
     logger(dbg_checks, most)
         << "Found another service check event for this service @ "
-        << my_ctime(&temp_event->run_time);
+        << string::ctime(temp_event->get_run_time());
 
     // Use the originally scheduled check unless we decide otherwise.
     use_original_event = true;
@@ -2349,7 +2317,7 @@ void service::schedule_check(time_t check_time, int options) {
       // The new event is also forced and its execution time is earlier
       // than the original, so use it instead.
       if ((options & CHECK_OPTION_FORCE_EXECUTION) &&
-          (check_time < temp_event->run_time)) {
+          (check_time < temp_event->get_run_time())) {
         use_original_event = false;
         logger(dbg_checks, most)
             << "New service check event is forced and occurs before the "
@@ -2367,7 +2335,7 @@ void service::schedule_check(time_t check_time, int options) {
       }
       // The new event is not forced either and its execution time is
       // earlier than the original, so use it instead.
-      else if (check_time < temp_event->run_time) {
+      else if (check_time < temp_event->get_run_time()) {
         use_original_event = false;
         logger(dbg_checks, most)
             << "New service check event occurs before the existing "
@@ -2400,6 +2368,15 @@ void service::schedule_check(time_t check_time, int options) {
     try {
       timed_event* new_event(new timed_event);
 
+      // Account the check load, regular checks can be postponed to a
+      // less loaded second.
+      check_time = events::load_leveler::instance().place(
+                     this,
+                     check_time,
+                     (options & CHECK_OPTION_FORCE_EXECUTION)
+                     ? 0
+                     : events::load_leveler::max_delay(*this));
+
       // Set the next service check time.
       set_next_check(check_time);
 
@@ -2408,7 +2385,7 @@ void service::schedule_check(time_t check_time, int options) {
       new_event->event_data = (void*)this;
       new_event->event_args = (void*)nullptr;
       new_event->event_options = options;
-      new_event->run_time = get_next_check();
+      new_event->set_run_time(get_next_check());
       new_event->recurring = false;
       new_event->event_interval = 0L;
       new_event->timing_func = nullptr;
@@ -2422,7 +2399,7 @@ void service::schedule_check(time_t check_time, int options) {
   } else {
     // Reset the next check time (it may be out of sync).
     if (temp_event)
-      set_next_check(temp_event->run_time);
+      set_next_check(temp_event->get_run_time());
 
     logger(dbg_checks, most)
         << "Keeping original service check event (ignoring the new one).";
@@ -2666,6 +2643,33 @@ void service::grab_macros_r(nagios_macros* mac) {
   grab_service_macros_r(mac, this);
 }
 
+/**
+ *  Find a service and a contact once one of their notification commands
+ *  completed. They may have been removed by a configuration reload in
+ *  the meantime.
+ *
+ *  @param[in]  id            Host ID and service ID.
+ *  @param[in]  contact_name  Contact name.
+ *  @param[out] svc           Service, if found.
+ *  @param[out] cntct         Contact, if found.
+ *
+ *  @return True if both were found.
+ */
+static bool find_notified(
+              std::pair<uint64_t, uint64_t> const& id,
+              std::string const& contact_name,
+              service*& svc,
+              contact*& cntct) {
+  service_id_map::const_iterator it_svc(service::services_by_id.find(id));
+  contact_map::const_iterator it_ctct(contact::contacts.find(contact_name));
+  if (it_svc == service::services_by_id.end()
+      || it_ctct == contact::contacts.end())
+    return false;
+  svc = it_svc->second.get();
+  cntct = it_ctct->second.get();
+  return true;
+}
+
 /* notify a specific contact about a service problem or recovery */
 int service::notify_contact(nagios_macros* mac,
                             contact* cntct,
@@ -2673,11 +2677,10 @@ int service::notify_contact(nagios_macros* mac,
                             std::string const& not_author,
                             std::string const& not_data,
                             int options __attribute__((unused)),
-                            int escalated) {
+                            int escalated,
+                            std::shared_ptr<void> const& notification_done) {
   std::string raw_command;
   std::string processed_command;
-  int early_timeout = false;
-  double exectime;
   struct timeval start_time, end_time;
   struct timeval method_start_time, method_end_time;
   int macro_options = STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS;
@@ -2717,6 +2720,36 @@ int service::notify_contact(nagios_macros* mac,
   else if (NEBERROR_CALLBACKOVERRIDE == neb_result)
     return OK;
 
+  /* the end of the notification of this contact is sent to the event
+     broker once all its commands completed, before the end of the
+     whole notification. The service and the contact are looked up
+     again then */
+  std::pair<uint64_t, uint64_t> id{_host_id, _service_id};
+  std::string contact_name{cntct->get_name()};
+  commands::system_runner::completion contact_done{
+      commands::system_runner::make_completion(
+          [id, contact_name, type, not_author, not_data, escalated,
+           start_time, notification_done]() {
+            service* svc;
+            contact* cntct;
+            if (!find_notified(id, contact_name, svc, cntct))
+              return;
+
+            /* get end time */
+            struct timeval end_time;
+            gettimeofday(&end_time, nullptr);
+
+            /* update the contact's last service notification time */
+            cntct->set_last_service_notification(start_time.tv_sec);
+
+            /* send data to event broker */
+            broker_contact_notification_data(
+                NEBTYPE_CONTACTNOTIFICATION_END, NEBFLAG_NONE, NEBATTR_NONE,
+                service_notification, type, start_time, end_time, (void*)svc,
+                cntct, not_author.c_str(), not_data.c_str(), escalated,
+                nullptr);
+          })};
+
   /* process all the notification commands this user has */
   for (std::shared_ptr<commands::command> const& cmd :
        cntct->get_service_notification_commands()) {
@@ -2788,48 +2821,42 @@ int service::notify_contact(nagios_macros* mac,
           << get_plugin_output() << info;
     }
 
-    /* run the notification command */
-    try {
-      std::string tmp;
-      my_system_r(mac, processed_command, config->notification_timeout(),
-                  &early_timeout, &exectime, tmp, 0);
-    } catch (std::exception const& e) {
-      logger(log_runtime_error, basic)
-          << "Error: can't execute service notification '" << cntct->get_name()
-          << "' : " << e.what();
-    }
-
-    /* check to see if the notification command timed out */
-    if (early_timeout) {
-      logger(log_service_notification | log_runtime_warning, basic)
-          << "Warning: Contact '" << cntct->get_name()
-          << "' service notification command '" << processed_command
-          << "' timed out after " << config->notification_timeout()
-          << " seconds";
-    }
-
-    /* get end time */
-    gettimeofday(&method_end_time, nullptr);
+    /* run the notification command, the end of the method is sent to
+       the event broker once it completed */
+    std::string command_line{cmd->get_command_line()};
+    unsigned int timeout{config->notification_timeout()};
+    my_system_async_r(
+        mac, processed_command, timeout,
+        [id, contact_name, type, not_author, not_data, escalated,
+         method_start_time, command_line, processed_command, timeout,
+         contact_done](int, int early_timeout, double, std::string const&) {
+          /* check to see if the notification command timed out */
+          if (early_timeout) {
+            logger(log_service_notification | log_runtime_warning, basic)
+                << "Warning: Contact '" << contact_name
+                << "' service notification command '" << processed_command
+                << "' timed out after " << timeout
+                << " seconds";
+          }
 
-    /* send data to event broker */
-    broker_contact_notification_method_data(
-        NEBTYPE_CONTACTNOTIFICATIONMETHOD_END, NEBFLAG_NONE, NEBATTR_NONE,
-        service_notification, type, method_start_time, method_end_time,
-        (void*)this, cntct, cmd->get_command_line().c_str(), not_author.c_str(),
-        not_data.c_str(), escalated, nullptr);
+          service* svc;
+          contact* cntct;
+          if (!find_notified(id, contact_name, svc, cntct))
+            return;
+
+          /* get end time */
+          struct timeval method_end_time;
+          gettimeofday(&method_end_time, nullptr);
+
+          /* send data to event broker */
+          broker_contact_notification_method_data(
+              NEBTYPE_CONTACTNOTIFICATIONMETHOD_END, NEBFLAG_NONE,
+              NEBATTR_NONE, service_notification, type, method_start_time,
+              method_end_time, (void*)svc, cntct, command_line.c_str(),
+              not_author.c_str(), not_data.c_str(), escalated, nullptr);
+        });
   }
 
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* update the contact's last service notification time */
-  cntct->set_last_service_notification(start_time.tv_sec);
-
-  /* send data to event broker */
-  broker_contact_notification_data(
-      NEBTYPE_CONTACTNOTIFICATION_END, NEBFLAG_NONE, NEBATTR_NONE,
-      service_notification, type, start_time, end_time, (void*)this, cntct,
-      not_author.c_str(), not_data.c_str(), escalated, nullptr);
   return OK;
 }
 
@@ -3199,6 +3226,9 @@ void service::check_for_orphaned() {
       /* decrement the number of running service checks */
       if (currently_running_service_checks > 0)
         currently_running_service_checks--;
+      checks::checker::instance().admission().finished(
+        it->second->get_host_id(),
+        it->second->get_service_id());
 
       /* disable the executing flag */
       it->second->set_is_executing(false);
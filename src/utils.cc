@@ -20,11 +20,13 @@
 */
 
 #include <algorithm>
+#include <cctype>
 #include <cerrno>
 #include <cmath>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <dirent.h>
 #include <fcntl.h>
@@ -38,6 +40,7 @@
 #include "com/centreon/engine/broker/loader.hh"
 #include "com/centreon/engine/checks/checker.hh"
 #include "com/centreon/engine/commands/raw.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/comment.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/events/defines.hh"
@@ -59,56 +62,32 @@ using namespace com::centreon::engine::logging;
 /******************** SYSTEM COMMAND FUNCTIONS ********************/
 /******************************************************************/
 
-/* executes a system command - used for notifications, event handlers, etc. */
-int my_system_r(
-      nagios_macros* mac,
-      std::string const& cmd,
-      int timeout,
-      int* early_timeout,
-      double* exectime,
-      std::string& output,
-      unsigned int max_output_length) {
-
-  logger(dbg_functions, basic)
-    << "my_system_r()";
-
-  // initialize return variables.
-  *early_timeout = false;
-  *exectime = 0.0;
-
-  // if no command was passed, return with no error.
-  if (cmd.empty()) {
-    return service::state_ok;
-  }
-
-  logger(dbg_commands, more)
-    << "Running command '" << cmd << "'...";
-
-  timeval start_time = timeval();
+/**
+ *  Handle the result of a system command: compute its execution time,
+ *  early timeout and output, then send the end of the command to the
+ *  event broker.
+ *
+ *  @param[in]  cmd                Command line.
+ *  @param[in]  timeout            Command timeout.
+ *  @param[in]  start_time         Time the command was started.
+ *  @param[in]  res                Command result.
+ *  @param[out] early_timeout      Set if the command timed out.
+ *  @param[out] exectime           Execution time.
+ *  @param[out] output             Command output.
+ *  @param[in]  max_output_length  Maximum output length, 0 for none.
+ *
+ *  @return Exit code of the command.
+ */
+static int end_system_command(
+             std::string const& cmd,
+             int timeout,
+             timeval const& start_time,
+             commands::result const& res,
+             int* early_timeout,
+             double* exectime,
+             std::string& output,
+             unsigned int max_output_length) {
   timeval end_time = timeval();
-
-  // time to start command.
-  gettimeofday(&start_time, nullptr);
-
-  // send event broker.
-  broker_system_command(
-    NEBTYPE_SYSTEM_COMMAND_START,
-    NEBFLAG_NONE,
-    NEBATTR_NONE,
-    start_time,
-    end_time,
-    *exectime,
-    timeout,
-    *early_timeout,
-    service::state_ok,
-    const_cast<char *>(cmd.c_str()),
-    nullptr,
-    nullptr);
-
-  commands::raw raw_cmd("system", cmd);
-  commands::result res;
-  raw_cmd.run(cmd, *mac, timeout, res);
-
   end_time.tv_sec = res.end_time.to_seconds();
   end_time.tv_usec
     = res.end_time.to_useconds() - end_time.tv_sec * 1000000ull;
@@ -145,6 +124,124 @@ int my_system_r(
   return result;
 }
 
+/**
+ *  Send the start of a system command to the event broker.
+ *
+ *  @param[in]  cmd         Command line.
+ *  @param[in]  timeout     Command timeout.
+ *  @param[out] start_time  Time the command is started.
+ */
+static void start_system_command(
+              std::string const& cmd,
+              int timeout,
+              timeval& start_time) {
+  logger(dbg_commands, more)
+    << "Running command '" << cmd << "'...";
+
+  timeval end_time = timeval();
+
+  // time to start command.
+  gettimeofday(&start_time, nullptr);
+
+  // send event broker.
+  broker_system_command(
+    NEBTYPE_SYSTEM_COMMAND_START,
+    NEBFLAG_NONE,
+    NEBATTR_NONE,
+    start_time,
+    end_time,
+    0.0,
+    timeout,
+    false,
+    service::state_ok,
+    const_cast<char *>(cmd.c_str()),
+    nullptr,
+    nullptr);
+}
+
+/* executes a system command - used for notifications, event handlers, etc. */
+int my_system_r(
+      nagios_macros* mac,
+      std::string const& cmd,
+      int timeout,
+      int* early_timeout,
+      double* exectime,
+      std::string& output,
+      unsigned int max_output_length) {
+
+  logger(dbg_functions, basic)
+    << "my_system_r()";
+
+  // initialize return variables.
+  *early_timeout = false;
+  *exectime = 0.0;
+
+  // if no command was passed, return with no error.
+  if (cmd.empty()) {
+    return service::state_ok;
+  }
+
+  timeval start_time = timeval();
+  start_system_command(cmd, timeout, start_time);
+
+  commands::raw raw_cmd("system", cmd);
+  commands::result res;
+  raw_cmd.run(cmd, *mac, timeout, res);
+
+  return end_system_command(
+           cmd,
+           timeout,
+           start_time,
+           res,
+           early_timeout,
+           exectime,
+           output,
+           max_output_length);
+}
+
+/* executes a system command without waiting for it */
+void my_system_async_r(
+       nagios_macros* mac,
+       std::string const& cmd,
+       int timeout,
+       my_system_callback const& callback) {
+
+  logger(dbg_functions, basic)
+    << "my_system_async_r()";
+
+  // if no command was passed, complete with no error.
+  if (cmd.empty()) {
+    callback(service::state_ok, false, 0.0, std::string());
+    return;
+  }
+
+  // The command may wait for a free slot, it is notified as started
+  // when it actually is.
+  std::shared_ptr<timeval> start_time(new timeval());
+  commands::system_runner::instance().run(
+    cmd,
+    *mac,
+    timeout,
+    [cmd, timeout, start_time, callback](commands::result const& res) {
+      int early_timeout(false);
+      double exectime(0.0);
+      std::string output;
+      int result(end_system_command(
+                   cmd,
+                   timeout,
+                   *start_time,
+                   res,
+                   &early_timeout,
+                   &exectime,
+                   output,
+                   0));
+      callback(result, early_timeout, exectime, output);
+    },
+    [cmd, timeout, start_time]() {
+      start_system_command(cmd, timeout, *start_time);
+    });
+}
+
 // same like unix ctime without the '\n' at the end of the string.
 char const* my_ctime(time_t const* t) {
   char* buf(ctime(t));
@@ -269,116 +366,262 @@ void sighandler(int sig) {
   /* else begin shutting down... */
   else
     sigshutdown = true;
+
+  /* let the events loop notice it */
+  events::loop::wakeup();
 }
 
 /******************************************************************/
 /************************* IPC FUNCTIONS **************************/
 /******************************************************************/
 
+namespace {
+  /**
+   *  Compute the size of the outputs of parse_check_output().
+   */
+  class     output_sizer {
+  public:
+            output_sizer() : long_output(0), perf_data(0), short_output(0) {}
+    void    append_long(char const* begin, char const* end) {
+      long_output += end - begin;
+    }
+    void    append_long_separator(char const* sep, size_t len) {
+      (void)sep;
+      long_output += len;
+    }
+    void    append_perf_data(char const* begin, char const* end) {
+      perf_data += end - begin;
+    }
+    void    append_perf_data_separator() {
+      ++perf_data;
+    }
+    void    append_short(char const* begin, char const* end) {
+      short_output += end - begin;
+    }
+
+    size_t  long_output;
+    size_t  perf_data;
+    size_t  short_output;
+  };
+
+  /**
+   *  Write the outputs of parse_check_output().
+   */
+  class     output_writer {
+  public:
+            output_writer(
+              std::string& short_output,
+              std::string& long_output,
+              std::string& perf_data)
+      : _long_output(long_output),
+        _perf_data(perf_data),
+        _short_output(short_output) {}
+    void    append_long(char const* begin, char const* end) {
+      _long_output.append(begin, end);
+    }
+    void    append_long_separator(char const* sep, size_t len) {
+      _long_output.append(sep, len);
+    }
+    void    append_perf_data(char const* begin, char const* end) {
+      _perf_data.append(begin, end);
+    }
+    void    append_perf_data_separator() {
+      _perf_data.push_back(' ');
+    }
+    void    append_short(char const* begin, char const* end) {
+      _short_output.append(begin, end);
+    }
+
+  private:
+    std::string& _long_output;
+    std::string& _perf_data;
+    std::string& _short_output;
+  };
+}
+
 /**
- * @brief Parse buffer and fill the three strings given as references:
- *    * short_output
- *    * long_output
- *    * perf_data
+ *  Check if a character is a blank, for any char value.
+ */
+static inline bool is_space(char c) {
+  return std::isspace(static_cast<unsigned char>(c));
+}
+
+/**
+ *  Remove trailing blanks of a line, keeping at least one character.
  *
- * @param[in] buffer
- * @param[out] short_output
- * @param[out] long_output
- * @param[out] perf_data
- * @param[in] escape_newlines_please To escape new lines in the returned strings
- * @param[in] newlines_are_escaped To consider input newlines as escaped.
+ *  @param[in] begin  Line begin.
+ *  @param[in] end    Line end.
  *
+ *  @return New line end.
  */
-void parse_check_output(
-      std::string const& buffer,
-      std::string& short_buffer,
-      std::string& long_buffer,
-      std::string& pd_buffer,
-      bool escape_newlines_please,
-      bool newlines_are_escaped) {
-  bool long_pipe{false};
-  bool perfdata_already_filled{false};
-
-  bool eof{false};
-  std::string line;
-  /* pos_line is used to cut a line
-   * start_line is the position of the line begin
-   * end_line is the position of the line end. */
-  size_t start_line{0}, end_line, pos_line;
-  int line_number{1};
-  while (!eof) {
-    if (newlines_are_escaped && (pos_line = buffer.find("\\n", start_line)) != std::string::npos) {
-      end_line = pos_line;
-      pos_line += 2;
-    }
-    else if ((pos_line = buffer.find("\n", start_line)) != std::string::npos) {
-      end_line = pos_line;
-      pos_line++;
+static inline char const* trim_line_end(char const* begin, char const* end) {
+  while (end - begin > 1 && is_space(end[-1]))
+    --end;
+  return end;
+}
+
+/**
+ *  Find the first escaped newline ("\n" as two characters).
+ *
+ *  @param[in] begin  Search begin.
+ *  @param[in] end    Search end.
+ *
+ *  @return Position of the backslash, nullptr if not found.
+ */
+static char const* find_escaped_newline(char const* begin, char const* end) {
+  while (end - begin > 1) {
+    char const* bs(static_cast<char const*>(
+                     memchr(begin, '\\', end - begin - 1)));
+    if (!bs)
+      return nullptr;
+    if (bs[1] == 'n')
+      return bs;
+    begin = bs + 1;
+  }
+  return nullptr;
+}
+
+/**
+ *  Split a check output in lines and send each part to an output
+ *  handler. Lines are slices of the buffer, nothing is copied here.
+ *
+ *  @param[in] data                    Output.
+ *  @param[in] size                    Output size.
+ *  @param[in] out                     Output handler.
+ *  @param[in] escape_newlines_please  Separate long output lines with
+ *                                     escaped newlines.
+ *  @param[in] newlines_are_escaped    Split lines on escaped newlines
+ *                                     first.
+ */
+template <typename T>
+static void split_check_output(
+              char const* data,
+              size_t size,
+              T& out,
+              bool escape_newlines_please,
+              bool newlines_are_escaped) {
+  char const* const end(data + size);
+  char const* separator(escape_newlines_please ? "\\n" : "\n");
+  size_t separator_len(escape_newlines_please ? 2 : 1);
+  bool long_pipe(false);
+  bool perfdata_already_filled(false);
+
+  // Escaped newlines take precedence over real ones as long as there
+  // are some left. The next one is remembered between lines.
+  char const* escaped(newlines_are_escaped
+                      ? find_escaped_newline(data, end)
+                      : nullptr);
+
+  char const* line(data);
+  for (int line_number(1); ; ++line_number) {
+    char const* line_end;
+    char const* next;
+    if (escaped) {
+      line_end = escaped;
+      next = escaped + 2;
+      escaped = find_escaped_newline(next, end);
     }
+    else if ((line_end = static_cast<char const*>(
+                           memchr(line, '\n', end - line))))
+      next = line_end + 1;
     else {
-      end_line = buffer.size();
-      eof = true;
+      line_end = end;
+      next = nullptr;
     }
-    line = buffer.substr(start_line, end_line - start_line);
-    size_t pipe;
-    if (!long_pipe)
-      pipe = line.find_last_of('|');
-    else
-      pipe = std::string::npos;
-
-    if (pipe != std::string::npos) {
-      end_line = pipe;
-      /* Let's trim the output */
-      while (end_line > 1 && std::isspace(line[end_line - 1]))
-        end_line--;
-
-      /* Let's trim the output */
-      pipe++;
-      while (pipe < line.size() - 1 && std::isspace(line[pipe]))
-        pipe++;
+
+    char const* pipe(long_pipe
+                     ? nullptr
+                     : static_cast<char const*>(
+                         memrchr(line, '|', line_end - line)));
+    if (pipe) {
+      char const* output_end(trim_line_end(line, pipe));
+      char const* perf(pipe + 1);
+      while (perf < line_end - 1 && is_space(*perf))
+        ++perf;
 
       if (line_number == 1) {
-        short_buffer.append(line.substr(0, end_line));
-        pd_buffer.append(line.substr(pipe));
+        out.append_short(line, output_end);
+        out.append_perf_data(perf, line_end);
         perfdata_already_filled = true;
       }
       else {
         if (line_number > 2)
-          long_buffer.append(escape_newlines_please ? "\\n" : "\n");
-        long_buffer.append(line.substr(0, end_line));
+          out.append_long_separator(separator, separator_len);
+        out.append_long(line, output_end);
         if (perfdata_already_filled)
-          pd_buffer.append(" ");
-        pd_buffer.append(line.substr(pipe));
+          out.append_perf_data_separator();
+        out.append_perf_data(perf, line_end);
         // Now, all new lines contain perfdata.
         long_pipe = true;
       }
     }
     else {
-      /* Let's trim the output */
-      end_line = line.size();
-      while (end_line > 1 && std::isspace(line[end_line - 1]))
-        end_line--;
-      line.erase(end_line);
+      char const* output_end(trim_line_end(line, line_end));
       if (line_number == 1)
-        short_buffer.append(line);
+        out.append_short(line, output_end);
+      else if (!long_pipe) {
+        if (line_number > 2)
+          out.append_long_separator(separator, separator_len);
+        out.append_long(line, output_end);
+      }
       else {
-        if (!long_pipe) {
-          if (line_number > 2)
-            long_buffer.append(escape_newlines_please ? "\\n" : "\n");
-          long_buffer.append(line);
-        }
-        else {
-          if (perfdata_already_filled)
-            pd_buffer.append(" ");
-          pd_buffer.append(line);
-        }
+        if (perfdata_already_filled)
+          out.append_perf_data_separator();
+        out.append_perf_data(line, output_end);
       }
     }
-    start_line = pos_line;
-    line_number++;
+
+    if (!next)
+      break;
+    line = next;
   }
 }
 
+/**
+ * @brief Parse buffer and fill the three strings given as references:
+ *    * short_output
+ *    * long_output
+ *    * perf_data
+ *
+ * Lines are never copied: the buffer is split in place, a first pass
+ * computes the size of each output so that each one is allocated once,
+ * a second pass copies them.
+ *
+ * @param[in] buffer
+ * @param[out] short_output
+ * @param[out] long_output
+ * @param[out] perf_data
+ * @param[in] escape_newlines_please To escape new lines in the returned strings
+ * @param[in] newlines_are_escaped To consider input newlines as escaped.
+ *
+ */
+void parse_check_output(
+      std::string const& buffer,
+      std::string& short_buffer,
+      std::string& long_buffer,
+      std::string& pd_buffer,
+      bool escape_newlines_please,
+      bool newlines_are_escaped) {
+  output_sizer sizes;
+  split_check_output(
+    buffer.data(),
+    buffer.size(),
+    sizes,
+    escape_newlines_please,
+    newlines_are_escaped);
+  short_buffer.reserve(short_buffer.size() + sizes.short_output);
+  long_buffer.reserve(long_buffer.size() + sizes.long_output);
+  pd_buffer.reserve(pd_buffer.size() + sizes.perf_data);
+
+  output_writer writer(short_buffer, long_buffer, pd_buffer);
+  split_check_output(
+    buffer.data(),
+    buffer.size(),
+    writer,
+    escape_newlines_please,
+    newlines_are_escaped);
+}
+
 /******************************************************************/
 /************************ STRING FUNCTIONS ************************/
 /******************************************************************/
@@ -472,29 +715,30 @@ void free_memory(nagios_macros* mac) {
   downtimes::downtime_manager::instance().clear_scheduled_downtimes();
 
   // Free memory for the high priority event list.
-  for (timed_event_list::iterator
+  for (timed_event_list::const_iterator
          it(timed_event::event_list_high.begin()),
          end(timed_event::event_list_high.end());
-       it != end;) {
-    //timed_event* next_event(this_event->next);
+       it != end;
+       ++it) {
     if ((*it)->event_type == EVENT_SCHEDULED_DOWNTIME) {
       delete static_cast<unsigned long *>((*it)->event_data);
       (*it)->event_data = nullptr;
     }
-    it = timed_event::event_list_high.erase(it);
   }
+  timed_event::event_list_high.clear();
 
   // Free memory for the low priority event list.
-  for (timed_event_list::iterator
+  for (timed_event_list::const_iterator
          it(timed_event::event_list_low.begin()),
          end(timed_event::event_list_low.end());
-       it != end;) {
+       it != end;
+       ++it) {
     if ((*it)->event_type == EVENT_SCHEDULED_DOWNTIME) {
       delete static_cast<unsigned long *>((*it)->event_data);
       (*it)->event_data = nullptr;
     }
-    it = timed_event::event_list_low.erase(it);
   }
+  timed_event::event_list_low.clear();
 
   /*
   ** Free memory associated with macros. It's ok to only free the
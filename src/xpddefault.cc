@@ -269,8 +269,6 @@ int xpddefault_run_service_performance_data_command(
       com::centreon::engine::service* svc) {
   std::string raw_command_line;
   std::string processed_command_line;
-  int early_timeout(false);
-  double exectime;
   int result(OK);
   int macro_options(STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
 
@@ -291,7 +289,7 @@ int xpddefault_run_service_performance_data_command(
     config->service_perfdata_command().c_str(),
     raw_command_line,
     macro_options);
-  if (raw_command_line.c_str())
+  if (raw_command_line.empty())
     return ERROR;
 
   logger(dbg_perfdata, most)
@@ -312,30 +310,27 @@ int xpddefault_run_service_performance_data_command(
     "command line: " << processed_command_line;
 
   // run the command.
-  try {
-    std::string tmp;
-    my_system_r(
-      mac,
-      processed_command_line,
-      config->perfdata_timeout(),
-      &early_timeout,
-      &exectime,
-      tmp,
-      0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-      << "Error: can't execute service performance data command line '"
-      << processed_command_line << "' : " << e.what();
-  }
-
-  // check to see if the command timed out.
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-      << "Warning: Service performance data command '"
-      << processed_command_line << "' for service '"
-      << svc->get_description() << "' on host '"
-      << svc->get_hostname() << "' timed out after "
-      << config->perfdata_timeout() << " seconds";
+  std::string description(svc->get_description());
+  std::string hostname(svc->get_hostname());
+  int timeout(config->perfdata_timeout());
+  my_system_async_r(
+    mac,
+    processed_command_line,
+    timeout,
+    [description, hostname, processed_command_line, timeout](
+      int,
+      int early_timeout,
+      double,
+      std::string const&) {
+      // check to see if the command timed out.
+      if (early_timeout == true)
+        logger(log_runtime_warning, basic)
+          << "Warning: Service performance data command '"
+          << processed_command_line << "' for service '"
+          << description << "' on host '"
+          << hostname << "' timed out after "
+          << timeout << " seconds";
+    });
 
   return result;
 }
@@ -346,8 +341,6 @@ int xpddefault_run_host_performance_data_command(
       host* hst) {
   std::string raw_command_line;
   std::string processed_command_line;
-  int early_timeout(false);
-  double exectime;
   int result(OK);
   int macro_options(STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
 
@@ -385,33 +378,29 @@ int xpddefault_run_host_performance_data_command(
     << "Processed host performance data command line: "
     << processed_command_line;
 
-  // run the command.
-  try {
-    std::string tmp;
-    my_system_r(
-      mac,
-      processed_command_line,
-      config->perfdata_timeout(),
-      &early_timeout,
-      &exectime,
-      tmp,
-      0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-      << "Error: can't execute host performance data command line '"
-      << processed_command_line << "' : " << e.what();
-  }
-
   if (processed_command_line.empty())
     return ERROR;
 
-  // check to see if the command timed out.
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-      << "Warning: Host performance data command '"
-      << processed_command_line << "' for host '" << hst->get_name()
-      << "' timed out after " << config->perfdata_timeout()
-      << " seconds";
+  // run the command.
+  std::string host_name(hst->get_name());
+  int timeout(config->perfdata_timeout());
+  my_system_async_r(
+    mac,
+    processed_command_line,
+    timeout,
+    [host_name, processed_command_line, timeout](
+      int,
+      int early_timeout,
+      double,
+      std::string const&) {
+      // check to see if the command timed out.
+      if (early_timeout == true)
+        logger(log_runtime_warning, basic)
+          << "Warning: Host performance data command '"
+          << processed_command_line << "' for host '" << host_name
+          << "' timed out after " << timeout
+          << " seconds";
+    });
 
   return result;
 }
@@ -28,10 +28,17 @@
 #include <string>
 #include <sys/stat.h>
 #include <unistd.h>
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/host_cache.hh"
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/comment.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/contact.hh"
+#include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/event_stats.hh"
+#include "com/centreon/engine/events/load_leveler.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/events/timed_event.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/macros.hh"
@@ -118,6 +125,22 @@ int xsddefault_save_status_data() {
   // generate check statistics
   generate_check_stats();
 
+  // counters of the last events loop iteration
+  events::loop::iteration const&
+    last_iteration(events::loop::instance().last_iteration());
+
+  // service checks waiting for an execution slot
+  checks::admission_queue const&
+    admission(checks::checker::instance().admission());
+
+  // projected check load
+  events::load_leveler const&
+    leveler(events::load_leveler::instance());
+
+  // time the events loop was stopped by the last reload
+  double stop_the_world_time(
+    configuration::applier::state::instance().stop_the_world_time());
+
   std::ostringstream stream;
 
   time_t current_time;
@@ -210,7 +233,31 @@ int xsddefault_save_status_data() {
     << check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[0] << ","
     << check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[1] << ","
     << check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[2] << "\n"
-       "\t}\n\n";
+       "\tloop_events_run=" << last_iteration.events_run << "\n"
+       "\tloop_events_deferred=" << last_iteration.events_deferred << "\n"
+       "\tloop_duration=" << last_iteration.duration << "\n"
+       "\tloop_lag=" << static_cast<long long>(last_iteration.lag) << "\n"
+       "\tqueued_service_checks=" << admission.size() << "\n"
+       "\tservice_check_queue_delay=" << std::setprecision(3) << std::fixed
+                                       << admission.average_delay() << ","
+                                       << admission.max_delay() << "\n"
+       "\tprojected_check_load=" << std::setprecision(3) << std::fixed
+                                  << leveler.load(time(NULL)) << ","
+                                  << leveler.average_load(60) << ","
+                                  << leveler.peak_load(300) << "\n"
+       "\treload_stop_the_world_time=" << std::setprecision(3) << std::fixed
+                                        << stop_the_world_time << "\n"
+       "\tcheck_result_reaper=" << checks::checker::instance().reaper_backlog()
+                                 << "," << std::setprecision(1) << std::fixed
+                                 << checks::checker::instance().reap_rate()
+                                 << "\n"
+       "\thost_check_cache=" << checks::host_cache::instance().hits()
+                              << "," << checks::host_cache::instance().misses()
+                              << "\n";
+
+  // time spent by the events loop for each event type (microseconds)
+  events::event_stats::instance().dump(stream, "\t");
+  stream << "\t}\n\n";
 
   /* save host status data */
   for (host_map::iterator
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "com/centreon/engine/checks/admission_queue.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/globals.hh"
+
+using namespace com::centreon::engine;
+
+extern configuration::state* config;
+
+static checks::admission_queue::entry new_entry(
+                                        uint64_t host_id,
+                                        uint64_t service_id,
+                                        std::string const& command = "ping") {
+  checks::admission_queue::entry e;
+  e.host_id = host_id;
+  e.service_id = service_id;
+  e.command = command;
+  e.check_options = 0;
+  e.latency = 0.0;
+  e.queued = std::chrono::steady_clock::now();
+  return e;
+}
+
+class AdmissionQueue : public ::testing::Test {
+ public:
+  void SetUp() override {
+    if (!config)
+      config = new configuration::state;
+    config->max_parallel_service_checks(2);
+    currently_running_service_checks = 0;
+  }
+
+  void TearDown() override {
+    delete config;
+    config = nullptr;
+    currently_running_service_checks = 0;
+  }
+
+ protected:
+  // Emulate checker::run() starting a service check.
+  void _start(checks::admission_queue::entry const& e) {
+    ++currently_running_service_checks;
+    _queue.started(e.host_id, e.service_id, e.command);
+  }
+
+  // Emulate the handling of a service check result.
+  void _finish(uint64_t host_id, uint64_t service_id) {
+    --currently_running_service_checks;
+    _queue.finished(host_id, service_id);
+  }
+
+  checks::admission_queue _queue;
+};
+
+// Given the parallel checks limit is reached
+// When slots free
+// Then queued checks are released in FIFO order.
+TEST_F(AdmissionQueue, ReleaseInFifoOrder) {
+  _start(new_entry(1, 1));
+  _start(new_entry(1, 2));
+  ASSERT_FALSE(_queue.can_run(1, "ping"));
+  for (uint64_t i(3); i <= 5; ++i)
+    ASSERT_TRUE(_queue.push(new_entry(1, i)));
+  ASSERT_EQ(_queue.size(), 3u);
+
+  checks::admission_queue::entry e;
+  ASSERT_FALSE(_queue.pop(e));
+
+  _finish(1, 1);
+  ASSERT_TRUE(_queue.pop(e));
+  ASSERT_EQ(e.service_id, 3u);
+  _start(e);
+  ASSERT_FALSE(_queue.pop(e));
+
+  _finish(1, 2);
+  _finish(1, 3);
+  ASSERT_TRUE(_queue.pop(e));
+  ASSERT_EQ(e.service_id, 4u);
+  _start(e);
+  ASSERT_TRUE(_queue.pop(e));
+  ASSERT_EQ(e.service_id, 5u);
+  ASSERT_TRUE(_queue.empty());
+}
+
+// Given a service whose check is already queued
+// When it is queued again
+// Then options are merged and it keeps its place.
+TEST_F(AdmissionQueue, PushMergesDuplicates) {
+  _start(new_entry(1, 1));
+  _start(new_entry(1, 2));
+  ASSERT_TRUE(_queue.push(new_entry(2, 1)));
+  ASSERT_TRUE(_queue.push(new_entry(2, 2)));
+  checks::admission_queue::entry dup(new_entry(2, 1));
+  dup.check_options = 4;
+  ASSERT_FALSE(_queue.push(dup));
+  ASSERT_EQ(_queue.size(), 2u);
+
+  _finish(1, 1);
+  checks::admission_queue::entry e;
+  ASSERT_TRUE(_queue.pop(e));
+  ASSERT_EQ(e.host_id, 2u);
+  ASSERT_EQ(e.service_id, 1u);
+  ASSERT_EQ(e.check_options, 4);
+}
+
+// Given a per host limit
+// When the first queued check belongs to a saturated host
+// Then checks of other hosts are released before it.
+TEST_F(AdmissionQueue, PerHostLimit) {
+  config->max_parallel_service_checks(0);
+  config->max_parallel_checks_per_host(1);
+  _start(new_entry(1, 1));
+  ASSERT_FALSE(_queue.can_run(1, "ping"));
+  ASSERT_TRUE(_queue.can_run(2, "ping"));
+  _queue.push(new_entry(1, 2));
+  _queue.push(new_entry(2, 1));
+
+  checks::admission_queue::entry e;
+  ASSERT_TRUE(_queue.pop(e));
+  ASSERT_EQ(e.host_id, 2u);
+  _start(e);
+  ASSERT_FALSE(_queue.pop(e));
+
+  _finish(1, 1);
+  ASSERT_TRUE(_queue.pop(e));
+  ASSERT_EQ(e.host_id, 1u);
+  ASSERT_EQ(e.service_id, 2u);
+}
+
+// Given a per command limit
+// When a command is saturated
+// Then only checks using another command can run.
+TEST_F(AdmissionQueue, PerCommandLimit) {
+  config->max_parallel_service_checks(0);
+  config->max_parallel_checks_per_command(2);
+  _start(new_entry(1, 1, "ping"));
+  _start(new_entry(2, 1, "ping"));
+  ASSERT_FALSE(_queue.can_run(3, "ping"));
+  ASSERT_TRUE(_queue.can_run(3, "http"));
+  _finish(2, 1);
+  ASSERT_TRUE(_queue.can_run(3, "ping"));
+}
+
+// Given queued checks
+// When they are released
+// Then their queueing delay is accounted.
+TEST_F(AdmissionQueue, QueueDelay) {
+  _start(new_entry(1, 1));
+  _start(new_entry(1, 2));
+  checks::admission_queue::entry queued(new_entry(1, 3));
+  queued.queued -= std::chrono::seconds(2);
+  _queue.push(queued);
+  _finish(1, 1);
+
+  checks::admission_queue::entry e;
+  ASSERT_TRUE(_queue.pop(e));
+  ASSERT_GE(_queue.max_delay(), 2.0);
+  ASSERT_GE(_queue.average_delay(), 2.0);
+}
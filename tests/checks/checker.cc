@@ -0,0 +1,148 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "../timeperiod/utils.hh"
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/configuration/applier/command.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+extern configuration::state* config;
+
+class Checker : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    if (!config)
+      config = new configuration::state;
+    timezone_manager::load();
+    configuration::applier::state::load();
+    checks::checker::load();
+
+    configuration::applier::command cmd_aply;
+    configuration::command cmd("cmd");
+    cmd.parse("command_line", "/usr/bin/echo 1");
+    cmd_aply.add_object(cmd);
+
+    configuration::applier::host hst_aply;
+    configuration::host hst;
+    hst.parse("host_name", "test_host");
+    hst.parse("address", "127.0.0.1");
+    hst.parse("host_id", "1");
+    hst.parse("check_command", "cmd");
+    hst_aply.add_object(hst);
+
+    configuration::applier::service svc_aply;
+    configuration::service svc;
+    svc.parse("host", "test_host");
+    svc.parse("service_description", "test_svc");
+    svc.parse("service_id", "1");
+    svc.parse("check_command", "cmd");
+    // We fake here the expand_object on configuration::service
+    svc.set_host_id(1);
+    svc_aply.add_object(svc);
+
+    hst_aply.expand_objects(*config);
+    svc_aply.expand_objects(*config);
+    set_time(20000);
+  }
+
+  void TearDown() override {
+    configuration::applier::state::unload();
+    checks::checker::unload();
+    delete config;
+    config = nullptr;
+    timezone_manager::unload();
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+
+ protected:
+  static check_result _result(enum check_source type, uint64_t service_id) {
+    timeval tv;
+    tv.tv_sec = time(nullptr);
+    tv.tv_usec = 0;
+    return check_result(
+             type,
+             1,
+             service_id,
+             checkable::check_passive,
+             CHECK_OPTION_NONE,
+             false,
+             0.0,
+             tv,
+             tv,
+             false,
+             true,
+             0,
+             "OK");
+  }
+};
+
+// Given a service result queued before a host result
+// When they are reaped with a budget allowing a single result
+// Then the host result is handled first
+// And the other result is left in the backlog.
+TEST_F(Checker, BudgetReapsHostsFirst) {
+  config->check_reaper_budget(1);
+  checks::checker::instance().push_check_result(_result(service_check, 1));
+  checks::checker::instance().push_check_result(_result(host_check, 0));
+  ASSERT_EQ(checks::checker::instance().reaper_backlog(), 2u);
+
+  checks::checker::instance().reap();
+  ASSERT_TRUE(engine::host::hosts["test_host"]->get_has_been_checked());
+  ASSERT_EQ(
+    engine::service::services[{"test_host", "test_svc"}]->get_last_check(),
+    0);
+  ASSERT_EQ(checks::checker::instance().reaper_backlog(), 1u);
+  ASSERT_FALSE(checks::checker::instance().reaper_is_empty());
+  ASSERT_GT(checks::checker::instance().reap_rate(), 0.0);
+
+  checks::checker::instance().reap();
+  ASSERT_NE(
+    engine::service::services[{"test_host", "test_svc"}]->get_last_check(),
+    0);
+  ASSERT_EQ(checks::checker::instance().reaper_backlog(), 0u);
+  ASSERT_TRUE(checks::checker::instance().reaper_is_empty());
+}
+
+// Given a service result queued before a host result
+// When they are reaped without budget
+// Then they are handled in the order they were received.
+TEST_F(Checker, NoBudgetReapsInOrder) {
+  config->check_reaper_budget(0);
+  checks::checker::instance().push_check_result(_result(service_check, 1));
+  checks::checker::instance().push_check_result(_result(host_check, 0));
+
+  checks::checker::instance().reap();
+  ASSERT_TRUE(engine::host::hosts["test_host"]->get_has_been_checked());
+  ASSERT_NE(
+    engine::service::services[{"test_host", "test_svc"}]->get_last_check(),
+    0);
+  ASSERT_TRUE(checks::checker::instance().reaper_is_empty());
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "../timeperiod/utils.hh"
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/host_cache.hh"
+#include "com/centreon/engine/configuration/applier/command.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/hostdependency.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+extern configuration::state* config;
+
+class HostCache : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    if (!config)
+      config = new configuration::state;
+    timezone_manager::load();
+    configuration::applier::state::load();
+    checks::checker::load();
+    checks::host_cache::instance().clear();
+    checks::host_cache::instance().reset_stats();
+
+    configuration::applier::command cmd_aply;
+    configuration::command cmd("cmd");
+    cmd.parse("command_line", "/usr/bin/echo 1");
+    cmd_aply.add_object(cmd);
+
+    configuration::applier::host hst_aply;
+    configuration::host parent;
+    parent.parse("host_name", "parent_host");
+    parent.parse("address", "127.0.0.1");
+    parent.parse("host_id", "1");
+    parent.parse("check_command", "cmd");
+    hst_aply.add_object(parent);
+
+    configuration::host child;
+    child.parse("host_name", "child_host");
+    child.parse("address", "127.0.0.2");
+    child.parse("host_id", "2");
+    child.parse("check_command", "cmd");
+    child.parse("parents", "parent_host");
+    hst_aply.add_object(child);
+
+    configuration::host dependent;
+    dependent.parse("host_name", "dependent_host");
+    dependent.parse("address", "127.0.0.3");
+    dependent.parse("host_id", "3");
+    dependent.parse("check_command", "cmd");
+    dependent.parse("cached_check_horizon", "60");
+    hst_aply.add_object(dependent);
+
+    hst_aply.expand_objects(*config);
+    hst_aply.resolve_object(parent);
+    hst_aply.resolve_object(child);
+    hst_aply.resolve_object(dependent);
+
+    configuration::applier::hostdependency hd_aply;
+    configuration::hostdependency hd;
+    hd.parse("master_host", "parent_host");
+    hd.parse("dependent_host", "dependent_host");
+    hd.parse("execution_failure_options", "d");
+    hd.dependency_type(
+      configuration::hostdependency::execution_dependency);
+    hd_aply.expand_objects(*config);
+    hd_aply.add_object(hd);
+    hd_aply.resolve_object(hd);
+
+    _parent = engine::host::hosts["parent_host"].get();
+    _child = engine::host::hosts["child_host"].get();
+    _dependent = engine::host::hosts["dependent_host"].get();
+    set_time(20000);
+  }
+
+  void TearDown() override {
+    checks::host_cache::instance().clear();
+    checks::host_cache::instance().reset_stats();
+    configuration::applier::state::unload();
+    checks::checker::unload();
+    delete config;
+    config = nullptr;
+    timezone_manager::unload();
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+
+ protected:
+  // Give a host a result of the given age.
+  static void _checked(engine::host* hst, time_t age) {
+    hst->set_has_been_checked(true);
+    hst->set_last_check(time(nullptr) - age);
+    // A check is already running, none will be launched.
+    hst->set_is_executing(true);
+  }
+
+  engine::host* _parent;
+  engine::host* _child;
+  engine::host* _dependent;
+};
+
+// Given a host checked 10 seconds ago
+// When its state is looked up with horizons of 15 and 5 seconds
+// Then it is reused the first time only and both lookups are counted.
+TEST_F(HostCache, LookupWithinHorizon) {
+  checks::host_cache& cache(checks::host_cache::instance());
+  _checked(_child, 10);
+  ASSERT_TRUE(cache.lookup(*_child, time(nullptr), 15));
+  ASSERT_FALSE(cache.lookup(*_child, time(nullptr), 5));
+  ASSERT_EQ(cache.hits(), 1u);
+  ASSERT_EQ(cache.misses(), 1u);
+}
+
+// Given a host that was never checked
+// When its state is looked up
+// Then it is not reused.
+TEST_F(HostCache, NeverChecked) {
+  ASSERT_FALSE(
+    checks::host_cache::instance().lookup(*_child, time(nullptr), 15));
+  ASSERT_EQ(checks::host_cache::instance().misses(), 1u);
+}
+
+// Given a host with its own cached_check_horizon of 60 seconds
+// When its state, 30 seconds old, is looked up with a horizon of 15
+// Then the horizon of the host is used.
+TEST_F(HostCache, PerHostHorizon) {
+  checks::host_cache& cache(checks::host_cache::instance());
+  ASSERT_EQ(cache.horizon(*_dependent, 15), 60u);
+  ASSERT_EQ(cache.horizon(*_child, 15), 15u);
+  _checked(_dependent, 30);
+  ASSERT_TRUE(cache.is_fresh(*_dependent, time(nullptr), 15));
+  _checked(_dependent, 61);
+  ASSERT_FALSE(cache.is_fresh(*_dependent, time(nullptr), 15));
+}
+
+// Given a child and a dependent host recently checked
+// When their parent and master host changes state
+// Then their cached states are no longer reused until they are checked
+// again.
+TEST_F(HostCache, InvalidatedByStateChange) {
+  checks::host_cache& cache(checks::host_cache::instance());
+  _checked(_child, 5);
+  _checked(_dependent, 5);
+  _parent->set_last_state(engine::host::state_up);
+  _parent->set_current_state(engine::host::state_down);
+  _parent->handle_state();
+  ASSERT_FALSE(cache.is_fresh(*_child, time(nullptr), 15));
+  ASSERT_FALSE(cache.is_fresh(*_dependent, time(nullptr), 15));
+
+  set_time(20001);
+  _checked(_child, 0);
+  ASSERT_TRUE(cache.is_fresh(*_child, time(nullptr), 15));
+}
+
+// Given a host whose parent is checked again without changing state
+// When its state is looked up
+// Then it is still reused.
+TEST_F(HostCache, NotInvalidatedWithoutStateChange) {
+  _checked(_child, 5);
+  _parent->set_last_state(engine::host::state_up);
+  _parent->set_current_state(engine::host::state_up);
+  _parent->handle_state();
+  ASSERT_TRUE(
+    checks::host_cache::instance().is_fresh(*_child, time(nullptr), 15));
+}
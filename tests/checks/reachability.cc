@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "../timeperiod/utils.hh"
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/configuration/applier/command.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+extern configuration::state* config;
+
+class Reachability : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    if (!config)
+      config = new configuration::state;
+    timezone_manager::load();
+    configuration::applier::state::load();
+    checks::checker::load();
+
+    configuration::applier::command cmd_aply;
+    configuration::command cmd("cmd");
+    cmd.parse("command_line", "/usr/bin/echo 1");
+    cmd_aply.add_object(cmd);
+
+    configuration::applier::host hst_aply;
+    configuration::host parent;
+    parent.parse("host_name", "parent_host");
+    parent.parse("address", "127.0.0.1");
+    parent.parse("host_id", "1");
+    parent.parse("check_command", "cmd");
+    hst_aply.add_object(parent);
+
+    configuration::host child;
+    child.parse("host_name", "child_host");
+    child.parse("address", "127.0.0.2");
+    child.parse("host_id", "2");
+    child.parse("check_command", "cmd");
+    child.parse("max_check_attempts", "1");
+    child.parse("parents", "parent_host");
+    hst_aply.add_object(child);
+
+    hst_aply.expand_objects(*config);
+    hst_aply.resolve_object(parent);
+    hst_aply.resolve_object(child);
+
+    _parent = engine::host::hosts["parent_host"].get();
+    _child = engine::host::hosts["child_host"].get();
+    set_time(20000);
+  }
+
+  void TearDown() override {
+    configuration::applier::state::unload();
+    checks::checker::unload();
+    delete config;
+    config = nullptr;
+    timezone_manager::unload();
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+
+ protected:
+  // Reap an active check result of a host.
+  static void _reap(uint64_t host_id, int return_code) {
+    timeval tv;
+    tv.tv_sec = time(nullptr);
+    tv.tv_usec = 0;
+    checks::checker::instance().push_check_result(check_result(
+      host_check,
+      host_id,
+      0,
+      checkable::check_active,
+      CHECK_OPTION_NONE,
+      false,
+      0.0,
+      tv,
+      tv,
+      false,
+      true,
+      return_code,
+      return_code ? "CRITICAL" : "OK"));
+    checks::checker::instance().reap();
+  }
+
+  // Give the parent a result, recent or not, without running it again.
+  void _set_parent(engine::host::host_state state, time_t age) {
+    _parent->set_current_state(state);
+    _parent->set_state_type(checkable::hard);
+    _parent->set_last_hard_state(state);
+    _parent->set_has_been_checked(true);
+    _parent->set_last_check(time(nullptr) - age);
+    // A check of the parent is already running, none will be launched.
+    _parent->set_is_executing(true);
+  }
+
+  engine::host* _parent;
+  engine::host* _child;
+};
+
+// Given a child host whose parent was recently seen UP
+// When the child goes down
+// Then it is DOWN without waiting for a check of its parent.
+TEST_F(Reachability, CachedParentUp) {
+  ASSERT_EQ(_child->parent_hosts.size(), 1u);
+  _set_parent(engine::host::state_up, 0);
+  _reap(2, 2);
+  ASSERT_EQ(_child->get_current_state(), engine::host::state_down);
+  ASSERT_EQ(_child->get_state_type(), checkable::hard);
+}
+
+// Given a child host whose parent was recently seen DOWN
+// When the child goes down
+// Then it is UNREACHABLE.
+TEST_F(Reachability, CachedParentDown) {
+  _set_parent(engine::host::state_down, 0);
+  _reap(2, 2);
+  ASSERT_EQ(_child->get_current_state(), engine::host::state_unreachable);
+}
+
+// Given a child host whose parent was DOWN a long time ago
+// When the child goes down
+// Then it is UNREACHABLE until the parent check result comes back
+// And it becomes DOWN when its parent is found UP.
+TEST_F(Reachability, StaleParentResolvedWhenResultComesBack) {
+  _set_parent(engine::host::state_down, 3600);
+  _reap(2, 2);
+  ASSERT_EQ(_child->get_current_state(), engine::host::state_unreachable);
+
+  _reap(1, 0);
+  ASSERT_EQ(_parent->get_current_state(), engine::host::state_up);
+  ASSERT_EQ(_child->get_current_state(), engine::host::state_down);
+  ASSERT_EQ(_child->get_last_state(), engine::host::state_unreachable);
+
+  // The child does not wait for its parent anymore.
+  _reap(1, 2);
+  ASSERT_EQ(_child->get_current_state(), engine::host::state_down);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "com/centreon/engine/checks/reaper_queue.hh"
+
+using namespace com::centreon::engine;
+
+static check_result new_result(uint64_t host_id, uint64_t service_id) {
+  check_result result;
+  result.set_object_check_type(service_check);
+  result.set_host_id(host_id);
+  result.set_service_id(service_id);
+  result.set_output("output of service check");
+  return result;
+}
+
+// Given an empty reaper queue
+// When results are pushed
+// Then only the first push reports an empty queue
+// And results are popped in FIFO order with their command ID.
+TEST(ReaperQueue, Fifo) {
+  checks::reaper_queue queue;
+  ASSERT_TRUE(queue.empty());
+  ASSERT_TRUE(queue.push(new_result(1, 1)));
+  ASSERT_FALSE(queue.push(new_result(1, 2), 42));
+  ASSERT_FALSE(queue.push(new_result(1, 3)));
+  ASSERT_EQ(queue.size(), 3u);
+
+  checks::reaper_queue::entry e;
+  ASSERT_TRUE(queue.pop(e));
+  ASSERT_EQ(e.command_id, 0u);
+  ASSERT_EQ(e.result.get_service_id(), 1u);
+  ASSERT_TRUE(queue.pop(e));
+  ASSERT_EQ(e.command_id, 42u);
+  ASSERT_EQ(e.result.get_service_id(), 2u);
+  ASSERT_TRUE(queue.pop(e));
+  ASSERT_EQ(e.command_id, 0u);
+  ASSERT_EQ(e.result.get_service_id(), 3u);
+  ASSERT_FALSE(queue.pop(e));
+  ASSERT_TRUE(queue.empty());
+  ASSERT_TRUE(queue.push(new_result(1, 4)));
+}
+
+// Given a result
+// When it goes through the reaper queue
+// Then its output is moved, not copied.
+TEST(ReaperQueue, MoveOutput) {
+  checks::reaper_queue queue;
+  check_result result(new_result(1, 1));
+  char const* data(result.get_output().data());
+  queue.push(std::move(result));
+
+  checks::reaper_queue::entry e;
+  ASSERT_TRUE(queue.pop(e));
+  ASSERT_EQ(e.result.get_output(), "output of service check");
+  ASSERT_EQ(e.result.get_output().data(), data);
+}
+
+// Given several threads pushing results
+// When the consumer pops them concurrently
+// Then no result is lost and each producer's order is kept.
+TEST(ReaperQueue, MultipleProducers) {
+  unsigned int const producers(4);
+  unsigned int const per_producer(20000);
+  checks::reaper_queue queue;
+
+  std::vector<std::thread> threads;
+  for (unsigned int p(0); p < producers; ++p)
+    threads.push_back(std::thread([&queue, p, per_producer]() {
+      for (unsigned int i(0); i < per_producer; ++i)
+        queue.push(new_result(p, i));
+    }));
+
+  std::vector<uint64_t> next(producers, 0);
+  unsigned int popped(0);
+  checks::reaper_queue::entry e;
+  while (popped < producers * per_producer) {
+    if (!queue.pop(e)) {
+      std::this_thread::yield();
+      continue ;
+    }
+    ASSERT_LT(e.result.get_host_id(), producers);
+    ASSERT_EQ(e.result.get_service_id(), next[e.result.get_host_id()]);
+    ++next[e.result.get_host_id()];
+    ++popped;
+  }
+  for (unsigned int p(0); p < producers; ++p)
+    threads[p].join();
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.pop(e));
+}
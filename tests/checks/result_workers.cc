@@ -0,0 +1,306 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../timeperiod/utils.hh"
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/result_workers.hh"
+#include "com/centreon/engine/configuration/applier/command.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+extern configuration::state* config;
+
+static char const* const outputs[] = {
+  "",
+  "OK",
+  "OK - all is fine | time=0.1s;1;2;0;10",
+  "WARNING; load is high | load1=5;4;6 load5=3;4;6",
+  "CRITICAL - disk full\\nline two\\nline three | used=99%;80;90",
+  "OK - multi\nline\noutput|a=1\nb=2\nc=3",
+  "UNKNOWN - pipe | in | output | x=1",
+  "   trailing spaces   |   p=1   "
+};
+static unsigned int const hosts(5);
+static unsigned int const services_per_host(4);
+
+/**
+ *  Build a passive check result.
+ */
+static check_result new_result(
+                      enum check_source type,
+                      uint64_t host_id,
+                      uint64_t service_id,
+                      int return_code,
+                      std::string const& output) {
+  timeval tv;
+  tv.tv_sec = time(nullptr);
+  tv.tv_usec = 0;
+  return check_result(
+           type,
+           host_id,
+           service_id,
+           checkable::check_passive,
+           CHECK_OPTION_NONE,
+           false,
+           0.0,
+           tv,
+           tv,
+           false,
+           true,
+           return_code,
+           output);
+}
+
+// Given results of several hosts
+// When they are prepared by a pool of threads
+// Then their parsed output is the same as when parsed serially.
+TEST(ResultWorkers, PrepareLikeSerial) {
+  std::deque<check_result> serial;
+  for (unsigned int i(0); i < 1000; ++i)
+    serial.push_back(new_result(
+                       service_check,
+                       i % 17 + 1,
+                       i,
+                       i % 4,
+                       outputs[i % (sizeof(outputs) / sizeof(*outputs))]));
+  std::deque<check_result> parallel(serial);
+
+  checks::result_workers workers;
+  workers.resize(4);
+  ASSERT_EQ(workers.size(), 4u);
+  workers.prepare(parallel);
+  for (unsigned int i(0); i < serial.size(); ++i) {
+    ASSERT_TRUE(parallel[i].get_output_parsed());
+    ASSERT_FALSE(serial[i].get_output_parsed());
+    std::string s_short, s_long, s_perf;
+    std::string p_short, p_long, p_perf;
+    serial[i].take_parsed_output(s_short, s_long, s_perf);
+    parallel[i].take_parsed_output(p_short, p_long, p_perf);
+    ASSERT_EQ(p_short, s_short);
+    ASSERT_EQ(p_long, s_long);
+    ASSERT_EQ(p_perf, s_perf);
+    ASSERT_EQ(s_short.find(';'), std::string::npos);
+  }
+}
+
+// Given a pool of threads
+// When it is resized between batches
+// Then all results of every batch are prepared.
+TEST(ResultWorkers, Resize) {
+  checks::result_workers workers;
+  for (unsigned int size(0); size < 4; ++size) {
+    workers.resize(size);
+    std::deque<check_result> results;
+    for (unsigned int i(0); i < 100; ++i)
+      results.push_back(new_result(host_check, i, 0, 0, "OK | a=1"));
+    workers.prepare(results);
+    for (unsigned int i(0); i < results.size(); ++i)
+      ASSERT_TRUE(results[i].get_output_parsed());
+  }
+  workers.resize(0);
+  ASSERT_EQ(workers.size(), 0u);
+}
+
+/**
+ *  State of an object after its results were handled.
+ */
+struct object_state {
+  int current_state;
+  int current_attempt;
+  int state_type;
+  std::string plugin_output;
+  std::string long_plugin_output;
+  std::string perf_data;
+  double percent_state_change;
+  unsigned int state_history_index;
+
+  bool operator==(object_state const& other) const {
+    return current_state == other.current_state
+           && current_attempt == other.current_attempt
+           && state_type == other.state_type
+           && percent_state_change == other.percent_state_change
+           && state_history_index == other.state_history_index
+           && plugin_output == other.plugin_output
+           && long_plugin_output == other.long_plugin_output
+           && perf_data == other.perf_data;
+  }
+};
+
+class ResultWorkersReap : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    if (!config)
+      config = new configuration::state;
+    timezone_manager::load();
+    configuration::applier::state::load();
+    checks::checker::load();
+
+    configuration::applier::command cmd_aply;
+    configuration::command cmd("cmd");
+    cmd.parse("command_line", "/usr/bin/echo 1");
+    cmd_aply.add_object(cmd);
+
+    configuration::applier::host hst_aply;
+    configuration::applier::service svc_aply;
+    for (unsigned int h(1); h <= hosts; ++h) {
+      configuration::host hst;
+      hst.parse("host_name", ("host_" + std::to_string(h)).c_str());
+      hst.parse("address", "127.0.0.1");
+      hst.parse("host_id", std::to_string(h).c_str());
+      hst.parse("check_command", "cmd");
+      hst.parse("max_check_attempts", "3");
+      hst_aply.add_object(hst);
+      for (unsigned int s(1); s <= services_per_host; ++s) {
+        configuration::service svc;
+        svc.parse("host", ("host_" + std::to_string(h)).c_str());
+        svc.parse(
+          "service_description",
+          ("svc_" + std::to_string(s)).c_str());
+        svc.parse("service_id", std::to_string(s).c_str());
+        svc.parse("check_command", "cmd");
+        svc.parse("max_check_attempts", "3");
+        // We fake here the expand_object on configuration::service
+        svc.set_host_id(h);
+        svc_aply.add_object(svc);
+      }
+    }
+    hst_aply.expand_objects(*config);
+    svc_aply.expand_objects(*config);
+    for (host_map::iterator
+           it(engine::host::hosts.begin()),
+           end(engine::host::hosts.end());
+         it != end;
+         ++it)
+      it->second->set_state_type(checkable::hard);
+    for (service_map::iterator
+           it(engine::service::services.begin()),
+           end(engine::service::services.end());
+         it != end;
+         ++it)
+      it->second->set_state_type(checkable::hard);
+  }
+
+  void TearDown() override {
+    configuration::applier::state::unload();
+    checks::checker::unload();
+    delete config;
+    config = nullptr;
+    timezone_manager::unload();
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+
+ protected:
+  // Push the same rounds of host and service results and reap them.
+  void _reap_rounds(unsigned int workers) {
+    config->check_result_workers(workers);
+    unsigned int i(0);
+    for (unsigned int round(0); round < 4; ++round) {
+      set_time(20000 + round * 60);
+      for (unsigned int h(1); h <= hosts; ++h) {
+        checks::checker::instance().push_check_result(new_result(
+          host_check,
+          h,
+          0,
+          (h + round) % 2,
+          outputs[i++ % (sizeof(outputs) / sizeof(*outputs))]));
+        for (unsigned int s(1); s <= services_per_host; ++s)
+          checks::checker::instance().push_check_result(new_result(
+            service_check,
+            h,
+            s,
+            (h + s + round) % 4,
+            outputs[i++ % (sizeof(outputs) / sizeof(*outputs))]));
+      }
+      checks::checker::instance().reap();
+      ASSERT_TRUE(checks::checker::instance().reaper_is_empty());
+    }
+  }
+
+  // Snapshot the state of hosts and services.
+  std::vector<object_state> _states() const {
+    std::vector<object_state> states;
+    for (host_map::const_iterator
+           it(engine::host::hosts.begin()),
+           end(engine::host::hosts.end());
+         it != end;
+         ++it) {
+      object_state s;
+      s.current_state = it->second->get_current_state();
+      s.current_attempt = it->second->get_current_attempt();
+      s.state_type = it->second->get_state_type();
+      s.plugin_output = it->second->get_plugin_output();
+      s.long_plugin_output = it->second->get_long_plugin_output();
+      s.perf_data = it->second->get_perf_data();
+      s.percent_state_change = it->second->get_percent_state_change();
+      s.state_history_index = it->second->get_state_history_index();
+      states.push_back(s);
+    }
+    for (service_map::const_iterator
+           it(engine::service::services.begin()),
+           end(engine::service::services.end());
+         it != end;
+         ++it) {
+      object_state s;
+      s.current_state = it->second->get_current_state();
+      s.current_attempt = it->second->get_current_attempt();
+      s.state_type = it->second->get_state_type();
+      s.plugin_output = it->second->get_plugin_output();
+      s.long_plugin_output = it->second->get_long_plugin_output();
+      s.perf_data = it->second->get_perf_data();
+      s.percent_state_change = it->second->get_percent_state_change();
+      s.state_history_index = it->second->get_state_history_index();
+      states.push_back(s);
+    }
+    return states;
+  }
+};
+
+// Given hosts and services receiving the same results
+// When results are reaped serially, then with worker threads
+// Then hosts and services end up in the same states, with the same
+// flap detection history.
+TEST_F(ResultWorkersReap, ParallelLikeSerial) {
+  _reap_rounds(0);
+  std::vector<object_state> serial(_states());
+
+  TearDown();
+  SetUp();
+  _reap_rounds(3);
+  std::vector<object_state> parallel(_states());
+
+  ASSERT_EQ(parallel.size(), hosts * (services_per_host + 1));
+  ASSERT_EQ(parallel.size(), serial.size());
+  for (unsigned int i(0); i < serial.size(); ++i)
+    ASSERT_TRUE(parallel[i] == serial[i]) << "object " << i;
+  config->check_result_workers(0);
+}
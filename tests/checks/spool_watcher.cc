@@ -0,0 +1,149 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+#include <unistd.h>
+#include "com/centreon/engine/checks/spool_watcher.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::checks;
+
+// Given the content of a file with two results and an incomplete one
+// When it is parsed
+// Then both complete results are returned with their attributes.
+TEST(SpoolWatcher, ParseMultipleResults) {
+  std::string content(
+    "### Check result file ###\n"
+    "file_time=1000\n"
+    "\n"
+    "host_name=host_1\n"
+    "check_type=1\n"
+    "latency=0.25\n"
+    "start_time=1000.500\n"
+    "finish_time=1001.250\n"
+    "return_code=1\n"
+    "output=DOWN\n"
+    "\n"
+    "host_name=host_1\n"
+    "service_description=svc_1\n"
+    "exited_ok=1\n"
+    "return_code=2\n"
+    "output=CRITICAL|metric=1\n"
+    "\n"
+    "host_name=host_2\n"
+    "return_code=0\n");
+  std::list<spool_watcher::record> records;
+  spool_watcher::parse(
+    content.data(),
+    content.size(),
+    1010,
+    60,
+    records);
+  ASSERT_EQ(records.size(), 2u);
+
+  spool_watcher::record const& hst(records.front());
+  ASSERT_EQ(hst.host_name, "host_1");
+  ASSERT_TRUE(hst.service_description.empty());
+  ASSERT_EQ(hst.result.get_object_check_type(), host_check);
+  ASSERT_EQ(hst.result.get_check_type(), checkable::check_passive);
+  ASSERT_EQ(hst.result.get_latency(), 0.25);
+  ASSERT_EQ(hst.result.get_start_time().tv_sec, 1000);
+  ASSERT_EQ(hst.result.get_start_time().tv_usec, 500);
+  ASSERT_EQ(hst.result.get_finish_time().tv_sec, 1001);
+  ASSERT_EQ(hst.result.get_return_code(), 1);
+  ASSERT_EQ(hst.result.get_output(), "DOWN");
+
+  spool_watcher::record const& svc(records.back());
+  ASSERT_EQ(svc.host_name, "host_1");
+  ASSERT_EQ(svc.service_description, "svc_1");
+  ASSERT_EQ(svc.result.get_object_check_type(), service_check);
+  ASSERT_TRUE(svc.result.get_exited_ok());
+  ASSERT_EQ(svc.result.get_return_code(), 2);
+  ASSERT_EQ(svc.result.get_output(), "CRITICAL|metric=1");
+}
+
+// Given a result whose output is split on several lines
+// When it is parsed
+// Then lines ending with a backslash are joined.
+TEST(SpoolWatcher, ParseContinuationLines) {
+  std::string content(
+    "host_name=host_1\r\n"
+    "output=first \\\n"
+    "   second\\\\\n"
+    "return_code=2");
+  std::list<spool_watcher::record> records;
+  spool_watcher::parse(content.data(), content.size(), 0, 0, records);
+  ASSERT_EQ(records.size(), 1u);
+  ASSERT_EQ(records.front().host_name, "host_1");
+  ASSERT_EQ(records.front().result.get_output(), "first second\\");
+  ASSERT_EQ(records.front().result.get_return_code(), 2);
+}
+
+// Given a file older than the maximum file age
+// When it is parsed
+// Then no result is returned.
+TEST(SpoolWatcher, ParseTooOld) {
+  std::string content(
+    "file_time=1000\n"
+    "host_name=host_1\n"
+    "output=UP\n");
+  std::list<spool_watcher::record> records;
+  spool_watcher::parse(content.data(), content.size(), 2000, 60, records);
+  ASSERT_TRUE(records.empty());
+  spool_watcher::parse(content.data(), content.size(), 2000, 0, records);
+  ASSERT_EQ(records.size(), 1u);
+}
+
+// Given a watched spool directory
+// When a result file and its ok-to-go file are written
+// Then the results are read and both files are removed.
+TEST(SpoolWatcher, WatchDirectory) {
+  char dir[] = "/tmp/spool_watcher.XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir));
+  std::string file(std::string(dir) + "/cAbC123");
+
+  spool_watcher watcher;
+  ASSERT_TRUE(watcher.watch(dir, 0));
+  {
+    std::ofstream ofs(file.c_str());
+    ofs << "host_name=host_1\noutput=UP\n\n"
+           "host_name=host_2\noutput=DOWN\nreturn_code=1\n";
+  }
+  std::ofstream((file + ".ok").c_str());
+
+  std::list<spool_watcher::record> records;
+  for (int i(0); i < 500 && records.size() < 2; ++i) {
+    watcher.take(records);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  watcher.stop();
+
+  ASSERT_EQ(records.size(), 2u);
+  ASSERT_EQ(records.front().host_name, "host_1");
+  ASSERT_EQ(records.back().host_name, "host_2");
+  ASSERT_EQ(records.back().result.get_return_code(), 1);
+  ASSERT_NE(access(file.c_str(), F_OK), 0);
+  ASSERT_NE(access((file + ".ok").c_str(), F_OK), 0);
+  rmdir(dir);
+}
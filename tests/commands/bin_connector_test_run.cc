@@ -80,6 +80,14 @@ static std::string execute_process(std::vector<std::string> const& argv,
     std::this_thread::sleep_for(std::chrono::seconds(timeout + 1));
   else if (arg == "--timeout=off")
     *exit_code = STATE_OK;
+  else if (arg == "--pid") {
+    // Stay busy long enough for concurrent queries to be spread.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::ostringstream oss;
+    oss << "pid=" << getpid();
+    output = oss.str();
+    *exit_code = STATE_OK;
+  }
   else if (arg.find("--kill=") == 0) {
     std::string value(arg.substr(7));
     int32_t delay(strtol(value.c_str(), NULL, 0));
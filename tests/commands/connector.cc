@@ -22,6 +22,8 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <string>
 #include "../timeperiod/utils.hh"
 #include "com/centreon/clib.hh"
 #include "com/centreon/engine/commands/forward.hh"
@@ -154,3 +156,92 @@ TEST_F(Connector, RunWithoutTimeout) {
   ASSERT_EQ(res.output, cmd_forward.get_command_line());
   ASSERT_TRUE(res.exit_status == process::normal);
 }
+
+class count_results : public commands::command_listener {
+  mutable std::mutex _mutex;
+  mutable std::condition_variable _condvar;
+  unsigned int _count;
+  std::set<std::string> _outputs;
+
+ public:
+  count_results() : _count{0} {}
+
+  std::set<std::string> outputs() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _outputs;
+  }
+
+  bool wait(unsigned int count) const noexcept {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _condvar.wait_for(
+      lock,
+      std::chrono::seconds(10),
+      [this, count] { return _count >= count; });
+  }
+
+  void finished(result const& res) throw() override {
+    if (res.exit_status == process::normal) {
+      std::lock_guard<std::mutex> guard(_mutex);
+      ++_count;
+      _outputs.insert(res.output);
+      _condvar.notify_all();
+    }
+  }
+};
+
+// Given a running connector and batched queries
+// When several commands are run and queries are flushed
+// Then all the results are received
+TEST_F(Connector, RunBatched) {
+  nagios_macros macros = nagios_macros();
+  connector cmd_connector("RunBatched", "tests/bin_connector_test_run");
+  forward cmd_forward(
+            "RunBatched",
+            "tests/bin_connector_test_run --timeout=off",
+            cmd_connector);
+  result res;
+  cmd_forward.run(cmd_forward.get_command_line(), macros, 0, res);
+  ASSERT_TRUE(res.exit_status == process::normal);
+
+  count_results counter;
+  cmd_connector.set_listener(&counter);
+  connector::batch_queries(true);
+  for (unsigned int i(0); i < 100; ++i)
+    cmd_forward.run(cmd_forward.get_command_line(), macros, 0);
+  connector::flush_queries();
+  bool received(counter.wait(100));
+  connector::batch_queries(false);
+  cmd_connector.set_listener(nullptr);
+  ASSERT_TRUE(received);
+}
+
+// Given a pool of connector processes
+// When several commands are run
+// Then all the results are received, from several processes
+TEST_F(Connector, RunPooled) {
+  config->connector_instances(3);
+  nagios_macros macros = nagios_macros();
+  connector cmd_connector("RunPooled", "tests/bin_connector_test_run");
+  forward cmd_forward(
+            "RunPooled",
+            "tests/bin_connector_test_run --timeout=off",
+            cmd_connector);
+
+  result res;
+  cmd_forward.run(cmd_forward.get_command_line(), macros, 0, res);
+  ASSERT_TRUE(res.exit_code == engine::service::state_ok);
+  ASSERT_EQ(res.output, cmd_forward.get_command_line());
+
+  forward cmd_pid(
+            "RunPooledPid",
+            "tests/bin_connector_test_run --pid",
+            cmd_connector);
+  count_results counter;
+  cmd_connector.set_listener(&counter);
+  for (unsigned int i(0); i < 30; ++i)
+    cmd_pid.run(cmd_pid.get_command_line(), macros, 0);
+  bool received(counter.wait(30));
+  cmd_connector.set_listener(nullptr);
+  ASSERT_TRUE(received);
+  ASSERT_GT(counter.outputs().size(), 1u);
+}
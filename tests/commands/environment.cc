@@ -0,0 +1,192 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/commands/environment.hh"
+#include "com/centreon/engine/commands/environment_cache.hh"
+#include "com/centreon/engine/commands/raw.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/host.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/macros/defines.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+
+extern configuration::state* config;
+
+class CommandEnvironment : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    if (!config)
+      config = new configuration::state;
+    timezone_manager::load();
+    configuration::applier::state::load();
+    config->enable_environment_macros(true);
+
+    configuration::applier::host hst_aply;
+    configuration::host hst;
+    hst.parse("host_name", "test_host");
+    hst.parse("alias", "test_alias");
+    hst.parse("address", "127.0.0.1");
+    hst.parse("host_id", "12");
+    hst.parse("_SNMPCOMMUNITY", "public");
+    hst_aply.add_object(hst);
+    _host = engine::host::hosts["test_host"].get();
+  }
+
+  void TearDown() override {
+    configuration::applier::state::unload();
+    delete config;
+    config = nullptr;
+    timezone_manager::unload();
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+
+  /**
+   *  Run a command printing its environment.
+   */
+  std::string run_env(raw& cmd) {
+    nagios_macros macros;
+    macros.host_ptr = _host;
+    result res;
+    cmd.run("/usr/bin/env", macros, 5, res);
+    return res.output;
+  }
+
+ protected:
+  engine::host* _host;
+};
+
+// Given an environment with its own variables
+// When a fragment is added and the internal buffer grows
+// Then variables of the fragment are referenced and all are kept.
+TEST_F(CommandEnvironment, FragmentIsReferenced) {
+  std::shared_ptr<environment> fragment(new environment);
+  fragment->add("FOO", "bar");
+  char* foo(fragment->data()[0]);
+
+  environment env;
+  env.add("A", "1");
+  env.add(std::shared_ptr<environment const>(fragment));
+  env.add("B", std::string(8192, 'b'));
+  char** data(env.data());
+  ASSERT_STREQ(data[0], "A=1");
+  ASSERT_EQ(data[1], foo);
+  ASSERT_EQ(std::string(data[2]), "B=" + std::string(8192, 'b'));
+  ASSERT_EQ(data[3], nullptr);
+
+  environment copy(env);
+  ASSERT_TRUE(copy == env);
+  ASSERT_STREQ(copy.data()[0], "A=1");
+  ASSERT_NE(copy.data()[0], data[0]);
+  ASSERT_EQ(copy.data()[1], foo);
+}
+
+// Given a host
+// When its environment fragment is requested twice
+// Then it is built once, until the cache is invalidated.
+TEST_F(CommandEnvironment, CachedUntilInvalidated) {
+  environment_cache& cache(environment_cache::instance());
+  environment_cache::fragment first(cache.host(_host));
+  ASSERT_EQ(cache.host(_host), first);
+
+  uint64_t generation(cache.generation());
+  _host->set_alias("new_alias");
+  cache.invalidate();
+  ASSERT_EQ(cache.generation(), generation + 1);
+  environment_cache::fragment second(cache.host(_host));
+  ASSERT_NE(second, first);
+
+  environment env;
+  env.add(second);
+  bool found(false);
+  for (char** var(env.data()); *var; ++var)
+    found = found || (std::string(*var) == "NAGIOS_HOSTALIAS=new_alias");
+  ASSERT_TRUE(found);
+}
+
+// Given a cached host fragment
+// When a custom variable of the host is modified and the host invalidated
+// Then only its fragment is rebuilt, with the new value.
+TEST_F(CommandEnvironment, ObjectInvalidated) {
+  environment_cache& cache(environment_cache::instance());
+  environment_cache::fragment first(cache.host(_host));
+  environment_cache::fragment global(cache.global());
+
+  uint64_t generation(cache.generation());
+  _host->custom_variables["SNMPCOMMUNITY"].update("private");
+  cache.invalidate(_host);
+  ASSERT_EQ(cache.generation(), generation);
+  ASSERT_EQ(cache.global(), global);
+  environment_cache::fragment second(cache.host(_host));
+  ASSERT_NE(second, first);
+
+  environment env;
+  env.add(second);
+  bool found(false);
+  for (char** var(env.data()); *var; ++var)
+    found = found
+      || (std::string(*var) == "NAGIOS__HOSTSNMPCOMMUNITY=private");
+  ASSERT_TRUE(found);
+}
+
+// Given environment macros exported in all mode
+// When a command is run
+// Then cached and computed macros are all in its environment.
+TEST_F(CommandEnvironment, AllMacros) {
+  raw cmd("env", "/usr/bin/env");
+  std::string output(run_env(cmd));
+  ASSERT_NE(output.find("NAGIOS_HOSTNAME=test_host\n"), std::string::npos);
+  ASSERT_NE(output.find("NAGIOS_HOSTALIAS=test_alias\n"), std::string::npos);
+  ASSERT_NE(output.find("NAGIOS__HOSTSNMPCOMMUNITY=public\n"), std::string::npos);
+  ASSERT_NE(output.find("NAGIOS_SERVICEDESC=\n"), std::string::npos);
+  ASSERT_NE(output.find("NAGIOS_HOSTSTATE="), std::string::npos);
+  ASSERT_NE(output.find("NAGIOS_ARG1="), std::string::npos);
+}
+
+// Given environment macros exported in referenced mode
+// When a command is run
+// Then only macros of its command line are in its environment.
+TEST_F(CommandEnvironment, ReferencedMacros) {
+  config->environment_macros_mode(
+    configuration::state::environment_macros_referenced);
+  raw cmd(
+        "env",
+        "/usr/bin/env $HOSTADDRESS$ $_HOSTSNMPCOMMUNITY$ $ARG2$ "
+        "$HOSTADDRESS$ $$ $HOSTNAME:other$ $USER1$");
+  std::string output(run_env(cmd));
+  ASSERT_EQ(
+    output,
+    "NAGIOS_HOSTADDRESS=127.0.0.1\n"
+    "NAGIOS__HOSTSNMPCOMMUNITY=public\n"
+    "NAGIOS_ARG2=\n");
+
+  cmd.set_command_line("/usr/bin/env $HOSTNAME$");
+  ASSERT_EQ(run_env(cmd), "NAGIOS_HOSTNAME=test_host\n");
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/commands/plugin.hh"
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/macros.hh"
+#include "com/centreon/engine/service.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+
+extern configuration::state* config;
+
+#define TEST_PLUGIN "tests/plugin_test_run.so"
+
+class Plugin : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    configuration::applier::state::load();
+    if (config == NULL)
+      config = new configuration::state;
+  }
+
+  void TearDown() override {
+    configuration::applier::state::unload();
+    delete config;
+    config = NULL;
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+};
+
+class wait_result : public commands::command_listener {
+ public:
+  wait_result() : _done(false) {}
+  void finished(result const& res) throw () override {
+    std::lock_guard<std::mutex> lock(_lock);
+    _res = res;
+    _done = true;
+    _cv.notify_all();
+  }
+  result const& wait() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while (!_done)
+      _cv.wait(lock);
+    return _res;
+  }
+
+ private:
+  std::condition_variable _cv;
+  bool _done;
+  std::mutex _lock;
+  result _res;
+};
+
+// Given a library that does not exist
+// When a plugin command is created with it
+// Then an error is thrown
+TEST_F(Plugin, BadLibrary) {
+  ASSERT_THROW(
+    plugin("BadLibrary", "2 critical", "tests/no_such_plugin.so"),
+    std::exception);
+}
+
+// Given a plugin command
+// When it is run synchronously
+// Then the exit code and output of the plugin are returned
+TEST_F(Plugin, RunSync) {
+  plugin cmd("RunSync", "2 critical output", TEST_PLUGIN);
+  nagios_macros mac;
+  result res;
+  cmd.run(cmd.get_command_line(), mac, 5, res);
+  ASSERT_EQ(res.exit_code, 2);
+  ASSERT_EQ(res.exit_status, process::normal);
+  ASSERT_EQ(res.output, "critical output");
+}
+
+// Given a plugin command completing from a plugin thread
+// When it is run asynchronously
+// Then its listener gets the result with the command id
+TEST_F(Plugin, RunAsync) {
+  wait_result listener;
+  plugin cmd("RunAsync", "--sleep=1 1 warning output", TEST_PLUGIN,
+             &listener);
+  nagios_macros mac;
+  unsigned long id(cmd.run(cmd.get_command_line(), mac, 5));
+  result const& res(listener.wait());
+  ASSERT_EQ(res.command_id, id);
+  ASSERT_EQ(res.exit_code, 1);
+  ASSERT_EQ(res.exit_status, process::normal);
+  ASSERT_EQ(res.output, "warning output");
+}
+
+// Given a plugin command that completes after its timeout
+// When it is run
+// Then a timeout is reported
+TEST_F(Plugin, RunWithTimeout) {
+  plugin cmd("RunWithTimeout", "--sleep=2 0 late", TEST_PLUGIN);
+  nagios_macros mac;
+  result res;
+  cmd.run(cmd.get_command_line(), mac, 1, res);
+  ASSERT_EQ(res.exit_code, engine::service::state_unknown);
+  ASSERT_EQ(res.exit_status, process::timeout);
+  ASSERT_EQ(res.output, "(Process Timeout)");
+}
+
+// Given a plugin that refuses to start a check
+// When it is run
+// Then an unknown result is reported
+TEST_F(Plugin, RunNotStarted) {
+  plugin cmd("RunNotStarted", "--fail", TEST_PLUGIN);
+  nagios_macros mac;
+  result res;
+  cmd.run(cmd.get_command_line(), mac, 5, res);
+  ASSERT_EQ(res.exit_code, engine::service::state_unknown);
+  ASSERT_EQ(res.exit_status, process::crash);
+}
+
+// Given a plugin returning an exit code out of range
+// When it is run
+// Then the exit code is reported as unknown
+TEST_F(Plugin, RunBadExitCode) {
+  plugin cmd("RunBadExitCode", "7 bad", TEST_PLUGIN);
+  nagios_macros mac;
+  result res;
+  cmd.run(cmd.get_command_line(), mac, 5, res);
+  ASSERT_EQ(res.exit_code, engine::service::state_unknown);
+  ASSERT_EQ(res.output, "bad");
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "com/centreon/engine/commands/plugin_api.hh"
+
+/*
+** Check plugin used by the unit tests. Its arguments are:
+**
+**   --fail                  the check is not started
+**   --sleep=<s> <code> ...  complete from another thread after s
+**                           seconds
+**   <code> <output>         complete before run returns
+*/
+
+namespace {
+  /**
+   *  Threads of the delayed checks, joined on destroy.
+   */
+  struct                     plugin_state {
+    std::mutex               lock;
+    std::vector<std::thread> threads;
+  };
+}
+
+extern "C" {
+  CCE_PLUGIN_API_VERSION(CURRENT_CCE_PLUGIN_API_VERSION)
+
+  int cce_plugin_init(void** plugin) {
+    *plugin = new plugin_state;
+    return 0;
+  }
+
+  int cce_plugin_run(
+        void* plugin,
+        char const* args,
+        unsigned int timeout,
+        cce_plugin_done done,
+        void* context) {
+    (void)timeout;
+    std::istringstream iss(args);
+    std::string arg;
+    iss >> arg;
+    if (arg == "--fail")
+      return 1;
+
+    unsigned int sleep(0);
+    if (arg.compare(0, 8, "--sleep=") == 0) {
+      sleep = strtoul(arg.c_str() + 8, NULL, 10);
+      iss >> arg;
+    }
+    int exit_code(atoi(arg.c_str()));
+    std::string output;
+    std::getline(iss >> std::ws, output);
+
+    if (!sleep)
+      done(context, exit_code, output.c_str());
+    else {
+      plugin_state* state(static_cast<plugin_state*>(plugin));
+      std::lock_guard<std::mutex> lock(state->lock);
+      state->threads.push_back(std::thread([=]() {
+        std::this_thread::sleep_for(std::chrono::seconds(sleep));
+        done(context, exit_code, output.c_str());
+      }));
+    }
+    return 0;
+  }
+
+  void cce_plugin_destroy(void* plugin) {
+    plugin_state* state(static_cast<plugin_state*>(plugin));
+    for (std::vector<std::thread>::iterator
+           it(state->threads.begin()), end(state->threads.end());
+         it != end;
+         ++it)
+      it->join();
+    delete state;
+  }
+}
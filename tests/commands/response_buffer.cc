@@ -0,0 +1,136 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "com/centreon/engine/commands/response_buffer.hh"
+
+using namespace com::centreon::engine::commands;
+
+static std::string const terminator(4, '\0');
+
+/**
+ *  Build an execute response as sent by a connector.
+ */
+static std::string execute_response(
+                     unsigned int id,
+                     std::string const& output) {
+  std::string response("3");
+  response.append(1, '\0');
+  response.append(std::to_string(id));
+  response.append(1, '\0');
+  response.append("1");
+  response.append(1, '\0');
+  response.append("0");
+  response.append(1, '\0');
+  response.append(1, '\0');
+  response.append(output);
+  return response;
+}
+
+// Given a response buffer
+// When a partial response is appended
+// Then no response is extracted
+// When the rest of the response is appended
+// Then the response is extracted with its last field NUL terminated
+TEST(CommandsResponseBuffer, PartialResponse) {
+  response_buffer buffer;
+  std::string response;
+  buffer.append(execute_response(1, "OK"));
+  buffer.append(terminator.data(), 2);
+  ASSERT_FALSE(buffer.pop(response));
+  buffer.append(terminator.data(), 2);
+  ASSERT_TRUE(buffer.pop(response));
+  ASSERT_EQ(response, execute_response(1, "OK") + std::string(1, '\0'));
+  ASSERT_EQ(buffer.size(), 0u);
+  ASSERT_FALSE(buffer.pop(response));
+}
+
+// Given a response buffer
+// When many responses are appended at once
+// Then they are all extracted in order
+TEST(CommandsResponseBuffer, ManyResponses) {
+  response_buffer buffer(16);
+  std::string data;
+  for (unsigned int i(0); i < 1000; ++i)
+    data.append(execute_response(i, "output " + std::to_string(i)))
+      .append(terminator);
+  buffer.append(data);
+  std::string response;
+  for (unsigned int i(0); i < 1000; ++i) {
+    ASSERT_TRUE(buffer.pop(response));
+    ASSERT_EQ(
+      response,
+      execute_response(i, "output " + std::to_string(i))
+      + std::string(1, '\0'));
+  }
+  ASSERT_FALSE(buffer.pop(response));
+  ASSERT_EQ(buffer.size(), 0u);
+}
+
+// Given a response buffer with a small capacity
+// When responses are appended byte by byte
+// Then responses wrapping around the ring are extracted
+TEST(CommandsResponseBuffer, WrapAround) {
+  response_buffer buffer(64);
+  std::string response;
+  for (unsigned int i(0); i < 100; ++i) {
+    std::string data(execute_response(i, "OK"));
+    data.append(terminator);
+    for (unsigned int j(0); j < data.size(); ++j) {
+      ASSERT_FALSE(buffer.pop(response));
+      buffer.append(data.data() + j, 1);
+    }
+    ASSERT_TRUE(buffer.pop(response));
+    ASSERT_EQ(response, execute_response(i, "OK") + std::string(1, '\0'));
+  }
+  ASSERT_EQ(buffer.capacity(), 64u);
+}
+
+// Given a response buffer
+// When a response with empty last fields is followed by another one
+// Then the empty fields are part of the first response only
+TEST(CommandsResponseBuffer, EmptyLastField) {
+  response_buffer buffer;
+  std::string data(execute_response(1, ""));
+  data.append(terminator);
+  data.append(execute_response(2, "OK"));
+  data.append(terminator);
+  buffer.append(data);
+  std::string response;
+  ASSERT_TRUE(buffer.pop(response));
+  ASSERT_EQ(response, execute_response(1, "") + std::string(1, '\0'));
+  ASSERT_TRUE(buffer.pop(response));
+  ASSERT_EQ(response, execute_response(2, "OK") + std::string(1, '\0'));
+}
+
+// Given a response buffer holding a partial response
+// When it is cleared
+// Then the partial response is dropped
+TEST(CommandsResponseBuffer, Clear) {
+  response_buffer buffer;
+  std::string response;
+  buffer.append(execute_response(1, "partial"));
+  buffer.append(terminator.data(), 1);
+  buffer.clear();
+  buffer.append(execute_response(2, "OK"));
+  buffer.append(terminator);
+  ASSERT_TRUE(buffer.pop(response));
+  ASSERT_EQ(response, execute_response(2, "OK") + std::string(1, '\0'));
+}
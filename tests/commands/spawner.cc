@@ -0,0 +1,156 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <memory>
+#include <mutex>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/commands/raw.hh"
+#include "com/centreon/engine/commands/spawner.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/macros.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+
+extern configuration::state* config;
+
+class Spawner : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    configuration::applier::state::load();
+    if (config == NULL)
+      config = new configuration::state;
+  }
+
+  void TearDown() override {
+    spawner::instance().stop();
+    configuration::applier::state::unload();
+    delete config;
+    config = NULL;
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+};
+
+class spawn_listener : public commands::command_listener {
+ public:
+  spawn_listener() : _count(0) {}
+
+  unsigned int count() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _count;
+  }
+
+  void finished(result const& res) throw () override {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _res = res;
+    ++_count;
+  }
+
+  result get_result() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _res;
+  }
+
+  bool wait(unsigned int count) const {
+    for (int i(0); i < 100 && this->count() < count; ++i)
+      usleep(100000);
+    return this->count() >= count;
+  }
+
+ private:
+  unsigned int       _count;
+  mutable std::mutex _mutex;
+  commands::result   _res;
+};
+
+// Given a raw command using the spawn launcher
+// When it is run synchronously
+// Then the spawner is started and the output is in the result.
+TEST_F(Spawner, SyncCommand) {
+  std::unique_ptr<commands::raw> cmd{
+    new commands::raw("test", "/bin/echo bonjour")};
+  cmd->set_launcher(commands::raw::launcher_spawn);
+  nagios_macros mac;
+  commands::result res;
+  std::string cc(cmd->process_cmd(&mac));
+  cmd->run(cc, mac, 2, res);
+  ASSERT_TRUE(spawner::instance().is_running());
+  ASSERT_EQ(res.exit_status, process::normal);
+  ASSERT_EQ(res.exit_code, 0);
+  ASSERT_EQ(res.output, "bonjour\n");
+}
+
+// Given the spawn launcher set globally
+// When raw commands are run asynchronously
+// Then the listener gets their results.
+TEST_F(Spawner, AsyncCommands) {
+  config->command_launcher(configuration::state::launcher_spawn);
+  spawn_listener lstnr;
+  std::unique_ptr<commands::raw> cmd{
+    new commands::raw("test", "/bin/sh -c 'exit 2'")};
+  cmd->set_listener(&lstnr);
+  nagios_macros mac;
+  std::string cc(cmd->process_cmd(&mac));
+  for (unsigned int i(0); i < 10; ++i)
+    cmd->run(cc, mac, 5);
+  ASSERT_TRUE(lstnr.wait(10));
+  ASSERT_EQ(lstnr.get_result().exit_status, process::normal);
+  ASSERT_EQ(lstnr.get_result().exit_code, 2);
+}
+
+// Given a raw command using the spawn launcher
+// When it runs longer than its timeout
+// Then it is killed and the result is a timeout.
+TEST_F(Spawner, Timeout) {
+  spawn_listener lstnr;
+  std::unique_ptr<commands::raw> cmd{
+    new commands::raw("test", "/bin/sleep 5")};
+  cmd->set_launcher(commands::raw::launcher_spawn);
+  cmd->set_listener(&lstnr);
+  nagios_macros mac;
+  std::string cc(cmd->process_cmd(&mac));
+  cmd->run(cc, mac, 1);
+  ASSERT_TRUE(lstnr.wait(1));
+  ASSERT_EQ(lstnr.get_result().exit_status, process::timeout);
+  ASSERT_EQ(lstnr.get_result().output, "(Process Timeout)");
+}
+
+// Given a raw command using the spawn launcher
+// When the spawner stops while the command runs
+// Then the command ends as crashed.
+TEST_F(Spawner, StoppedSpawner) {
+  spawn_listener lstnr;
+  std::unique_ptr<commands::raw> cmd{
+    new commands::raw("test", "/bin/sleep 5")};
+  cmd->set_launcher(commands::raw::launcher_spawn);
+  cmd->set_listener(&lstnr);
+  nagios_macros mac;
+  std::string cc(cmd->process_cmd(&mac));
+  cmd->run(cc, mac, 0);
+  spawner::instance().stop();
+  ASSERT_TRUE(lstnr.wait(1));
+  ASSERT_EQ(lstnr.get_result().exit_status, process::crash);
+  ASSERT_EQ(lstnr.get_result().exit_code, engine::service::state_unknown);
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/commands/system_runner.hh"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/macros.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+
+extern configuration::state* config;
+
+class SystemRunner : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    configuration::applier::state::load();
+    if (config == NULL)
+      config = new configuration::state;
+  }
+
+  void TearDown() override {
+    configuration::applier::state::unload();
+    delete config;
+    config = NULL;
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+
+  // Reap commands, including waiting ones, until none is left.
+  void reap_all() {
+    while (!system_runner::instance().empty()) {
+      system_runner::instance().reap();
+      usleep(1000);
+    }
+  }
+};
+
+// Given a system command
+// When it is run by the system runner
+// Then its callback is called with its result once the runner is drained
+TEST_F(SystemRunner, RunAndDrain) {
+  nagios_macros mac;
+  bool called(false);
+  result res;
+  system_runner::instance().run(
+    "/bin/echo hello",
+    mac,
+    5,
+    [&called, &res](result const& r) {
+      called = true;
+      res = r;
+    });
+  system_runner::instance().drain();
+  ASSERT_TRUE(called);
+  ASSERT_EQ(res.exit_code, 0);
+  ASSERT_EQ(res.exit_status, process::normal);
+  ASSERT_EQ(res.output, "hello\n");
+  ASSERT_TRUE(system_runner::instance().empty());
+}
+
+// Given max_concurrent_system_commands set to 2
+// When 5 commands are run
+// Then 2 commands are started and 3 wait, and all callbacks are called
+// once reaped
+TEST_F(SystemRunner, BoundedConcurrency) {
+  config->max_concurrent_system_commands(2);
+  nagios_macros mac;
+  unsigned int called(0);
+  for (unsigned int i(0); i < 5; ++i)
+    system_runner::instance().run(
+      "/bin/sleep 0.1",
+      mac,
+      5,
+      [&called](result const& r) {
+        if (r.exit_code == 0)
+          ++called;
+      });
+  ASSERT_EQ(system_runner::instance().running(), 2u);
+  ASSERT_EQ(system_runner::instance().waiting(), 3u);
+  reap_all();
+  ASSERT_EQ(called, 5u);
+  ASSERT_EQ(system_runner::instance().running(), 0u);
+  ASSERT_EQ(system_runner::instance().waiting(), 0u);
+}
+
+// Given max_concurrent_system_commands set to 1
+// When 2 commands with a start callback are run
+// Then the second one is only started once the first one finished
+TEST_F(SystemRunner, StartedWithSlot) {
+  config->max_concurrent_system_commands(1);
+  nagios_macros mac;
+  std::vector<std::string> calls;
+  for (unsigned int i(0); i < 2; ++i) {
+    std::string id(1, static_cast<char>('1' + i));
+    system_runner::instance().run(
+      "/bin/true",
+      mac,
+      5,
+      [&calls, id](result const&) { calls.push_back("end " + id); },
+      [&calls, id]() { calls.push_back("start " + id); });
+  }
+  ASSERT_EQ(calls.size(), 1u);
+  ASSERT_EQ(calls[0], "start 1");
+  reap_all();
+  ASSERT_EQ(calls.size(), 4u);
+  ASSERT_EQ(calls[1], "end 1");
+  ASSERT_EQ(calls[2], "start 2");
+  ASSERT_EQ(calls[3], "end 2");
+}
+
+// Given max_concurrent_system_commands and max_queued_system_commands
+// set to 1
+// When 3 commands are run
+// Then the third one is not run and completes as failed
+TEST_F(SystemRunner, BoundedQueue) {
+  config->max_concurrent_system_commands(1);
+  config->max_queued_system_commands(1);
+  nagios_macros mac;
+  std::vector<result> results(3);
+  for (unsigned int i(0); i < 3; ++i)
+    system_runner::instance().run(
+      "/bin/echo ok",
+      mac,
+      5,
+      [&results, i](result const& r) { results[i] = r; });
+  ASSERT_EQ(system_runner::instance().running(), 1u);
+  ASSERT_EQ(system_runner::instance().waiting(), 1u);
+  reap_all();
+  ASSERT_EQ(results[0].output, "ok\n");
+  ASSERT_EQ(results[1].output, "ok\n");
+  ASSERT_EQ(results[2].exit_status, process::crash);
+  ASSERT_EQ(results[2].output, "too many system commands waiting");
+}
+
+// Given max_concurrent_system_commands set to 1
+// When 2 commands are run and the runner is drained
+// Then the running command completes and the waiting one is cancelled
+TEST_F(SystemRunner, DrainCancelsWaiting) {
+  config->max_concurrent_system_commands(1);
+  nagios_macros mac;
+  std::vector<result> results(2);
+  for (unsigned int i(0); i < 2; ++i)
+    system_runner::instance().run(
+      "/bin/echo ok",
+      mac,
+      5,
+      [&results, i](result const& r) { results[i] = r; });
+  ASSERT_EQ(system_runner::instance().waiting(), 1u);
+  system_runner::instance().drain();
+  ASSERT_EQ(results[0].output, "ok\n");
+  ASSERT_EQ(results[1].exit_status, process::crash);
+  ASSERT_EQ(results[1].output, "system command cancelled");
+  ASSERT_TRUE(system_runner::instance().empty());
+}
+
+// Given a completion held by the callbacks of two commands
+// When the commands finish
+// Then the completion is called once, after both callbacks
+TEST_F(SystemRunner, CompletionAfterCallbacks) {
+  nagios_macros mac;
+  std::vector<std::string> calls;
+  system_runner::completion done(system_runner::make_completion(
+    [&calls]() { calls.push_back("done"); }));
+  for (unsigned int i(0); i < 2; ++i)
+    system_runner::instance().run(
+      "/bin/true",
+      mac,
+      5,
+      [&calls, done](result const&) { calls.push_back("command"); });
+  done.reset();
+  ASSERT_TRUE(calls.empty());
+  system_runner::instance().drain();
+  ASSERT_EQ(calls.size(), 3u);
+  ASSERT_EQ(calls[0], "command");
+  ASSERT_EQ(calls[1], "command");
+  ASSERT_EQ(calls[2], "done");
+}
+
+// Given a completion not held by any command
+// When it is released
+// Then it is called immediately
+TEST_F(SystemRunner, CompletionWithoutCommand) {
+  bool called(false);
+  system_runner::completion done(system_runner::make_completion(
+    [&called]() { called = true; }));
+  ASSERT_FALSE(called);
+  done.reset();
+  ASSERT_TRUE(called);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/commands/command.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/command.hh"
+#include "com/centreon/engine/configuration/host.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+extern configuration::state* config;
+
+class ApplierState : public ::testing::Test {
+ public:
+  void SetUp() override {
+    if (config == nullptr)
+      config = new configuration::state;
+    clib::load();
+    com::centreon::logging::engine::load();
+    configuration::applier::state::load();
+    timezone_manager::load();
+    checks::checker::load();
+  }
+
+  void TearDown() override {
+    configuration::applier::state::unload();
+    com::centreon::logging::engine::unload();
+    clib::unload();
+    checks::checker::unload();
+    delete config;
+    config = nullptr;
+    timezone_manager::unload();
+  }
+};
+
+// Given a state applier
+// When no configuration was prepared
+// Then apply_prepared() does nothing.
+TEST_F(ApplierState, NothingPrepared) {
+  ASSERT_FALSE(configuration::applier::state::instance().apply_prepared());
+  ASSERT_EQ(
+    configuration::applier::state::instance().stop_the_world_time(),
+    0.0);
+}
+
+// Given a new configuration with a command and a host
+// When it is prepared
+// Then engine objects and the current configuration are not modified.
+TEST_F(ApplierState, PrepareDoesNotApply) {
+  std::unique_ptr<configuration::state> new_cfg(new configuration::state);
+  configuration::command cmd("cmd");
+  cmd.parse("command_line", "echo 1");
+  new_cfg->commands().insert(cmd);
+  configuration::host hst;
+  hst.parse("host_name", "test_host");
+  hst.parse("address", "127.0.0.1");
+  hst.parse("_HOST_ID", "12");
+  new_cfg->hosts().insert(hst);
+
+  configuration::applier::state::instance().prepare(std::move(new_cfg));
+  ASSERT_TRUE(config->commands().empty());
+  ASSERT_TRUE(config->hosts().empty());
+  ASSERT_TRUE(commands::command::commands.empty());
+  ASSERT_TRUE(engine::host::hosts.empty());
+}
+
+/**
+ *  Build a configuration with a command and some hosts using it.
+ */
+static std::unique_ptr<configuration::state> new_config(
+         std::vector<std::string> const& hosts,
+         std::string const& address = "127.0.0.1") {
+  std::unique_ptr<configuration::state> cfg(new configuration::state);
+  cfg->log_file("");
+  cfg->use_syslog(false);
+  configuration::command cmd("cmd");
+  cmd.parse("command_line", "echo 1");
+  cfg->commands().insert(cmd);
+  unsigned int id(12);
+  for (std::vector<std::string>::const_iterator
+         it(hosts.begin()),
+         end(hosts.end());
+       it != end;
+       ++it, ++id) {
+    configuration::host hst;
+    hst.parse("host_name", it->c_str());
+    hst.parse("address", address.c_str());
+    hst.parse("check_command", "cmd");
+    hst.parse("_HOST_ID", std::to_string(id).c_str());
+    cfg->hosts().insert(hst);
+  }
+  return cfg;
+}
+
+// Given a prepared configuration with a command and a host
+// When it is applied
+// Then engine objects and the current configuration are created.
+TEST_F(ApplierState, ApplyPreparedCreates) {
+  configuration::applier::state::instance().prepare(
+    new_config({ "test_host" }));
+  ASSERT_TRUE(configuration::applier::state::instance().apply_prepared());
+  ASSERT_EQ(config->commands().size(), 1u);
+  ASSERT_EQ(config->hosts().size(), 1u);
+  ASSERT_EQ(commands::command::commands.count("cmd"), 1u);
+  ASSERT_EQ(engine::host::hosts.count("test_host"), 1u);
+  ASSERT_GT(
+    configuration::applier::state::instance().stop_the_world_time(),
+    0.0);
+
+  // Nothing is left to apply.
+  ASSERT_FALSE(configuration::applier::state::instance().apply_prepared());
+}
+
+// Given an applied configuration with two hosts
+// When a configuration modifying the first host and without the second
+// one is prepared and applied
+// Then the first host is modified and the second one removed.
+TEST_F(ApplierState, ApplyPreparedModifiesAndRemoves) {
+  configuration::applier::state::instance().prepare(
+    new_config({ "host_1", "host_2" }));
+  ASSERT_TRUE(configuration::applier::state::instance().apply_prepared());
+  ASSERT_EQ(engine::host::hosts.size(), 2u);
+
+  configuration::applier::state::instance().prepare(
+    new_config({ "host_1" }, "10.0.0.1"));
+  ASSERT_TRUE(configuration::applier::state::instance().apply_prepared());
+  ASSERT_EQ(config->hosts().size(), 1u);
+  ASSERT_EQ(engine::host::hosts.size(), 1u);
+  ASSERT_EQ(engine::host::hosts.count("host_2"), 0u);
+  ASSERT_EQ(
+    engine::host::hosts.find("host_1")->second->get_address(),
+    "10.0.0.1");
+}
+
+// Given an applied configuration with a host
+// When a configuration adding a host with an unknown check command is
+// prepared and applied
+// Then the configuration fails to apply and the previous one is
+// restored.
+TEST_F(ApplierState, ApplyPreparedRestoresOnError) {
+  configuration::applier::state::instance().prepare(
+    new_config({ "host_1" }));
+  ASSERT_TRUE(configuration::applier::state::instance().apply_prepared());
+
+  std::unique_ptr<configuration::state> cfg(new_config({ "host_1" }));
+  configuration::host hst;
+  hst.parse("host_name", "host_2");
+  hst.parse("address", "127.0.0.1");
+  hst.parse("check_command", "unknown");
+  hst.parse("_HOST_ID", "42");
+  cfg->hosts().insert(hst);
+  configuration::applier::state::instance().prepare(std::move(cfg));
+  ASSERT_TRUE(configuration::applier::state::instance().apply_prepared());
+  ASSERT_EQ(config->hosts().size(), 1u);
+  ASSERT_EQ(config->hosts().begin()->host_name(), "host_1");
+  ASSERT_EQ(engine::host::hosts.size(), 1u);
+  ASSERT_EQ(engine::host::hosts.count("host_1"), 1u);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/event_stats.hh"
+
+using namespace com::centreon::engine;
+
+// Given handled events of several types
+// Then they are accounted for their own type.
+TEST(EventStats, PerEventType) {
+  events::event_stats stats;
+  stats.record(EVENT_CHECK_REAPER, 10, 2000);
+  stats.record(EVENT_CHECK_REAPER, 30, 4000);
+  stats.record(EVENT_STATUS_SAVE, 0, 50000);
+  stats.record(EVENT_USER_FUNCTION, 0, 1);
+
+  events::event_stats::entry const* reaper(stats.find(EVENT_CHECK_REAPER));
+  ASSERT_TRUE(reaper);
+  ASSERT_EQ(reaper->execution.count(), 2u);
+  ASSERT_EQ(reaper->execution.total(), 6000u);
+  ASSERT_EQ(reaper->lag.max(), 30u);
+  ASSERT_EQ(stats.find(EVENT_STATUS_SAVE)->execution.max(), 50000u);
+  ASSERT_EQ(stats.find(EVENT_USER_FUNCTION)->execution.count(), 1u);
+  ASSERT_EQ(stats.find(EVENT_ORPHAN_CHECK)->execution.count(), 0u);
+}
+
+// Given an untracked event type
+// Then nothing is recorded for it.
+TEST(EventStats, UntrackedEventType) {
+  events::event_stats stats;
+  stats.record(EVENT_SLEEP, 0, 10);
+  ASSERT_EQ(stats.find(EVENT_SLEEP), nullptr);
+
+  stats.record(EVENT_CHECK_REAPER, 0, 10);
+  stats.reset();
+  ASSERT_EQ(stats.find(EVENT_CHECK_REAPER)->execution.count(), 0u);
+}
+
+// Given handled events of one type
+// When statistics are dumped
+// Then one line is written for this type only.
+TEST(EventStats, Dump) {
+  events::event_stats stats;
+  stats.record(EVENT_CHECK_REAPER, 10, 2000);
+  stats.record(EVENT_CHECK_REAPER, 10, 2000);
+
+  std::ostringstream oss;
+  stats.dump(oss, "\t");
+  ASSERT_EQ(
+    oss.str(),
+    "\tevent_stats=EVENT_CHECK_REAPER,2,10,10,10,10,2000,2000,2000,2000,4000\n");
+}
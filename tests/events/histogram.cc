@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "com/centreon/engine/events/histogram.hh"
+
+using namespace com::centreon::engine;
+
+// Given an empty histogram
+// Then all its statistics are null.
+TEST(Histogram, Empty) {
+  events::histogram h;
+  ASSERT_EQ(h.count(), 0u);
+  ASSERT_EQ(h.max(), 0u);
+  ASSERT_EQ(h.min(), 0u);
+  ASSERT_EQ(h.mean(), 0.0);
+  ASSERT_EQ(h.percentile(99), 0u);
+}
+
+// Given small values
+// When they are recorded
+// Then percentiles are exact.
+TEST(Histogram, SmallValuesAreExact) {
+  events::histogram h;
+  for (uint64_t i(1); i <= 8; ++i)
+    h.record(i);
+  ASSERT_EQ(h.count(), 8u);
+  ASSERT_EQ(h.min(), 1u);
+  ASSERT_EQ(h.max(), 8u);
+  ASSERT_EQ(h.total(), 36u);
+  ASSERT_EQ(h.percentile(50), 4u);
+  ASSERT_EQ(h.percentile(100), 8u);
+}
+
+// Given values spread over several orders of magnitude
+// When percentiles are computed
+// Then their relative error is bounded by the bucket width.
+TEST(Histogram, BoundedRelativeError) {
+  events::histogram h;
+  for (uint64_t i(1); i <= 100000; ++i)
+    h.record(i);
+  uint64_t p50(h.percentile(50));
+  uint64_t p99(h.percentile(99));
+  ASSERT_GE(p50, 50000u);
+  ASSERT_LE(p50, 50000u + 50000u / events::histogram::sub_buckets);
+  ASSERT_GE(p99, 99000u);
+  ASSERT_LE(p99, 100000u);
+  ASSERT_EQ(h.percentile(100), 100000u);
+}
+
+// Given a histogram with large values
+// When it is reset
+// Then it is empty again.
+TEST(Histogram, Reset) {
+  events::histogram h;
+  h.record(0);
+  h.record(~static_cast<uint64_t>(0));
+  ASSERT_EQ(h.max(), ~static_cast<uint64_t>(0));
+  ASSERT_EQ(h.percentile(100), ~static_cast<uint64_t>(0));
+  h.reset();
+  ASSERT_EQ(h.count(), 0u);
+  ASSERT_EQ(h.max(), 0u);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "com/centreon/engine/events/load_leveler.hh"
+
+using namespace com::centreon::engine::events;
+
+class LoadLeveler : public ::testing::Test {
+ public:
+  void SetUp() override {
+    _now = time(nullptr);
+  }
+
+ protected:
+  int          _checks[20];
+  load_leveler _leveler;
+  time_t       _now;
+};
+
+// Given checks due at the same time
+// When they can be postponed
+// Then they are spread over the least loaded seconds.
+TEST_F(LoadLeveler, SpreadChecks) {
+  for (int i(0); i < 10; ++i) {
+    _leveler.learn(&_checks[i], 1.0);
+    time_t when(_leveler.place(&_checks[i], _now + 10, 9));
+    ASSERT_GE(when, _now + 10);
+    ASSERT_LE(when, _now + 19);
+  }
+  for (int i(0); i < 10; ++i)
+    ASSERT_DOUBLE_EQ(_leveler.load(_now + 10 + i), 1.0);
+  ASSERT_DOUBLE_EQ(_leveler.peak_load(30), 1.0);
+}
+
+// Given checks that cannot be postponed
+// When they are placed
+// Then they keep their time and their load adds up.
+TEST_F(LoadLeveler, NoDelay) {
+  for (int i(0); i < 3; ++i) {
+    _leveler.learn(&_checks[i], 0.5);
+    ASSERT_EQ(_leveler.place(&_checks[i], _now + 5, 0), _now + 5);
+  }
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 5), 1.5);
+  ASSERT_TRUE(_leveler.placed(&_checks[0]));
+  ASSERT_FALSE(_leveler.placed(&_checks[3]));
+}
+
+// Given a check placed several times
+// When it is placed again
+// Then its previous reservation is released and nothing is learned.
+TEST_F(LoadLeveler, PlaceAgain) {
+  _leveler.learn(&_checks[0], 2.0);
+  _leveler.place(&_checks[0], _now + 5, 0);
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 5), 2.0);
+  _leveler.place(&_checks[0], _now + 8, 0);
+  _leveler.place(&_checks[0], _now + 8, 0);
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 5), 0.0);
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 8), 2.0);
+  ASSERT_DOUBLE_EQ(_leveler.expected_cost(&_checks[0]), 2.0);
+}
+
+// Given a placed check
+// When its executions complete
+// Then its cost is learned and used by its next placement.
+TEST_F(LoadLeveler, LearnExecutionTime) {
+  _leveler.learn(&_checks[0], 2.0);
+  ASSERT_DOUBLE_EQ(_leveler.expected_cost(&_checks[0]), 2.0);
+  _leveler.place(&_checks[0], _now + 5, 0);
+  _leveler.learn(&_checks[0], 1.0);
+  ASSERT_DOUBLE_EQ(_leveler.expected_cost(&_checks[0]), 1.7);
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 5), 2.0);
+  _leveler.place(&_checks[0], _now + 8, 0);
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 8), 1.7);
+
+  // Checks that never ran cost the average learned cost.
+  _leveler.place(&_checks[1], _now + 8, 0);
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 8), 3.4);
+}
+
+// Given a placed check
+// When it is forgotten
+// Then its load is released.
+TEST_F(LoadLeveler, Forget) {
+  _leveler.learn(&_checks[0], 1.0);
+  _leveler.learn(&_checks[1], 1.0);
+  _leveler.place(&_checks[0], _now + 5, 0);
+  _leveler.place(&_checks[1], _now + 5, 0);
+  _leveler.forget(&_checks[0]);
+  ASSERT_DOUBLE_EQ(_leveler.load(_now + 5), 1.0);
+  ASSERT_FALSE(_leveler.placed(&_checks[0]));
+  ASSERT_DOUBLE_EQ(_leveler.average_load(10), 0.1);
+}
+
+// Given a check scheduled farther than the projection
+// When it is placed
+// Then it is not moved nor accounted.
+TEST_F(LoadLeveler, BeyondHorizon) {
+  time_t when(_now + 2 * load_leveler::horizon);
+  _leveler.learn(&_checks[0], 1.0);
+  ASSERT_EQ(_leveler.place(&_checks[0], when, 60), when);
+  ASSERT_FALSE(_leveler.placed(&_checks[0]));
+  ASSERT_DOUBLE_EQ(_leveler.peak_load(load_leveler::horizon), 0.0);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "com/centreon/engine/events/monotonic_clock.hh"
+
+using namespace com::centreon::engine::events;
+
+// Given the monotonic clock
+// When times are converted back and forth
+// Then the wall clock time is preserved.
+TEST(MonotonicClock, ConvertWallClockTimes) {
+  time_t wall(time(nullptr));
+  ASSERT_EQ(monotonic_clock::to_wall(monotonic_clock::to_monotonic(wall)),
+            wall);
+  ASSERT_EQ(monotonic_clock::to_monotonic(wall),
+            wall - monotonic_clock::skew());
+}
+
+// Given the monotonic clock
+// When it is read
+// Then it matches the wall clock shifted by the skew.
+TEST(MonotonicClock, FollowsWallClock) {
+  monotonic_clock::sync();
+  time_t now(monotonic_clock::now());
+  time_t wall(monotonic_clock::to_monotonic(time(nullptr)));
+  ASSERT_LE(now, wall + 1);
+  ASSERT_GE(now, wall - 1);
+  ASSERT_EQ(monotonic_clock::now_us() / 1000000, monotonic_clock::now());
+}
+
+// Given a synchronized clock
+// When the wall clock did not change
+// Then no time change is reported.
+TEST(MonotonicClock, NoTimeChange) {
+  monotonic_clock::sync();
+  ASSERT_EQ(monotonic_clock::sync(), 0);
+}
@@ -0,0 +1,428 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include "com/centreon/engine/events/defines.hh"
+#include "com/centreon/engine/events/timed_event.hh"
+
+using namespace com::centreon::engine;
+
+static timed_event* new_event(
+                      time_t run_time,
+                      uint32_t type = EVENT_SERVICE_CHECK,
+                      void* data = nullptr) {
+  return new timed_event(
+               type,
+               run_time,
+               false,
+               0,
+               nullptr,
+               true,
+               data,
+               nullptr,
+               0);
+}
+
+class TimedEventList : public ::testing::Test {
+ public:
+  void TearDown() override {
+    for (timed_event_list::const_iterator
+           it(_list.begin()),
+           end(_list.end());
+         it != end;
+         ++it)
+      delete *it;
+    _list.clear();
+  }
+
+ protected:
+  timed_event_list _list;
+};
+
+// Given an empty event list
+// Then it has no front event and pop_front() returns nullptr.
+TEST_F(TimedEventList, Empty) {
+  ASSERT_TRUE(_list.empty());
+  ASSERT_EQ(_list.size(), 0u);
+  ASSERT_EQ(_list.front(), nullptr);
+  ASSERT_EQ(_list.pop_front(), nullptr);
+}
+
+// Given events pushed in random order
+// When they are popped
+// Then they come out ordered by run time.
+TEST_F(TimedEventList, PopInRunTimeOrder) {
+  srand(42);
+  for (int i(0); i < 1000; ++i)
+    _list.push(new_event(rand() % 100));
+  ASSERT_EQ(_list.size(), 1000u);
+
+  time_t last(0);
+  while (!_list.empty()) {
+    std::unique_ptr<timed_event> evt(_list.pop_front());
+    ASSERT_GE(evt->get_run_time(), last);
+    last = evt->get_run_time();
+  }
+}
+
+// Given events sharing the same run time
+// When they are popped
+// Then they come out in insertion order.
+TEST_F(TimedEventList, SameRunTimeIsFifo) {
+  std::vector<timed_event*> events;
+  for (int i(0); i < 10; ++i) {
+    events.push_back(new_event(10));
+    _list.push(events.back());
+  }
+  for (int i(0); i < 10; ++i) {
+    std::unique_ptr<timed_event> evt(_list.pop_front());
+    ASSERT_EQ(evt.get(), events[i]);
+  }
+}
+
+// Given events pushed at once
+// When they are popped
+// Then they come out ordered by run time, then in vector order.
+TEST_F(TimedEventList, BulkPush) {
+  srand(42);
+  std::vector<timed_event*> events;
+  for (int i(0); i < 1000; ++i)
+    events.push_back(new_event(rand() % 100));
+  _list.push(events);
+  ASSERT_EQ(_list.size(), 1000u);
+
+  timed_event* last(nullptr);
+  while (!_list.empty()) {
+    timed_event* evt(_list.pop_front());
+    if (last) {
+      ASSERT_LE(last->get_run_time(), evt->get_run_time());
+      if (last->get_run_time() == evt->get_run_time()) {
+        ASSERT_LT(
+          std::find(events.begin(), events.end(), last),
+          std::find(events.begin(), events.end(), evt));
+      }
+    }
+    delete last;
+    last = evt;
+  }
+  delete last;
+}
+
+// Given scheduled events
+// When a few events, one of them already stored, are pushed at once
+// Then the stored one is moved and the others are added.
+TEST_F(TimedEventList, BulkPushIntoList) {
+  int data[4];
+  timed_event* evt1(new_event(10, EVENT_SERVICE_CHECK, &data[0]));
+  timed_event* evt2(new_event(20, EVENT_SERVICE_CHECK, &data[1]));
+  timed_event* evt3(new_event(30, EVENT_SERVICE_CHECK, &data[2]));
+  timed_event* evt4(new_event(15, EVENT_SERVICE_CHECK, &data[3]));
+  _list.push(evt1);
+  _list.push(evt2);
+  _list.push(evt3);
+
+  std::vector<timed_event*> events;
+  evt1->set_run_time(40);
+  events.push_back(evt1);
+  events.push_back(evt4);
+  _list.push(events);
+  ASSERT_EQ(_list.size(), 4u);
+  ASSERT_EQ(_list.find(EVENT_SERVICE_CHECK, &data[3]), evt4);
+  ASSERT_EQ(_list.pop_front(), evt4);
+  ASSERT_EQ(_list.pop_front(), evt2);
+  ASSERT_EQ(_list.pop_front(), evt3);
+  ASSERT_EQ(_list.pop_front(), evt1);
+  delete evt1;
+  delete evt2;
+  delete evt3;
+  delete evt4;
+}
+
+// Given scheduled events
+// When one of them is erased
+// Then it is neither found nor popped anymore.
+TEST_F(TimedEventList, Erase) {
+  int data[3];
+  timed_event* evt1(new_event(30, EVENT_SERVICE_CHECK, &data[0]));
+  timed_event* evt2(new_event(10, EVENT_SERVICE_CHECK, &data[1]));
+  timed_event* evt3(new_event(20, EVENT_SERVICE_CHECK, &data[2]));
+  _list.push(evt1);
+  _list.push(evt2);
+  _list.push(evt3);
+
+  ASSERT_TRUE(_list.erase(evt2));
+  ASSERT_FALSE(_list.erase(evt2));
+  ASSERT_FALSE(_list.contains(evt2));
+  ASSERT_EQ(_list.find(EVENT_SERVICE_CHECK, &data[1]), nullptr);
+  ASSERT_EQ(_list.size(), 2u);
+  ASSERT_EQ(_list.pop_front(), evt3);
+  ASSERT_EQ(_list.pop_front(), evt1);
+  delete evt1;
+  delete evt2;
+  delete evt3;
+}
+
+// Given scheduled events
+// When they are searched by type and data
+// Then the matching event is returned.
+TEST_F(TimedEventList, Find) {
+  int data[2];
+  timed_event* svc(new_event(10, EVENT_SERVICE_CHECK, &data[0]));
+  timed_event* hst(new_event(10, EVENT_HOST_CHECK, &data[0]));
+  _list.push(svc);
+  _list.push(hst);
+
+  ASSERT_EQ(_list.find(EVENT_SERVICE_CHECK, &data[0]), svc);
+  ASSERT_EQ(_list.find(EVENT_HOST_CHECK, &data[0]), hst);
+  ASSERT_EQ(_list.find(EVENT_HOST_CHECK, &data[1]), nullptr);
+}
+
+// Given an event whose data changed while it was scheduled
+// When it is erased
+// Then the lookup index is kept consistent.
+TEST_F(TimedEventList, EraseAfterDataChange) {
+  int data;
+  timed_event* evt(new_event(10, EVENT_SCHEDULED_DOWNTIME, &data));
+  _list.push(evt);
+  evt->event_data = nullptr;
+  ASSERT_TRUE(_list.erase(evt));
+  ASSERT_EQ(_list.find(EVENT_SCHEDULED_DOWNTIME, &data), nullptr);
+  delete evt;
+}
+
+// Given a scheduled event
+// When its run time is changed and the list updated
+// Then it is moved accordingly.
+TEST_F(TimedEventList, Update) {
+  timed_event* evt1(new_event(10));
+  timed_event* evt2(new_event(20));
+  _list.push(evt1);
+  _list.push(evt2);
+  ASSERT_EQ(_list.front(), evt1);
+
+  evt1->set_run_time(30);
+  _list.update(evt1);
+  ASSERT_EQ(_list.front(), evt2);
+
+  // Pushing an already scheduled event only moves it.
+  evt1->set_run_time(5);
+  _list.push(evt1);
+  ASSERT_EQ(_list.size(), 2u);
+  ASSERT_EQ(_list.front(), evt1);
+}
+
+// Given a scheduled event
+// When its run time is changed
+// Then its monotonic time follows but its order is kept until the
+// list is updated.
+TEST_F(TimedEventList, MonotonicOrdering) {
+  timed_event* evt1(new_event(10));
+  timed_event* evt2(new_event(20));
+  _list.push(evt1);
+  _list.push(evt2);
+  time_t monotonic(evt1->monotonic_time());
+
+  evt1->set_run_time(30);
+  ASSERT_EQ(_list.front(), evt1);
+  ASSERT_EQ(evt1->monotonic_time(), monotonic + 20);
+  ASSERT_EQ(evt1->get_run_time(), 30);
+
+  _list.update(evt1);
+  ASSERT_EQ(_list.front(), evt2);
+}
+
+// Given events occurring at specific times or with a timing function
+// When they are pushed and erased
+// Then only them are tracked as pinned to the wall clock.
+TEST_F(TimedEventList, Pinned) {
+  int data[3];
+  timed_event* compensated(new_event(10, EVENT_SERVICE_CHECK, &data[0]));
+  timed_event* fixed(new_event(20, EVENT_SCHEDULED_DOWNTIME, &data[1]));
+  fixed->compensate_for_time_change = false;
+  timed_event* timed(new_event(30, EVENT_LOG_ROTATION, &data[2]));
+  timed->timing_func = &data[2];
+  _list.push(compensated);
+  _list.push(fixed);
+  _list.push(timed);
+  ASSERT_EQ(_list.pinned().size(), 2u);
+  ASSERT_EQ(_list.pinned().count(compensated), 0u);
+  ASSERT_EQ(_list.pinned().count(fixed), 1u);
+  ASSERT_EQ(_list.pinned().count(timed), 1u);
+
+  ASSERT_TRUE(_list.erase(fixed));
+  ASSERT_EQ(_list.pinned().size(), 1u);
+  delete fixed;
+}
+
+// Given events whose run times were modified in place
+// When the list is resorted
+// Then the order is restored.
+TEST_F(TimedEventList, Resort) {
+  std::vector<timed_event*> events;
+  for (int i(0); i < 100; ++i) {
+    events.push_back(new_event(i));
+    _list.push(events.back());
+  }
+  for (int i(0); i < 100; ++i)
+    events[i]->set_run_time(1000 - i);
+  _list.resort();
+
+  time_t last(0);
+  while (!_list.empty()) {
+    std::unique_ptr<timed_event> evt(_list.pop_front());
+    ASSERT_GE(evt->get_run_time(), last);
+    last = evt->get_run_time();
+  }
+}
+
+// Given the wheel scheduler and events spread over several weeks
+// When the list is advanced
+// Then due events are returned and no due event is left behind.
+TEST_F(TimedEventList, WheelReturnsDueEvents) {
+  time_t now(time(nullptr));
+  _list.set_scheduler(timed_event_list::wheel);
+  ASSERT_EQ(_list.get_scheduler(), timed_event_list::wheel);
+
+  srand(42);
+  for (int i(0); i < 2000; ++i)
+    _list.push(new_event(now + rand() % (1 << 22)));
+
+  size_t popped(0);
+  for (time_t t(now); !_list.empty(); t += 1 + rand() % 5000) {
+    _list.advance(t);
+    while (!_list.empty() && (_list.front()->get_run_time() <= t)) {
+      std::unique_ptr<timed_event> evt(_list.pop_front());
+      ASSERT_LE(evt->get_run_time(), t);
+      ++popped;
+    }
+    // Nothing due must remain.
+    for (timed_event_list::const_iterator
+           it(_list.begin()),
+           end(_list.end());
+         it != end;
+         ++it)
+      ASSERT_GT((*it)->get_run_time(), t);
+  }
+  ASSERT_EQ(popped, 2000u);
+}
+
+// Given the wheel scheduler
+// When nothing is due
+// Then front() is the earliest event.
+TEST_F(TimedEventList, WheelFrontIsEarliest) {
+  time_t now(time(nullptr));
+  _list.set_scheduler(timed_event_list::wheel);
+  timed_event* far(new_event(now + 100000));
+  timed_event* near(new_event(now + 300));
+  timed_event* nearest(new_event(now + 10));
+  _list.push(far);
+  _list.push(near);
+  ASSERT_EQ(_list.front(), near);
+  _list.push(nearest);
+  ASSERT_EQ(_list.front(), nearest);
+  ASSERT_TRUE(_list.erase(nearest));
+  ASSERT_EQ(_list.front(), near);
+  delete nearest;
+}
+
+// Given the wheel scheduler and events spread over several days
+// When events are rescheduled one after the other
+// Then front() is the earliest event after every reschedule.
+TEST_F(TimedEventList, WheelFrontAfterReschedules) {
+  time_t now(time(nullptr));
+  _list.set_scheduler(timed_event_list::wheel);
+
+  srand(42);
+  std::vector<timed_event*> events;
+  for (int i(0); i < 500; ++i) {
+    events.push_back(new_event(now + 1 + rand() % (1 << 18)));
+    _list.push(events.back());
+  }
+
+  for (int i(0); i < 5000; ++i) {
+    // Reschedule the front event as the events loop does, or a random
+    // one as external commands do.
+    timed_event* evt(i % 2 ? _list.front() : events[rand() % 500]);
+    ASSERT_TRUE(_list.erase(evt));
+    evt->set_run_time(now + 1 + rand() % (1 << 18));
+    _list.push(evt);
+
+    time_t earliest(evt->get_run_time());
+    for (timed_event_list::const_iterator
+           it(_list.begin()),
+           end(_list.end());
+         it != end;
+         ++it)
+      earliest = std::min(earliest, (*it)->get_run_time());
+    ASSERT_EQ(_list.front()->get_run_time(), earliest);
+
+    // Move forward from time to time to cascade upper levels, due
+    // events are run and rescheduled.
+    if (!(i % 100)) {
+      now += rand() % 2000;
+      _list.advance(now);
+      while (_list.front()->get_run_time() <= now) {
+        timed_event* due(_list.pop_front());
+        due->set_run_time(now + 1 + rand() % (1 << 18));
+        _list.push(due);
+      }
+    }
+  }
+}
+
+// Given the wheel scheduler and an event scheduled in the past
+// When it is pushed
+// Then it is immediately returned.
+TEST_F(TimedEventList, WheelPastEventIsReady) {
+  time_t now(time(nullptr));
+  _list.set_scheduler(timed_event_list::wheel);
+  _list.push(new_event(now + 60));
+  timed_event* late(new_event(now - 60));
+  _list.push(late);
+  ASSERT_EQ(_list.front(), late);
+}
+
+// Given scheduled events
+// When the scheduler is switched back and forth
+// Then events are kept and still ordered.
+TEST_F(TimedEventList, SwitchScheduler) {
+  time_t now(time(nullptr));
+  int data;
+  for (int i(0); i < 100; ++i)
+    _list.push(new_event(now + 1000 - i));
+  _list.push(new_event(now + 5000, EVENT_HOST_CHECK, &data));
+  _list.set_scheduler(timed_event_list::wheel);
+  ASSERT_EQ(_list.size(), 101u);
+  ASSERT_NE(_list.find(EVENT_HOST_CHECK, &data), nullptr);
+  ASSERT_EQ(_list.front()->get_run_time(), now + 901);
+  _list.set_scheduler(timed_event_list::heap);
+  ASSERT_EQ(_list.get_scheduler(), timed_event_list::heap);
+  ASSERT_EQ(_list.size(), 101u);
+
+  time_t last(0);
+  while (!_list.empty()) {
+    std::unique_ptr<timed_event> evt(_list.pop_front());
+    ASSERT_GE(evt->get_run_time(), last);
+    last = evt->get_run_time();
+  }
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "com/centreon/clib.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/configuration/host.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/macros/command_template.hh"
+#include "com/centreon/engine/macros/process.hh"
+#include "com/centreon/engine/timezone_manager.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+extern configuration::state* config;
+
+class CommandTemplate : public ::testing::Test {
+ public:
+  void SetUp() override {
+    clib::load();
+    com::centreon::logging::engine::load();
+    if (!config)
+      config = new configuration::state;
+    timezone_manager::load();
+    configuration::applier::state::load();
+
+    configuration::applier::host hst_aply;
+    configuration::host hst;
+    hst.parse("host_name", "test_host");
+    hst.parse("alias", "test_alias");
+    hst.parse("address", "127.0.0.1");
+    hst.parse("host_id", "12");
+    hst.parse("_SNMPCOMMUNITY", "public");
+    hst_aply.add_object(hst);
+    _macros.host_ptr = engine::host::hosts["test_host"].get();
+    _macros.argv[0] = "100,20%";
+    _macros.argv[1] = "500,60%";
+    macro_user[0] = "/usr/lib/nagios/plugins";
+  }
+
+  void TearDown() override {
+    macro_user[0].clear();
+    configuration::applier::state::unload();
+    delete config;
+    config = nullptr;
+    timezone_manager::unload();
+    com::centreon::logging::engine::unload();
+    clib::unload();
+  }
+
+  /**
+   *  Expand a command line with process_macros_r().
+   */
+  std::string process(std::string const& command_line, int options = 0) {
+    std::string output;
+    process_macros_r(&_macros, command_line, output, options);
+    return output;
+  }
+
+  /**
+   *  Expand a command line with a command template.
+   */
+  std::string expand(std::string const& command_line, int options = 0) {
+    std::string output;
+    macros::command_template(command_line).expand(&_macros, output, options);
+    return output;
+  }
+
+ protected:
+  nagios_macros _macros;
+};
+
+// Given a typical check command line
+// When it is expanded by a command template
+// Then standard, argument and user macros are replaced
+TEST_F(CommandTemplate, CheckCommand) {
+  std::string const command_line(
+    "$USER1$/check_ping -H $HOSTADDRESS$ -w $ARG1$ -c $ARG2$ -p 5");
+  ASSERT_EQ(
+    expand(command_line),
+    "/usr/lib/nagios/plugins/check_ping -H 127.0.0.1 "
+    "-w 100,20% -c 500,60% -p 5");
+  ASSERT_EQ(expand(command_line), process(command_line));
+}
+
+// Given command lines with escaped, unterminated and invalid macros
+// When they are expanded by a command template
+// Then the output is the one of process_macros_r()
+TEST_F(CommandTemplate, SameAsProcessMacros) {
+  char const* command_lines[] = {
+    "",
+    "no macro at all",
+    "echo $$HOME $HOSTNAME$$$ARG1$",
+    "unterminated $HOSTNAME",
+    "trailing dollar $",
+    "$_HOSTSNMPCOMMUNITY$ $ARG0$ $ARG33$ $USER0$ $UNKNOWN$ $$",
+    "$HOSTNAME:test_host$ $HOSTALIAS$$HOSTID$",
+    "$HOSTOUTPUT$ $HOSTPERFDATA$",
+    "$$$$$$"
+  };
+  for (unsigned int i(0);
+       i < sizeof(command_lines) / sizeof(*command_lines);
+       ++i) {
+    ASSERT_EQ(expand(command_lines[i]), process(command_lines[i]))
+      << "command line: " << command_lines[i];
+    ASSERT_EQ(
+      expand(command_lines[i], URL_ENCODE_MACRO_CHARS),
+      process(command_lines[i], URL_ENCODE_MACRO_CHARS))
+      << "command line: " << command_lines[i];
+  }
+}
+
+// Given a compiled command template
+// When a macro value changes
+// Then the next expansion uses the new value
+TEST_F(CommandTemplate, ValuesAreNotCompiled) {
+  macros::command_template tmpl("$USER1$/check -w $ARG1$");
+  std::string output;
+  tmpl.expand(&_macros, output);
+  ASSERT_EQ(output, "/usr/lib/nagios/plugins/check -w 100,20%");
+  _macros.argv[0] = "1";
+  macro_user[0] = "/opt/plugins";
+  tmpl.expand(&_macros, output);
+  ASSERT_EQ(output, "/opt/plugins/check -w 1");
+}
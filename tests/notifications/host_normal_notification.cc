@@ -44,6 +44,7 @@
 #include "com/centreon/engine/retention/dump.hh"
 #include "com/centreon/engine/config.hh"
 #include "com/centreon/engine/error.hh"
+#include "com/centreon/engine/events/timed_event.hh"
 #include "com/centreon/engine/modules/external_commands/commands.hh"
 #include "com/centreon/engine/timezone_manager.hh"
 
@@ -1113,3 +1114,47 @@ TEST_F(HostNotification, HostEscalationRetention) {
 
   ASSERT_EQ(notification0, notification1);
 }
+
+// Given a host notified at 20000 with a notification interval of one
+// minute
+// When the system time jumps one hour backwards
+// Then once compensated, the next notification is due one minute after
+// the previous one and not one hour later.
+TEST_F(HostNotification, NextNotificationAfterTimeJump) {
+  std::unique_ptr<engine::timeperiod> tperiod{
+      new engine::timeperiod("tperiod", "alias")};
+  for (int i = 0; i < 7; ++i)
+    tperiod->days[i].push_back(std::make_shared<engine::timerange>(0, 86400));
+
+  set_time(20000);
+  uint64_t id{_host->get_next_notification_id()};
+  _host->set_notification_period_ptr(tperiod.get());
+  _host->set_current_state(engine::host::state_down);
+  _host->set_last_state(engine::host::state_down);
+  _host->set_last_hard_state_change(19000);
+  _host->set_state_type(checkable::hard);
+  _host->set_notification_interval(1);
+  ASSERT_EQ(_host->notify(notifier::reason_normal, "", "",
+                          notifier::notification_option_none),
+            OK);
+  ASSERT_EQ(id + 1, _host->get_next_notification_id());
+  ASSERT_EQ(_host->get_last_notification(), 20000);
+
+  set_time(16400);
+  compensate_for_system_time_change(20000, 16400);
+  ASSERT_EQ(_host->get_last_notification(), 16400);
+  ASSERT_EQ(_host->get_last_hard_state_change(), 15400);
+  ASSERT_EQ(_host->get_next_notification(), 16460);
+
+  set_time(16430);
+  ASSERT_EQ(_host->notify(notifier::reason_normal, "", "",
+                          notifier::notification_option_none),
+            OK);
+  ASSERT_EQ(id + 1, _host->get_next_notification_id());
+
+  set_time(16460);
+  ASSERT_EQ(_host->notify(notifier::reason_normal, "", "",
+                          notifier::notification_option_none),
+            OK);
+  ASSERT_EQ(id + 2, _host->get_next_notification_id());
+}
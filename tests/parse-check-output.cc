@@ -1,6 +1,91 @@
+#include <cctype>
+#include <random>
+#include <string>
 #include "gtest/gtest.h"
 #include "com/centreon/engine/utils.hh"
 
+// The line by line implementation parse_check_output() used to have,
+// kept as a reference for fuzz tests.
+static void reference_parse_check_output(
+              std::string const& buffer,
+              std::string& short_buffer,
+              std::string& long_buffer,
+              std::string& pd_buffer,
+              bool escape_newlines_please,
+              bool newlines_are_escaped) {
+  bool long_pipe{false};
+  bool perfdata_already_filled{false};
+  bool eof{false};
+  std::string line;
+  size_t start_line{0}, end_line, pos_line;
+  int line_number{1};
+  while (!eof) {
+    if (newlines_are_escaped && (pos_line = buffer.find("\\n", start_line)) != std::string::npos) {
+      end_line = pos_line;
+      pos_line += 2;
+    }
+    else if ((pos_line = buffer.find("\n", start_line)) != std::string::npos) {
+      end_line = pos_line;
+      pos_line++;
+    }
+    else {
+      end_line = buffer.size();
+      eof = true;
+    }
+    line = buffer.substr(start_line, end_line - start_line);
+    size_t pipe;
+    if (!long_pipe)
+      pipe = line.find_last_of('|');
+    else
+      pipe = std::string::npos;
+
+    if (pipe != std::string::npos) {
+      end_line = pipe;
+      while (end_line > 1 && std::isspace(line[end_line - 1]))
+        end_line--;
+      pipe++;
+      while (pipe < line.size() - 1 && std::isspace(line[pipe]))
+        pipe++;
+      if (line_number == 1) {
+        short_buffer.append(line.substr(0, end_line));
+        pd_buffer.append(line.substr(pipe));
+        perfdata_already_filled = true;
+      }
+      else {
+        if (line_number > 2)
+          long_buffer.append(escape_newlines_please ? "\\n" : "\n");
+        long_buffer.append(line.substr(0, end_line));
+        if (perfdata_already_filled)
+          pd_buffer.append(" ");
+        pd_buffer.append(line.substr(pipe));
+        long_pipe = true;
+      }
+    }
+    else {
+      end_line = line.size();
+      while (end_line > 1 && std::isspace(line[end_line - 1]))
+        end_line--;
+      line.erase(end_line);
+      if (line_number == 1)
+        short_buffer.append(line);
+      else {
+        if (!long_pipe) {
+          if (line_number > 2)
+            long_buffer.append(escape_newlines_please ? "\\n" : "\n");
+          long_buffer.append(line);
+        }
+        else {
+          if (perfdata_already_filled)
+            pd_buffer.append(" ");
+          pd_buffer.append(line);
+        }
+      }
+    }
+    start_line = pos_line;
+    line_number++;
+  }
+}
+
 TEST(ParseCheckOutput, singleLineWithoutPerfdata) {
   std::string buf = "The service is OK";
   std::string short_output;
@@ -140,3 +225,63 @@ TEST(ParseCheckOutput, multipleLineWithMultiplePerfdata1ReturnEscaped) {
   ASSERT_EQ(long_output, "/ 15272 MB (77%);\n/boot 68 MB (69%);\n/home 69357 MB (27%);\n/var/log 819 MB (84%);");
   ASSERT_EQ(perf_data, "/=2643MB;5948;5958;0;5968 /boot=68MB;88;93;0;98 /home=69357MB;253404;253409;0;253414 /var/log=818MB;970;975;0;980");
 }
+
+TEST(ParseCheckOutput, largeLongOutput) {
+  std::string buf = "SNMP OK - 2000 interfaces | if_count=2000";
+  std::string expected_long;
+  for (int i = 0; i < 2000; ++i) {
+    std::string row("ifIndex." + std::to_string(i) + " = up   ");
+    buf.append("\n").append(row);
+    if (i)
+      expected_long.append("\\n");
+    expected_long.append(row, 0, row.size() - 3);
+  }
+  std::string short_output;
+  std::string long_output;
+  std::string perf_data;
+
+  parse_check_output(buf, short_output, long_output, perf_data, true, false);
+  ASSERT_EQ(short_output, "SNMP OK - 2000 interfaces");
+  ASSERT_EQ(long_output, expected_long);
+  ASSERT_EQ(perf_data, "if_count=2000");
+}
+
+TEST(ParseCheckOutput, appendToNonEmptyOutputs) {
+  std::string buf = "OK | a=1\nline";
+  std::string short_output("s:");
+  std::string long_output("l:");
+  std::string perf_data("p:");
+
+  parse_check_output(buf, short_output, long_output, perf_data, true, false);
+  ASSERT_EQ(short_output, "s:OK");
+  ASSERT_EQ(long_output, "l:line");
+  ASSERT_EQ(perf_data, "p:a=1");
+}
+
+// Given random outputs made of the characters the parser cares about
+// When they are parsed with all flag combinations
+// Then the results are the ones of the reference implementation.
+TEST(ParseCheckOutput, fuzzAgainstReference) {
+  static char const alphabet[] = "ab =;|| \t\r\n\n\\\\nnx";
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> length(0, 48);
+  std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2);
+  for (int i = 0; i < 20000; ++i) {
+    std::string buf;
+    for (size_t len = length(gen); len; --len)
+      buf.push_back(alphabet[pick(gen)]);
+    for (int flags = 0; flags < 4; ++flags) {
+      bool escape_newlines(flags & 1);
+      bool newlines_are_escaped(flags & 2);
+      std::string short_output, long_output, perf_data;
+      std::string ref_short, ref_long, ref_perf;
+      parse_check_output(buf, short_output, long_output, perf_data,
+                         escape_newlines, newlines_are_escaped);
+      reference_parse_check_output(buf, ref_short, ref_long, ref_perf,
+                                   escape_newlines, newlines_are_escaped);
+      ASSERT_EQ(short_output, ref_short) << "input: '" << buf << "'";
+      ASSERT_EQ(long_output, ref_long) << "input: '" << buf << "'";
+      ASSERT_EQ(perf_data, ref_perf) << "input: '" << buf << "'";
+    }
+  }
+}
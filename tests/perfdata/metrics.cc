@@ -0,0 +1,172 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include "com/centreon/engine/perfdata.hh"
+
+using namespace com::centreon::engine;
+
+// Given performance data with several metrics
+// When it is parsed
+// Then every metric is available with its value, unit and bounds.
+TEST(PerfdataMetrics, FullMetrics) {
+  perfdata pd;
+  ASSERT_TRUE(pd.parse(
+    "time=0.012s;1;2;0;10 size=4096B;;;0 'used %'=55.5%;80;90;0;100"));
+  ASSERT_EQ(pd.size(), 3u);
+
+  perfdata::metric const& time(pd.metrics()[0]);
+  ASSERT_STREQ(time.label, "time");
+  ASSERT_STREQ(time.unit, "s");
+  ASSERT_DOUBLE_EQ(time.value, 0.012);
+  ASSERT_DOUBLE_EQ(time.warning.low, 0.0);
+  ASSERT_DOUBLE_EQ(time.warning.high, 1.0);
+  ASSERT_FALSE(time.warning.inverted);
+  ASSERT_DOUBLE_EQ(time.critical.high, 2.0);
+  ASSERT_DOUBLE_EQ(time.min, 0.0);
+  ASSERT_DOUBLE_EQ(time.max, 10.0);
+
+  perfdata::metric const& size(pd.metrics()[1]);
+  ASSERT_STREQ(size.label, "size");
+  ASSERT_STREQ(size.unit, "B");
+  ASSERT_DOUBLE_EQ(size.value, 4096.0);
+  ASSERT_FALSE(size.warning.is_set());
+  ASSERT_FALSE(size.critical.is_set());
+  ASSERT_DOUBLE_EQ(size.min, 0.0);
+  ASSERT_TRUE(std::isnan(size.max));
+
+  perfdata::metric const* used(pd.find("used %"));
+  ASSERT_NE(used, nullptr);
+  ASSERT_STREQ(used->unit, "%");
+  ASSERT_DOUBLE_EQ(used->value, 55.5);
+}
+
+// Given quoted labels
+// When they hold spaces, equal signs or doubled quotes
+// Then labels are unquoted.
+TEST(PerfdataMetrics, QuotedLabels) {
+  perfdata pd;
+  ASSERT_TRUE(pd.parse("'a b'=1 'c=d'=2 'it''s'=3 ''''=4"));
+  ASSERT_EQ(pd.size(), 4u);
+  ASSERT_STREQ(pd.metrics()[0].label, "a b");
+  ASSERT_STREQ(pd.metrics()[1].label, "c=d");
+  ASSERT_STREQ(pd.metrics()[2].label, "it's");
+  ASSERT_STREQ(pd.metrics()[3].label, "'");
+  ASSERT_DOUBLE_EQ(pd.metrics()[3].value, 4.0);
+}
+
+// Given thresholds in the range format
+// When they are parsed
+// Then their bounds follow the plugins guidelines.
+TEST(PerfdataMetrics, Ranges) {
+  perfdata pd;
+  ASSERT_TRUE(pd.parse(
+    "a=1;10:;~:20 b=1;@10:20;5:15 c=1;-5:-1;~: d=1;abc;1:x"));
+  ASSERT_EQ(pd.size(), 4u);
+  double const inf(std::numeric_limits<double>::infinity());
+
+  perfdata::metric const& a(pd.metrics()[0]);
+  ASSERT_DOUBLE_EQ(a.warning.low, 10.0);
+  ASSERT_EQ(a.warning.high, inf);
+  ASSERT_EQ(a.critical.low, -inf);
+  ASSERT_DOUBLE_EQ(a.critical.high, 20.0);
+
+  perfdata::metric const& b(pd.metrics()[1]);
+  ASSERT_TRUE(b.warning.inverted);
+  ASSERT_DOUBLE_EQ(b.warning.low, 10.0);
+  ASSERT_DOUBLE_EQ(b.warning.high, 20.0);
+  ASSERT_FALSE(b.critical.inverted);
+  ASSERT_DOUBLE_EQ(b.critical.low, 5.0);
+  ASSERT_DOUBLE_EQ(b.critical.high, 15.0);
+
+  perfdata::metric const& c(pd.metrics()[2]);
+  ASSERT_DOUBLE_EQ(c.warning.low, -5.0);
+  ASSERT_DOUBLE_EQ(c.warning.high, -1.0);
+  ASSERT_EQ(c.critical.low, -inf);
+  ASSERT_EQ(c.critical.high, inf);
+
+  perfdata::metric const& d(pd.metrics()[3]);
+  ASSERT_FALSE(d.warning.is_set());
+  ASSERT_FALSE(d.critical.is_set());
+}
+
+// Given values with a decimal comma or unknown
+// When they are parsed
+// Then the comma is a decimal separator and unknown values are NaN.
+TEST(PerfdataMetrics, SpecialValues) {
+  perfdata pd;
+  ASSERT_TRUE(pd.parse("load=0,75 temp=U;;;; neg=-3.5e2ms"));
+  ASSERT_EQ(pd.size(), 3u);
+  ASSERT_DOUBLE_EQ(pd.metrics()[0].value, 0.75);
+  ASSERT_STREQ(pd.metrics()[0].unit, "");
+  ASSERT_TRUE(std::isnan(pd.metrics()[1].value));
+  ASSERT_DOUBLE_EQ(pd.metrics()[2].value, -350.0);
+  ASSERT_STREQ(pd.metrics()[2].unit, "ms");
+}
+
+// Given performance data with malformed metrics
+// When it is parsed
+// Then malformed metrics are skipped and the others kept.
+TEST(PerfdataMetrics, MalformedMetrics) {
+  perfdata pd;
+  ASSERT_FALSE(pd.parse(
+    "ok=1 novalue= noequal =5 bad=abc 'unterminated=3 after=2"));
+  ASSERT_EQ(pd.size(), 1u);
+  ASSERT_STREQ(pd.metrics()[0].label, "ok");
+
+  ASSERT_FALSE(pd.parse("a b=1 c=2"));
+  ASSERT_EQ(pd.size(), 2u);
+  ASSERT_STREQ(pd.metrics()[0].label, "b");
+  ASSERT_STREQ(pd.metrics()[1].label, "c");
+
+  ASSERT_TRUE(pd.parse("  \t "));
+  ASSERT_TRUE(pd.empty());
+}
+
+// Given two parses of metrics with the same label and unit
+// When their labels and units are compared
+// Then they are the same interned strings.
+TEST(PerfdataMetrics, InternedLabels) {
+  perfdata first;
+  perfdata second;
+  ASSERT_TRUE(first.parse("rta=0.1ms;100;500;0"));
+  ASSERT_TRUE(second.parse("pl=0% 'rta'=0.2ms"));
+  ASSERT_EQ(first.metrics()[0].label, second.metrics()[1].label);
+  ASSERT_EQ(first.metrics()[0].unit, second.metrics()[1].unit);
+  ASSERT_EQ(first.metrics()[0].label, perfdata::intern("rta")->c_str());
+  ASSERT_NE(first.metrics()[0].label, second.metrics()[0].label);
+}
+
+// Given parsed metrics
+// When the original performance data is destroyed
+// Then the labels and units of its copies remain valid.
+TEST(PerfdataMetrics, InternedLabelsOutliveOriginal) {
+  std::unique_ptr<perfdata> original(new perfdata);
+  ASSERT_TRUE(original->parse("'unique label'=1KB"));
+  perfdata copy(*original);
+  original.reset();
+  ASSERT_STREQ(copy.metrics()[0].label, "unique label");
+  ASSERT_STREQ(copy.metrics()[0].unit, "KB");
+  ASSERT_EQ(
+    copy.metrics()[0].label,
+    perfdata::intern("unique label")->c_str());
+}